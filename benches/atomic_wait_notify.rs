@@ -0,0 +1,73 @@
+//! Measure contended `memory.atomic.wait32` and `memory.atomic.notify` on a
+//! shared memory, as used by fine-grained locking in multi-threaded guests.
+//!
+//! Threads are paired up and each pair ping-pongs on its own address, so the
+//! pairs only contend with each other inside Wasmtime's wait table.
+
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
+use std::sync::atomic::{AtomicU32, Ordering::SeqCst};
+use std::thread;
+use std::time::{Duration, Instant};
+use wasmtime::*;
+
+criterion_group!(benches, bench_atomic_wait_notify);
+criterion_main!(benches);
+
+fn bench_atomic_wait_notify(c: &mut Criterion) {
+    let mut config = Config::new();
+    config.wasm_threads(true);
+    let engine = Engine::new(&config).unwrap();
+
+    let mut group = c.benchmark_group("atomic-wait-notify");
+    for num_threads in [2, 4, 8, 16, 32, 64] {
+        group.throughput(Throughput::Elements(num_threads / 2));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(num_threads),
+            &num_threads,
+            |b, &num_threads| {
+                let memory = SharedMemory::new(&engine, MemoryType::shared(1, 1)).unwrap();
+                b.iter_custom(|iters| ping_pong(&memory, num_threads / 2, iters));
+            },
+        );
+    }
+    group.finish();
+}
+
+/// Runs `pairs` pairs of threads which each pass a token back and forth
+/// `iters` times, returning the total elapsed time.
+fn ping_pong(memory: &SharedMemory, pairs: u64, iters: u64) -> Duration {
+    let start = Instant::now();
+    thread::scope(|s| {
+        for pair in 0..pairs {
+            // Space the addresses out so each is on its own cache line.
+            let addr = pair * 64;
+            s.spawn(move || player(memory, addr, 0, iters));
+            s.spawn(move || player(memory, addr, 1, iters));
+        }
+    });
+    start.elapsed()
+}
+
+/// Waits for the value at `addr` to be `me`, then hands it to the other
+/// player, `iters` times.
+fn player(memory: &SharedMemory, addr: u64, me: u32, iters: u64) {
+    let atomic = atomic_at(memory, addr);
+    for _ in 0..iters {
+        loop {
+            let cur = atomic.load(SeqCst);
+            if cur == me {
+                break;
+            }
+            memory.atomic_wait32(addr, cur, None).unwrap();
+        }
+        atomic.store(1 - me, SeqCst);
+        memory.atomic_notify(addr, 1).unwrap();
+    }
+}
+
+fn atomic_at(memory: &SharedMemory, addr: u64) -> &AtomicU32 {
+    let cell = &memory.data()[usize::try_from(addr).unwrap()];
+    // SAFETY: shared memory is only ever accessed atomically in this
+    // benchmark and `addr` is 4-byte aligned.
+    unsafe { &*cell.get().cast::<AtomicU32>() }
+}
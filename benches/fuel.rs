@@ -0,0 +1,110 @@
+//! Measure the overhead of fuel metering on compute-bound kernels, comparing
+//! exact fuel with approximate fuel and with fuel disabled.
+//!
+//! The kernels mirror the workloads in `applications/`: an iterative
+//! Fibonacci, a hash over a buffer, and the nested loops of the PolyBench
+//! correlation kernel.
+
+use criterion::{BenchmarkId, Criterion, criterion_group, criterion_main};
+use wasmtime::{Config, Engine, Instance, Module, Store, TypedFunc};
+
+criterion_main!(benches);
+criterion_group!(benches, bench_fuel);
+
+const KERNELS: &[(&str, &str, u32)] = &[
+    (
+        "fibonacci",
+        r#"
+            (module
+                (func (export "run") (param $n i32) (result i32)
+                    (local $a i32) (local $b i32) (local $t i32)
+                    (local.set $b (i32.const 1))
+                    (block $done
+                        (loop $l
+                            (br_if $done (i32.eqz (local.get $n)))
+                            (local.set $t (i32.add (local.get $a) (local.get $b)))
+                            (local.set $a (local.get $b))
+                            (local.set $b (local.get $t))
+                            (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+                            (br $l)))
+                    (local.get $a)))
+        "#,
+        100_000,
+    ),
+    (
+        "hash",
+        r#"
+            (module
+                (memory 1)
+                (func (export "run") (param $n i32) (result i32)
+                    (local $h i32) (local $i i32)
+                    (local.set $h (i32.const 0x811c9dc5))
+                    (loop $l
+                        (local.set $h
+                            (i32.mul
+                                (i32.xor
+                                    (local.get $h)
+                                    (i32.load8_u (i32.and (local.get $i) (i32.const 0xffff))))
+                                (i32.const 0x01000193)))
+                        (if (i32.eqz (i32.and (local.get $h) (i32.const 1)))
+                            (then (local.set $h (i32.rotl (local.get $h) (i32.const 5)))))
+                        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+                        (br_if $l (i32.lt_u (local.get $i) (local.get $n))))
+                    (local.get $h)))
+        "#,
+        100_000,
+    ),
+    (
+        "correlation",
+        r#"
+            (module
+                (memory 1)
+                (func (export "run") (param $n i32) (result i32)
+                    (local $i i32) (local $j i32) (local $k i32) (local $sum f64)
+                    (loop $li
+                        (local.set $j (local.get $i))
+                        (loop $lj
+                            (local.set $sum (f64.const 0))
+                            (local.set $k (i32.const 0))
+                            (loop $lk
+                                (local.set $sum
+                                    (f64.add
+                                        (local.get $sum)
+                                        (f64.mul
+                                            (f64.load (i32.shl (i32.add (local.get $k) (local.get $i)) (i32.const 3)))
+                                            (f64.load (i32.shl (i32.add (local.get $k) (local.get $j)) (i32.const 3))))))
+                                (local.set $k (i32.add (local.get $k) (i32.const 1)))
+                                (br_if $lk (i32.lt_u (local.get $k) (local.get $n))))
+                            (f64.store (i32.shl (local.get $j) (i32.const 3)) (local.get $sum))
+                            (local.set $j (i32.add (local.get $j) (i32.const 1)))
+                            (br_if $lj (i32.lt_u (local.get $j) (local.get $n))))
+                        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+                        (br_if $li (i32.lt_u (local.get $i) (local.get $n))))
+                    (local.get $n)))
+        "#,
+        64,
+    ),
+];
+
+fn bench_fuel(c: &mut Criterion) {
+    for (name, wat, arg) in KERNELS {
+        let mut group = c.benchmark_group(format!("fuel/{name}"));
+        for mode in ["none", "exact", "approximate"] {
+            let mut config = Config::new();
+            config.consume_fuel(mode != "none");
+            config.approximate_fuel(mode == "approximate");
+            let engine = Engine::new(&config).unwrap();
+            let module = Module::new(&engine, wat).unwrap();
+            let mut store = Store::new(&engine, ());
+            if mode != "none" {
+                store.set_fuel(u64::MAX).unwrap();
+            }
+            let instance = Instance::new(&mut store, &module, &[]).unwrap();
+            let run: TypedFunc<u32, u32> = instance.get_typed_func(&mut store, "run").unwrap();
+            group.bench_function(BenchmarkId::from_parameter(mode), |b| {
+                b.iter(|| run.call(&mut store, *arg).unwrap())
+            });
+        }
+        group.finish();
+    }
+}
@@ -0,0 +1,131 @@
+//! Benchmarks for GC allocation throughput and collection pause times.
+
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
+use std::time::{Duration, Instant};
+use wasmtime::*;
+
+criterion_main!(benches);
+criterion_group!(benches, bench_gc);
+
+fn bench_gc(c: &mut Criterion) {
+    allocation_rate(c);
+    pause_time(c);
+}
+
+const WAT: &str = r#"
+    (module
+        (type $node (struct (field (mut i32)) (field (mut (ref null $node)))))
+        (type $bytes (array (mut i8)))
+
+        (global $live (mut (ref null $node)) (ref.null $node))
+
+        ;; Allocate `n` structs, keeping every struct whose index has none of
+        ;; the bits of `keep_mask` set alive in a linked list.
+        (func (export "alloc_structs") (param $n i32) (param $keep_mask i32)
+            (local $node (ref null $node))
+            (loop $l
+                (local.set $node (struct.new $node (local.get $n) (ref.null $node)))
+                (if (i32.eqz (i32.and (local.get $n) (local.get $keep_mask)))
+                    (then
+                        (struct.set $node 1 (local.get $node) (global.get $live))
+                        (global.set $live (local.get $node))))
+                (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1))))))
+
+        ;; Allocate `n` short-lived byte arrays of length `len`.
+        (func (export "alloc_arrays") (param $n i32) (param $len i32)
+            (loop $l
+                (drop (array.new_default $bytes (local.get $len)))
+                (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1))))))
+
+        (func (export "clear")
+            (global.set $live (ref.null $node)))
+    )
+"#;
+
+/// Number of objects allocated per call into Wasm.
+const ALLOCS: u32 = 10_000;
+
+fn engine() -> Engine {
+    let mut config = Config::new();
+    config.wasm_function_references(true);
+    config.wasm_gc(true);
+    config.collector(Collector::DeferredReferenceCounting);
+    Engine::new(&config).unwrap()
+}
+
+fn instantiate(engine: &Engine) -> (Store<()>, Instance) {
+    let module = Module::new(engine, WAT).unwrap();
+    let mut store = Store::new(engine, ());
+    let instance = Instance::new(&mut store, &module, &[]).unwrap();
+    (store, instance)
+}
+
+/// How fast can Wasm allocate objects, depending on how many of them survive?
+fn allocation_rate(c: &mut Criterion) {
+    let mut group = c.benchmark_group("gc-allocation-rate");
+    group.throughput(Throughput::Elements(u64::from(ALLOCS)));
+    let engine = engine();
+
+    // The mask is applied to the allocation's index, so `u32::MAX` keeps
+    // nothing alive and `0` keeps everything alive.
+    for (name, keep_mask) in [("none-live", u32::MAX), ("1-in-16-live", 0xf)] {
+        group.bench_function(BenchmarkId::new("structs", name), |b| {
+            let (mut store, instance) = instantiate(&engine);
+            let alloc = instance
+                .get_typed_func::<(u32, u32), ()>(&mut store, "alloc_structs")
+                .unwrap();
+            let clear = instance
+                .get_typed_func::<(), ()>(&mut store, "clear")
+                .unwrap();
+            b.iter(|| {
+                alloc.call(&mut store, (ALLOCS, keep_mask)).unwrap();
+                clear.call(&mut store, ()).unwrap();
+            });
+        });
+    }
+
+    for len in [16, 256] {
+        group.bench_function(BenchmarkId::new("arrays", len), |b| {
+            let (mut store, instance) = instantiate(&engine);
+            let alloc = instance
+                .get_typed_func::<(u32, u32), ()>(&mut store, "alloc_arrays")
+                .unwrap();
+            b.iter(|| alloc.call(&mut store, (ALLOCS, len)).unwrap());
+        });
+    }
+
+    group.finish();
+}
+
+/// How long does a full collection take, depending on the size of the live
+/// heap?
+fn pause_time(c: &mut Criterion) {
+    let mut group = c.benchmark_group("gc-pause-time");
+    let engine = engine();
+
+    for live in [0, 1_000, 10_000] {
+        group.bench_function(BenchmarkId::from_parameter(live), |b| {
+            let (mut store, instance) = instantiate(&engine);
+            let alloc = instance
+                .get_typed_func::<(u32, u32), ()>(&mut store, "alloc_structs")
+                .unwrap();
+            if live > 0 {
+                alloc.call(&mut store, (live, 0)).unwrap();
+            }
+
+            b.iter_custom(|iters| {
+                let mut elapsed = Duration::ZERO;
+                for _ in 0..iters {
+                    // Create a fresh batch of garbage for every collection.
+                    alloc.call(&mut store, (ALLOCS, u32::MAX)).unwrap();
+                    let start = Instant::now();
+                    store.gc(None);
+                    elapsed += start.elapsed();
+                }
+                elapsed
+            });
+        });
+    }
+
+    group.finish();
+}
@@ -0,0 +1,108 @@
+//! Measure the throughput of transcoding strings passed between components
+//! which use different string encodings.
+
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
+use wasmtime::component::{Component, Func, Linker};
+use wasmtime::{Engine, Store};
+
+criterion_main!(benches);
+criterion_group!(benches, bench_transcode);
+
+fn bench_transcode(c: &mut Criterion) {
+    let engine = Engine::default();
+
+    for (src, dst) in [
+        ("utf8", "utf8"),
+        ("utf8", "utf16"),
+        ("utf8", "latin1+utf16"),
+        ("utf16", "utf8"),
+        ("utf16", "latin1+utf16"),
+    ] {
+        let mut group = c.benchmark_group(format!("transcode/{src}-to-{dst}"));
+        let (mut store, func) = instantiate(&engine, src, dst);
+        let func = func.typed::<(&str,), (u32,)>(&store).unwrap();
+
+        for (kind, unit) in [("ascii", "a"), ("non-ascii", "aaaaaaaaaaaaaaaé")] {
+            for size in [64, 4 << 10, 64 << 10, 1 << 20] {
+                let string = unit.repeat(size / unit.len());
+                group.throughput(Throughput::Bytes(string.len() as u64));
+                group.bench_with_input(BenchmarkId::new(kind, size), &string, |b, string| {
+                    b.iter(|| {
+                        func.call(&mut store, (string.as_str(),)).unwrap();
+                        func.post_return(&mut store).unwrap();
+                    })
+                });
+            }
+        }
+
+        group.finish();
+    }
+}
+
+/// Creates a component where the `len` export, which uses the `src` string
+/// encoding, passes its argument to a function using the `dst` string
+/// encoding. All transcoding happens within the adapter between the two.
+fn instantiate(engine: &Engine, src: &str, dst: &str) -> (Store<()>, Func) {
+    // A `realloc` which always returns the same allocation, growing memory as
+    // necessary, so that repeated calls don't exhaust memory.
+    let libc = r#"
+        (core module $libc
+            (memory (export "memory") 1)
+            (func (export "realloc") (param i32 i32 i32 i32) (result i32)
+                (local $pages i32)
+                (local.set $pages
+                    (i32.shr_u (i32.add (local.get 3) (i32.const 65543)) (i32.const 16)))
+                (if (i32.gt_u (local.get $pages) (memory.size))
+                    (then (drop (memory.grow (i32.sub (local.get $pages) (memory.size))))))
+                i32.const 8)
+        )
+        (core instance $libc (instantiate $libc))
+    "#;
+    let wat = format!(
+        r#"
+(component
+    (component $dst
+        {libc}
+        (core module $m
+            (func (export "len") (param i32 i32) (result i32) local.get 1)
+        )
+        (core instance $m (instantiate $m))
+        (func (export "len") (param "a" string) (result u32)
+            (canon lift (core func $m "len")
+                (memory $libc "memory")
+                (realloc (func $libc "realloc"))
+                string-encoding={dst}))
+    )
+    (component $src
+        (import "len" (func $len (param "a" string) (result u32)))
+        {libc}
+        (core func $len (canon lower (func $len)
+            (memory $libc "memory")
+            string-encoding={src}))
+        (core module $m
+            (import "" "len" (func $len (param i32 i32) (result i32)))
+            (func (export "len") (param i32 i32) (result i32)
+                (call $len (local.get 0) (local.get 1)))
+        )
+        (core instance $m (instantiate $m
+            (with "" (instance (export "len" (func $len))))))
+        (func (export "len") (param "a" string) (result u32)
+            (canon lift (core func $m "len")
+                (memory $libc "memory")
+                (realloc (func $libc "realloc"))
+                string-encoding={src}))
+    )
+    (instance $dst (instantiate $dst))
+    (instance $src (instantiate $src (with "len" (func $dst "len"))))
+    (export "len" (func $src "len"))
+)
+        "#
+    );
+    let component = Component::new(engine, &wat).unwrap();
+    let mut store = Store::new(engine, ());
+    let instance = Linker::new(engine)
+        .instantiate(&mut store, &component)
+        .unwrap();
+    let func = instance.get_func(&mut store, "len").unwrap();
+    (store, func)
+}
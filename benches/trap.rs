@@ -10,6 +10,7 @@ fn bench_traps(c: &mut Criterion) {
     bench_many_modules_registered_traps(c);
     bench_many_stack_frames_traps(c);
     bench_host_wasm_frames_traps(c);
+    bench_exit_traps(c);
 }
 
 fn bench_multi_threaded_traps(c: &mut Criterion) {
@@ -213,6 +214,84 @@ fn bench_host_wasm_frames_traps(c: &mut Criterion) {
     group.finish()
 }
 
+/// An error like WASI's `I32Exit`, returned from a host function to exit.
+#[derive(Debug)]
+struct Exit(i32);
+
+impl std::fmt::Display for Exit {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        write!(f, "exited with status {}", self.0)
+    }
+}
+
+impl std::error::Error for Exit {}
+
+/// Measures a `_start`-style program exiting through a `proc_exit`-like host
+/// function from the bottom of a stack of wasm frames, where the embedder
+/// only looks at the exit status. Compares not capturing a backtrace at all,
+/// capturing one that's never symbolicated, and capturing and symbolicating
+/// one.
+fn bench_exit_traps(c: &mut Criterion) {
+    let mut group = c.benchmark_group("exit-traps");
+
+    for (name, backtrace, symbolicate) in [
+        ("no-backtrace", false, false),
+        ("lazy-backtrace", true, false),
+        ("symbolicated-backtrace", true, true),
+    ] {
+        let mut config = Config::new();
+        config.wasm_backtrace(backtrace);
+        let engine = Engine::new(&config).unwrap();
+
+        for num_stack_frames in vec![1, 8, 64, 512] {
+            let module = exit_module(&engine, num_stack_frames).unwrap();
+            group.throughput(Throughput::Elements(num_stack_frames));
+            group.bench_with_input(
+                BenchmarkId::new(name, num_stack_frames),
+                &num_stack_frames,
+                |b, _| {
+                    b.iter_custom(|iters| {
+                        let mut store = Store::new(&engine, ());
+                        let exit = Func::wrap(&mut store, |code: i32| -> Result<()> {
+                            Err(Exit(code).into())
+                        });
+                        let instance = Instance::new(&mut store, &module, &[exit.into()]).unwrap();
+                        let f = instance.get_typed_func::<(), ()>(&mut store, "").unwrap();
+
+                        let start = std::time::Instant::now();
+                        for _ in 0..iters {
+                            let err = f.call(&mut store, ()).unwrap_err();
+                            assert_eq!(err.downcast_ref::<Exit>().unwrap().0, 0);
+                            if symbolicate {
+                                let bt = err.downcast_ref::<WasmBacktrace>().unwrap();
+                                assert_eq!(bt.frames().len() as u64, num_stack_frames + 1);
+                            }
+                        }
+                        start.elapsed()
+                    });
+                },
+            );
+        }
+    }
+
+    group.finish()
+}
+
+fn exit_module(engine: &Engine, num_funcs: u64) -> Result<Module> {
+    let mut wat = String::new();
+    wat.push_str("(module\n");
+    wat.push_str("(import \"\" \"exit\" (func $exit (param i32)))\n");
+    for i in 0..num_funcs {
+        let j = i + 1;
+        wat.push_str(&format!("(func $f{i} call $f{j})\n"));
+    }
+    wat.push_str(&format!("(func $f{num_funcs} i32.const 0 call $exit)\n"));
+    wat.push_str(&format!("(export \"\" (func $f0))\n"));
+    wat.push_str(")\n");
+
+    Module::new(engine, &wat)
+}
+
 fn module(engine: &Engine, num_funcs: u64) -> Result<Module> {
     let mut wat = String::new();
     wat.push_str("(module\n");
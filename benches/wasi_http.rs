@@ -0,0 +1,92 @@
+//! Measure the throughput of reading `wasi:http` incoming bodies.
+
+use bytes::Bytes;
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
+use http_body_util::{BodyExt, StreamBody};
+use hyper::body::Frame;
+use std::time::Duration;
+use wasmtime_wasi::p2::{InputStream, StreamError};
+use wasmtime_wasi_http::body::{HostIncomingBody, HostIncomingBodyStream, HyperIncomingBody};
+
+criterion_main!(benches);
+criterion_group!(benches, bench_wasi_http);
+
+/// Size of each data frame that the body is made of.
+const FRAME: usize = 64 << 10;
+
+/// Size of the buffer that the "guest" reads into on each call.
+const GUEST_BUFFER: usize = 64 << 10;
+
+fn bench_wasi_http(c: &mut Criterion) {
+    let rt = tokio::runtime::Builder::new_current_thread()
+        .enable_time()
+        .build()
+        .unwrap();
+
+    let mut group = c.benchmark_group("wasi-http-incoming-body");
+    group.sample_size(10);
+
+    for size in [1 << 20, 16 << 20, 256 << 20, 1 << 30] {
+        group.throughput(Throughput::Bytes(size as u64));
+
+        // Reads frames as `Bytes`, converting them to a `Vec<u8>` and then
+        // copying them into the guest buffer, which is what lowering the
+        // result of `input-stream.read` does.
+        group.bench_function(BenchmarkId::new("read", size), |b| {
+            let mut guest = vec![0; GUEST_BUFFER];
+            b.iter(|| {
+                let mut body = HostIncomingBody::new(body(size), Duration::from_secs(600));
+                let mut stream = body.take_stream().unwrap();
+                let read = rt.block_on(async {
+                    let mut total = 0;
+                    loop {
+                        match stream.blocking_read(guest.len()).await {
+                            Ok(bytes) => {
+                                let bytes = Vec::from(bytes);
+                                guest[..bytes.len()].copy_from_slice(&bytes);
+                                total += bytes.len();
+                            }
+                            Err(StreamError::Closed) => break total,
+                            Err(e) => panic!("failed to read body: {e:?}"),
+                        }
+                    }
+                });
+                assert_eq!(read, size);
+            });
+        });
+
+        // Copies frames directly into the guest buffer.
+        group.bench_function(BenchmarkId::new("read_into", size), |b| {
+            let mut guest = vec![0; GUEST_BUFFER];
+            b.iter(|| {
+                let mut body = HostIncomingBody::new(body(size), Duration::from_secs(600));
+                let mut stream = body.take_stream().unwrap();
+                let read = rt.block_on(read_into(&mut stream, &mut guest));
+                assert_eq!(read, size);
+            });
+        });
+    }
+
+    group.finish();
+}
+
+/// Creates a body of `size` bytes split into `FRAME`-sized data frames.
+///
+/// All frames share the same allocation so that creating the body doesn't
+/// dominate the measurement.
+fn body(size: usize) -> HyperIncomingBody {
+    let chunk = Bytes::from(vec![0xa5; FRAME]);
+    let frames = (0..size / FRAME).map(move |_| Ok(Frame::data(chunk.clone())));
+    StreamBody::new(futures::stream::iter(frames)).boxed()
+}
+
+async fn read_into(stream: &mut HostIncomingBodyStream, guest: &mut [u8]) -> usize {
+    let mut total = 0;
+    loop {
+        match stream.blocking_read_into(guest).await {
+            Ok(n) => total += n,
+            Err(StreamError::Closed) => break total,
+            Err(e) => panic!("failed to read body: {e:?}"),
+        }
+    }
+}
@@ -0,0 +1,89 @@
+//! Compare WASI file I/O performed on tokio's blocking thread pool with file
+//! I/O submitted through io_uring when many guests run concurrently.
+
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
+use std::{fs::File, path::Path, sync::Arc, time::Instant};
+use wasmtime::{Config, Engine, InstancePre, Linker, Module, Store};
+use wasmtime_wasi::{DirPerms, FilePerms, WasiCtx, p1::WasiP1Ctx};
+
+criterion_group!(benches, bench_wasi_io_uring);
+criterion_main!(benches);
+
+fn bench_wasi_io_uring(c: &mut Criterion) {
+    let _ = env_logger::try_init();
+
+    // Build a zero-filled test file if it does not yet exist.
+    let test_file = Path::new("benches/wasi/test.bin");
+    if !test_file.is_file() {
+        let file = File::create(test_file).unwrap();
+        file.set_len(4096).unwrap();
+    }
+
+    let rt = tokio::runtime::Builder::new_multi_thread()
+        .enable_all()
+        .build()
+        .unwrap();
+    let mut config = Config::new();
+    config.async_support(true);
+    let engine = Engine::new(&config).unwrap();
+
+    for name in ["read-file.wat", "open-file.wat"] {
+        let module = Module::from_file(&engine, Path::new("benches/wasi").join(name)).unwrap();
+        let mut linker = Linker::new(&engine);
+        wasmtime_wasi::p1::add_to_linker_async(&mut linker, |cx| cx).unwrap();
+        let pre = Arc::new(linker.instantiate_pre(&module).unwrap());
+
+        let mut group = c.benchmark_group(format!("wasi-io-uring/{name}"));
+        for concurrency in [1, 16, 256] {
+            group.throughput(Throughput::Elements(concurrency));
+            for io_uring in [false, true] {
+                let id = if io_uring {
+                    "io_uring"
+                } else {
+                    "spawn_blocking"
+                };
+                group.bench_function(BenchmarkId::new(id, concurrency), |b| {
+                    b.iter_custom(|iters| rt.block_on(run(&pre, concurrency, iters, io_uring)))
+                });
+            }
+        }
+        group.finish();
+    }
+}
+
+/// Runs `concurrency` instances of the module at once, each of which performs
+/// `iters` iterations of its loop, returning the total elapsed time.
+async fn run(
+    pre: &Arc<InstancePre<WasiP1Ctx>>,
+    concurrency: u64,
+    iters: u64,
+    io_uring: bool,
+) -> std::time::Duration {
+    let start = Instant::now();
+    let tasks = (0..concurrency)
+        .map(|_| {
+            let pre = pre.clone();
+            tokio::spawn(async move {
+                let mut store = Store::new(pre.module().engine(), wasi_context(io_uring));
+                let instance = pre.instantiate_async(&mut store).await.unwrap();
+                let run = instance
+                    .get_typed_func::<u64, u64>(&mut store, "run")
+                    .unwrap();
+                let result = run.call_async(&mut store, iters).await.unwrap();
+                assert_eq!(iters, result);
+            })
+        })
+        .collect::<Vec<_>>();
+    for task in tasks {
+        task.await.unwrap();
+    }
+    start.elapsed()
+}
+
+fn wasi_context(io_uring: bool) -> WasiP1Ctx {
+    WasiCtx::builder()
+        .io_uring(io_uring)
+        .preopened_dir("benches/wasi", "/", DirPerms::READ, FilePerms::READ)
+        .unwrap()
+        .build_p1()
+}
@@ -4,6 +4,11 @@
 #
 #     wasmtime-serve-rps.sh [WASMTIME-FLAGS] path/to/wasi-http-component.wasm
 #
+# The server is benchmarked twice: once instantiating the component on demand
+# for every request, and once with `$PREWARM` instances (default: the number of
+# cores) instantiated ahead of requests. Requests per second and latency
+# percentiles are reported for both.
+#
 # For a basic WASI HTTP component, check out
 # https://github.com/sunfishcode/hello-wasi-http
 #
@@ -23,18 +28,28 @@ fi
 # Build Wasmtime.
 cargo build --manifest-path "$cargo_toml" --release -p wasmtime-cli
 
-# Spawn `wasmtime serve` in the background.
-"$target_dir/release/wasmtime" serve "$@" &
-pid=$!
+bench() {
+    local name="$1"
+    shift
+
+    # Spawn `wasmtime serve` in the background.
+    "$target_dir/release/wasmtime" serve "$@" &
+    local pid=$!
+
+    # Give it a second to print its diagnostic information and get the server
+    # up and running.
+    sleep 1
 
-# Give it a second to print its diagnostic information and get the server up and
-# running.
-sleep 1
+    echo 'Running `wasmtime serve` in background as pid '"$pid"
 
-echo 'Running `wasmtime serve` in background as pid '"$pid"
+    # Benchmark the server!
+    echo "Benchmarking $name instances for 10 seconds..."
+    hey -z 10s http://0.0.0.0:8080/ \
+        | sed -n -e '/Requests\/sec/p' -e '/Latency distribution/,/^$/p'
 
-# Benchmark the server!
-echo "Benchmarking for 10 seconds..."
-hey -z 10s http://0.0.0.0:8080/
+    kill "$pid"
+    wait "$pid" || true
+}
 
-kill "$pid"
+bench on-demand "$@"
+bench prewarmed --prewarm-instances "${PREWARM:-$(getconf _NPROCESSORS_ONLN)}" "$@"
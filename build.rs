@@ -14,6 +14,19 @@ fn main() {
         }
         _ => {}
     }
+
+    // Mirror the `has_native_signals` cfg of the `wasmtime` crate so that tests
+    // of APIs only available with native signals are built in the same cases.
+    println!("cargo:rustc-check-cfg=cfg(has_native_signals)");
+    let supported_os =
+        env::var_os("CARGO_CFG_UNIX").is_some() || env::var_os("CARGO_CFG_WINDOWS").is_some();
+    let has_host_compiler_backend = matches!(
+        env::var("CARGO_CFG_TARGET_ARCH").unwrap().as_str(),
+        "x86_64" | "riscv64" | "s390x" | "aarch64"
+    );
+    if env::var_os("CARGO_CFG_MIRI").is_none() && supported_os && has_host_compiler_backend {
+        println!("cargo:rustc-cfg=has_native_signals");
+    }
 }
 
 fn set_commit_info_for_rustc() {
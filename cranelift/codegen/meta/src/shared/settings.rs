@@ -69,6 +69,19 @@ pub(crate) fn define() -> SettingGroup {
         true,
     );
 
+    settings.add_bool(
+        "enable_loop_vectorization",
+        "Vectorize simple counted reduction loops.",
+        r#"
+            This enables a pass which rewrites single-block loops that fold
+            integer elements loaded from memory into an accumulator to use
+            SIMD instructions, with a scalar loop handling the remaining
+            iterations. Only effective when `opt_level` is `speed` or
+            `speed_and_size` and the target supports SSE4.1 on x86-64.
+        "#,
+        false,
+    );
+
     settings.add_bool(
         "enable_verifier",
         "Run the Cranelift IR verifier at strategic times during compilation.",
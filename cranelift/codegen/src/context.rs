@@ -19,6 +19,7 @@ use crate::ir::Function;
 use crate::isa::TargetIsa;
 use crate::legalizer::simple_legalize;
 use crate::loop_analysis::LoopAnalysis;
+use crate::loop_vectorize::do_loop_vectorization;
 use crate::machinst::{CompiledCode, CompiledCodeStencil};
 use crate::nan_canonicalization::do_nan_canonicalization;
 use crate::remove_constant_phis::do_remove_constant_phis;
@@ -189,6 +190,9 @@ impl Context {
 
         if opt_level != OptLevel::None {
             self.egraph_pass(isa, ctrl_plane)?;
+            if isa.flags().enable_loop_vectorization() {
+                self.vectorize_loops(isa)?;
+            }
         }
 
         Ok(())
@@ -284,6 +288,28 @@ impl Context {
         Ok(())
     }
 
+    /// Vectorize simple counted reduction loops.
+    ///
+    /// This is a no-op on targets without 128-bit integer SIMD support.
+    pub fn vectorize_loops(&mut self, isa: &dyn TargetIsa) -> CodegenResult<()> {
+        let has_simd = match isa.triple().architecture {
+            Architecture::X86_64 => match isa.isa_flags().iter().find(|f| f.name == "has_sse41") {
+                Some(value) => value.as_bool().unwrap_or(false),
+                None => false,
+            },
+            _ => false,
+        };
+        if !has_simd {
+            return Ok(());
+        }
+        self.compute_cfg();
+        if do_loop_vectorization(&mut self.func, &mut self.cfg) {
+            self.compute_domtree();
+            self.verify_if(isa)?;
+        }
+        Ok(())
+    }
+
     /// Perform NaN canonicalizing rewrites on the function.
     pub fn canonicalize_nans(&mut self, isa: &dyn TargetIsa) -> CodegenResult<()> {
         // Currently only RiscV64 is the only arch that may not have vector support.
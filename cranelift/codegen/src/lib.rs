@@ -81,6 +81,7 @@ mod egraph;
 mod inst_predicates;
 mod isle_prelude;
 mod legalizer;
+mod loop_vectorize;
 mod nan_canonicalization;
 mod opts;
 mod ranges;
@@ -0,0 +1,882 @@
+//! A loop vectorization pass for simple counted reduction loops.
+//!
+//! This pass looks for single-block loops of the shape produced by a
+//! straight-line `for` loop that folds elements loaded from memory into one
+//! or more integer accumulators, e.g.:
+//!
+//! ```text
+//! block1(v0: i32, v1: i32):             ;; v0 = i, v1 = acc
+//!     v2 = ishl v0, v10                 ;; i * 4
+//!     v3 = uextend.i64 v2
+//!     v4 = iadd v11, v3                 ;; base + i * 4
+//!     v5 = load.i32 little heap v4
+//!     v6 = iadd v1, v5                  ;; acc += a[i]
+//!     v7 = iadd v0, v12                 ;; i + 1
+//!     v8 = icmp ult v7, v13             ;; i + 1 < n
+//!     brif v8, block1(v7, v6), block2
+//! ```
+//!
+//! Such loops are versioned: a guard block computes how many full vectors
+//! worth of iterations the loop has left and checks that the address
+//! computations can't wrap while being vectorized. When the check succeeds a
+//! vector loop processes `lanes` scalar iterations at a time with 128-bit
+//! loads and lane-wise arithmetic, and the vector accumulators are then
+//! reduced horizontally and fed back into the original scalar loop, which
+//! runs the remaining iterations (always at least one). When the check fails
+//! the original loop runs unchanged.
+//!
+//! Only transformations which are unobservable are performed:
+//!
+//! * The loop may not contain any stores, calls, or other side effects, so
+//!   trapping on a vector load instead of on one of the scalar loads it
+//!   replaces can't be distinguished from the original program. Every vector
+//!   load covers exactly the bytes of scalar loads the original loop performs.
+//!
+//! * Only integer `iadd`, `band`, `bor` and `bxor` reductions are vectorized,
+//!   because those are associative and commutative. Floating-point reductions
+//!   would require reassociation, which changes rounding.
+
+use crate::cursor::{Cursor, FuncCursor};
+use crate::flowgraph::ControlFlowGraph;
+use crate::ir::condcodes::{CondCode, IntCC};
+use crate::ir::immediates::Imm64;
+use crate::ir::{
+    Block, BlockArg, Endianness, Function, Inst, InstBuilder, InstructionData, Opcode, Type, Value,
+    ValueDef, types,
+};
+use crate::timing;
+use crate::trace;
+use alloc::vec::Vec;
+use rustc_hash::{FxHashMap, FxHashSet};
+use smallvec::SmallVec;
+
+/// Width of the vectors produced by this pass, in bytes.
+const VECTOR_BYTES: u32 = 16;
+
+/// Loops with more instructions than this are left alone to bound the code
+/// growth of versioning them.
+const MAX_LOOP_INSTS: usize = 64;
+
+/// The largest stride of a zero-extended address component that is
+/// supported, which keeps the overflow checks in the guard block from
+/// overflowing themselves.
+const MAX_WRAP_STRIDE: u64 = 1 << 16;
+
+/// Vectorize all supported loops in `func`.
+///
+/// The `cfg` must be up to date on entry and is kept up to date. Returns
+/// whether any loop was vectorized, in which case the dominator tree needs to
+/// be recomputed.
+pub fn do_loop_vectorization(func: &mut Function, cfg: &mut ControlFlowGraph) -> bool {
+    let _tt = timing::loop_vectorize();
+    let entry = func.layout.entry_block();
+    let blocks: Vec<Block> = func.layout.blocks().collect();
+    let mut changed = false;
+    for block in blocks {
+        if Some(block) == entry {
+            continue;
+        }
+        if let Some(plan) = analyze(func, cfg, block) {
+            trace!(
+                "vectorizing loop {block} with {} x {}",
+                plan.lanes, plan.lane_ty
+            );
+            transform(func, &plan);
+            cfg.compute(func);
+            changed = true;
+        }
+    }
+    changed
+}
+
+/// Everything needed to vectorize one loop.
+struct Plan {
+    /// The loop header, which is also the only block of the loop.
+    header: Block,
+    /// The branch in the one block outside of the loop entering it.
+    preheader: Inst,
+    /// The scalar type of every lane.
+    lane_ty: Type,
+    /// Number of lanes in each vector.
+    lanes: u32,
+    /// Induction variables among the header's parameters and their step.
+    steps: FxHashMap<Value, i64>,
+    /// The reductions performed by the loop.
+    reductions: Vec<Reduction>,
+    /// Values computed in the loop that become vectors.
+    lane_values: FxHashSet<Value>,
+    /// The loop's trip counter.
+    counter: Counter,
+    /// Narrow values that are zero-extended as part of address computations,
+    /// along with their stride. These must not wrap while vectorized.
+    wraps: Vec<(Value, i64)>,
+}
+
+/// An accumulator updated with `param' = op(param, lane)` every iteration.
+struct Reduction {
+    param: Value,
+    op: Opcode,
+    lane: Value,
+}
+
+/// The loop keeps going while `cond(value, bound)` holds, where `value`
+/// changes by `step` (either 1 or -1) each iteration. A `bound` of `None`
+/// means zero.
+struct Counter {
+    value: Value,
+    bound: Option<Value>,
+    step: i64,
+    cond: IntCC,
+}
+
+/// Sign-extend `value` from the width of `ty`.
+fn normalize(value: i64, ty: Type) -> i64 {
+    let shift = 64 - ty.bits();
+    (value << shift) >> shift
+}
+
+fn is_scalar_int(ty: Type) -> bool {
+    ty.is_int() && ty.bits() <= 64
+}
+
+/// Returns the value of `v` if it's an `iconst`, sign-extended.
+fn iconst_value(func: &Function, v: Value) -> Option<i64> {
+    let v = func.dfg.resolve_aliases(v);
+    let inst = func.dfg.value_def(v).inst()?;
+    match func.dfg.insts[inst] {
+        InstructionData::UnaryImm {
+            opcode: Opcode::Iconst,
+            imm,
+        } => {
+            let bits = func.dfg.value_type(v).bits();
+            Some(imm.sign_extend_from_width(bits).bits())
+        }
+        _ => None,
+    }
+}
+
+/// Returns the instruction defining `v` if it is in `block`.
+fn def_in_block(func: &Function, block: Block, v: Value) -> Option<Inst> {
+    match func.dfg.value_def(func.dfg.resolve_aliases(v)) {
+        ValueDef::Result(inst, _) if func.layout.inst_block(inst) == Some(block) => Some(inst),
+        _ => None,
+    }
+}
+
+fn defined_in_block(func: &Function, block: Block, v: Value) -> bool {
+    match func.dfg.value_def(func.dfg.resolve_aliases(v)) {
+        ValueDef::Result(inst, _) => func.layout.inst_block(inst) == Some(block),
+        ValueDef::Param(b, _) => b == block,
+        ValueDef::Union(..) => false,
+    }
+}
+
+/// Instructions which may appear in a vectorized loop at all.
+fn is_supported(opcode: Opcode) -> bool {
+    matches!(
+        opcode,
+        Opcode::Iconst
+            | Opcode::Iadd
+            | Opcode::Isub
+            | Opcode::Imul
+            | Opcode::Ishl
+            | Opcode::Ushr
+            | Opcode::Sshr
+            | Opcode::Band
+            | Opcode::Bor
+            | Opcode::Bxor
+            | Opcode::Bnot
+            | Opcode::Ineg
+            | Opcode::Uextend
+            | Opcode::Sextend
+            | Opcode::Ireduce
+            | Opcode::Icmp
+            | Opcode::Load
+    )
+}
+
+/// Per-loop analysis state.
+struct Analysis<'a> {
+    func: &'a Function,
+    header: Block,
+    /// How much each affine value computed in the loop changes per
+    /// iteration. Values defined outside of the loop are implicitly
+    /// invariant.
+    strides: FxHashMap<Value, i64>,
+    lane_ty: Type,
+    lane_values: FxHashSet<Value>,
+}
+
+impl Analysis<'_> {
+    fn stride(&self, v: Value) -> Option<i64> {
+        let v = self.func.dfg.resolve_aliases(v);
+        if defined_in_block(self.func, self.header, v) {
+            self.strides.get(&v).copied()
+        } else {
+            Some(0)
+        }
+    }
+
+    /// Computes the stride of the result of `inst`, if it is affine in the
+    /// loop's induction variables.
+    fn inst_stride(&self, inst: Inst) -> Option<i64> {
+        let dfg = &self.func.dfg;
+        let ty = dfg.value_type(dfg.first_result(inst));
+        let args = dfg.inst_args(inst);
+        let invariant = || {
+            for &arg in args {
+                if self.stride(arg)? != 0 {
+                    return None;
+                }
+            }
+            Some(0)
+        };
+        let stride = match dfg.insts[inst] {
+            InstructionData::UnaryImm {
+                opcode: Opcode::Iconst,
+                ..
+            } => 0,
+            // Invariant loads are re-executed once per vector iteration, or
+            // hoisted into the guard block, so they must not trap.
+            InstructionData::Load { flags, arg, .. } if flags.notrap() => {
+                if self.stride(arg)? != 0 {
+                    return None;
+                }
+                0
+            }
+            InstructionData::Load { .. } => return None,
+            InstructionData::Binary {
+                opcode: Opcode::Iadd,
+                args: [a, b],
+            } => self.stride(a)?.wrapping_add(self.stride(b)?),
+            InstructionData::Binary {
+                opcode: Opcode::Isub,
+                args: [a, b],
+            } => self.stride(a)?.wrapping_sub(self.stride(b)?),
+            InstructionData::Binary {
+                opcode: Opcode::Imul,
+                args: [a, b],
+            } => match (iconst_value(self.func, a), iconst_value(self.func, b)) {
+                (_, Some(c)) => self.stride(a)?.wrapping_mul(c),
+                (Some(c), _) => self.stride(b)?.wrapping_mul(c),
+                _ => invariant()?,
+            },
+            InstructionData::Binary {
+                opcode: Opcode::Ishl,
+                args: [a, b],
+            } => match iconst_value(self.func, b) {
+                Some(c) if is_scalar_int(ty) => {
+                    let amt = (c as u32) & (ty.bits() - 1);
+                    self.stride(a)?.wrapping_shl(amt)
+                }
+                _ => invariant()?,
+            },
+            InstructionData::Unary {
+                opcode: Opcode::Uextend | Opcode::Ireduce,
+                arg,
+            } => self.stride(arg)?,
+            _ => invariant()?,
+        };
+        if is_scalar_int(ty) {
+            Some(normalize(stride, ty))
+        } else if stride == 0 {
+            Some(0)
+        } else {
+            None
+        }
+    }
+
+    /// Checks whether `v` can be computed lane-wise, recording it in
+    /// `lane_values` if so.
+    fn check_lane(&mut self, v: Value) -> bool {
+        let func = self.func;
+        let dfg = &func.dfg;
+        let v = dfg.resolve_aliases(v);
+        if dfg.value_type(v) != self.lane_ty {
+            return false;
+        }
+        if self.lane_values.contains(&v) || self.stride(v) == Some(0) {
+            return true;
+        }
+        let Some(inst) = def_in_block(func, self.header, v) else {
+            return false;
+        };
+        let ok = match dfg.insts[inst] {
+            InstructionData::Load {
+                opcode: Opcode::Load,
+                arg,
+                flags,
+                ..
+            } => {
+                !flags.aligned()
+                    && flags.explicit_endianness() != Some(Endianness::Big)
+                    && self.stride(arg) == Some(i64::from(self.lane_ty.bytes()))
+            }
+            InstructionData::Binary { opcode, args } => {
+                let supported = match opcode {
+                    Opcode::Iadd | Opcode::Isub | Opcode::Band | Opcode::Bor | Opcode::Bxor => true,
+                    // There are no 8-bit or 64-bit vector multiplications in
+                    // SSE4.1.
+                    Opcode::Imul => self.lane_ty != types::I8 && self.lane_ty != types::I64,
+                    _ => false,
+                };
+                supported && self.check_lane(args[0]) && self.check_lane(args[1])
+            }
+            InstructionData::Unary {
+                opcode: Opcode::Bnot | Opcode::Ineg,
+                arg,
+            } => self.check_lane(arg),
+            _ => false,
+        };
+        if ok {
+            self.lane_values.insert(v);
+        }
+        ok
+    }
+}
+
+/// Determines whether the loop headed by `header` can be vectorized.
+fn analyze(func: &Function, cfg: &ControlFlowGraph, header: Block) -> Option<Plan> {
+    let dfg = &func.dfg;
+    let term = func.layout.last_inst(header)?;
+    let (cond, then_dest, else_dest) = match dfg.insts[term] {
+        InstructionData::Brif {
+            arg,
+            blocks: [then_dest, else_dest],
+            ..
+        } => (arg, then_dest, else_dest),
+        _ => return None,
+    };
+    let back_edge_then = match (
+        then_dest.block(&dfg.value_lists) == header,
+        else_dest.block(&dfg.value_lists) == header,
+    ) {
+        (true, false) => true,
+        (false, true) => false,
+        _ => return None,
+    };
+    let back_edge = if back_edge_then { then_dest } else { else_dest };
+
+    // The loop must be entered through exactly one edge from a plain
+    // branch, which is redirected to the guard block.
+    let mut preheader = None;
+    for pred in cfg.pred_iter(header) {
+        if pred.inst == term {
+            continue;
+        }
+        if preheader.replace(pred.inst).is_some() {
+            return None;
+        }
+    }
+    let preheader = preheader?;
+    match dfg.insts[preheader] {
+        InstructionData::Jump { .. } => {}
+        InstructionData::Brif { blocks, .. }
+            if blocks[0].block(&dfg.value_lists) != blocks[1].block(&dfg.value_lists) => {}
+        _ => return None,
+    }
+
+    let insts: SmallVec<[Inst; 32]> = func
+        .layout
+        .block_insts(header)
+        .filter(|&inst| inst != term)
+        .collect();
+    if insts.len() > MAX_LOOP_INSTS
+        || insts
+            .iter()
+            .any(|&inst| !is_supported(dfg.insts[inst].opcode()))
+    {
+        return None;
+    }
+
+    // Classify the header's parameters into induction variables and
+    // accumulators.
+    let params = dfg.block_params(header);
+    let args: SmallVec<[Value; 8]> = back_edge
+        .args(&dfg.value_lists)
+        .map(|arg| arg.as_value().map(|v| dfg.resolve_aliases(v)))
+        .collect::<Option<_>>()?;
+    let mut steps = FxHashMap::default();
+    let mut accs = SmallVec::<[(Value, Value); 4]>::new();
+    for (&param, &next) in params.iter().zip(args.iter()) {
+        if next == param {
+            steps.insert(param, 0);
+            continue;
+        }
+        let ty = dfg.value_type(param);
+        let step = def_in_block(func, header, next).and_then(|inst| {
+            let (opcode, [a, b]) = match dfg.insts[inst] {
+                InstructionData::Binary { opcode, args } => {
+                    (opcode, args.map(|v| dfg.resolve_aliases(v)))
+                }
+                _ => return None,
+            };
+            match opcode {
+                Opcode::Iadd if a == param => iconst_value(func, b),
+                Opcode::Iadd if b == param => iconst_value(func, a),
+                Opcode::Isub if a == param => iconst_value(func, b).map(|c| c.wrapping_neg()),
+                _ => None,
+            }
+        });
+        match step {
+            Some(step) if is_scalar_int(ty) => {
+                steps.insert(param, normalize(step, ty));
+            }
+            _ => accs.push((param, next)),
+        }
+    }
+
+    let mut reductions = Vec::new();
+    for (param, next) in accs {
+        let inst = def_in_block(func, header, next)?;
+        let (op, lane) = match dfg.insts[inst] {
+            InstructionData::Binary {
+                opcode: opcode @ (Opcode::Iadd | Opcode::Band | Opcode::Bor | Opcode::Bxor),
+                args,
+            } => {
+                let [a, b] = args.map(|v| dfg.resolve_aliases(v));
+                if a == param && b != param {
+                    (opcode, b)
+                } else if b == param && a != param {
+                    (opcode, a)
+                } else {
+                    return None;
+                }
+            }
+            _ => return None,
+        };
+        reductions.push(Reduction { param, op, lane });
+    }
+    let lane_ty = dfg.value_type(reductions.first()?.param);
+    if !is_scalar_int(lane_ty)
+        || reductions
+            .iter()
+            .any(|r| dfg.value_type(r.param) != lane_ty)
+    {
+        return None;
+    }
+    let lanes = VECTOR_BYTES / lane_ty.bytes();
+
+    let mut analysis = Analysis {
+        func,
+        header,
+        strides: steps.clone(),
+        lane_ty,
+        lane_values: FxHashSet::default(),
+    };
+    for &inst in &insts {
+        if let Some(stride) = analysis.inst_stride(inst) {
+            analysis.strides.insert(dfg.first_result(inst), stride);
+        }
+    }
+    for r in &reductions {
+        if !analysis.check_lane(r.lane) {
+            return None;
+        }
+    }
+
+    // Find the trip counter from the exit condition, normalized so that the
+    // loop keeps going while `cond(value, bound)` holds.
+    let mut exit_insts = SmallVec::<[Inst; 2]>::new();
+    let mut cond_value = dfg.resolve_aliases(cond);
+    if let Some(inst) = def_in_block(func, header, cond_value) {
+        if let InstructionData::Unary {
+            opcode: Opcode::Uextend,
+            arg,
+        } = dfg.insts[inst]
+        {
+            exit_insts.push(inst);
+            cond_value = dfg.resolve_aliases(arg);
+        }
+    }
+    let (mut cc, value, bound) =
+        match def_in_block(func, header, cond_value).map(|inst| (inst, &dfg.insts[inst])) {
+            Some((
+                inst,
+                InstructionData::IntCompare {
+                    cond, args: [a, b], ..
+                },
+            )) => {
+                exit_insts.push(inst);
+                let (a, b) = (dfg.resolve_aliases(*a), dfg.resolve_aliases(*b));
+                if analysis.stride(b) == Some(0) {
+                    (*cond, a, Some(b))
+                } else if analysis.stride(a) == Some(0) {
+                    (cond.swap_args(), b, Some(a))
+                } else {
+                    return None;
+                }
+            }
+            _ => (IntCC::NotEqual, cond_value, None),
+        };
+    if !back_edge_then {
+        cc = cc.complement();
+    }
+    let step = analysis.stride(value)?;
+    match (step, cc) {
+        (1, IntCC::NotEqual | IntCC::UnsignedLessThan | IntCC::SignedLessThan)
+        | (-1, IntCC::NotEqual | IntCC::UnsignedGreaterThan | IntCC::SignedGreaterThan) => {}
+        _ => return None,
+    }
+    let counter = Counter {
+        value,
+        bound,
+        step,
+        cond: cc,
+    };
+
+    // Everything that isn't part of a vector computation is either affine
+    // or part of the exit condition, and must not use any of the vector
+    // computations or accumulators, which don't exist in scalar form in the
+    // vector loop.
+    let reduction_insts: SmallVec<[Inst; 4]> = reductions
+        .iter()
+        .map(|r| {
+            let next = args[params.iter().position(|&p| p == r.param).unwrap()];
+            def_in_block(func, header, next).unwrap()
+        })
+        .collect();
+    let is_vector = |v: Value| {
+        analysis.lane_values.contains(&v)
+            || reductions.iter().any(|r| r.param == v)
+            || reduction_insts
+                .iter()
+                .any(|&inst| dfg.first_result(inst) == v)
+    };
+    for &inst in &insts {
+        let result = dfg.first_result(inst);
+        if analysis.lane_values.contains(&result) || reduction_insts.contains(&inst) {
+            continue;
+        }
+        if !analysis.strides.contains_key(&result) && !exit_insts.contains(&inst) {
+            return None;
+        }
+        if dfg
+            .inst_args(inst)
+            .iter()
+            .any(|&arg| is_vector(dfg.resolve_aliases(arg)))
+        {
+            return None;
+        }
+    }
+    if is_vector(dfg.resolve_aliases(cond)) {
+        return None;
+    }
+
+    let mut wraps = Vec::new();
+    for &inst in &insts {
+        if let InstructionData::Unary {
+            opcode: Opcode::Uextend,
+            arg,
+        } = dfg.insts[inst]
+        {
+            let arg = dfg.resolve_aliases(arg);
+            match analysis.stride(arg) {
+                Some(0) | None => {}
+                Some(stride) if stride.unsigned_abs() <= MAX_WRAP_STRIDE => {
+                    wraps.push((arg, stride))
+                }
+                Some(_) => return None,
+            }
+        }
+    }
+
+    let Analysis { lane_values, .. } = analysis;
+    Some(Plan {
+        header,
+        preheader,
+        lane_ty,
+        lanes,
+        steps,
+        reductions,
+        lane_values,
+        counter,
+        wraps,
+    })
+}
+
+fn iconst(pos: &mut FuncCursor, ty: Type, value: i64) -> Value {
+    let imm = Imm64::new(value).zero_extend_from_width(ty.bits());
+    pos.ins().iconst(ty, imm)
+}
+
+fn binary(pos: &mut FuncCursor, opcode: Opcode, a: Value, b: Value) -> Value {
+    match opcode {
+        Opcode::Iadd => pos.ins().iadd(a, b),
+        Opcode::Isub => pos.ins().isub(a, b),
+        Opcode::Imul => pos.ins().imul(a, b),
+        Opcode::Band => pos.ins().band(a, b),
+        Opcode::Bor => pos.ins().bor(a, b),
+        Opcode::Bxor => pos.ins().bxor(a, b),
+        _ => unreachable!("unsupported vector op {opcode}"),
+    }
+}
+
+/// Emits a copy of the computation of `v` at `pos`, substituting the
+/// header's parameters according to `params`.
+fn materialize(
+    pos: &mut FuncCursor,
+    header: Block,
+    params: &FxHashMap<Value, Value>,
+    memo: &mut FxHashMap<Value, Value>,
+    v: Value,
+) -> Value {
+    let v = pos.func.dfg.resolve_aliases(v);
+    if let Some(&new) = params.get(&v).or_else(|| memo.get(&v)) {
+        return new;
+    }
+    let Some(inst) = def_in_block(pos.func, header, v) else {
+        return v;
+    };
+    let args: SmallVec<[Value; 4]> = pos.func.dfg.inst_args(inst).iter().copied().collect();
+    let args: SmallVec<[Value; 4]> = args
+        .into_iter()
+        .map(|arg| materialize(pos, header, params, memo, arg))
+        .collect();
+    let new_inst = pos.func.dfg.clone_inst(inst);
+    pos.func
+        .dfg
+        .overwrite_inst_values(new_inst, args.into_iter());
+    pos.insert_inst(new_inst);
+    let new = pos.func.dfg.first_result(new_inst);
+    memo.insert(v, new);
+    new
+}
+
+/// Emits the vector form of the lane value `v` at `pos`.
+///
+/// Splats of invariant operands are expected to already be in `vectors`.
+fn vectorize(
+    pos: &mut FuncCursor,
+    plan: &Plan,
+    params: &FxHashMap<Value, Value>,
+    memo: &mut FxHashMap<Value, Value>,
+    vectors: &mut FxHashMap<Value, Value>,
+    v: Value,
+) -> Value {
+    let v = pos.func.dfg.resolve_aliases(v);
+    if let Some(&vector) = vectors.get(&v) {
+        return vector;
+    }
+    let vector_ty = plan.lane_ty.by(plan.lanes).unwrap();
+    let inst = pos.func.dfg.value_def(v).unwrap_inst();
+    let data = pos.func.dfg.insts[inst];
+    let vector = match data {
+        InstructionData::Load {
+            arg, flags, offset, ..
+        } => {
+            let addr = materialize(pos, plan.header, params, memo, arg);
+            pos.ins().load(vector_ty, flags, addr, offset)
+        }
+        InstructionData::Binary { opcode, args } => {
+            let a = vectorize(pos, plan, params, memo, vectors, args[0]);
+            let b = vectorize(pos, plan, params, memo, vectors, args[1]);
+            binary(pos, opcode, a, b)
+        }
+        InstructionData::Unary {
+            opcode: Opcode::Bnot,
+            arg,
+        } => {
+            let a = vectorize(pos, plan, params, memo, vectors, arg);
+            pos.ins().bnot(a)
+        }
+        InstructionData::Unary {
+            opcode: Opcode::Ineg,
+            arg,
+        } => {
+            let a = vectorize(pos, plan, params, memo, vectors, arg);
+            pos.ins().ineg(a)
+        }
+        _ => unreachable!("unsupported vector instruction {data:?}"),
+    };
+    vectors.insert(v, vector);
+    vector
+}
+
+fn transform(func: &mut Function, plan: &Plan) {
+    let header = plan.header;
+    let lane_ty = plan.lane_ty;
+    let vector_ty = lane_ty.by(plan.lanes).unwrap();
+    let log2_lanes = i64::from(plan.lanes.ilog2());
+    let params: SmallVec<[Value; 8]> = func.dfg.block_params(header).iter().copied().collect();
+    let counter_ty = func.dfg.value_type(plan.counter.value);
+
+    let guard = func.dfg.make_block();
+    let body = func.dfg.make_block();
+    let exit = func.dfg.make_block();
+    let mut guard_params = SmallVec::<[Value; 8]>::new();
+    let mut body_params = SmallVec::<[Value; 8]>::new();
+    let mut exit_params = SmallVec::<[Value; 8]>::new();
+    let iters = func.dfg.append_block_param(body, counter_ty);
+    for &param in &params {
+        let ty = func.dfg.value_type(param);
+        guard_params.push(func.dfg.append_block_param(guard, ty));
+        body_params.push(func.dfg.append_block_param(body, ty));
+        exit_params.push(func.dfg.append_block_param(exit, ty));
+    }
+    let body_accs: SmallVec<[Value; 4]> = plan
+        .reductions
+        .iter()
+        .map(|_| func.dfg.append_block_param(body, vector_ty))
+        .collect();
+    let exit_accs: SmallVec<[Value; 4]> = plan
+        .reductions
+        .iter()
+        .map(|_| func.dfg.append_block_param(exit, vector_ty))
+        .collect();
+    func.layout.insert_block(guard, header);
+    func.layout.insert_block(body, header);
+    func.layout.insert_block(exit, header);
+
+    let dfg = &mut func.dfg;
+    for dest in dfg.insts[plan.preheader]
+        .branch_destination_mut(&mut dfg.jump_tables, &mut dfg.exception_tables)
+    {
+        if dest.block(&dfg.value_lists) == header {
+            dest.set_block(guard, &mut dfg.value_lists);
+        }
+    }
+
+    // The guard block: compute the number of vector iterations and check
+    // that the loop has at least one of them left and that no zero-extended
+    // address component wraps around during them.
+    let mut pos = FuncCursor::new(func).at_bottom(guard);
+    let entry: FxHashMap<Value, Value> = params
+        .iter()
+        .copied()
+        .zip(guard_params.iter().copied())
+        .collect();
+    let mut memo = FxHashMap::default();
+    let start = materialize(&mut pos, header, &entry, &mut memo, plan.counter.value);
+    let bound = match plan.counter.bound {
+        Some(bound) => materialize(&mut pos, header, &entry, &mut memo, bound),
+        None => iconst(&mut pos, counter_ty, 0),
+    };
+    let remaining = if plan.counter.step > 0 {
+        pos.ins().isub(bound, start)
+    } else {
+        pos.ins().isub(start, bound)
+    };
+    let shift = iconst(&mut pos, counter_ty, log2_lanes);
+    let vector_iters = pos.ins().ushr(remaining, shift);
+    let zero = iconst(&mut pos, counter_ty, 0);
+    let mut ok = pos.ins().icmp(IntCC::NotEqual, vector_iters, zero);
+    if plan.counter.cond != IntCC::NotEqual {
+        let in_range = pos.ins().icmp(plan.counter.cond, start, bound);
+        ok = pos.ins().band(ok, in_range);
+    }
+    if !plan.wraps.is_empty() {
+        let iters64 = if counter_ty == types::I64 {
+            let max = iconst(&mut pos, types::I64, i64::from(u32::MAX));
+            let small = pos
+                .ins()
+                .icmp(IntCC::UnsignedLessThanOrEqual, vector_iters, max);
+            ok = pos.ins().band(ok, small);
+            vector_iters
+        } else {
+            pos.ins().uextend(types::I64, vector_iters)
+        };
+        let shift = iconst(&mut pos, types::I64, log2_lanes);
+        let total = pos.ins().ishl(iters64, shift);
+        for &(x, stride) in &plan.wraps {
+            let bits = pos.func.dfg.value_type(x).bits();
+            let x = materialize(&mut pos, header, &entry, &mut memo, x);
+            let x = pos.ins().uextend(types::I64, x);
+            let scale = iconst(&mut pos, types::I64, stride.unsigned_abs() as i64);
+            let distance = pos.ins().imul(total, scale);
+            let in_range = if stride > 0 {
+                let end = pos.ins().iadd(x, distance);
+                let limit = iconst(&mut pos, types::I64, 1 << bits);
+                pos.ins().icmp(IntCC::UnsignedLessThanOrEqual, end, limit)
+            } else {
+                pos.ins().icmp(IntCC::UnsignedLessThanOrEqual, distance, x)
+            };
+            ok = pos.ins().band(ok, in_range);
+        }
+    }
+
+    // Splat invariant operands of vector computations once, up front.
+    let mut vectors = FxHashMap::default();
+    let mut lane_values: SmallVec<[Value; 16]> = plan.lane_values.iter().copied().collect();
+    lane_values.sort();
+    let mut invariants: SmallVec<[Value; 8]> = plan.reductions.iter().map(|r| r.lane).collect();
+    for v in lane_values {
+        let inst = pos.func.dfg.value_def(v).unwrap_inst();
+        match pos.func.dfg.insts[inst] {
+            InstructionData::Binary { args, .. } => invariants.extend(args),
+            InstructionData::Unary { arg, .. } => invariants.push(arg),
+            _ => {}
+        }
+    }
+    for v in invariants {
+        let v = pos.func.dfg.resolve_aliases(v);
+        if plan.lane_values.contains(&v) || vectors.contains_key(&v) {
+            continue;
+        }
+        let scalar = materialize(&mut pos, header, &entry, &mut memo, v);
+        let splat = pos.ins().splat(vector_ty, scalar);
+        vectors.insert(v, splat);
+    }
+    let mut body_args = SmallVec::<[BlockArg; 16]>::new();
+    body_args.push(vector_iters.into());
+    body_args.extend(guard_params.iter().map(|&v| BlockArg::from(v)));
+    for r in &plan.reductions {
+        let identity = if r.op == Opcode::Band { -1 } else { 0 };
+        let identity = iconst(&mut pos, lane_ty, identity);
+        body_args.push(pos.ins().splat(vector_ty, identity).into());
+    }
+    let header_args: SmallVec<[BlockArg; 8]> = guard_params.iter().map(|&v| v.into()).collect();
+    pos.ins().brif(ok, body, &body_args, header, &header_args);
+
+    // The vector loop.
+    pos.goto_bottom(body);
+    let body_map: FxHashMap<Value, Value> = params
+        .iter()
+        .copied()
+        .zip(body_params.iter().copied())
+        .collect();
+    let mut memo = FxHashMap::default();
+    let mut next_accs = SmallVec::<[Value; 4]>::new();
+    for (r, &acc) in plan.reductions.iter().zip(&body_accs) {
+        let lane = vectorize(&mut pos, plan, &body_map, &mut memo, &mut vectors, r.lane);
+        next_accs.push(binary(&mut pos, r.op, acc, lane));
+    }
+    let mut next_params = SmallVec::<[Value; 8]>::new();
+    for (param, &body_param) in params.iter().zip(&body_params) {
+        let step = plan.steps.get(param).copied().unwrap_or(0);
+        if step == 0 {
+            next_params.push(body_param);
+        } else {
+            let ty = pos.func.dfg.value_type(body_param);
+            let delta = iconst(&mut pos, ty, step.wrapping_mul(i64::from(plan.lanes)));
+            next_params.push(pos.ins().iadd(body_param, delta));
+        }
+    }
+    let one = iconst(&mut pos, counter_ty, 1);
+    let next_iters = pos.ins().isub(iters, one);
+    let mut loop_args = SmallVec::<[BlockArg; 16]>::new();
+    loop_args.push(next_iters.into());
+    loop_args.extend(next_params.iter().map(|&v| BlockArg::from(v)));
+    loop_args.extend(next_accs.iter().map(|&v| BlockArg::from(v)));
+    let exit_args: SmallVec<[BlockArg; 16]> = next_params
+        .iter()
+        .chain(next_accs.iter())
+        .map(|&v| v.into())
+        .collect();
+    pos.ins()
+        .brif(next_iters, body, &loop_args, exit, &exit_args);
+
+    // Reduce the vector accumulators and resume the scalar loop.
+    pos.goto_bottom(exit);
+    let mut header_args: SmallVec<[BlockArg; 8]> = exit_params.iter().map(|&v| v.into()).collect();
+    for (r, &vector) in plan.reductions.iter().zip(&exit_accs) {
+        let idx = params.iter().position(|&p| p == r.param).unwrap();
+        let mut acc = exit_params[idx];
+        for lane in 0..plan.lanes {
+            let x = pos.ins().extractlane(vector, lane as u8);
+            acc = binary(&mut pos, r.op, acc, x);
+        }
+        header_args[idx] = acc.into();
+    }
+    pos.ins().jump(header, &header_args);
+}
@@ -499,6 +499,7 @@ log2_min_function_alignment = 0
 regalloc_checker = false
 regalloc_verbose_logs = false
 enable_alias_analysis = true
+enable_loop_vectorization = false
 enable_verifier = true
 enable_pcc = false
 is_pic = false
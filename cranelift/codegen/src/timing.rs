@@ -31,6 +31,12 @@ macro_rules! define_passes {
 
         const DESCRIPTIONS: [&str; NUM_PASSES] = [ $($desc),+ ];
 
+        #[cfg_attr(
+            not(feature = "timing"),
+            expect(dead_code, reason = "only used when timing is enabled")
+        )]
+        const PASSES: [Pass; NUM_PASSES] = [ $(Pass::$pass),+ ];
+
         $(
             #[doc=$desc]
             #[must_use]
@@ -64,6 +70,7 @@ define_passes! {
     licm: "Loop invariant code motion",
     unreachable_code: "Remove unreachable blocks",
     remove_constant_phis: "Remove constant phi-nodes",
+    loop_vectorize: "Loop vectorization",
 
     vcode_lower: "VCode lowering",
     vcode_emit: "VCode emission",
@@ -117,7 +124,7 @@ pub use enabled::*;
 
 #[cfg(feature = "timing")]
 mod enabled {
-    use super::{DESCRIPTIONS, DefaultProfiler, NUM_PASSES, Pass, Profiler};
+    use super::{DESCRIPTIONS, DefaultProfiler, NUM_PASSES, PASSES, Pass, Profiler};
     use std::any::Any;
     use std::boxed::Box;
     use std::cell::{Cell, RefCell};
@@ -173,6 +180,23 @@ mod enabled {
         pub fn total(&self) -> Duration {
             self.pass.iter().map(|p| p.total - p.child).sum()
         }
+
+        /// Returns the time taken by `pass`, including its child passes.
+        pub fn get(&self, pass: Pass) -> Duration {
+            self.pass
+                .get(pass.idx())
+                .map_or(Duration::ZERO, |p| p.total)
+        }
+
+        /// Iterates over all passes that ran along with the time taken by each
+        /// of them, excluding time spent in child passes.
+        pub fn self_times(&self) -> impl Iterator<Item = (Pass, Duration)> + '_ {
+            self.pass
+                .iter()
+                .zip(PASSES)
+                .filter(|(time, _)| time.total != Duration::default())
+                .map(|(time, pass)| (pass, time.total.saturating_sub(time.child)))
+        }
     }
 
     impl Default for PassTimes {
@@ -302,4 +326,19 @@ mod tests {
         assert_eq!(Pass::None.to_string(), "<no pass>");
         assert_eq!(Pass::regalloc.to_string(), "Register allocation");
     }
+
+    #[test]
+    #[cfg(feature = "timing")]
+    fn self_times() {
+        let _ = take_current();
+        {
+            let _outer = regalloc();
+            let _inner = regalloc_checker();
+        }
+        let times = take_current();
+        let passes: alloc::vec::Vec<_> = times.self_times().map(|(pass, _)| pass).collect();
+        assert_eq!(passes, [Pass::regalloc, Pass::regalloc_checker]);
+        assert!(times.get(Pass::regalloc) >= times.get(Pass::regalloc_checker));
+        assert_eq!(times.get(Pass::None), core::time::Duration::ZERO);
+    }
 }
@@ -22,6 +22,7 @@ const FEATURES: &[&str] = &[
     "DEBUG_BUILTINS",
     "WAT",
     "POOLING_ALLOCATOR",
+    "MEMORY_PROTECTION_KEYS",
     "COMPONENT_MODEL",
 ];
 // ... if you add a line above this be sure to change the other locations
@@ -45,6 +45,7 @@ feature(cranelift ON)
 feature(winch ON)
 feature(debug-builtins ON)
 feature(pooling-allocator ON)
+feature(memory-protection-keys ON)
 feature(component-model ON)
 # ... if you add a line above this be sure to change the other locations
 # marked WASMTIME_FEATURE_LIST
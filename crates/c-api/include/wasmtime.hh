@@ -30,6 +30,7 @@
 #ifndef WASMTIME_HH
 #define WASMTIME_HH
 
+#include <wasmtime/async.hh>
 #include <wasmtime/config.hh>
 #include <wasmtime/engine.hh>
 #include <wasmtime/error.hh>
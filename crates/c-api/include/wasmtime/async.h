@@ -28,6 +28,14 @@
  * will keep all parameters to the function alive and unmodified until the
  * `wasmtime_func_async_continuation_callback_t` returns true.
  *
+ * Alternatively host functions defined with
+ * #wasmtime_linker_define_async_completion_func are handed a
+ * #wasmtime_async_completion_t instead of returning a continuation. The host
+ * starts its work, for example on its own thread pool, and completes the
+ * handle from any thread once results are available. Futures polled with
+ * #wasmtime_call_future_poll_with_waker are then woken up through the provided
+ * #wasmtime_async_waker_t instead of having to be polled repeatedly.
+ *
  */
 
 #ifndef WASMTIME_ASYNC_H
@@ -166,6 +174,96 @@ typedef void (*wasmtime_func_async_callback_t)(
     size_t nargs, wasmtime_val_t *results, size_t nresults,
     wasm_trap_t **trap_ret, wasmtime_async_continuation_t *continuation_ret);
 
+/**
+ * \brief A handle used to deliver the results of a host function defined with
+ * #wasmtime_linker_define_async_completion_func.
+ *
+ * Ownership of this handle is given to the host function, which must pass it to
+ * exactly one of #wasmtime_async_completion_complete,
+ * #wasmtime_async_completion_trap or #wasmtime_async_completion_delete. This
+ * may happen from any thread, and either before or after the host function
+ * returns. Until then the WebAssembly which called the host function remains
+ * suspended.
+ */
+typedef struct wasmtime_async_completion wasmtime_async_completion_t;
+
+/**
+ * \brief Callback signature for
+ * #wasmtime_linker_define_async_completion_func.
+ *
+ * \param env user-provided argument passed to
+ *        #wasmtime_linker_define_async_completion_func
+ * \param caller a temporary object that can only be used during this function
+ *        call. Used to acquire #wasmtime_context_t or caller's state
+ * \param args the arguments provided to this function invocation, which are
+ *        only valid for the duration of this call
+ * \param nargs how many arguments are provided
+ * \param nresults how many results must be passed to
+ *        #wasmtime_async_completion_complete
+ * \param completion the handle used to finish this call, owned by the callee
+ *
+ * Only supported for async stores.
+ */
+typedef void (*wasmtime_func_async_completion_callback_t)(
+    void *env, wasmtime_caller_t *caller, const wasmtime_val_t *args,
+    size_t nargs, size_t nresults, wasmtime_async_completion_t *completion);
+
+/**
+ * \brief Completes an asynchronous host call with the given results.
+ *
+ * This may be called from any thread. The results are copied out of `results`
+ * and ownership of any references within them is transferred to wasmtime, just
+ * like the results of a #wasmtime_func_callback_t. They're converted back into
+ * WebAssembly values on the thread that polls the suspended call, so
+ * references must belong to the store which made the call.
+ *
+ * If `nresults` doesn't match the number of results that the function is
+ * declared to return then the call traps.
+ *
+ * This function takes ownership of `completion`.
+ */
+WASM_API_EXTERN void
+wasmtime_async_completion_complete(wasmtime_async_completion_t *completion,
+                                   const wasmtime_val_t *results,
+                                   size_t nresults);
+
+/**
+ * \brief Completes an asynchronous host call by trapping with `trap`.
+ *
+ * This may be called from any thread and takes ownership of both `completion`
+ * and `trap`.
+ */
+WASM_API_EXTERN void
+wasmtime_async_completion_trap(wasmtime_async_completion_t *completion,
+                               wasm_trap_t *trap);
+
+/**
+ * \brief Abandons an asynchronous host call without completing it.
+ *
+ * This may be called from any thread and takes ownership of `completion`. The
+ * suspended call traps, just as if #wasmtime_async_completion_trap had been
+ * called, so that it isn't left suspended forever.
+ */
+WASM_API_EXTERN void
+wasmtime_async_completion_delete(wasmtime_async_completion_t *completion);
+
+/**
+ * \brief A callback used to signal that a #wasmtime_call_future_t can make
+ * progress and should be polled again.
+ *
+ * See #wasmtime_call_future_poll_with_waker.
+ */
+typedef struct wasmtime_async_waker_t {
+  /// Callback invoked, possibly from another thread, when the future should be
+  /// polled again.
+  void (*wake)(void *env);
+  /// User-provided argument to pass to `wake`.
+  void *env;
+  /// An optional finalizer for `env`, invoked once the waker is no longer in
+  /// use.
+  void (*finalizer)(void *);
+} wasmtime_async_waker_t;
+
 /**
  * \brief The structure representing a asynchronously running function.
  *
@@ -197,6 +295,33 @@ typedef struct wasmtime_call_future wasmtime_call_future_t;
  */
 WASM_API_EXTERN bool wasmtime_call_future_poll(wasmtime_call_future_t *future);
 
+/**
+ * \brief Same as #wasmtime_call_future_poll, but registers `waker` to be
+ * notified when the future can make progress.
+ *
+ * If this returns false because the WebAssembly is waiting on a host function
+ * defined with #wasmtime_linker_define_async_completion_func then `waker`'s
+ * callback is invoked once that call is completed, possibly from another
+ * thread. Embedders can then poll other futures, or sleep, in the meantime
+ * rather than polling this future in a loop. Yields due to fuel or epochs, and
+ * continuations of host functions defined with
+ * #wasmtime_linker_define_async_func which aren't finished yet, invoke the
+ * callback before this function returns since the future can be polled again
+ * right away.
+ *
+ * The fields of `waker` are copied and wasmtime takes ownership of `env`. The
+ * finalizer is invoked once wasmtime no longer needs `env`, which may be after
+ * this function returns or even after `future` is deleted, since a pending
+ * host call may still hold on to the waker. Polling `future` again with the
+ * same `wake` and `env` reuses the waker registered by the previous poll and
+ * does *not* take ownership of `env` again, so the finalizer runs once for all
+ * of those polls. Passing a different `wake` or `env` releases the previous
+ * waker and registers the new one, whose finalizer runs separately.
+ */
+WASM_API_EXTERN bool
+wasmtime_call_future_poll_with_waker(wasmtime_call_future_t *future,
+                                     const wasmtime_async_waker_t *waker);
+
 /**
  * /brief Frees the underlying memory for a future.
  *
@@ -237,6 +362,28 @@ WASM_API_EXTERN wasmtime_call_future_t *wasmtime_func_call_async(
     const wasmtime_val_t *args, size_t nargs, wasmtime_val_t *results,
     size_t nresults, wasm_trap_t **trap_ret, wasmtime_error_t **error_ret);
 
+/**
+ * \brief Same as #wasmtime_func_call_async, but passes arguments and results
+ * as raw values.
+ *
+ * This function is the asynchronous counterpart of
+ * #wasmtime_func_call_unchecked. The `args_and_results` array holds the
+ * arguments on entry, and once the returned future completes successfully it
+ * holds the results. It must be at least as large as the greater of the
+ * function's number of parameters and results, and the values must have the
+ * types that the function expects. As with #wasmtime_func_call_unchecked no
+ * type checking is performed, and passing values of the wrong type or an
+ * array that is too small is undefined behavior.
+ *
+ * As with #wasmtime_func_call_async, `args_and_results`, `trap_ret` and
+ * `error_ret` must be kept alive and not modified until the returned
+ * #wasmtime_call_future_t is deleted.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *wasmtime_func_call_async_unchecked(
+    wasmtime_context_t *context, const wasmtime_func_t *func,
+    wasmtime_val_raw_t *args_and_results, size_t args_and_results_len,
+    wasm_trap_t **trap_ret, wasmtime_error_t **error_ret);
+
 /**
  * \brief Defines a new async function in this linker.
  *
@@ -250,6 +397,23 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_linker_define_async_func(
     const char *name, size_t name_len, const wasm_functype_t *ty,
     wasmtime_func_async_callback_t cb, void *data, void (*finalizer)(void *));
 
+/**
+ * \brief Defines a new async function in this linker whose results are
+ * delivered through a #wasmtime_async_completion_t.
+ *
+ * This function behaves similar to #wasmtime_linker_define_async_func, except
+ * that `cb` doesn't return a continuation which is polled. Instead `cb` is
+ * given ownership of a completion handle which it, or any other thread, later
+ * completes with #wasmtime_async_completion_complete or
+ * #wasmtime_async_completion_trap. This allows host calls to run concurrently
+ * with other stores without polling overhead.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_linker_define_async_completion_func(
+    wasmtime_linker_t *linker, const char *module, size_t module_len,
+    const char *name, size_t name_len, const wasm_functype_t *ty,
+    wasmtime_func_async_completion_callback_t cb, void *data,
+    void (*finalizer)(void *));
+
 /**
  * \brief Instantiates a #wasm_module_t with the items defined in this linker
  * for an async store.
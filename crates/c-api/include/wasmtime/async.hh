@@ -0,0 +1,339 @@
+/**
+ * \file wasmtime/async.hh
+ *
+ * C++20 coroutine support for asynchronously calling into WebAssembly.
+ *
+ * When the C API is built with async support and the compiler supports
+ * coroutines this header defines `WASMTIME_HAS_COROUTINES` along with
+ * `Task`, `Executor` and `SimpleExecutor`. `TypedFunc::call_async` and
+ * `Linker::instantiate_async` then return a `Task` which can be `co_await`-ed
+ * from another `Task`, suspending it whenever WebAssembly is waiting on the
+ * host, for example on fuel or epoch yields or on host functions defined with
+ * `wasmtime_linker_define_async_completion_func`.
+ */
+
+#ifndef WASMTIME_ASYNC_HH
+#define WASMTIME_ASYNC_HH
+
+#include <wasmtime/conf.h>
+
+#if defined(WASMTIME_FEATURE_ASYNC) && defined(__cpp_impl_coroutine)
+
+/// Defined when `Task`, `TypedFunc::call_async` and
+/// `Linker::instantiate_async` are available.
+#define WASMTIME_HAS_COROUTINES
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <wasmtime/async.h>
+
+namespace wasmtime {
+
+/**
+ * \brief Resumes coroutines once they're able to make progress.
+ *
+ * Every `Task` runs on an executor which is responsible for resuming it after
+ * it has been suspended waiting on WebAssembly. Implement this interface to
+ * drive tasks from an existing event loop, or use `SimpleExecutor`.
+ */
+class Executor {
+public:
+  virtual ~Executor() = default;
+
+  /// \brief Arranges for `handle` to be resumed by the thread driving this
+  /// executor.
+  ///
+  /// This may be called from any thread, for example from a thread completing
+  /// a host function defined with `wasmtime_linker_define_async_completion_func`.
+  virtual void schedule(std::coroutine_handle<> handle) = 0;
+};
+
+template <typename T> class Task;
+
+namespace detail {
+
+/// @private
+struct TaskPromiseBase {
+  Executor *executor = nullptr;
+  std::coroutine_handle<> continuation;
+
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+      if (auto next = h.promise().continuation) {
+        return next;
+      }
+      return std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  FinalAwaiter final_suspend() noexcept { return {}; }
+  void unhandled_exception() noexcept { std::terminate(); }
+};
+
+/// @private
+template <typename T> struct TaskPromise : TaskPromiseBase {
+  std::optional<T> value;
+
+  Task<T> get_return_object() noexcept;
+  void return_value(T v) { value.emplace(std::move(v)); }
+  T take() { return std::move(*value); }
+};
+
+/// @private
+template <> struct TaskPromise<void> : TaskPromiseBase {
+  Task<void> get_return_object() noexcept;
+  void return_void() noexcept {}
+  void take() noexcept {}
+};
+
+} // namespace detail
+
+/**
+ * \brief A coroutine producing a `T`, which runs on an `Executor`.
+ *
+ * Tasks are lazy: they don't start running until they're either `co_await`-ed
+ * from another `Task`, in which case they run on the same executor, or
+ * explicitly started with `Task::start` (or `SimpleExecutor::spawn`).
+ */
+template <typename T> class [[nodiscard]] Task {
+public:
+  /// @private
+  using promise_type = detail::TaskPromise<T>;
+
+  /// Moves ownership of the coroutine in `other` into this task.
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+  /// Moves ownership of the coroutine in `other` into this task.
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      reset();
+      handle = std::exchange(other.handle, {});
+    }
+    return *this;
+  }
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task() { reset(); }
+
+  /// \brief Schedules this task to start running on `executor`.
+  ///
+  /// Everything this task awaits also runs on `executor`.
+  void start(Executor &executor) {
+    handle.promise().executor = &executor;
+    executor.schedule(handle);
+  }
+
+  /// Returns whether this task has run to completion.
+  bool done() const { return handle.done(); }
+
+  /// Returns the result of this task, which must be `done`.
+  T result() { return handle.promise().take(); }
+
+  /// @private
+  bool await_ready() const noexcept { return false; }
+  /// @private
+  template <typename P>
+  std::coroutine_handle<>
+  await_suspend(std::coroutine_handle<P> caller) noexcept {
+    handle.promise().executor = caller.promise().executor;
+    handle.promise().continuation = caller;
+    return handle;
+  }
+  /// @private
+  T await_resume() { return handle.promise().take(); }
+
+private:
+  friend promise_type;
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+  void reset() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+namespace detail {
+
+template <typename T> Task<T> TaskPromise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+  return Task<void>(
+      std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+/// @private
+///
+/// Owns a `wasmtime_call_future_t` and polls it from within a `Task`, with
+/// the task suspended in between polls until wasmtime wakes it up.
+class CallFuture {
+  struct deleter {
+    void operator()(wasmtime_call_future_t *p) const {
+      wasmtime_call_future_delete(p);
+    }
+  };
+
+  // State shared with the wakers handed to wasmtime, which may be invoked from
+  // any thread and may outlive this future.
+  struct Waiter {
+    std::mutex mutex;
+    Executor *executor = nullptr;
+    std::coroutine_handle<> handle;
+    bool suspended = false;
+    bool woken = false;
+
+    // Resumes the task if it's suspended, and otherwise records that the
+    // task should be rescheduled once the current poll returns. The task is
+    // only scheduled once per suspension no matter how many times this is
+    // called.
+    void wake() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (suspended) {
+        suspended = false;
+        executor->schedule(handle);
+      } else {
+        woken = true;
+      }
+    }
+
+    static void on_wake(void *env) {
+      (*static_cast<std::shared_ptr<Waiter> *>(env))->wake();
+    }
+
+    static void finalize(void *env) {
+      delete static_cast<std::shared_ptr<Waiter> *>(env);
+    }
+  };
+
+  std::unique_ptr<wasmtime_call_future_t, deleter> ptr;
+  std::shared_ptr<Waiter> waiter;
+  // The `env` of the waker registered with `ptr`. It's allocated on the first
+  // poll, after which wasmtime owns it and reuses the waker for every poll.
+  std::shared_ptr<Waiter> *waker_env = nullptr;
+
+public:
+  explicit CallFuture(wasmtime_call_future_t *ptr)
+      : ptr(ptr), waiter(std::make_shared<Waiter>()) {}
+
+  /// Awaitable which polls the future once, suspending the awaiting task until
+  /// it's woken up if the future isn't complete. Evaluates to whether the
+  /// future is complete.
+  struct Poll {
+    CallFuture &future;
+    bool ready = false;
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename P> bool await_suspend(std::coroutine_handle<P> h) {
+      auto waiter = future.waiter;
+      {
+        std::lock_guard<std::mutex> lock(waiter->mutex);
+        waiter->executor = h.promise().executor;
+        waiter->handle = h;
+        waiter->woken = false;
+      }
+      if (future.waker_env == nullptr) {
+        future.waker_env = new std::shared_ptr<Waiter>(waiter);
+      }
+      wasmtime_async_waker_t waker = {Waiter::on_wake, future.waker_env,
+                                      Waiter::finalize};
+      ready = wasmtime_call_future_poll_with_waker(future.ptr.get(), &waker);
+      if (ready) {
+        return false;
+      }
+      std::lock_guard<std::mutex> lock(waiter->mutex);
+      if (waiter->woken) {
+        // Woken while being polled, for example by a fuel or epoch yield.
+        // Go to the back of the executor's queue instead of polling again
+        // straight away so other tasks get to run in between.
+        waiter->woken = false;
+        waiter->executor->schedule(h);
+        return true;
+      }
+      waiter->suspended = true;
+      return true;
+    }
+
+    bool await_resume() const noexcept { return ready; }
+  };
+
+  /// Returns an awaitable polling this future once.
+  Poll poll() { return Poll{*this}; }
+};
+
+} // namespace detail
+
+/**
+ * \brief A minimal single-threaded `Executor`.
+ *
+ * Tasks are added with `SimpleExecutor::spawn` and then all run on the thread
+ * calling `SimpleExecutor::run`, which sleeps whenever every task is waiting
+ * on WebAssembly.
+ */
+class SimpleExecutor : public Executor {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::coroutine_handle<>> ready;
+  std::vector<Task<void>> tasks;
+  size_t pending = 0;
+
+  Task<void> track(Task<void> task) {
+    co_await std::move(task);
+    pending--;
+  }
+
+public:
+  /// @private
+  void schedule(std::coroutine_handle<> handle) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ready.push_back(handle);
+    }
+    cv.notify_one();
+  }
+
+  /// \brief Adds `task` to the set of tasks run by `run`.
+  ///
+  /// This must be called either before `run` or from within a task running
+  /// on this executor.
+  void spawn(Task<void> task) {
+    tasks.push_back(track(std::move(task)));
+    pending++;
+    tasks.back().start(*this);
+  }
+
+  /// Runs tasks on the current thread until all spawned tasks are done.
+  void run() {
+    while (pending > 0) {
+      std::coroutine_handle<> next;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return !ready.empty(); });
+        next = ready.front();
+        ready.pop_front();
+      }
+      next.resume();
+    }
+    tasks.clear();
+  }
+};
+
+} // namespace wasmtime
+
+#endif // WASMTIME_FEATURE_ASYNC && __cpp_impl_coroutine
+
+#endif // WASMTIME_ASYNC_HH
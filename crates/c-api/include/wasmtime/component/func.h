@@ -3,10 +3,12 @@
 #ifndef WASMTIME_COMPONENT_FUNC_H
 #define WASMTIME_COMPONENT_FUNC_H
 
+#include <wasmtime/async.h>
 #include <wasmtime/component/val.h>
 #include <wasmtime/conf.h>
 #include <wasmtime/error.h>
 #include <wasmtime/store.h>
+#include <wasmtime/val.h>
 
 #ifdef WASMTIME_FEATURE_COMPONENT_MODEL
 
@@ -48,6 +50,116 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_component_func_call(
     const wasmtime_component_val_t *args, size_t args_size,
     wasmtime_component_val_t *results, size_t results_size);
 
+/// \brief Context used to lower parameters in
+/// #wasmtime_component_func_call_flat.
+typedef struct wasmtime_component_lower_cx wasmtime_component_lower_cx_t;
+
+/// \brief Context used to lift results in #wasmtime_component_func_call_flat.
+typedef struct wasmtime_component_lift_cx wasmtime_component_lift_cx_t;
+
+/**
+ * \brief Callback used to lower the parameters of a function in
+ * #wasmtime_component_func_call_flat.
+ *
+ * The first argument is the `lower_env` passed to
+ * #wasmtime_component_func_call_flat. The callback must fill in the
+ * `params_len` core wasm parameters of the function, which are initialized to
+ * zero, in their flattened canonical ABI representation. If the flattened
+ * parameters don't fit in 16 core wasm values then `params_len` is 1 and the
+ * single parameter is a pointer to the parameters in linear memory.
+ *
+ * Returning an error aborts the call and the error is returned from
+ * #wasmtime_component_func_call_flat.
+ */
+typedef wasmtime_error_t *(*wasmtime_component_func_lower_callback_t)(
+    void *env, wasmtime_component_lower_cx_t *cx, wasmtime_val_raw_t *params,
+    size_t params_len);
+
+/**
+ * \brief Callback used to lift the results of a function in
+ * #wasmtime_component_func_call_flat.
+ *
+ * The first argument is the `lift_env` passed to
+ * #wasmtime_component_func_call_flat. The `results` are the core wasm results
+ * of the function in their flattened canonical ABI representation, or a single
+ * pointer to them in linear memory if they don't fit in one core wasm value.
+ *
+ * Returning an error is propagated from #wasmtime_component_func_call_flat.
+ */
+typedef wasmtime_error_t *(*wasmtime_component_func_lift_callback_t)(
+    void *env, const wasmtime_component_lift_cx_t *cx,
+    const wasmtime_val_raw_t *results, size_t results_len);
+
+/**
+ * \brief Invokes \p func with parameters and results in their flattened
+ * canonical ABI representation.
+ *
+ * This is a lower-level alternative to #wasmtime_component_func_call which
+ * avoids converting parameters and results to and from
+ * #wasmtime_component_val_t. Parameters are written directly by \p lower,
+ * allocating space in linear memory with
+ * #wasmtime_component_lower_cx_realloc for strings, lists and spilled
+ * parameters. Results are then handed to \p lift, which can read strings and
+ * lists in-place from linear memory with #wasmtime_component_lift_cx_memory.
+ *
+ * The values written by \p lower are passed to the guest as-is and it is up to
+ * the embedder to ensure that they are valid for the function's type. C++
+ * users can use `wasmtime::component::TypedFunc` from
+ * `<wasmtime/component/func.hh>` to lower and lift native types instead.
+ *
+ * Like with #wasmtime_component_func_call,
+ * #wasmtime_component_func_post_return must be called once the results have
+ * been processed, and memory borrowed from the guest must not be used
+ * afterwards.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_func_call_flat(
+    const wasmtime_component_func_t *func, wasmtime_context_t *context,
+    wasmtime_component_func_lower_callback_t lower, void *lower_env,
+    wasmtime_component_func_lift_callback_t lift, void *lift_env);
+
+/**
+ * \brief Returns the linear memory that parameters are lowered into.
+ *
+ * The returned pointer is invalidated by
+ * #wasmtime_component_lower_cx_realloc, which may grow memory.
+ *
+ * An error is returned if the function doesn't have a `memory` canonical
+ * option, which is always present when its parameters contain strings or
+ * lists or don't fit in 16 core wasm values.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_component_lower_cx_memory(wasmtime_component_lower_cx_t *cx,
+                                   uint8_t **data, size_t *len);
+
+/**
+ * \brief Invokes the function's `realloc` canonical option to allocate
+ * \p new_size bytes aligned to \p align in linear memory.
+ *
+ * On success the address of the allocation is written to \p ret.
+ *
+ * An error is returned if the function doesn't have `memory` and `realloc`
+ * canonical options, or if `realloc` traps or returns an invalid allocation.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_component_lower_cx_realloc(wasmtime_component_lower_cx_t *cx,
+                                    size_t old_ptr, size_t old_size,
+                                    uint32_t align, size_t new_size,
+                                    size_t *ret);
+
+/**
+ * \brief Returns the linear memory that results are lifted from.
+ *
+ * This memory is borrowed from the guest and is valid until
+ * #wasmtime_component_func_post_return is called.
+ *
+ * An error is returned if the function doesn't have a `memory` canonical
+ * option, which is always present when its results contain strings or lists or
+ * don't fit in one core wasm value.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_component_lift_cx_memory(const wasmtime_component_lift_cx_t *cx,
+                                  const uint8_t **data, size_t *len);
+
 /**
  * \brief Invokes the `post-return` canonical ABI option, if specified, after a
  * #wasmtime_component_func_call has finished.
@@ -60,6 +172,41 @@ WASM_API_EXTERN wasmtime_error_t *
 wasmtime_component_func_post_return(const wasmtime_component_func_t *func,
                                     wasmtime_context_t *context);
 
+#ifdef WASMTIME_FEATURE_ASYNC
+
+/**
+ * \brief Same as #wasmtime_component_func_call but for async stores.
+ *
+ * The returned #wasmtime_call_future_t must be polled using
+ * #wasmtime_call_future_poll, and is owned and must be deleted using
+ * #wasmtime_call_future_delete. Results are written to \p results once the
+ * future has completed successfully.
+ *
+ * All arguments to this function must outlive the returned future and be
+ * unmodified until the future is deleted. The `error_ret` pointer may *not*
+ * be `NULL` and the returned error is owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *wasmtime_component_func_call_async(
+    const wasmtime_component_func_t *func, wasmtime_context_t *context,
+    const wasmtime_component_val_t *args, size_t args_size,
+    wasmtime_component_val_t *results, size_t results_size,
+    wasmtime_error_t **error_ret);
+
+/**
+ * \brief Same as #wasmtime_component_func_post_return but for async stores,
+ * to be used after #wasmtime_component_func_call_async.
+ *
+ * All arguments to this function must outlive the returned future and be
+ * unmodified until the future is deleted. The `error_ret` pointer may *not*
+ * be `NULL` and the returned error is owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *
+wasmtime_component_func_post_return_async(const wasmtime_component_func_t *func,
+                                          wasmtime_context_t *context,
+                                          wasmtime_error_t **error_ret);
+
+#endif // WASMTIME_FEATURE_ASYNC
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
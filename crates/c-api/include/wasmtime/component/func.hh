@@ -0,0 +1,431 @@
+/**
+ * \file wasmtime/component/func.hh
+ */
+
+#ifndef WASMTIME_COMPONENT_FUNC_HH
+#define WASMTIME_COMPONENT_FUNC_HH
+
+#include <wasmtime/conf.h>
+
+#ifdef WASMTIME_FEATURE_COMPONENT_MODEL
+
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
+#include <wasmtime/component/func.h>
+#include <wasmtime/error.hh>
+#include <wasmtime/span.hh>
+#include <wasmtime/store.hh>
+
+namespace wasmtime {
+namespace component {
+
+/**
+ * \brief Context used to lower parameters into a component function's linear
+ * memory, see #wasmtime_component_lower_cx_t.
+ */
+class LowerContext {
+  wasmtime_component_lower_cx_t *ptr;
+
+public:
+  /// Creates a context from the raw C API representation.
+  explicit LowerContext(wasmtime_component_lower_cx_t *ptr) : ptr(ptr) {}
+
+  /// Returns the linear memory that parameters are lowered into, see
+  /// #wasmtime_component_lower_cx_memory.
+  Result<Span<uint8_t>> memory() {
+    uint8_t *data = nullptr;
+    size_t len = 0;
+    auto *error = wasmtime_component_lower_cx_memory(ptr, &data, &len);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Span<uint8_t>(data, len);
+  }
+
+  /// Allocates memory in the guest with its `realloc` canonical option, see
+  /// #wasmtime_component_lower_cx_realloc.
+  Result<size_t> realloc(size_t old_ptr, size_t old_size, uint32_t align,
+                         size_t new_size) {
+    size_t ret = 0;
+    auto *error = wasmtime_component_lower_cx_realloc(ptr, old_ptr, old_size,
+                                                      align, new_size, &ret);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return ret;
+  }
+};
+
+/**
+ * \brief Context used to lift results out of a component function's linear
+ * memory, see #wasmtime_component_lift_cx_t.
+ */
+class LiftContext {
+  const wasmtime_component_lift_cx_t *ptr;
+
+public:
+  /// Creates a context from the raw C API representation.
+  explicit LiftContext(const wasmtime_component_lift_cx_t *ptr) : ptr(ptr) {}
+
+  /// Returns the linear memory that results are lifted from, see
+  /// #wasmtime_component_lift_cx_memory.
+  Result<Span<const uint8_t>> memory() const {
+    const uint8_t *data = nullptr;
+    size_t len = 0;
+    auto *error = wasmtime_component_lift_cx_memory(ptr, &data, &len);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return Span<const uint8_t>(data, len);
+  }
+};
+
+namespace detail {
+
+/// The maximum number of core wasm values that parameters are passed as before
+/// they're spilled to linear memory.
+inline constexpr size_t MAX_FLAT_PARAMS = 16;
+
+/// The maximum number of core wasm values that results are returned as before
+/// they're spilled to linear memory.
+inline constexpr size_t MAX_FLAT_RESULTS = 1;
+
+/// A "trait" for native types that correspond to component model types for use
+/// with `TypedFunc`.
+template <typename T> struct ComponentType {
+  static const bool valid = false;
+};
+
+/// Helper macro to define `ComponentType` definitions for primitive types like
+/// uint32_t and such.
+// NOLINTNEXTLINE
+#define NATIVE_COMPONENT_TYPE(native, field)                                   \
+  template <> struct ComponentType<native> {                                   \
+    static const bool valid = true;                                            \
+    static const size_t flat_size = 1;                                         \
+    static const size_t size = sizeof(native);                                 \
+    static const size_t align = alignof(native);                               \
+    static Result<std::monostate> lower(LowerContext &cx,                      \
+                                        wasmtime_val_raw_t *p,                 \
+                                        const native &t) {                     \
+      p->field = t;                                                            \
+      return std::monostate();                                                 \
+    }                                                                          \
+    static Result<native> lift(const LiftContext &cx,                          \
+                               const wasmtime_val_raw_t *p) {                  \
+      return static_cast<native>(p->field);                                    \
+    }                                                                          \
+    static Result<native> load(const LiftContext &cx, const uint8_t *bytes) {  \
+      native t;                                                                \
+      memcpy(&t, bytes, sizeof(native));                                       \
+      return t;                                                                \
+    }                                                                          \
+  };
+
+NATIVE_COMPONENT_TYPE(int8_t, i32)
+NATIVE_COMPONENT_TYPE(uint8_t, i32)
+NATIVE_COMPONENT_TYPE(int16_t, i32)
+NATIVE_COMPONENT_TYPE(uint16_t, i32)
+NATIVE_COMPONENT_TYPE(int32_t, i32)
+NATIVE_COMPONENT_TYPE(uint32_t, i32)
+NATIVE_COMPONENT_TYPE(int64_t, i64)
+NATIVE_COMPONENT_TYPE(uint64_t, i64)
+NATIVE_COMPONENT_TYPE(float, f32)
+NATIVE_COMPONENT_TYPE(double, f64)
+
+#undef NATIVE_COMPONENT_TYPE
+
+/// Type information for `bool`, which is an `i32` when flattened and a single
+/// byte in linear memory.
+template <> struct ComponentType<bool> {
+  static const bool valid = true;
+  static const size_t flat_size = 1;
+  static const size_t size = 1;
+  static const size_t align = 1;
+  static Result<std::monostate> lower(LowerContext &cx, wasmtime_val_raw_t *p,
+                                      const bool &t) {
+    p->i32 = t ? 1 : 0;
+    return std::monostate();
+  }
+  static Result<bool> lift(const LiftContext &cx, const wasmtime_val_raw_t *p) {
+    return p->i32 != 0;
+  }
+  static Result<bool> load(const LiftContext &cx, const uint8_t *bytes) {
+    return bytes[0] != 0;
+  }
+};
+
+/// Type information for `string` parameters, which are copied into linear
+/// memory allocated with the function's `realloc` option.
+///
+/// Strings are assumed to use the default `utf8` string encoding.
+template <> struct ComponentType<std::string_view> {
+  static const bool valid = true;
+  static const size_t flat_size = 2;
+  static Result<std::monostate> lower(LowerContext &cx, wasmtime_val_raw_t *p,
+                                      std::string_view t) {
+    auto ptr = cx.realloc(0, 0, 1, t.size());
+    if (!ptr) {
+      return ptr.err();
+    }
+    size_t offset = ptr.ok();
+    auto memory = cx.memory();
+    if (!memory) {
+      return memory.err();
+    }
+    memcpy(memory.ok().data() + offset, t.data(), t.size());
+    p[0].i32 = static_cast<int32_t>(offset);
+    p[1].i32 = static_cast<int32_t>(t.size());
+    return std::monostate();
+  }
+};
+
+/// Type information for `string`, copied out of linear memory when used as a
+/// result.
+///
+/// Strings are assumed to use the default `utf8` string encoding and are not
+/// validated.
+template <> struct ComponentType<std::string> {
+  static const bool valid = true;
+  static const size_t flat_size = 2;
+  static const size_t size = 8;
+  static const size_t align = 4;
+  static Result<std::monostate> lower(LowerContext &cx, wasmtime_val_raw_t *p,
+                                      const std::string &t) {
+    return ComponentType<std::string_view>::lower(cx, p, t);
+  }
+  static Result<std::string> lift(const LiftContext &cx,
+                                  const wasmtime_val_raw_t *p) {
+    return read(cx, static_cast<uint32_t>(p[0].i32),
+                static_cast<uint32_t>(p[1].i32));
+  }
+  static Result<std::string> load(const LiftContext &cx, const uint8_t *bytes) {
+    uint32_t ptr = 0;
+    uint32_t len = 0;
+    memcpy(&ptr, bytes, sizeof(ptr));
+    memcpy(&len, bytes + sizeof(ptr), sizeof(len));
+    return read(cx, ptr, len);
+  }
+
+private:
+  static Result<std::string> read(const LiftContext &cx, size_t ptr,
+                                  size_t len) {
+    auto memory = cx.memory();
+    if (!memory) {
+      return memory.err();
+    }
+    auto bytes = memory.ok();
+    if (ptr > bytes.size() || len > bytes.size() - ptr) {
+      return Error(std::string("string out of bounds of memory"));
+    }
+    return std::string(reinterpret_cast<const char *>(bytes.data() + ptr), len);
+  }
+};
+
+/// A "trait" for the parameters of a `TypedFunc`, which are either a
+/// `std::tuple` of types or `std::monostate` if there are none.
+template <typename T> struct ComponentParams {
+  static const bool valid = false;
+};
+
+/// std::monostate translates to no parameters.
+template <> struct ComponentParams<std::monostate> {
+  static const bool valid = true;
+  static const size_t flat_size = 0;
+  static Result<std::monostate> lower(LowerContext &cx,
+                                      wasmtime_val_raw_t *storage,
+                                      const std::monostate &t) {
+    return std::monostate();
+  }
+};
+
+/// std::tuple<> translates to the corresponding list of parameters.
+template <typename... T> struct ComponentParams<std::tuple<T...>> {
+  static const bool valid = (ComponentType<T>::valid && ...);
+  static const size_t flat_size = (0 + ... + ComponentType<T>::flat_size);
+  static Result<std::monostate> lower(LowerContext &cx,
+                                      wasmtime_val_raw_t *storage,
+                                      const std::tuple<T...> &t) {
+    std::optional<Error> error;
+    size_t n = 0;
+    std::apply(
+        [&](const auto &...val) {
+          (lower_one<T>(cx, storage, n, val, error), ...);
+        },
+        t);
+    if (error) {
+      return std::move(*error);
+    }
+    return std::monostate();
+  }
+
+private:
+  template <typename U>
+  static void lower_one(LowerContext &cx, wasmtime_val_raw_t *storage,
+                        size_t &n, const U &val, std::optional<Error> &error) {
+    if (!error) {
+      auto result = ComponentType<U>::lower(cx, &storage[n], val);
+      if (!result) {
+        error = result.err();
+      }
+    }
+    n += ComponentType<U>::flat_size;
+  }
+};
+
+/// A "trait" for the result of a `TypedFunc`, which is either a single type or
+/// `std::monostate` if there is none.
+///
+/// The base case is a single result, which is spilled to linear memory if it
+/// doesn't fit in `MAX_FLAT_RESULTS` core wasm values.
+template <typename R> struct ComponentResults {
+  static const bool valid = ComponentType<R>::valid;
+  static const size_t flat_size = ComponentType<R>::flat_size;
+  static Result<R> lift(const LiftContext &cx, const wasmtime_val_raw_t *raw,
+                        size_t len) {
+    if (len != 1) {
+      return Error(std::string("function returns an unexpected number of "
+                               "core wasm results"));
+    }
+    if constexpr (flat_size <= MAX_FLAT_RESULTS) {
+      return ComponentType<R>::lift(cx, raw);
+    } else {
+      size_t ptr = static_cast<uint32_t>(raw[0].i32);
+      auto memory = cx.memory();
+      if (!memory) {
+        return memory.err();
+      }
+      auto bytes = memory.ok();
+      if (ptr % ComponentType<R>::align != 0) {
+        return Error(std::string("return pointer not aligned"));
+      }
+      if (ptr > bytes.size() || ComponentType<R>::size > bytes.size() - ptr) {
+        return Error(std::string("return pointer out of bounds of memory"));
+      }
+      return ComponentType<R>::load(cx, bytes.data() + ptr);
+    }
+  }
+};
+
+/// Functions can return nothing.
+template <> struct ComponentResults<std::monostate> {
+  static const bool valid = true;
+  static Result<std::monostate> lift(const LiftContext &cx,
+                                     const wasmtime_val_raw_t *raw,
+                                     size_t len) {
+    if (len != 0) {
+      return Error(std::string("function returns an unexpected number of "
+                               "core wasm results"));
+    }
+    return std::monostate();
+  }
+};
+
+} // namespace detail
+
+/**
+ * \brief A version of a component function with statically known parameter
+ * and result types.
+ *
+ * This is a typed wrapper around #wasmtime_component_func_call_flat which
+ * lowers `Params` directly into the core wasm parameters of the function and
+ * lifts `Results` out of its core wasm results, without converting through
+ * #wasmtime_component_val_t.
+ *
+ * `Params` is a `std::tuple` of the parameter types, or `std::monostate` if
+ * there are none. `Results` is the single result type of the function, or
+ * `std::monostate` if it has none. Supported types are `bool`, the fixed-size
+ * integer types, `float`, `double`, `std::string_view` and `std::string` for
+ * parameters, and `std::string` for results.
+ *
+ * The component type of the function isn't available through the C API, so
+ * only the number of core wasm parameters and results is checked. It's up to
+ * the embedder to use types which match the function's signature.
+ */
+template <typename Params, typename Results> class TypedFunc {
+  using ParamList = detail::ComponentParams<Params>;
+  using ResultList = detail::ComponentResults<Results>;
+
+  static_assert(ParamList::valid, "unsupported parameter types");
+  static_assert(ResultList::valid, "unsupported result type");
+  static_assert(ParamList::flat_size <= detail::MAX_FLAT_PARAMS,
+                "parameters spilled to linear memory are not supported");
+
+  wasmtime_component_func_t f;
+
+  static wasmtime_error_t *lower_callback(void *env,
+                                          wasmtime_component_lower_cx_t *raw,
+                                          wasmtime_val_raw_t *params,
+                                          size_t params_len) {
+    if (params_len != ParamList::flat_size) {
+      return Error(std::string("function takes an unexpected number of core "
+                               "wasm parameters"))
+          .release();
+    }
+    LowerContext cx(raw);
+    auto result = ParamList::lower(cx, params, *static_cast<Params *>(env));
+    if (!result) {
+      return result.err().release();
+    }
+    return nullptr;
+  }
+
+  static wasmtime_error_t *
+  lift_callback(void *env, const wasmtime_component_lift_cx_t *raw,
+                const wasmtime_val_raw_t *results, size_t results_len) {
+    LiftContext cx(raw);
+    auto result = ResultList::lift(cx, results, results_len);
+    if (!result) {
+      return result.err().release();
+    }
+    static_cast<std::optional<Results> *>(env)->emplace(result.ok());
+    return nullptr;
+  }
+
+public:
+  /// Creates a typed function from the raw C API representation.
+  explicit TypedFunc(wasmtime_component_func_t f) : f(f) {}
+
+  /**
+   * \brief Calls this function with the provided parameters.
+   *
+   * Like with #wasmtime_component_func_call_flat, `post_return` must be called
+   * once the results have been processed and before the function is called
+   * again.
+   */
+  Result<Results> call(Store::Context cx, const Params &params) {
+    std::optional<Results> results;
+    auto *error = wasmtime_component_func_call_flat(
+        &f, cx.raw_context(), lower_callback,
+        const_cast<Params *>(&params), // NOLINT
+        lift_callback, &results);
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::move(*results);
+  }
+
+  /// Invokes the `post-return` canonical ABI option, if specified, after a
+  /// call has finished, see #wasmtime_component_func_post_return.
+  Result<std::monostate> post_return(Store::Context cx) {
+    auto *error = wasmtime_component_func_post_return(&f, cx.raw_context());
+    if (error != nullptr) {
+      return Error(error);
+    }
+    return std::monostate();
+  }
+
+  /// Returns the underlying C API representation of this function.
+  const wasmtime_component_func_t &raw() const { return f; }
+};
+
+} // namespace component
+} // namespace wasmtime
+
+#endif // WASMTIME_FEATURE_COMPONENT_MODEL
+
+#endif // WASMTIME_COMPONENT_FUNC_HH
@@ -5,7 +5,9 @@
 
 #include <wasmtime/component/component.h>
 #include <wasmtime/component/func.h>
+#include <wasmtime/async.h>
 #include <wasmtime/conf.h>
+#include <wasmtime/error.h>
 #include <wasmtime/store.h>
 
 #ifdef WASMTIME_FEATURE_COMPONENT_MODEL
@@ -60,6 +62,75 @@ WASM_API_EXTERN bool wasmtime_component_instance_get_func(
     const wasmtime_component_export_index_t *export_index,
     wasmtime_component_func_t *func_out);
 
+/**
+ * \brief A #wasmtime_component_t, pre-instantiation, that is ready to be
+ * instantiated.
+ *
+ * All imports of the component have already been resolved and type-checked
+ * against a #wasmtime_component_linker_t so instantiating is as cheap as
+ * possible. This is created with #wasmtime_component_linker_instantiate_pre
+ * and must be deleted using #wasmtime_component_instance_pre_delete.
+ *
+ * For more information see the Rust documentation:
+ * https://docs.wasmtime.dev/api/wasmtime/component/struct.InstancePre.html
+ */
+typedef struct wasmtime_component_instance_pre_t
+    wasmtime_component_instance_pre_t;
+
+/**
+ * \brief Deletes a previously created #wasmtime_component_instance_pre_t.
+ */
+WASM_API_EXTERN void wasmtime_component_instance_pre_delete(
+    wasmtime_component_instance_pre_t *instance_pre);
+
+/**
+ * \brief Instantiates a component instance within the given store.
+ *
+ * \param instance_pre the pre-instantiated component
+ * \param context the #wasmtime_context_t in which the instance should be
+ *        created
+ * \param instance_out on success, the instantiated
+ *        #wasmtime_component_instance_t
+ *
+ * \return wasmtime_error_t* on success `NULL` is returned, otherwise an error
+ *         is returned which describes why instantiation failed.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_instance_pre_instantiate(
+    const wasmtime_component_instance_pre_t *instance_pre,
+    wasmtime_context_t *context, wasmtime_component_instance_t *instance_out);
+
+/**
+ * \brief Returns the component (as a shallow clone) that \p instance_pre
+ * will instantiate.
+ *
+ * The returned component is owned by the caller and must be deleted via
+ * #wasmtime_component_delete.
+ */
+WASM_API_EXTERN wasmtime_component_t *wasmtime_component_instance_pre_component(
+    const wasmtime_component_instance_pre_t *instance_pre);
+
+#ifdef WASMTIME_FEATURE_ASYNC
+
+/**
+ * \brief Same as #wasmtime_component_instance_pre_instantiate but for async
+ * stores.
+ *
+ * The returned #wasmtime_call_future_t must be polled using
+ * #wasmtime_call_future_poll, and is owned and must be deleted using
+ * #wasmtime_call_future_delete.
+ *
+ * All arguments to this function must outlive the returned future and be
+ * unmodified until the future is deleted. The `error_ret` pointer may *not*
+ * be `NULL` and the returned error is owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *
+wasmtime_component_instance_pre_instantiate_async(
+    const wasmtime_component_instance_pre_t *instance_pre,
+    wasmtime_context_t *context, wasmtime_component_instance_t *instance_out,
+    wasmtime_error_t **error_ret);
+
+#endif // WASMTIME_FEATURE_ASYNC
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
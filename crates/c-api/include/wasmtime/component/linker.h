@@ -6,6 +6,7 @@
 #include <wasm.h>
 #include <wasmtime/component/component.h>
 #include <wasmtime/component/instance.h>
+#include <wasmtime/async.h>
 #include <wasmtime/conf.h>
 #include <wasmtime/error.h>
 #include <wasmtime/store.h>
@@ -64,6 +65,45 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_component_linker_instantiate(
     const wasmtime_component_t *component,
     wasmtime_component_instance_t *instance_out);
 
+/**
+ * \brief Resolves all the imports of \p component with this linker,
+ * returning a #wasmtime_component_instance_pre_t which can be instantiated
+ * quickly any number of times.
+ *
+ * \param linker the #wasmtime_component_linker_t providing imports
+ * \param component the #wasmtime_component_t to pre-instantiate
+ * \param instance_pre_out on success, the newly created
+ *        #wasmtime_component_instance_pre_t which is owned by the caller
+ *
+ * \return wasmtime_error_t* on success `NULL` is returned, otherwise an error
+ *         is returned which describes why the imports couldn't be resolved.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_component_linker_instantiate_pre(
+    const wasmtime_component_linker_t *linker,
+    const wasmtime_component_t *component,
+    wasmtime_component_instance_pre_t **instance_pre_out);
+
+#ifdef WASMTIME_FEATURE_ASYNC
+
+/**
+ * \brief Same as #wasmtime_component_linker_instantiate but for async stores.
+ *
+ * The returned #wasmtime_call_future_t must be polled using
+ * #wasmtime_call_future_poll, and is owned and must be deleted using
+ * #wasmtime_call_future_delete.
+ *
+ * All arguments to this function must outlive the returned future and be
+ * unmodified until the future is deleted. The `error_ret` pointer may *not*
+ * be `NULL` and the returned error is owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_call_future_t *
+wasmtime_component_linker_instantiate_async(
+    const wasmtime_component_linker_t *linker, wasmtime_context_t *context,
+    const wasmtime_component_t *component,
+    wasmtime_component_instance_t *instance_out, wasmtime_error_t **error_ret);
+
+#endif // WASMTIME_FEATURE_ASYNC
+
 /**
  * \brief Deletes a #wasmtime_component_linker_t created by
  * #wasmtime_component_linker_new
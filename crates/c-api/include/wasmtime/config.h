@@ -371,6 +371,49 @@ WASMTIME_CONFIG_PROP(void, memory_reservation_for_growth, uint64_t)
  */
 WASMTIME_CONFIG_PROP(void, native_unwind_info, bool)
 
+/**
+ * \brief Configures whether a backtrace of wasm frames is captured when wasm
+ * traps or a host function returns an error.
+ *
+ * This option defaults to true. Capturing a backtrace requires walking the
+ * stack on every trap, including the trap used to implement WASI's
+ * `proc_exit`, so embeddings which never inspect backtraces can disable it.
+ *
+ * Frames in a captured backtrace are only symbolicated when they're requested
+ * through #wasmtime_error_wasm_trace or #wasm_trap_trace, or when the error
+ * is printed.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.wasm_backtrace
+ */
+WASMTIME_CONFIG_PROP(void, wasm_backtrace, bool)
+
+/**
+ * \brief Configures whether backtraces include filename and line number
+ * information parsed from DWARF debug information in the wasm module.
+ *
+ * By default this is determined by the `WASMTIME_BACKTRACE_DETAILS`
+ * environment variable.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.wasm_backtrace_details
+ */
+WASMTIME_CONFIG_PROP(void, wasm_backtrace_details, bool)
+
+#ifdef WASMTIME_FEATURE_COREDUMP
+
+/**
+ * \brief Configures whether a core dump is captured when wasm traps.
+ *
+ * This option defaults to false.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.coredump_on_trap
+ */
+WASMTIME_CONFIG_PROP(void, coredump_on_trap, bool)
+
+#endif // WASMTIME_FEATURE_COREDUMP
+
 #ifdef WASMTIME_FEATURE_CACHE
 
 /**
@@ -759,6 +802,62 @@ WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(max_memory_size, size_t)
  */
 WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(total_gc_heaps, uint32_t)
 
+#ifdef WASMTIME_FEATURE_MEMORY_PROTECTION_KEYS
+
+/**
+ * \brief Whether the pooling allocator uses memory protection keys (MPK),
+ * values are in #wasmtime_mpk_enabled_enum.
+ */
+typedef uint8_t wasmtime_mpk_enabled_t;
+
+/**
+ * \brief Different ways the pooling allocator can use memory protection keys.
+ *
+ * The default value is #WASMTIME_MPK_ENABLED_DISABLE.
+ */
+enum wasmtime_mpk_enabled_enum { // MpkEnabled
+  /// Use MPK if supported by the current system, and fall back to guard
+  /// regions otherwise.
+  WASMTIME_MPK_ENABLED_AUTO,
+  /// Use MPK or fail to create the engine if it isn't supported.
+  WASMTIME_MPK_ENABLED_ENABLE,
+  /// Do not use MPK.
+  WASMTIME_MPK_ENABLED_DISABLE,
+};
+
+/**
+ * \brief Configures whether memory protection keys are used to pack more
+ * linear memory slots into the pool's address space.
+ *
+ * With memory protection keys the slots are split into one stripe per key,
+ * which can be monitored with #wasmtime_engine_pooling_memory_stripes.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.memory_protection_keys.
+ */
+WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(memory_protection_keys,
+                                        wasmtime_mpk_enabled_t)
+
+/**
+ * \brief The maximum number of memory protection keys, and thus stripes, to
+ * use (default is 16).
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.max_memory_protection_keys.
+ */
+WASMTIME_POOLING_ALLOCATION_CONFIG_PROP(max_memory_protection_keys, size_t)
+
+/**
+ * \brief Returns whether memory protection keys are available on this system.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.are_memory_protection_keys_available.
+ */
+WASM_API_EXTERN bool
+wasmtime_pooling_allocation_are_memory_protection_keys_available(void);
+
+#endif // WASMTIME_FEATURE_MEMORY_PROTECTION_KEYS
+
 /**
  * \brief Sets the Wasmtime allocation strategy to use the pooling allocator. It
  * does not take ownership of the pooling allocation configuration object, which
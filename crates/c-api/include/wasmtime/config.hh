@@ -5,6 +5,7 @@
 #ifndef WASMTIME_CONFIG_HH
 #define WASMTIME_CONFIG_HH
 
+#include <wasmtime/async.h>
 #include <wasmtime/conf.h>
 #include <wasmtime/config.h>
 #include <wasmtime/error.hh>
@@ -42,6 +43,18 @@ enum class ProfilingStrategy {
   Perfmap = WASMTIME_PROFILING_STRATEGY_PERFMAP,
 };
 
+#ifdef WASMTIME_FEATURE_MEMORY_PROTECTION_KEYS
+/// \brief Values passed to `PoolAllocationConfig::memory_protection_keys`
+enum class MpkEnabled {
+  /// Use MPK if supported by the current system
+  Auto = WASMTIME_MPK_ENABLED_AUTO,
+  /// Use MPK or fail if not supported
+  Enable = WASMTIME_MPK_ENABLED_ENABLE,
+  /// Do not use MPK
+  Disable = WASMTIME_MPK_ENABLED_DISABLE,
+};
+#endif // WASMTIME_FEATURE_MEMORY_PROTECTION_KEYS
+
 #ifdef WASMTIME_FEATURE_POOLING_ALLOCATOR
 /**
  * \brief Pool allocation configuration for Wasmtime.
@@ -238,6 +251,34 @@ public:
   void total_gc_heaps(uint32_t count) {
     wasmtime_pooling_allocation_config_total_gc_heaps_set(ptr.get(), count);
   }
+
+#ifdef WASMTIME_FEATURE_MEMORY_PROTECTION_KEYS
+  /// \brief Configures whether memory protection keys are used to pack more
+  /// linear memory slots into the pool.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.memory_protection_keys.
+  void memory_protection_keys(MpkEnabled enable) {
+    wasmtime_pooling_allocation_config_memory_protection_keys_set(
+        ptr.get(), static_cast<wasmtime_mpk_enabled_t>(enable));
+  }
+
+  /// \brief The maximum number of memory protection keys to use (default is
+  /// 16).
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.max_memory_protection_keys.
+  void max_memory_protection_keys(size_t max) {
+    wasmtime_pooling_allocation_config_max_memory_protection_keys_set(
+        ptr.get(), max);
+  }
+
+  /// \brief Returns whether memory protection keys are available on this
+  /// system.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.PoolingAllocationConfig.html#method.are_memory_protection_keys_available.
+  static bool are_memory_protection_keys_available() {
+    return wasmtime_pooling_allocation_are_memory_protection_keys_available();
+  }
+#endif // WASMTIME_FEATURE_MEMORY_PROTECTION_KEYS
 };
 #endif // WASMTIME_FEATURE_POOLING_ALLOCATOR
 
@@ -294,6 +335,16 @@ public:
     wasmtime_config_max_wasm_stack_set(ptr.get(), stack);
   }
 
+#ifdef WASMTIME_FEATURE_ASYNC
+  /// \brief Configures whether WebAssembly can be called asynchronously, for
+  /// example with `TypedFunc::call_async`.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.async_support
+  void async_support(bool enable) {
+    wasmtime_config_async_support_set(ptr.get(), enable);
+  }
+#endif // WASMTIME_FEATURE_ASYNC
+
 #ifdef WASMTIME_FEATURE_THREADS
   /// \brief Configures whether the WebAssembly threads proposal is enabled
   ///
@@ -508,6 +559,30 @@ public:
     wasmtime_config_native_unwind_info_set(ptr.get(), enable);
   }
 
+  /// \brief Configures whether wasm backtraces are captured on traps.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.wasm_backtrace
+  void wasm_backtrace(bool enable) {
+    wasmtime_config_wasm_backtrace_set(ptr.get(), enable);
+  }
+
+  /// \brief Configures whether wasm backtraces include DWARF-derived
+  /// filename and line information.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.wasm_backtrace_details
+  void wasm_backtrace_details(bool enable) {
+    wasmtime_config_wasm_backtrace_details_set(ptr.get(), enable);
+  }
+
+#ifdef WASMTIME_FEATURE_COREDUMP
+  /// \brief Configures whether a core dump is captured on traps.
+  ///
+  /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.coredump_on_trap
+  void coredump_on_trap(bool enable) {
+    wasmtime_config_coredump_on_trap_set(ptr.get(), enable);
+  }
+#endif // WASMTIME_FEATURE_COREDUMP
+
   /// \brief Configures whether mach ports are used on macOS
   ///
   /// https://docs.wasmtime.dev/api/wasmtime/struct.Config.html#method.macos_use_mach_ports
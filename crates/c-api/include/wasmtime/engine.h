@@ -8,6 +8,7 @@
 #define WASMTIME_ENGINE_H
 
 #include <wasm.h>
+#include <wasmtime/conf.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,6 +42,48 @@ WASM_API_EXTERN void wasmtime_engine_increment_epoch(wasm_engine_t *engine);
  */
 WASM_API_EXTERN bool wasmtime_engine_is_pulley(wasm_engine_t *engine);
 
+#ifdef WASMTIME_FEATURE_POOLING_ALLOCATOR
+
+/**
+ * \brief The usage of one stripe of linear memory slots in the pooling
+ * allocator, see #wasmtime_engine_pooling_memory_stripes.
+ */
+typedef struct wasmtime_pool_memory_stripe {
+  /// Whether the slots in this stripe are protected by a memory protection
+  /// key.
+  bool is_protected;
+  /// The total number of linear memory slots in this stripe.
+  size_t total_slots;
+  /// The number of linear memory slots in this stripe currently in use.
+  size_t used_slots;
+  /// The number of live stores which allocate their linear memories from this
+  /// stripe, which is always zero for unprotected stripes.
+  size_t stores;
+} wasmtime_pool_memory_stripe_t;
+
+/**
+ * \brief Returns the usage of each stripe of linear memory slots in the
+ * pooling allocator.
+ *
+ * When memory protection keys are enabled with
+ * `wasmtime_pooling_allocation_config_memory_protection_keys_set` the pooling
+ * allocator splits its linear memory slots into one stripe per key, and new
+ * stores are assigned to the stripe with the fewest live stores. Otherwise
+ * there's a single unprotected stripe.
+ *
+ * Up to `len` stripes are written to `stripes`, and the total number of
+ * stripes is returned, which is zero if `engine` doesn't use the pooling
+ * allocator.
+ *
+ * For more information see the Rust documentation at
+ * https://docs.wasmtime.dev/api/wasmtime/struct.Engine.html#method.pooling_memory_stripes.
+ */
+WASM_API_EXTERN size_t wasmtime_engine_pooling_memory_stripes(
+    const wasm_engine_t *engine, wasmtime_pool_memory_stripe_t *stripes,
+    size_t len);
+
+#endif // WASMTIME_FEATURE_POOLING_ALLOCATOR
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -5,7 +5,9 @@
 #ifndef WASMTIME_ENGINE_HH
 #define WASMTIME_ENGINE_HH
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 #include <wasmtime/config.hh>
 #include <wasmtime/engine.h>
 
@@ -49,6 +51,12 @@ public:
   /// Moves resources from another engine into this one.
   Engine &operator=(Engine &&other) = default;
 
+  /// \brief Returns the underlying C API pointer.
+  const wasm_engine_t *capi() const { return ptr.get(); }
+
+  /// \brief Returns the underlying C API pointer.
+  wasm_engine_t *capi() { return ptr.get(); }
+
   /// \brief Increments the current epoch which may result in interrupting
   /// currently executing WebAssembly in connected stores if the epoch is now
   /// beyond the configured threshold.
@@ -56,6 +64,19 @@ public:
 
   /// \brief Returns whether this engine is using Pulley for execution.
   void is_pulley() const { wasmtime_engine_is_pulley(ptr.get()); }
+
+#ifdef WASMTIME_FEATURE_POOLING_ALLOCATOR
+  /// \brief Returns the usage of each stripe of linear memory slots in the
+  /// pooling allocator, which is empty if the pooling allocator isn't used.
+  std::vector<wasmtime_pool_memory_stripe_t> pooling_memory_stripes() const {
+    std::vector<wasmtime_pool_memory_stripe_t> stripes(
+        wasmtime_engine_pooling_memory_stripes(ptr.get(), nullptr, 0));
+    size_t len = wasmtime_engine_pooling_memory_stripes(
+        ptr.get(), stripes.data(), stripes.size());
+    stripes.resize(std::min(len, stripes.size()));
+    return stripes;
+  }
+#endif // WASMTIME_FEATURE_POOLING_ALLOCATOR
 };
 
 } // namespace wasmtime
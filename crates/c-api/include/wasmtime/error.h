@@ -57,6 +57,9 @@ WASM_API_EXTERN void wasmtime_error_message(const wasmtime_error_t *error,
  * Returns `true` if the error is a WASI "exit" trap and has a return status.
  * If `true` is returned then the exit status is returned through the `status`
  * pointer. If `false` is returned then this is not a wasi exit trap.
+ *
+ * This does not symbolicate the backtrace attached to the error, if any, so
+ * it's cheap to call after every `_start`-style command finishes.
  */
 WASM_API_EXTERN bool wasmtime_error_exit_status(const wasmtime_error_t *,
                                                 int *status);
@@ -67,6 +70,11 @@ WASM_API_EXTERN bool wasmtime_error_exit_status(const wasmtime_error_t *,
  * This is similar to #wasm_trap_trace except that it takes a #wasmtime_error_t
  * as input. The `out` argument will be filled in with the wasm trace, if
  * present.
+ *
+ * The frames of the trace are symbolicated the first time they're requested,
+ * so errors whose trace is never requested don't pay for symbolication. No
+ * trace is captured at all if #wasmtime_config_wasm_backtrace_set disabled
+ * backtraces.
  */
 WASM_API_EXTERN void wasmtime_error_wasm_trace(const wasmtime_error_t *,
                                                wasm_frame_vec_t *out);
@@ -5,7 +5,9 @@
 #ifndef WASMTIME_FUNC_HH
 #define WASMTIME_FUNC_HH
 
+#include <algorithm>
 #include <array>
+#include <wasmtime/async.hh>
 #include <wasmtime/error.hh>
 #include <wasmtime/extern_declare.hh>
 #include <wasmtime/func.h>
@@ -563,6 +565,34 @@ template <typename Params, typename Results> class TypedFunc {
   Func f;
   TypedFunc(Func func) : f(func) {}
 
+#ifdef WASMTIME_HAS_COROUTINES
+  static Task<TrapResult<Results>>
+  call_async_impl(Store::Context cx, wasmtime_func_t func, Params params) {
+    std::array<wasmtime_val_raw_t, std::max(WasmTypeList<Params>::size,
+                                            WasmTypeList<Results>::size)>
+        storage;
+    wasmtime_val_raw_t *ptr = storage.data();
+    if (ptr == nullptr)
+      ptr = reinterpret_cast<wasmtime_val_raw_t *>(alignof(wasmtime_val_raw_t));
+    WasmTypeList<Params>::store(cx, ptr, params);
+    wasm_trap_t *trap = nullptr;
+    wasmtime_error_t *error = nullptr;
+    {
+      detail::CallFuture future(wasmtime_func_call_async_unchecked(
+          cx.raw_context(), &func, ptr, storage.size(), &trap, &error));
+      while (!co_await future.poll()) {
+      }
+    }
+    if (error != nullptr) {
+      co_return TrapError(Error(error));
+    }
+    if (trap != nullptr) {
+      co_return TrapError(Trap(trap));
+    }
+    co_return WasmTypeList<Results>::load(cx, ptr);
+  }
+#endif // WASMTIME_HAS_COROUTINES
+
 public:
   /**
    * \brief Calls this function with the provided parameters.
@@ -594,6 +624,20 @@ public:
     return WasmTypeList<Results>::load(cx, ptr);
   }
 
+#ifdef WASMTIME_HAS_COROUTINES
+  /**
+   * \brief Asynchronously calls this function with the provided parameters.
+   *
+   * This is the asynchronous version of `TypedFunc::call` and requires a store
+   * whose engine was configured with `Config::async_support`. The call starts
+   * once the returned `Task` is awaited, or started on an `Executor`, and the
+   * store must not be used for anything else until the task completes.
+   */
+  Task<TrapResult<Results>> call_async(Store::Context cx, Params params) const {
+    return call_async_impl(cx, f.func, std::move(params));
+  }
+#endif // WASMTIME_HAS_COROUTINES
+
   /// Returns the underlying un-typed `Func` for this function.
   const Func &func() const { return f; }
 };
@@ -204,6 +204,10 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_linker_define_instance(
  * provided with items previously defined in this linker. If any name isn't
  * defined in the linker than an error is returned. (or if the previously
  * defined item is of the wrong type).
+ *
+ * The resolved imports of recently instantiated modules are cached in the
+ * linker until an item is next defined in it, so instantiating the same module
+ * repeatedly is as fast as using #wasmtime_linker_instantiate_pre.
  */
 WASM_API_EXTERN wasmtime_error_t *
 wasmtime_linker_instantiate(const wasmtime_linker_t *linker,
@@ -5,6 +5,7 @@
 #ifndef WASMTIME_LINKER_HH
 #define WASMTIME_LINKER_HH
 
+#include <wasmtime/async.hh>
 #include <wasmtime/engine.hh>
 #include <wasmtime/error.hh>
 #include <wasmtime/extern.hh>
@@ -29,6 +30,29 @@ class Linker {
 
   std::unique_ptr<wasmtime_linker_t, deleter> ptr;
 
+#ifdef WASMTIME_HAS_COROUTINES
+  static Task<TrapResult<Instance>>
+  instantiate_async_impl(const wasmtime_linker_t *linker, Store::Context cx,
+                         const wasmtime_module_t *module) {
+    wasmtime_instance_t instance;
+    wasm_trap_t *trap = nullptr;
+    wasmtime_error_t *error = nullptr;
+    {
+      detail::CallFuture future(wasmtime_linker_instantiate_async(
+          linker, cx.ptr, module, &instance, &trap, &error));
+      while (!co_await future.poll()) {
+      }
+    }
+    if (error != nullptr) {
+      co_return TrapError(Error(error));
+    }
+    if (trap != nullptr) {
+      co_return TrapError(Trap(trap));
+    }
+    co_return Instance(instance);
+  }
+#endif // WASMTIME_HAS_COROUTINES
+
 public:
   /// Creates a new linker which will instantiate in the given engine.
   explicit Linker(Engine &engine)
@@ -95,6 +119,19 @@ public:
     return Instance(instance);
   }
 
+#ifdef WASMTIME_HAS_COROUTINES
+  /// Asynchronously instantiates the module `m` provided within the store `cx`
+  /// using the items defined within this linker.
+  ///
+  /// This is the asynchronous version of `Linker::instantiate` and requires a
+  /// store whose engine was configured with `Config::async_support`. This
+  /// linker and `m` must outlive the returned `Task`.
+  Task<TrapResult<Instance>> instantiate_async(Store::Context cx,
+                                               const Module &m) {
+    return instantiate_async_impl(ptr.get(), cx, m.ptr.get());
+  }
+#endif // WASMTIME_HAS_COROUTINES
+
   /// Defines instantiations of the module `m` within this linker under the
   /// given `name`.
   Result<std::monostate> module(Store::Context cx, std::string_view name,
@@ -49,6 +49,200 @@ WASM_API_EXTERN wasmtime_error_t *wasmtime_module_new(wasm_engine_t *engine,
                                                       size_t wasm_len,
                                                       wasmtime_module_t **ret);
 
+/**
+ * \brief Compiles a WebAssembly binary guided by a runtime call profile.
+ *
+ * This is the same as #wasmtime_module_new except that `profile` is a call
+ * profile previously produced by #wasmtime_guestprofiler_call_profile for the
+ * same WebAssembly binary. Call edges that the profile reports as hot are
+ * favored by the inliner. The profile only has an effect when inlining is
+ * enabled in the engine's configuration.
+ *
+ * An error is returned if `profile` is not a valid call profile.
+ *
+ * This function does not take ownership of any of its arguments, but the
+ * returned error and module are owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_error_t *wasmtime_module_new_with_call_profile(
+    wasm_engine_t *engine, const uint8_t *wasm, size_t wasm_len,
+    const uint8_t *profile, size_t profile_len, wasmtime_module_t **ret);
+
+/**
+ * \typedef wasmtime_compile_report_t
+ * \brief Convenience alias for #wasmtime_compile_report
+ *
+ * \struct wasmtime_compile_report
+ * \brief A report on how each function of a module was compiled.
+ *
+ * Created with #wasmtime_module_new_with_report and deleted with
+ * #wasmtime_compile_report_delete.
+ */
+typedef struct wasmtime_compile_report wasmtime_compile_report_t;
+
+/**
+ * \brief Statistics about the compilation of a single function.
+ *
+ * Statistics which the configured compilation strategy doesn't measure are
+ * reported as zero.
+ */
+typedef struct wasmtime_function_compile_report {
+  /// The index of the function in the module's function index space, which
+  /// includes imported functions.
+  uint32_t func_index;
+  /// The symbol name of the function, which is not nul-terminated. This is
+  /// owned by the #wasmtime_compile_report_t it was retrieved from.
+  const char *name;
+  /// The length, in bytes, of `name`.
+  size_t name_len;
+  /// The size, in bytes, of the function's WebAssembly body.
+  size_t wasm_size;
+  /// The number of instructions in the compiler's intermediate representation
+  /// of the function, before optimizations.
+  size_t ir_size;
+  /// The size, in bytes, of the generated machine code.
+  size_t code_size;
+  /// The wall-clock time spent compiling the function, in nanoseconds.
+  uint64_t compile_time_nanos;
+  /// The time spent in register allocation, in nanoseconds.
+  uint64_t regalloc_time_nanos;
+  /// The number of passes which can be inspected with
+  /// #wasmtime_compile_report_function_pass.
+  size_t num_passes;
+  /// Whether the machine code was loaded from the incremental compilation
+  /// cache instead of being compiled.
+  bool cache_hit;
+} wasmtime_function_compile_report_t;
+
+/**
+ * \brief Compiles a WebAssembly binary and reports how it was compiled.
+ *
+ * This is the same as #wasmtime_module_new except that on success `report` is
+ * additionally filled in with a #wasmtime_compile_report_t describing where
+ * time and space went while compiling each function. This can be used to
+ * identify functions which are unexpectedly expensive to compile.
+ *
+ * This function does not take ownership of any of its arguments, but the
+ * returned error, module and report are owned by the caller.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_module_new_with_report(wasm_engine_t *engine, const uint8_t *wasm,
+                                size_t wasm_len, wasmtime_module_t **ret,
+                                wasmtime_compile_report_t **report);
+
+/**
+ * \brief Deletes a compile report.
+ */
+WASM_API_EXTERN void
+wasmtime_compile_report_delete(wasmtime_compile_report_t *report);
+
+/**
+ * \brief Returns whether the whole module was loaded from Wasmtime's module
+ * cache, in which case the report contains no functions.
+ */
+WASM_API_EXTERN bool wasmtime_compile_report_module_cache_hit(
+    const wasmtime_compile_report_t *report);
+
+/**
+ * \brief Returns the number of functions in a compile report.
+ */
+WASM_API_EXTERN size_t
+wasmtime_compile_report_functions_len(const wasmtime_compile_report_t *report);
+
+/**
+ * \brief Retrieves the statistics of the `index`th function in a compile
+ * report.
+ *
+ * Functions are ordered by their function index. Returns `false` and leaves
+ * `out` unmodified if `index` is out of bounds.
+ */
+WASM_API_EXTERN bool
+wasmtime_compile_report_function(const wasmtime_compile_report_t *report,
+                                 size_t index,
+                                 wasmtime_function_compile_report_t *out);
+
+/**
+ * \brief Retrieves the time spent in a single compiler pass for a function in
+ * a compile report.
+ *
+ * The `pass_index` must be less than the `num_passes` field of the function's
+ * #wasmtime_function_compile_report_t. On success `name` and `name_len` are
+ * filled in with a human-readable description of the pass, which is not
+ * nul-terminated and remains valid for the lifetime of the program, and
+ * `time_nanos` with the time spent in the pass, excluding nested passes.
+ *
+ * Returns `false` and leaves the out-parameters unmodified if either index is
+ * out of bounds.
+ */
+WASM_API_EXTERN bool wasmtime_compile_report_function_pass(
+    const wasmtime_compile_report_t *report, size_t func_index,
+    size_t pass_index, const char **name, size_t *name_len,
+    uint64_t *time_nanos);
+
+/**
+ * \typedef wasmtime_module_builder_t
+ * \brief Convenience alias for #wasmtime_module_builder
+ *
+ * \struct wasmtime_module_builder
+ * \brief A builder which compiles a module from a WebAssembly binary while
+ * it arrives in pieces.
+ *
+ * Created with #wasmtime_module_builder_new. Bytes are supplied with
+ * #wasmtime_module_builder_feed as they become available, for example while a
+ * module is being downloaded, and the module is produced by
+ * #wasmtime_module_builder_finish. A background thread validates each section
+ * as soon as it has arrived and hands each function body to the compilation
+ * workers as soon as its code section entry has arrived, so compilation
+ * overlaps with receiving the rest of the binary.
+ * #wasmtime_module_builder_finish then only waits for the remaining functions
+ * and links them into a module, without parsing or validating the binary again.
+ *
+ * See `wasmtime::StreamingModuleBuilder` in the Rust API for more details.
+ */
+typedef struct wasmtime_module_builder wasmtime_module_builder_t;
+
+/**
+ * \brief Creates a new builder which compiles a module for `engine`.
+ *
+ * The returned builder must be consumed with #wasmtime_module_builder_finish
+ * or deleted with #wasmtime_module_builder_delete.
+ */
+WASM_API_EXTERN wasmtime_module_builder_t *
+wasmtime_module_builder_new(wasm_engine_t *engine);
+
+/**
+ * \brief Supplies the next `len` bytes of the WebAssembly binary.
+ *
+ * The bytes are copied, so `bytes` may be reused once this returns, and this
+ * doesn't wait for them to be parsed or compiled. Returns an error if the bytes
+ * supplied previously have been found not to be a valid prefix of a WebAssembly
+ * module or if a function failed to compile, in which case the builder should
+ * be deleted. Errors in the bytes of this call are returned by a later call.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_module_builder_feed(wasmtime_module_builder_t *builder,
+                             const uint8_t *bytes, size_t len);
+
+/**
+ * \brief Finishes compiling the module once the whole binary has been
+ * supplied.
+ *
+ * This takes ownership of `builder` and waits for compilation to finish. On
+ * success `ret` is filled in with a
+ * module owned by the caller, and otherwise an error is returned if the binary
+ * was truncated or invalid or if compilation failed.
+ */
+WASM_API_EXTERN wasmtime_error_t *
+wasmtime_module_builder_finish(wasmtime_module_builder_t *builder,
+                               wasmtime_module_t **ret);
+
+/**
+ * \brief Deletes a builder without finishing the module.
+ *
+ * This waits for any function which is being compiled to finish.
+ */
+WASM_API_EXTERN void
+wasmtime_module_builder_delete(wasmtime_module_builder_t *builder);
+
 #endif // WASMTIME_FEATURE_COMPILER
 
 /**
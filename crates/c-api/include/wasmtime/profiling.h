@@ -94,6 +94,28 @@ wasmtime_guestprofiler_sample(wasmtime_guestprofiler_t *guestprofiler,
                               const wasmtime_store_t *store,
                               uint64_t delta_nanos);
 
+/**
+ * \brief Serializes the call-edge profile collected so far.
+ *
+ * \param guestprofiler the profiler whose samples are being serialized
+ * \param out           pointer to where #wasm_byte_vec_t containing the
+ *                      serialized call profile will be written
+ *
+ * The call profile records which functions of the first module passed to
+ * #wasmtime_guestprofiler_new were hot and which call edges between them were
+ * hot. It can be persisted and later passed to
+ * #wasmtime_module_new_with_call_profile to guide inlining when recompiling
+ * the same module.
+ *
+ * This function does not take ownership of `guestprofiler`. The `out` vector
+ * is owned by the caller.
+ *
+ * For more information see the Rust documentation at:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.GuestProfiler.html#method.call_profile
+ */
+WASM_API_EXTERN void wasmtime_guestprofiler_call_profile(
+    const wasmtime_guestprofiler_t *guestprofiler, wasm_byte_vec_t *out);
+
 /**
  * \brief Writes out the captured profile.
  *
@@ -116,6 +138,113 @@ WASM_API_EXTERN /* own */ wasmtime_error_t *
 wasmtime_guestprofiler_finish(/* own */ wasmtime_guestprofiler_t *guestprofiler,
                               /* own */ wasm_byte_vec_t *out);
 
+/**
+ * \brief Continuously samples the WebAssembly stacks of many stores.
+ *
+ * A sampler spawns a thread which increments the engine's epoch at a fixed
+ * interval, and every store attached with #wasmtime_stack_sampler_attach
+ * records a sample of its own stack whenever it observes a new epoch. Samples
+ * are aggregated per tag and stack, and retrieved as folded stacks with
+ * #wasmtime_stack_sampler_folded.
+ *
+ * For more information see the Rust documentation at:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.StackSampler.html
+ */
+typedef struct wasmtime_stack_sampler wasmtime_stack_sampler_t;
+
+/**
+ * \brief Stops and deletes a sampler, discarding its samples.
+ *
+ * Stores which were attached to this sampler keep running but no longer
+ * record samples.
+ */
+WASM_API_EXTERN void
+wasmtime_stack_sampler_delete(/* own */ wasmtime_stack_sampler_t *sampler);
+
+/**
+ * \brief Creates a new sampler for stores in `engine`.
+ *
+ * \param engine         engine whose stores will be sampled, which must have
+ *                       epoch interruption enabled
+ * \param interval_nanos interval between samples in nanoseconds, which must
+ *                       not be zero
+ * \param out            where the sampler, owned by the caller, is written on
+ *                       success
+ *
+ * \return Returns #wasmtime_error_t owned by the caller in case of error,
+ * `NULL` otherwise.
+ *
+ * For more information see the Rust documentation at:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.StackSampler.html#method.new
+ */
+WASM_API_EXTERN /* own */ wasmtime_error_t *
+wasmtime_stack_sampler_new(const wasm_engine_t *engine, uint64_t interval_nanos,
+                           /* own */ wasmtime_stack_sampler_t **out);
+
+/**
+ * \brief Starts sampling `store`, attributing its samples to `tag`.
+ *
+ * This replaces any callback configured with
+ * #wasmtime_store_epoch_deadline_callback for `store` and sets its epoch
+ * deadline to the next tick of `sampler`. Samples remain in the sampler after
+ * `store` is deleted.
+ *
+ * This function does not take ownership of the arguments.
+ *
+ * For more information see the Rust documentation at:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.StackSampler.html#method.attach
+ */
+WASM_API_EXTERN void
+wasmtime_stack_sampler_attach(const wasmtime_stack_sampler_t *sampler,
+                              wasmtime_store_t *store, const wasm_name_t *tag);
+
+/**
+ * \brief Sets the maximum number of distinct tags and stacks which are kept,
+ * 10,000 by default.
+ *
+ * Once this many have been sampled, samples of any other stack are only
+ * counted per tag and written by #wasmtime_stack_sampler_folded as a single
+ * `[other]` frame below the tag.
+ *
+ * For more information see the Rust documentation at:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.StackSampler.html#method.set_max_stacks
+ */
+WASM_API_EXTERN void
+wasmtime_stack_sampler_set_max_stacks(const wasmtime_stack_sampler_t *sampler,
+                                      size_t max);
+
+/**
+ * \brief Returns the total number of samples taken so far.
+ */
+WASM_API_EXTERN uint64_t
+wasmtime_stack_sampler_sample_count(const wasmtime_stack_sampler_t *sampler);
+
+/**
+ * \brief Writes all samples taken so far as folded stacks.
+ *
+ * \param sampler the sampler whose samples are being written
+ * \param out     pointer to where a #wasm_byte_vec_t owned by the caller is
+ *                written
+ *
+ * There's one line per distinct tag and stack in the format read by
+ * `flamegraph.pl` and `inferno`: the tag, followed by the functions on the
+ * stack from oldest to youngest, separated by semicolons, and finally the
+ * number of samples of that stack. Each function is named by its module's name
+ * and its own name joined by a backtick.
+ *
+ * For more information see the Rust documentation at:
+ * https://docs.wasmtime.dev/api/wasmtime/struct.StackSampler.html#method.folded
+ */
+WASM_API_EXTERN void
+wasmtime_stack_sampler_folded(const wasmtime_stack_sampler_t *sampler,
+                              wasm_byte_vec_t *out);
+
+/**
+ * \brief Discards all samples taken so far.
+ */
+WASM_API_EXTERN void
+wasmtime_stack_sampler_reset(const wasmtime_stack_sampler_t *sampler);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
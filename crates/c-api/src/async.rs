@@ -4,11 +4,11 @@ use std::mem::{self, MaybeUninit};
 use std::num::NonZeroU64;
 use std::ops::Range;
 use std::pin::Pin;
-use std::sync::Arc;
-use std::task::{Context, Poll, Waker};
+use std::sync::{Arc, Mutex};
+use std::task::{Context, Poll, Wake, Waker};
 use std::{ptr, str};
 use wasmtime::{
-    AsContextMut, Func, Instance, Result, RootScope, StackCreator, StackMemory, Trap, Val,
+    AsContextMut, Func, Instance, Result, RootScope, StackCreator, StackMemory, Trap, Val, ValRaw,
 };
 
 use crate::{
@@ -76,12 +76,15 @@ impl Drop for wasmtime_async_continuation_t {
 }
 impl Future for wasmtime_async_continuation_t {
     type Output = ();
-    fn poll(self: Pin<&mut Self>, _cx: &mut Context) -> Poll<Self::Output> {
+    fn poll(self: Pin<&mut Self>, cx: &mut Context) -> Poll<Self::Output> {
         let this = self.get_mut();
         let cb = this.callback;
         if cb(this.env) {
             Poll::Ready(())
         } else {
+            // Continuations have no way to signal readiness, so ask to be
+            // polled again right away to keep waker-driven executors going.
+            cx.waker().wake_by_ref();
             Poll::Pending
         }
     }
@@ -189,9 +192,221 @@ unsafe fn c_async_callback_to_rust_fn(
     }
 }
 
-#[repr(transparent)]
+pub type wasmtime_func_async_completion_callback_t = extern "C" fn(
+    *mut c_void,
+    *mut wasmtime_caller_t,
+    *const wasmtime_val_t,
+    usize,
+    usize,
+    Box<wasmtime_async_completion_t>,
+);
+
+/// A handle given to a host function defined with
+/// `wasmtime_linker_define_async_completion_func` which is used to deliver its
+/// results, possibly from another thread.
+///
+/// Dropping this without completing it traps the suspended call, rather than
+/// leaving it suspended forever.
+pub struct wasmtime_async_completion_t {
+    /// `None` once the call has been completed.
+    state: Option<Arc<Mutex<CompletionState>>>,
+    nresults: usize,
+}
+
+#[derive(Default)]
+struct CompletionState {
+    result: Option<Result<Vec<wasmtime_val_t>, Box<wasm_trap_t>>>,
+    waker: Option<Waker>,
+}
+
+// The results are only converted back to `Val`s on the thread which owns the
+// store once the host call resumes.
+unsafe impl Send for CompletionState {}
+
+impl wasmtime_async_completion_t {
+    fn complete(mut self, result: Result<Vec<wasmtime_val_t>, Box<wasm_trap_t>>) {
+        self.finish(result);
+    }
+
+    fn finish(&mut self, result: Result<Vec<wasmtime_val_t>, Box<wasm_trap_t>>) {
+        let Some(state) = self.state.take() else {
+            return;
+        };
+        let waker = {
+            let mut state = state.lock().unwrap();
+            state.result = Some(result);
+            state.waker.take()
+        };
+        if let Some(waker) = waker {
+            waker.wake();
+        }
+    }
+}
+
+impl Drop for wasmtime_async_completion_t {
+    fn drop(&mut self) {
+        if self.state.is_some() {
+            self.finish(Err(Box::new(wasm_trap_t::new(anyhow::anyhow!(
+                "async host function dropped its completion without completing it"
+            )))));
+        }
+    }
+}
+
+/// Future which resolves once a `wasmtime_async_completion_t` is completed.
+struct Completion<'a>(&'a Mutex<CompletionState>);
+
+impl Future for Completion<'_> {
+    type Output = Result<Vec<wasmtime_val_t>, Box<wasm_trap_t>>;
+    fn poll(self: Pin<&mut Self>, cx: &mut Context) -> Poll<Self::Output> {
+        let mut state = self.0.lock().unwrap();
+        match state.result.take() {
+            Some(result) => Poll::Ready(result),
+            None => {
+                state.waker = Some(cx.waker().clone());
+                Poll::Pending
+            }
+        }
+    }
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_async_completion_complete(
+    completion: Box<wasmtime_async_completion_t>,
+    results: *const wasmtime_val_t,
+    nresults: usize,
+) {
+    let results = crate::slice_from_raw_parts(results, nresults);
+    let result = if results.len() == completion.nresults {
+        Ok(results.iter().map(|r| ptr::read(r)).collect())
+    } else {
+        Err(Box::new(wasm_trap_t::new(anyhow::anyhow!(
+            "async host function completed with {} results but {} were expected",
+            results.len(),
+            completion.nresults,
+        ))))
+    };
+    completion.complete(result);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_async_completion_trap(
+    completion: Box<wasmtime_async_completion_t>,
+    trap: Box<wasm_trap_t>,
+) {
+    completion.complete(Err(trap));
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_async_completion_delete(_completion: Box<wasmtime_async_completion_t>) {}
+
+async fn invoke_c_completion_callback<'a>(
+    cb: wasmtime_func_async_completion_callback_t,
+    data: CallbackDataPtr,
+    mut caller: WasmtimeCaller<'a>,
+    params: &'a [Val],
+    results: &'a mut [Val],
+) -> Result<()> {
+    // Unlike `invoke_c_async_callback` the results are delivered through the
+    // completion, so only the parameters need space here.
+    let mut hostcall_val_storage = mem::take(&mut caller.data_mut().hostcall_val_storage);
+    debug_assert!(hostcall_val_storage.is_empty());
+    hostcall_val_storage.extend(
+        params
+            .iter()
+            .cloned()
+            .map(|p| wasmtime_val_t::from_val_unscoped(&mut caller, p)),
+    );
+
+    let state = Arc::new(Mutex::new(CompletionState::default()));
+    let completion = Box::new(wasmtime_async_completion_t {
+        state: Some(state.clone()),
+        nresults: results.len(),
+    });
+    let mut caller = wasmtime_caller_t { caller };
+    cb(
+        data.ptr,
+        &mut caller,
+        hostcall_val_storage.as_ptr(),
+        hostcall_val_storage.len(),
+        results.len(),
+        completion,
+    );
+    hostcall_val_storage.truncate(0);
+    caller.caller.data_mut().hostcall_val_storage = hostcall_val_storage;
+
+    let vals = Completion(&state).await.map_err(|trap| trap.error)?;
+    for (result, val) in results.iter_mut().zip(&vals) {
+        *result = unsafe { val.to_val_unscoped(&mut caller.caller) };
+    }
+    Ok(())
+}
+
+unsafe fn c_completion_callback_to_rust_fn(
+    callback: wasmtime_func_async_completion_callback_t,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut std::ffi::c_void)>,
+) -> impl for<'a> Fn(
+    WasmtimeCaller<'a>,
+    &'a [Val],
+    &'a mut [Val],
+) -> Box<dyn Future<Output = Result<()>> + Send + 'a>
++ Send
++ Sync
++ 'static {
+    let foreign = crate::ForeignData { data, finalizer };
+    move |caller, params, results| {
+        let _ = &foreign; // move entire foreign into this closure
+        let data = CallbackDataPtr { ptr: foreign.data };
+        Box::new(invoke_c_completion_callback(
+            callback, data, caller, params, results,
+        ))
+    }
+}
+
+#[repr(C)]
+pub struct wasmtime_async_waker_t {
+    pub wake: extern "C" fn(*mut c_void),
+    pub env: *mut c_void,
+    pub finalizer: Option<extern "C" fn(*mut c_void)>,
+}
+
+/// A `Waker` which calls back into C.
+struct CWaker {
+    wake: extern "C" fn(*mut c_void),
+    foreign: crate::ForeignData,
+}
+
+impl Wake for CWaker {
+    fn wake(self: Arc<Self>) {
+        self.wake_by_ref()
+    }
+    fn wake_by_ref(self: &Arc<Self>) {
+        (self.wake)(self.foreign.data)
+    }
+}
+
 pub struct wasmtime_call_future_t<'a> {
     underlying: Pin<Box<dyn Future<Output = ()> + 'a>>,
+    /// The waker most recently passed to
+    /// `wasmtime_call_future_poll_with_waker`, reused while the same one is
+    /// passed in again.
+    waker: Option<RegisteredWaker>,
+}
+
+struct RegisteredWaker {
+    wake: extern "C" fn(*mut c_void),
+    env: *mut c_void,
+    waker: Waker,
+}
+
+impl<'a> wasmtime_call_future_t<'a> {
+    pub(crate) fn new(underlying: Pin<Box<dyn Future<Output = ()> + 'a>>) -> Box<Self> {
+        Box::new(wasmtime_call_future_t {
+            underlying,
+            waker: None,
+        })
+    }
 }
 
 #[unsafe(no_mangle)]
@@ -209,6 +424,38 @@ pub extern "C" fn wasmtime_call_future_poll(future: &mut wasmtime_call_future_t)
     }
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_call_future_poll_with_waker(
+    future: &mut wasmtime_call_future_t,
+    waker: &wasmtime_async_waker_t,
+) -> bool {
+    // Only take ownership of `env` if it's not the waker which is already
+    // registered, so that its finalizer runs once rather than once per poll.
+    let registered = match future.waker.take() {
+        Some(r) if r.wake as usize == waker.wake as usize && r.env == waker.env => r,
+        _ => RegisteredWaker {
+            wake: waker.wake,
+            env: waker.env,
+            waker: Waker::from(Arc::new(CWaker {
+                wake: waker.wake,
+                foreign: crate::ForeignData {
+                    data: waker.env,
+                    finalizer: waker.finalizer,
+                },
+            })),
+        },
+    };
+    let waker = &future.waker.insert(registered).waker;
+    match future
+        .underlying
+        .as_mut()
+        .poll(&mut Context::from_waker(waker))
+    {
+        Poll::Ready(()) => true,
+        Poll::Pending => false,
+    }
+}
+
 fn handle_call_error(
     err: wasmtime::Error,
     trap_ret: &mut *mut wasm_trap_t,
@@ -270,7 +517,40 @@ pub unsafe extern "C" fn wasmtime_func_call_async<'a>(
         trap_ret,
         err_ret,
     ));
-    Box::new(wasmtime_call_future_t { underlying: fut })
+    wasmtime_call_future_t::new(fut)
+}
+
+async fn do_func_call_async_unchecked(
+    store: WasmtimeStoreContextMut<'_>,
+    func: &Func,
+    args_and_results: *mut [ValRaw],
+    trap_ret: &mut *mut wasm_trap_t,
+    err_ret: &mut *mut wasmtime_error_t,
+) {
+    let result = unsafe { func.call_unchecked_async(store, args_and_results).await };
+    if let Err(err) = result {
+        handle_call_error(err, trap_ret, err_ret);
+    }
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_func_call_async_unchecked<'a>(
+    store: WasmtimeStoreContextMut<'a>,
+    func: &'a Func,
+    args_and_results: *mut ValRaw,
+    args_and_results_len: usize,
+    trap_ret: &'a mut *mut wasm_trap_t,
+    err_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let args_and_results = ptr::slice_from_raw_parts_mut(args_and_results, args_and_results_len);
+    let fut = Box::pin(do_func_call_async_unchecked(
+        store,
+        func,
+        args_and_results,
+        trap_ret,
+        err_ret,
+    ));
+    wasmtime_call_future_t::new(fut)
 }
 
 #[unsafe(no_mangle)]
@@ -296,6 +576,29 @@ pub unsafe extern "C" fn wasmtime_linker_define_async_func(
     )
 }
 
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_linker_define_async_completion_func(
+    linker: &mut wasmtime_linker_t,
+    module: *const u8,
+    module_len: usize,
+    name: *const u8,
+    name_len: usize,
+    ty: &wasm_functype_t,
+    callback: wasmtime_func_async_completion_callback_t,
+    data: *mut c_void,
+    finalizer: Option<extern "C" fn(*mut std::ffi::c_void)>,
+) -> Option<Box<wasmtime_error_t>> {
+    let ty = ty.ty().ty(linker.linker.engine());
+    let module = to_str!(module, module_len);
+    let name = to_str!(name, name_len);
+    let cb = c_completion_callback_to_rust_fn(callback, data, finalizer);
+
+    handle_result(
+        linker.linker.func_new_async(module, name, ty, cb),
+        |_linker| (),
+    )
+}
+
 async fn do_linker_instantiate_async(
     linker: &wasmtime_linker_t,
     store: WasmtimeStoreContextMut<'_>,
@@ -328,7 +631,7 @@ pub extern "C" fn wasmtime_linker_instantiate_async<'a>(
         trap_ret,
         err_ret,
     ));
-    Box::new(crate::wasmtime_call_future_t { underlying: fut })
+    crate::wasmtime_call_future_t::new(fut)
 }
 
 async fn do_instance_pre_instantiate_async(
@@ -360,7 +663,7 @@ pub extern "C" fn wasmtime_instance_pre_instantiate_async<'a>(
         trap_ret,
         err_ret,
     ));
-    Box::new(crate::wasmtime_call_future_t { underlying: fut })
+    crate::wasmtime_call_future_t::new(fut)
 }
 
 pub type wasmtime_stack_memory_get_callback_t =
@@ -0,0 +1,134 @@
+use wasmtime::component::{Func, Instance, Val};
+
+use crate::{WasmtimeStoreContextMut, wasmtime_call_future_t, wasmtime_error_t};
+
+use super::{
+    wasmtime_component_instance_pre_t, wasmtime_component_linker_t, wasmtime_component_t,
+    wasmtime_component_val_t,
+};
+
+fn handle_error(err: wasmtime::Error, err_ret: &mut *mut wasmtime_error_t) {
+    *err_ret = Box::into_raw(Box::new(wasmtime_error_t::from(err)));
+}
+
+async fn do_linker_instantiate_async(
+    linker: &wasmtime_component_linker_t,
+    store: WasmtimeStoreContextMut<'_>,
+    component: &wasmtime_component_t,
+    instance_out: &mut Instance,
+    err_ret: &mut *mut wasmtime_error_t,
+) {
+    let result = linker
+        .linker
+        .instantiate_async(store, &component.component)
+        .await;
+    match result {
+        Ok(instance) => *instance_out = instance,
+        Err(err) => handle_error(err, err_ret),
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_linker_instantiate_async<'a>(
+    linker: &'a wasmtime_component_linker_t,
+    store: WasmtimeStoreContextMut<'a>,
+    component: &'a wasmtime_component_t,
+    instance_out: &'a mut Instance,
+    err_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let fut = Box::pin(do_linker_instantiate_async(
+        linker,
+        store,
+        component,
+        instance_out,
+        err_ret,
+    ));
+    wasmtime_call_future_t::new(fut)
+}
+
+async fn do_instance_pre_instantiate_async(
+    instance_pre: &wasmtime_component_instance_pre_t,
+    store: WasmtimeStoreContextMut<'_>,
+    instance_out: &mut Instance,
+    err_ret: &mut *mut wasmtime_error_t,
+) {
+    let result = instance_pre.underlying.instantiate_async(store).await;
+    match result {
+        Ok(instance) => *instance_out = instance,
+        Err(err) => handle_error(err, err_ret),
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_instance_pre_instantiate_async<'a>(
+    instance_pre: &'a wasmtime_component_instance_pre_t,
+    store: WasmtimeStoreContextMut<'a>,
+    instance_out: &'a mut Instance,
+    err_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let fut = Box::pin(do_instance_pre_instantiate_async(
+        instance_pre,
+        store,
+        instance_out,
+        err_ret,
+    ));
+    wasmtime_call_future_t::new(fut)
+}
+
+async fn do_func_call_async(
+    func: &Func,
+    mut store: WasmtimeStoreContextMut<'_>,
+    args: Vec<Val>,
+    c_results: &mut [wasmtime_component_val_t],
+    err_ret: &mut *mut wasmtime_error_t,
+) {
+    let mut results = vec![Val::Bool(false); c_results.len()];
+    let result = func.call_async(&mut store, &args, &mut results).await;
+    match result {
+        Ok(()) => {
+            for (c_val, rust_val) in std::iter::zip(c_results, results) {
+                *c_val = wasmtime_component_val_t::from(&rust_val);
+            }
+        }
+        Err(err) => handle_error(err, err_ret),
+    }
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_func_call_async<'a>(
+    func: &'a Func,
+    context: WasmtimeStoreContextMut<'a>,
+    args: *const wasmtime_component_val_t,
+    args_len: usize,
+    results: *mut wasmtime_component_val_t,
+    results_len: usize,
+    err_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let args = crate::slice_from_raw_parts(args, args_len)
+        .iter()
+        .map(Val::from)
+        .collect::<Vec<_>>();
+    let results = crate::slice_from_raw_parts_mut(results, results_len);
+    let fut = Box::pin(do_func_call_async(func, context, args, results, err_ret));
+    wasmtime_call_future_t::new(fut)
+}
+
+async fn do_func_post_return_async(
+    func: &Func,
+    store: WasmtimeStoreContextMut<'_>,
+    err_ret: &mut *mut wasmtime_error_t,
+) {
+    if let Err(err) = func.post_return_async(store).await {
+        handle_error(err, err_ret);
+    }
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_func_post_return_async<'a>(
+    func: &'a Func,
+    context: WasmtimeStoreContextMut<'a>,
+    err_ret: &'a mut *mut wasmtime_error_t,
+) -> Box<wasmtime_call_future_t<'a>> {
+    let fut = Box::pin(do_func_post_return_async(func, context, err_ret));
+    wasmtime_call_future_t::new(fut)
+}
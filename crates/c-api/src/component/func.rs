@@ -1,6 +1,11 @@
+use std::ffi::c_void;
+
+use anyhow::{Result, anyhow, bail};
+use wasmtime::ValRaw;
+use wasmtime::component::__internal::{LiftContext, LowerContext};
 use wasmtime::component::{Func, Val};
 
-use crate::{WasmtimeStoreContextMut, wasmtime_error_t};
+use crate::{WasmtimeStoreContextMut, WasmtimeStoreData, wasmtime_error_t};
 
 use super::wasmtime_component_val_t;
 
@@ -28,6 +33,109 @@ pub unsafe extern "C" fn wasmtime_component_func_call(
     })
 }
 
+pub type wasmtime_component_lower_cx_t<'a> = LowerContext<'a, WasmtimeStoreData>;
+pub type wasmtime_component_lift_cx_t<'a> = LiftContext<'a>;
+
+pub type wasmtime_component_func_lower_callback_t = extern "C" fn(
+    *mut c_void,
+    &mut wasmtime_component_lower_cx_t<'_>,
+    *mut ValRaw,
+    usize,
+) -> Option<Box<wasmtime_error_t>>;
+
+pub type wasmtime_component_func_lift_callback_t = extern "C" fn(
+    *mut c_void,
+    &wasmtime_component_lift_cx_t<'_>,
+    *const ValRaw,
+    usize,
+) -> Option<Box<wasmtime_error_t>>;
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_func_call_flat(
+    func: &Func,
+    context: WasmtimeStoreContextMut<'_>,
+    lower: wasmtime_component_func_lower_callback_t,
+    lower_env: *mut c_void,
+    lift: wasmtime_component_func_lift_callback_t,
+    lift_env: *mut c_void,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = func.call_flat(
+        context,
+        |cx, params| match lower(lower_env, cx, params.as_mut_ptr(), params.len()) {
+            None => Ok(()),
+            Some(err) => Err((*err).into()),
+        },
+        |cx, results| match lift(lift_env, cx, results.as_ptr(), results.len()) {
+            None => Ok(()),
+            Some(err) => Err((*err).into()),
+        },
+    );
+    crate::handle_result(result, |()| {})
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_lower_cx_memory(
+    cx: &mut wasmtime_component_lower_cx_t<'_>,
+    data: &mut *mut u8,
+    len: &mut usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = if cx.options.has_memory() {
+        Ok(cx.as_slice_mut())
+    } else {
+        Err(anyhow!("function has no `memory` canonical option"))
+    };
+    crate::handle_result(result, |memory| {
+        *data = memory.as_mut_ptr();
+        *len = memory.len();
+    })
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_lower_cx_realloc(
+    cx: &mut wasmtime_component_lower_cx_t<'_>,
+    old_ptr: usize,
+    old_size: usize,
+    align: u32,
+    new_size: usize,
+    ret: &mut usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = lower_cx_realloc(cx, old_ptr, old_size, align, new_size);
+    crate::handle_result(result, |ptr| *ret = ptr)
+}
+
+fn lower_cx_realloc(
+    cx: &mut wasmtime_component_lower_cx_t<'_>,
+    old_ptr: usize,
+    old_size: usize,
+    align: u32,
+    new_size: usize,
+) -> Result<usize> {
+    if !cx.options.has_realloc() {
+        bail!("function has no `realloc` canonical option");
+    }
+    if !cx.options.has_memory() {
+        bail!("function has no `memory` canonical option");
+    }
+    cx.realloc(old_ptr, old_size, align, new_size)
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_component_lift_cx_memory(
+    cx: &wasmtime_component_lift_cx_t<'_>,
+    data: &mut *const u8,
+    len: &mut usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = if cx.options.has_memory() {
+        Ok(cx.memory())
+    } else {
+        Err(anyhow!("function has no `memory` canonical option"))
+    };
+    crate::handle_result(result, |memory| {
+        *data = memory.as_ptr();
+        *len = memory.len();
+    })
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_component_func_post_return(
     func: &Func,
@@ -1,8 +1,8 @@
-use wasmtime::component::{Func, Instance};
+use wasmtime::component::{Func, Instance, InstancePre};
 
-use crate::WasmtimeStoreContextMut;
+use crate::{WasmtimeStoreContextMut, WasmtimeStoreData, wasmtime_error_t};
 
-use super::wasmtime_component_export_index_t;
+use super::{wasmtime_component_export_index_t, wasmtime_component_t};
 
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_component_instance_get_export_index(
@@ -42,3 +42,32 @@ pub unsafe extern "C" fn wasmtime_component_instance_get_func(
         false
     }
 }
+
+pub struct wasmtime_component_instance_pre_t {
+    pub(crate) underlying: InstancePre<WasmtimeStoreData>,
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_instance_pre_delete(
+    _instance_pre: Box<wasmtime_component_instance_pre_t>,
+) {
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_instance_pre_instantiate(
+    instance_pre: &wasmtime_component_instance_pre_t,
+    context: WasmtimeStoreContextMut<'_>,
+    instance_out: &mut Instance,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = instance_pre.underlying.instantiate(context);
+    crate::handle_result(result, |instance| *instance_out = instance)
+}
+
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_instance_pre_component(
+    instance_pre: &wasmtime_component_instance_pre_t,
+) -> Box<wasmtime_component_t> {
+    Box::new(wasmtime_component_t {
+        component: instance_pre.underlying.component().clone(),
+    })
+}
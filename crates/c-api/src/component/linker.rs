@@ -6,7 +6,7 @@ use crate::{
     WasmtimeStoreContextMut, WasmtimeStoreData, wasm_engine_t, wasmtime_error_t, wasmtime_module_t,
 };
 
-use super::{wasmtime_component_t, wasmtime_component_val_t};
+use super::{wasmtime_component_instance_pre_t, wasmtime_component_t, wasmtime_component_val_t};
 
 #[repr(transparent)]
 pub struct wasmtime_component_linker_t {
@@ -47,6 +47,19 @@ pub unsafe extern "C" fn wasmtime_component_linker_instantiate(
     crate::handle_result(result, |instance| *instance_out = instance)
 }
 
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn wasmtime_component_linker_instantiate_pre(
+    linker: &wasmtime_component_linker_t,
+    component: &wasmtime_component_t,
+    instance_pre_out: &mut *mut wasmtime_component_instance_pre_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let result = linker.linker.instantiate_pre(&component.component);
+    crate::handle_result(result, |underlying| {
+        *instance_pre_out =
+            Box::into_raw(Box::new(wasmtime_component_instance_pre_t { underlying }));
+    })
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_component_linker_delete(
     _linker: Box<wasmtime_component_linker_t>,
@@ -1,9 +1,13 @@
+#[cfg(feature = "async")]
+mod r#async;
 mod component;
 mod func;
 mod instance;
 mod linker;
 mod val;
 
+#[cfg(feature = "async")]
+pub use r#async::*;
 pub use component::*;
 pub use func::*;
 pub use instance::*;
@@ -8,12 +8,15 @@ use std::ptr;
 use std::{ffi::CStr, sync::Arc};
 use wasmtime::{
     Config, InstanceAllocationStrategy, LinearMemory, MemoryCreator, OptLevel, ProfilingStrategy,
-    Result, Strategy,
+    Result, Strategy, WasmBacktraceDetails,
 };
 
 #[cfg(feature = "pooling-allocator")]
 use wasmtime::PoolingAllocationConfig;
 
+#[cfg(feature = "memory-protection-keys")]
+use wasmtime::MpkEnabled;
+
 #[repr(C)]
 #[derive(Clone)]
 pub struct wasm_config_t {
@@ -46,6 +49,15 @@ pub enum wasmtime_profiling_strategy_t {
     WASMTIME_PROFILING_STRATEGY_PERFMAP,
 }
 
+#[repr(u8)]
+#[derive(Clone)]
+#[cfg(feature = "memory-protection-keys")]
+pub enum wasmtime_mpk_enabled_t {
+    WASMTIME_MPK_ENABLED_AUTO,
+    WASMTIME_MPK_ENABLED_ENABLE,
+    WASMTIME_MPK_ENABLED_DISABLE,
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasm_config_new() -> Box<wasm_config_t> {
     Box::new(wasm_config_t {
@@ -263,6 +275,26 @@ pub extern "C" fn wasmtime_config_native_unwind_info_set(c: &mut wasm_config_t,
     c.config.native_unwind_info(enabled);
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_wasm_backtrace_set(c: &mut wasm_config_t, enabled: bool) {
+    c.config.wasm_backtrace(enabled);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_config_wasm_backtrace_details_set(c: &mut wasm_config_t, enabled: bool) {
+    c.config.wasm_backtrace_details(if enabled {
+        WasmBacktraceDetails::Enable
+    } else {
+        WasmBacktraceDetails::Disable
+    });
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "coredump")]
+pub extern "C" fn wasmtime_config_coredump_on_trap_set(c: &mut wasm_config_t, enabled: bool) {
+    c.config.coredump_on_trap(enabled);
+}
+
 #[unsafe(no_mangle)]
 pub unsafe extern "C" fn wasmtime_config_target_set(
     c: &mut wasm_config_t,
@@ -663,6 +695,35 @@ pub extern "C" fn wasmtime_pooling_allocation_config_total_gc_heaps_set(
     c.config.total_gc_heaps(count);
 }
 
+#[unsafe(no_mangle)]
+#[cfg(feature = "memory-protection-keys")]
+pub extern "C" fn wasmtime_pooling_allocation_config_memory_protection_keys_set(
+    c: &mut wasmtime_pooling_allocation_config_t,
+    enable: wasmtime_mpk_enabled_t,
+) {
+    use wasmtime_mpk_enabled_t::*;
+    c.config.memory_protection_keys(match enable {
+        WASMTIME_MPK_ENABLED_AUTO => MpkEnabled::Auto,
+        WASMTIME_MPK_ENABLED_ENABLE => MpkEnabled::Enable,
+        WASMTIME_MPK_ENABLED_DISABLE => MpkEnabled::Disable,
+    });
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "memory-protection-keys")]
+pub extern "C" fn wasmtime_pooling_allocation_config_max_memory_protection_keys_set(
+    c: &mut wasmtime_pooling_allocation_config_t,
+    max: usize,
+) {
+    c.config.max_memory_protection_keys(max);
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "memory-protection-keys")]
+pub extern "C" fn wasmtime_pooling_allocation_are_memory_protection_keys_available() -> bool {
+    PoolingAllocationConfig::are_memory_protection_keys_available()
+}
+
 #[unsafe(no_mangle)]
 #[cfg(feature = "pooling-allocator")]
 pub extern "C" fn wasmtime_pooling_allocation_strategy_set(
@@ -52,3 +52,33 @@ pub extern "C" fn wasmtime_engine_increment_epoch(engine: &wasm_engine_t) {
 pub extern "C" fn wasmtime_engine_is_pulley(engine: &wasm_engine_t) -> bool {
     engine.engine.is_pulley()
 }
+
+#[repr(C)]
+#[cfg(feature = "pooling-allocator")]
+pub struct wasmtime_pool_memory_stripe_t {
+    pub is_protected: bool,
+    pub total_slots: usize,
+    pub used_slots: usize,
+    pub stores: usize,
+}
+
+#[unsafe(no_mangle)]
+#[cfg(feature = "pooling-allocator")]
+pub unsafe extern "C" fn wasmtime_engine_pooling_memory_stripes(
+    engine: &wasm_engine_t,
+    stripes: *mut wasmtime_pool_memory_stripe_t,
+    len: usize,
+) -> usize {
+    let all = engine.engine.pooling_memory_stripes();
+    for (i, stripe) in all.iter().take(len).enumerate() {
+        unsafe {
+            stripes.add(i).write(wasmtime_pool_memory_stripe_t {
+                is_protected: stripe.protected,
+                total_slots: stripe.total_slots,
+                used_slots: stripe.used_slots,
+                stores: stripe.stores,
+            });
+        }
+    }
+    all.len()
+}
@@ -6,6 +6,8 @@ use crate::{
 use anyhow::Context;
 use std::ffi::CStr;
 use std::os::raw::c_char;
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+use wasmtime::{CallProfile, CodeBuilder, CompileReport, StreamingModuleBuilder};
 use wasmtime::{Engine, Module};
 
 #[derive(Clone)]
@@ -149,6 +151,183 @@ pub unsafe extern "C" fn wasmtime_module_new(
     )
 }
 
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub unsafe extern "C" fn wasmtime_module_new_with_call_profile(
+    engine: &wasm_engine_t,
+    wasm: *const u8,
+    len: usize,
+    profile: *const u8,
+    profile_len: usize,
+    out: &mut *mut wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let wasm = crate::slice_from_raw_parts(wasm, len);
+    let profile = crate::slice_from_raw_parts(profile, profile_len);
+    let result = CallProfile::from_bytes(profile).and_then(|profile| {
+        let mut builder = CodeBuilder::new(&engine.engine);
+        builder.wasm_binary(wasm, None)?.call_profile(&profile)?;
+        builder.compile_module()
+    });
+    handle_result(result, |module| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t { module }));
+    })
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub struct wasmtime_compile_report_t {
+    report: CompileReport,
+}
+
+#[repr(C)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub struct wasmtime_function_compile_report_t {
+    pub func_index: u32,
+    pub name: *const c_char,
+    pub name_len: usize,
+    pub wasm_size: usize,
+    pub ir_size: usize,
+    pub code_size: usize,
+    pub compile_time_nanos: u64,
+    pub regalloc_time_nanos: u64,
+    pub num_passes: usize,
+    pub cache_hit: bool,
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub unsafe extern "C" fn wasmtime_module_new_with_report(
+    engine: &wasm_engine_t,
+    wasm: *const u8,
+    len: usize,
+    out: &mut *mut wasmtime_module_t,
+    report_out: &mut *mut wasmtime_compile_report_t,
+) -> Option<Box<wasmtime_error_t>> {
+    let wasm = crate::slice_from_raw_parts(wasm, len);
+    let mut builder = CodeBuilder::new(&engine.engine);
+    let result = builder
+        .wasm_binary(wasm, None)
+        .and_then(|builder| builder.compile_module_with_report());
+    handle_result(result, |(module, report)| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t { module }));
+        *report_out = Box::into_raw(Box::new(wasmtime_compile_report_t { report }));
+    })
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_compile_report_delete(_report: Box<wasmtime_compile_report_t>) {}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_compile_report_module_cache_hit(
+    report: &wasmtime_compile_report_t,
+) -> bool {
+    report.report.module_cache_hit()
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_compile_report_functions_len(
+    report: &wasmtime_compile_report_t,
+) -> usize {
+    report.report.functions().len()
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_compile_report_function(
+    report: &wasmtime_compile_report_t,
+    index: usize,
+    out: &mut wasmtime_function_compile_report_t,
+) -> bool {
+    let Some(func) = report.report.functions().get(index) else {
+        return false;
+    };
+    *out = wasmtime_function_compile_report_t {
+        func_index: func.index(),
+        name: func.name().as_ptr().cast(),
+        name_len: func.name().len(),
+        wasm_size: func.wasm_size(),
+        ir_size: func.ir_size(),
+        code_size: func.code_size(),
+        compile_time_nanos: saturating_nanos(func.compile_time()),
+        regalloc_time_nanos: saturating_nanos(func.regalloc_time()),
+        num_passes: func.pass_times().len(),
+        cache_hit: func.cache_hit(),
+    };
+    true
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_compile_report_function_pass(
+    report: &wasmtime_compile_report_t,
+    func_index: usize,
+    pass_index: usize,
+    name: &mut *const c_char,
+    name_len: &mut usize,
+    time_nanos: &mut u64,
+) -> bool {
+    let Some((pass, time)) = report
+        .report
+        .functions()
+        .get(func_index)
+        .and_then(|f| f.pass_times().get(pass_index))
+    else {
+        return false;
+    };
+    *name = pass.as_ptr().cast();
+    *name_len = pass.len();
+    *time_nanos = saturating_nanos(*time);
+    true
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+fn saturating_nanos(duration: std::time::Duration) -> u64 {
+    u64::try_from(duration.as_nanos()).unwrap_or(u64::MAX)
+}
+
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub struct wasmtime_module_builder_t {
+    builder: StreamingModuleBuilder,
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_module_builder_new(
+    engine: &wasm_engine_t,
+) -> Box<wasmtime_module_builder_t> {
+    Box::new(wasmtime_module_builder_t {
+        builder: StreamingModuleBuilder::new(&engine.engine),
+    })
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub unsafe extern "C" fn wasmtime_module_builder_feed(
+    builder: &mut wasmtime_module_builder_t,
+    bytes: *const u8,
+    len: usize,
+) -> Option<Box<wasmtime_error_t>> {
+    let bytes = crate::slice_from_raw_parts(bytes, len);
+    handle_result(builder.builder.feed(bytes), |()| {})
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_module_builder_finish(
+    builder: Box<wasmtime_module_builder_t>,
+    out: &mut *mut wasmtime_module_t,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(builder.builder.finish(), |module| {
+        *out = Box::into_raw(Box::new(wasmtime_module_t { module }));
+    })
+}
+
+#[unsafe(no_mangle)]
+#[cfg(any(feature = "cranelift", feature = "winch"))]
+pub extern "C" fn wasmtime_module_builder_delete(_builder: Box<wasmtime_module_builder_t>) {}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_module_clone(module: &wasmtime_module_t) -> Box<wasmtime_module_t> {
     Box::new(module.clone())
@@ -1,8 +1,11 @@
-use crate::{wasm_byte_vec_t, wasm_name_t, wasmtime_error_t, wasmtime_module_t, wasmtime_store_t};
+use crate::{
+    handle_result, wasm_byte_vec_t, wasm_engine_t, wasm_name_t, wasmtime_error_t,
+    wasmtime_module_t, wasmtime_store_t,
+};
 use std::slice;
 use std::str::from_utf8;
 use std::time::Duration;
-use wasmtime::GuestProfiler;
+use wasmtime::{GuestProfiler, StackSampler};
 
 pub struct wasmtime_guestprofiler_t {
     guest_profiler: GuestProfiler,
@@ -51,6 +54,14 @@ pub extern "C" fn wasmtime_guestprofiler_sample(
         .sample(&store.store, Duration::from_nanos(delta_nanos));
 }
 
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_guestprofiler_call_profile(
+    guestprofiler: &wasmtime_guestprofiler_t,
+    out: &mut wasm_byte_vec_t,
+) {
+    out.set_buffer(guestprofiler.guest_profiler.call_profile().to_bytes());
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn wasmtime_guestprofiler_finish(
     guestprofiler: Box<wasmtime_guestprofiler_t>,
@@ -65,3 +76,59 @@ pub extern "C" fn wasmtime_guestprofiler_finish(
         Err(e) => Some(Box::new(e.into())),
     }
 }
+
+pub struct wasmtime_stack_sampler_t {
+    sampler: StackSampler,
+}
+
+wasmtime_c_api_macros::declare_own!(wasmtime_stack_sampler_t);
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_stack_sampler_new(
+    engine: &wasm_engine_t,
+    interval_nanos: u64,
+    out: &mut *mut wasmtime_stack_sampler_t,
+) -> Option<Box<wasmtime_error_t>> {
+    handle_result(
+        StackSampler::new(&engine.engine, Duration::from_nanos(interval_nanos)),
+        |sampler| {
+            *out = Box::into_raw(Box::new(wasmtime_stack_sampler_t { sampler }));
+        },
+    )
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_stack_sampler_attach(
+    sampler: &wasmtime_stack_sampler_t,
+    store: &mut wasmtime_store_t,
+    tag: &wasm_name_t,
+) {
+    let tag = from_utf8(tag.as_slice()).expect("not valid utf-8");
+    sampler.sampler.attach(&mut store.store, tag);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_stack_sampler_set_max_stacks(
+    sampler: &wasmtime_stack_sampler_t,
+    max: usize,
+) {
+    sampler.sampler.set_max_stacks(max);
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_stack_sampler_sample_count(sampler: &wasmtime_stack_sampler_t) -> u64 {
+    sampler.sampler.sample_count()
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_stack_sampler_folded(
+    sampler: &wasmtime_stack_sampler_t,
+    out: &mut wasm_byte_vec_t,
+) {
+    out.set_buffer(sampler.sampler.folded().into_bytes());
+}
+
+#[unsafe(no_mangle)]
+pub extern "C" fn wasmtime_stack_sampler_reset(sampler: &wasmtime_stack_sampler_t) {
+    sampler.sampler.reset();
+}
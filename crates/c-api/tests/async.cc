@@ -0,0 +1,304 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <wasmtime.h>
+#include <wasmtime.hh>
+
+namespace {
+
+struct Wakeup {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool woken = false;
+  size_t finalized = 0;
+
+  static void wake(void *env) {
+    auto *self = static_cast<Wakeup *>(env);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->woken = true;
+    self->cv.notify_all();
+  }
+
+  static void finalize(void *env) {
+    auto *self = static_cast<Wakeup *>(env);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->finalized++;
+    self->cv.notify_all();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return woken; });
+    woken = false;
+  }
+
+  // Waits for at least `n` finalizations, returning how many there were.
+  size_t wait_finalized(size_t n) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return finalized >= n; });
+    return finalized;
+  }
+};
+
+// Adds the two arguments on another thread.
+void add_on_thread(void *env, wasmtime_caller_t *caller,
+                   const wasmtime_val_t *args, size_t nargs, size_t nresults,
+                   wasmtime_async_completion_t *completion) {
+  EXPECT_EQ(nargs, 2);
+  EXPECT_EQ(nresults, 1);
+  int32_t a = args[0].of.i32;
+  int32_t b = args[1].of.i32;
+  std::thread([=] {
+    wasmtime_val_t result;
+    result.kind = WASMTIME_I32;
+    result.of.i32 = a + b;
+    wasmtime_async_completion_complete(completion, &result, 1);
+  }).detach();
+}
+
+void trap_on_thread(void *env, wasmtime_caller_t *caller,
+                    const wasmtime_val_t *args, size_t nargs, size_t nresults,
+                    wasmtime_async_completion_t *completion) {
+  std::thread([=] {
+    wasmtime_async_completion_trap(completion,
+                                   wasmtime_trap_new("boom", strlen("boom")));
+  }).detach();
+}
+
+void delete_on_thread(void *env, wasmtime_caller_t *caller,
+                      const wasmtime_val_t *args, size_t nargs,
+                      size_t nresults, wasmtime_async_completion_t *completion) {
+  std::thread([=] { wasmtime_async_completion_delete(completion); }).detach();
+}
+
+struct Fixture {
+  wasm_engine_t *engine;
+  wasmtime_store_t *store;
+  wasmtime_linker_t *linker;
+  wasmtime_module_t *module;
+  // Shared by every future polled by `call`, each of which finalizes it once.
+  Wakeup wakeup;
+  size_t futures = 0;
+
+  Fixture(wasmtime_func_async_completion_callback_t cb) {
+    wasm_config_t *config = wasm_config_new();
+    wasmtime_config_async_support_set(config, true);
+    engine = wasm_engine_new_with_config(config);
+    store = wasmtime_store_new(engine, nullptr, nullptr);
+    linker = wasmtime_linker_new(engine);
+
+    wasm_valtype_vec_t params, results;
+    wasm_valtype_t *ps[2] = {wasm_valtype_new_i32(), wasm_valtype_new_i32()};
+    wasm_valtype_t *rs[1] = {wasm_valtype_new_i32()};
+    wasm_valtype_vec_new(&params, 2, ps);
+    wasm_valtype_vec_new(&results, 1, rs);
+    wasm_functype_t *ty = wasm_functype_new(&params, &results);
+    wasmtime_error_t *error = wasmtime_linker_define_async_completion_func(
+        linker, "host", 4, "f", 1, ty, cb, nullptr, nullptr);
+    EXPECT_EQ(error, nullptr);
+    wasm_functype_delete(ty);
+
+    std::string_view wat = R"(
+      (module
+        (import "host" "f" (func $f (param i32 i32) (result i32)))
+        (func (export "run") (param i32 i32) (result i32)
+          (i32.add
+            (call $f (local.get 0) (local.get 1))
+            (i32.const 1))))
+    )";
+    wasm_byte_vec_t wasm;
+    error = wasmtime_wat2wasm(wat.data(), wat.size(), &wasm);
+    EXPECT_EQ(error, nullptr);
+    error = wasmtime_module_new(engine, (uint8_t *)wasm.data, wasm.size,
+                                &module);
+    EXPECT_EQ(error, nullptr);
+    wasm_byte_vec_delete(&wasm);
+  }
+
+  ~Fixture() {
+    // Host calls may still hold on to the waker after their future is gone.
+    wakeup.wait_finalized(futures);
+    wasmtime_module_delete(module);
+    wasmtime_linker_delete(linker);
+    wasmtime_store_delete(store);
+    wasm_engine_delete(engine);
+  }
+
+  // Calls `run` with the given arguments, sleeping until woken up rather
+  // than polling in a loop.
+  void call(int32_t a, int32_t b, wasmtime_val_t *result, wasm_trap_t **trap,
+            wasmtime_error_t **error) {
+    wasmtime_context_t *context = wasmtime_store_context(store);
+    wasmtime_async_waker_t waker = {Wakeup::wake, &wakeup, Wakeup::finalize};
+
+    wasmtime_instance_t instance;
+    wasmtime_call_future_t *future = wasmtime_linker_instantiate_async(
+        linker, context, module, &instance, trap, error);
+    futures++;
+    while (!wasmtime_call_future_poll_with_waker(future, &waker))
+      wakeup.wait();
+    wasmtime_call_future_delete(future);
+    ASSERT_EQ(*trap, nullptr);
+    ASSERT_EQ(*error, nullptr);
+
+    wasmtime_extern_t run;
+    ASSERT_TRUE(
+        wasmtime_instance_export_get(context, &instance, "run", 3, &run));
+    ASSERT_EQ(run.kind, WASMTIME_EXTERN_FUNC);
+
+    wasmtime_val_t args[2];
+    args[0].kind = WASMTIME_I32;
+    args[0].of.i32 = a;
+    args[1].kind = WASMTIME_I32;
+    args[1].of.i32 = b;
+    future = wasmtime_func_call_async(context, &run.of.func, args, 2, result,
+                                      1, trap, error);
+    futures++;
+    while (!wasmtime_call_future_poll_with_waker(future, &waker))
+      wakeup.wait();
+    wasmtime_call_future_delete(future);
+  }
+};
+
+} // namespace
+
+TEST(Async, CompletionFromAnotherThread) {
+  Fixture f(add_on_thread);
+  wasmtime_val_t result;
+  wasm_trap_t *trap = nullptr;
+  wasmtime_error_t *error = nullptr;
+  f.call(2, 3, &result, &trap, &error);
+  ASSERT_EQ(trap, nullptr);
+  ASSERT_EQ(error, nullptr);
+  EXPECT_EQ(result.kind, WASMTIME_I32);
+  EXPECT_EQ(result.of.i32, 6);
+}
+
+TEST(Async, CompletionTrap) {
+  Fixture f(trap_on_thread);
+  wasmtime_val_t result;
+  wasm_trap_t *trap = nullptr;
+  wasmtime_error_t *error = nullptr;
+  f.call(2, 3, &result, &trap, &error);
+  ASSERT_NE(trap, nullptr);
+  EXPECT_EQ(error, nullptr);
+  wasm_trap_delete(trap);
+}
+
+TEST(Async, CompletionDeleted) {
+  Fixture f(delete_on_thread);
+  wasmtime_val_t result;
+  wasm_trap_t *trap = nullptr;
+  wasmtime_error_t *error = nullptr;
+  f.call(2, 3, &result, &trap, &error);
+  ASSERT_NE(trap, nullptr);
+  EXPECT_EQ(error, nullptr);
+  wasm_trap_delete(trap);
+}
+
+TEST(Async, WakerFinalizedOncePerFuture) {
+  Fixture f(add_on_thread);
+  wasmtime_val_t result;
+  wasm_trap_t *trap = nullptr;
+  wasmtime_error_t *error = nullptr;
+  // The call future is polled at least twice, once before and once after the
+  // completion, but the same waker is passed every time.
+  f.call(2, 3, &result, &trap, &error);
+  ASSERT_EQ(trap, nullptr);
+  ASSERT_EQ(error, nullptr);
+  EXPECT_EQ(f.wakeup.wait_finalized(f.futures), f.futures);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(f.wakeup.wait_finalized(f.futures), f.futures);
+}
+
+#ifdef WASMTIME_HAS_COROUTINES
+
+namespace {
+
+using namespace wasmtime;
+
+// Sums the integers from 1 to its argument, consuming plenty of fuel.
+const char *sum_wat = R"(
+  (module
+    (func (export "run") (param i32) (result i32)
+      (local i32)
+      (loop $l
+        (local.set 1 (i32.add (local.get 1) (local.get 0)))
+        (local.set 0 (i32.sub (local.get 0) (i32.const 1)))
+        (br_if $l (local.get 0)))
+      (local.get 1)))
+)";
+
+Engine async_engine() {
+  Config config;
+  config.async_support(true);
+  config.consume_fuel(true);
+  return Engine(std::move(config));
+}
+
+// Instantiates `module` in a new store and calls its `run` export, yielding
+// back to the executor every 100 units of fuel.
+Task<void> run_sum(Engine *engine, Module *module, int32_t n,
+                   std::optional<TrapResult<int32_t>> *result) {
+  Store store(*engine);
+  store.context().set_fuel(1'000'000).unwrap();
+  EXPECT_EQ(wasmtime_context_fuel_async_yield_interval(
+                store.context().raw_context(), 100),
+            nullptr);
+  Linker linker(*engine);
+  auto instance = (co_await linker.instantiate_async(store, *module)).unwrap();
+  auto run = std::get<Func>(*instance.get(store, "run"));
+  auto typed = run.typed<int32_t, int32_t>(store).unwrap();
+  *result = co_await typed.call_async(store, n);
+}
+
+// Runs `run_sum` and then records that task `id` has finished.
+Task<void> run_sum_then_finish(Engine *engine, Module *module, int32_t n,
+                               std::optional<TrapResult<int32_t>> *result,
+                               int32_t id, std::vector<int32_t> *finished) {
+  co_await run_sum(engine, module, n, result);
+  finished->push_back(id);
+}
+
+} // namespace
+
+TEST(Async, CoroutineCalls) {
+  Engine engine = async_engine();
+  Module module = Module::compile(engine, sum_wat).unwrap();
+  SimpleExecutor executor;
+  std::vector<std::optional<TrapResult<int32_t>>> results(4);
+  std::vector<int32_t> finished;
+  // Earlier tasks have more work to do, so they only finish last if every
+  // fuel yield gives the other tasks a turn.
+  for (int32_t i = 0; i < 4; i++) {
+    executor.spawn(run_sum_then_finish(&engine, &module, 1000 * (4 - i),
+                                       &results[i], i, &finished));
+  }
+  executor.run();
+  for (int32_t i = 0; i < 4; i++) {
+    int32_t n = 1000 * (4 - i);
+    ASSERT_TRUE(results[i]);
+    EXPECT_EQ(results[i]->unwrap(), n * (n + 1) / 2);
+  }
+  EXPECT_EQ(finished, (std::vector<int32_t>{3, 2, 1, 0}));
+}
+
+TEST(Async, CoroutineOutOfFuel) {
+  Engine engine = async_engine();
+  Module module = Module::compile(engine, sum_wat).unwrap();
+  SimpleExecutor executor;
+  std::optional<TrapResult<int32_t>> result;
+  // Summing this many integers needs more fuel than the store is given.
+  executor.spawn(run_sum(&engine, &module, 1'000'000, &result));
+  executor.run();
+  ASSERT_TRUE(result);
+  EXPECT_FALSE(*result);
+}
+
+#endif // WASMTIME_HAS_COROUTINES
@@ -0,0 +1,246 @@
+#include "utils.h"
+
+#include <array>
+#include <gtest/gtest.h>
+#include <initializer_list>
+#include <wasmtime.h>
+
+namespace {
+
+static constexpr auto component_text = std::string_view{
+    R"END(
+(component
+    (core module $m
+        (global $post_returns (mut i32) (i32.const 0))
+        (func (export "add") (param $x i32) (param $y i32) (result i32)
+            (i32.add (local.get $x) (local.get $y))
+        )
+        (func (export "add-post-return") (param i32)
+            (global.set $post_returns
+                (i32.add (global.get $post_returns) (i32.const 1)))
+        )
+        (func (export "post-returns") (result i32)
+            (global.get $post_returns)
+        )
+        (func (export "sum") (param $n i32) (result i32)
+            (local $sum i32)
+            (block $done
+                (loop $loop
+                    (br_if $done (i32.eqz (local.get $n)))
+                    (local.set $sum (i32.add (local.get $sum) (local.get $n)))
+                    (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+                    (br $loop)
+                )
+            )
+            (local.get $sum)
+        )
+    )
+    (core instance $i (instantiate $m))
+    (func $add (param "x" u32) (param "y" u32) (result u32)
+        (canon lift (core func $i "add")
+            (post-return (func $i "add-post-return"))))
+    (func $post-returns (result u32) (canon lift (core func $i "post-returns")))
+    (func $sum (param "n" u32) (result u32) (canon lift (core func $i "sum")))
+    (export "add" (func $add))
+    (export "post-returns" (func $post-returns))
+    (export "sum" (func $sum))
+)
+      )END",
+};
+
+// Polls `future` until it completes and then deletes it, returning how many
+// times it was polled.
+int run(wasmtime_call_future_t *future) {
+  int polls = 1;
+  while (!wasmtime_call_future_poll(future))
+    polls++;
+  wasmtime_call_future_delete(future);
+  return polls;
+}
+
+struct Fixture {
+  wasm_engine_t *engine;
+  wasmtime_store_t *store;
+  wasmtime_context_t *context;
+  wasmtime_component_t *component = nullptr;
+  wasmtime_component_linker_t *linker;
+
+  Fixture() {
+    wasm_config_t *config = wasm_config_new();
+    wasmtime_config_async_support_set(config, true);
+    wasmtime_config_epoch_interruption_set(config, true);
+    engine = wasm_engine_new_with_config(config);
+    store = wasmtime_store_new(engine, nullptr, nullptr);
+    context = wasmtime_store_context(store);
+    wasmtime_context_set_epoch_deadline(context, 1);
+
+    auto err = wasmtime_component_new(
+        engine, reinterpret_cast<const uint8_t *>(component_text.data()),
+        component_text.size(), &component);
+    CHECK_ERR(err);
+
+    linker = wasmtime_component_linker_new(engine);
+  }
+
+  ~Fixture() {
+    wasmtime_component_linker_delete(linker);
+    wasmtime_component_delete(component);
+    wasmtime_store_delete(store);
+    wasm_engine_delete(engine);
+  }
+
+  wasmtime_component_func_t
+  get_func(const wasmtime_component_instance_t &instance,
+           std::string_view name) {
+    const auto index = wasmtime_component_get_export_index(
+        component, nullptr, name.data(), name.size());
+    EXPECT_NE(index, nullptr);
+    wasmtime_component_func_t func = {};
+    const auto found =
+        wasmtime_component_instance_get_func(&instance, context, index, &func);
+    EXPECT_TRUE(found);
+    wasmtime_component_export_index_delete(index);
+    return func;
+  }
+
+  // Calls `func` with `u32` arguments and then its post-return, returning its
+  // `u32` result. The number of polls the call took is stored in `polls`.
+  uint32_t call(const wasmtime_component_func_t &func,
+                std::initializer_list<uint32_t> args, int *polls = nullptr) {
+    std::array<wasmtime_component_val_t, 2> params = {};
+    size_t nparams = 0;
+    for (auto arg : args) {
+      params[nparams].kind = WASMTIME_COMPONENT_U32;
+      params[nparams].of.u32 = arg;
+      nparams++;
+    }
+    auto results = std::array<wasmtime_component_val_t, 1>{};
+
+    wasmtime_error_t *err = nullptr;
+    const auto n = run(wasmtime_component_func_call_async(
+        &func, context, params.data(), nparams, results.data(), results.size(),
+        &err));
+    CHECK_ERR(err);
+    if (polls)
+      *polls = n;
+
+    run(wasmtime_component_func_post_return_async(&func, context, &err));
+    CHECK_ERR(err);
+
+    EXPECT_EQ(results[0].kind, WASMTIME_COMPONENT_U32);
+    return results[0].of.u32;
+  }
+};
+
+} // namespace
+
+TEST(component_async, linker_instantiate_and_call) {
+  Fixture f;
+
+  wasmtime_component_instance_t instance = {};
+  wasmtime_error_t *err = nullptr;
+  run(wasmtime_component_linker_instantiate_async(
+      f.linker, f.context, f.component, &instance, &err));
+  CHECK_ERR(err);
+
+  const auto add = f.get_func(instance, "add");
+  const auto post_returns = f.get_func(instance, "post-returns");
+
+  EXPECT_EQ(f.call(post_returns, {}), 0);
+  EXPECT_EQ(f.call(add, {34, 35}), 69);
+  EXPECT_EQ(f.call(add, {1, 2}), 3);
+  EXPECT_EQ(f.call(post_returns, {}), 2);
+}
+
+TEST(component_async, instance_pre_instantiate) {
+  Fixture f;
+
+  wasmtime_component_instance_pre_t *instance_pre = nullptr;
+  auto err = wasmtime_component_linker_instantiate_pre(f.linker, f.component,
+                                                       &instance_pre);
+  CHECK_ERR(err);
+
+  for (uint32_t i = 0; i < 3; i++) {
+    wasmtime_component_instance_t instance = {};
+    run(wasmtime_component_instance_pre_instantiate_async(
+        instance_pre, f.context, &instance, &err));
+    CHECK_ERR(err);
+
+    // Each instance starts with its own state.
+    const auto add = f.get_func(instance, "add");
+    const auto post_returns = f.get_func(instance, "post-returns");
+    EXPECT_EQ(f.call(add, {i, i}), 2 * i);
+    EXPECT_EQ(f.call(post_returns, {}), 1);
+  }
+
+  wasmtime_component_instance_pre_delete(instance_pre);
+}
+
+TEST(component_async, instantiate_error) {
+  Fixture f;
+
+  // A component with an import that isn't defined in the linker.
+  static constexpr auto bytes = std::string_view{
+      R"END(
+      (component
+          (import "f" (func))
+      )
+      )END",
+  };
+  wasmtime_component_t *component = nullptr;
+  auto err = wasmtime_component_new(
+      f.engine, reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size(),
+      &component);
+  CHECK_ERR(err);
+
+  wasmtime_component_instance_t instance = {};
+  run(wasmtime_component_linker_instantiate_async(f.linker, f.context,
+                                                  component, &instance, &err));
+  EXPECT_NE(err, nullptr);
+  wasmtime_error_delete(err);
+
+  wasmtime_component_delete(component);
+}
+
+TEST(component_async, call_yields_on_epoch) {
+  Fixture f;
+
+  wasmtime_component_instance_t instance = {};
+  wasmtime_error_t *err = nullptr;
+  run(wasmtime_component_linker_instantiate_async(
+      f.linker, f.context, f.component, &instance, &err));
+  CHECK_ERR(err);
+  const auto sum = f.get_func(instance, "sum");
+
+  // Without the epoch advancing the call runs to completion in one poll.
+  int polls = 0;
+  EXPECT_EQ(f.call(sum, {100}, &polls), 5050);
+  EXPECT_EQ(polls, 1);
+
+  // Once the deadline has passed the guest yields back to the poller each
+  // time it checks the epoch, and keeps going when polled again.
+  err = wasmtime_context_epoch_deadline_async_yield_and_update(f.context, 1);
+  CHECK_ERR(err);
+  wasmtime_engine_increment_epoch(f.engine);
+
+  std::array<wasmtime_component_val_t, 1> params = {};
+  params[0].kind = WASMTIME_COMPONENT_U32;
+  params[0].of.u32 = 100;
+  auto results = std::array<wasmtime_component_val_t, 1>{};
+  const auto future = wasmtime_component_func_call_async(
+      &sum, f.context, params.data(), params.size(), results.data(),
+      results.size(), &err);
+  polls = 1;
+  while (!wasmtime_call_future_poll(future)) {
+    wasmtime_engine_increment_epoch(f.engine);
+    polls++;
+  }
+  wasmtime_call_future_delete(future);
+  CHECK_ERR(err);
+  EXPECT_GT(polls, 1);
+  EXPECT_EQ(results[0].kind, WASMTIME_COMPONENT_U32);
+  EXPECT_EQ(results[0].of.u32, 5050);
+
+  run(wasmtime_component_func_post_return_async(&sum, f.context, &err));
+  CHECK_ERR(err);
+}
@@ -1,8 +1,12 @@
 #include "utils.h"
 
 #include <array>
+#include <format>
 #include <gtest/gtest.h>
 #include <wasmtime.h>
+#include <wasmtime/component/func.hh>
+
+using namespace wasmtime::component;
 
 TEST(component, call_func) {
   static constexpr auto component_text = std::string_view{
@@ -76,9 +80,144 @@ TEST(component, call_func) {
   EXPECT_EQ(results[0].kind, WASMTIME_COMPONENT_U32);
   EXPECT_EQ(results[0].of.u32, 69);
 
+  uint32_t flat_result = 0;
+  err = wasmtime_component_func_call_flat(
+      &func, context,
+      [](void *, wasmtime_component_lower_cx_t *, wasmtime_val_raw_t *params,
+         size_t params_len) -> wasmtime_error_t * {
+        EXPECT_EQ(params_len, 2);
+        params[0].i32 = 34;
+        params[1].i32 = 35;
+        return nullptr;
+      },
+      nullptr,
+      [](void *env, const wasmtime_component_lift_cx_t *,
+         const wasmtime_val_raw_t *results,
+         size_t results_len) -> wasmtime_error_t * {
+        EXPECT_EQ(results_len, 1);
+        *static_cast<uint32_t *>(env) = results[0].i32;
+        return nullptr;
+      },
+      &flat_result);
+  CHECK_ERR(err);
+
+  err = wasmtime_component_func_post_return(&func, context);
+  CHECK_ERR(err);
+
+  EXPECT_EQ(flat_result, 69);
+
+  // This function has no `memory` option, so lowering into memory fails
+  // rather than aborting.
+  err = wasmtime_component_func_call_flat(
+      &func, context,
+      [](void *, wasmtime_component_lower_cx_t *cx, wasmtime_val_raw_t *,
+         size_t) -> wasmtime_error_t * {
+        uint8_t *data = nullptr;
+        size_t len = 0;
+        return wasmtime_component_lower_cx_memory(cx, &data, &len);
+      },
+      nullptr,
+      [](void *, const wasmtime_component_lift_cx_t *,
+         const wasmtime_val_raw_t *, size_t) -> wasmtime_error_t * {
+        return nullptr;
+      },
+      nullptr);
+  EXPECT_NE(err, nullptr);
+  wasmtime_error_delete(err);
+
   wasmtime_component_export_index_delete(f);
   wasmtime_component_linker_delete(linker);
 
   wasmtime_store_delete(store);
   wasm_engine_delete(engine);
 }
+
+static wasmtime_component_func_t instantiate(wasmtime::Engine &engine,
+                                             wasmtime::Store &store,
+                                             std::string_view text,
+                                             std::string_view name) {
+  const auto context = store.context().raw_context();
+  wasmtime_component_t *component = nullptr;
+  auto err = wasmtime_component_new(
+      engine.capi(), reinterpret_cast<const uint8_t *>(text.data()),
+      text.size(), &component);
+  CHECK_ERR(err);
+
+  const auto f = wasmtime_component_get_export_index(component, nullptr,
+                                                     name.data(), name.size());
+  EXPECT_NE(f, nullptr);
+
+  const auto linker = wasmtime_component_linker_new(engine.capi());
+  wasmtime_component_instance_t instance = {};
+  err = wasmtime_component_linker_instantiate(linker, context, component,
+                                              &instance);
+  CHECK_ERR(err);
+
+  wasmtime_component_func_t func = {};
+  EXPECT_TRUE(
+      wasmtime_component_instance_get_func(&instance, context, f, &func));
+
+  wasmtime_component_export_index_delete(f);
+  wasmtime_component_linker_delete(linker);
+  wasmtime_component_delete(component);
+  return func;
+}
+
+TEST(component, call_func_typed) {
+  wasmtime::Engine engine;
+  wasmtime::Store store(engine);
+  auto func = instantiate(engine, store, R"END(
+(component
+    (core module $m
+        (func (export "f") (param $x i32) (param $y i32) (result i32)
+            (i32.add (local.get $x) (local.get $y))
+        )
+    )
+    (core instance $i (instantiate $m))
+    (func $f (param "x" u32) (param "y" u32) (result u32) (canon lift (core func $i "f")))
+    (export "f" (func $f))
+)
+      )END",
+                          "f");
+
+  TypedFunc<std::tuple<uint32_t, uint32_t>, uint32_t> add(func);
+  EXPECT_EQ(add.call(store, {34, 35}).unwrap(), 69);
+  add.post_return(store).unwrap();
+
+  // Mismatched types are caught by the number of core wasm values.
+  TypedFunc<std::tuple<uint32_t>, uint32_t> wrong(func);
+  EXPECT_FALSE(wrong.call(store, {34}));
+}
+
+TEST(component, call_func_typed_strings) {
+  wasmtime::Engine engine;
+  wasmtime::Store store(engine);
+  auto text = std::format(R"END(
+(component
+    (core module $m
+        (memory (export "memory") 1)
+        {}
+        (func (export "echo") (param $ptr i32) (param $len i32) (result i32)
+            (i32.store (i32.const 0) (local.get $ptr))
+            (i32.store (i32.const 4) (local.get $len))
+            (i32.const 0)
+        )
+    )
+    (core instance $i (instantiate $m))
+    (func $echo (param "s" string) (result string)
+        (canon lift
+            (core func $i "echo")
+            (memory $i "memory")
+            (realloc (func $i "realloc"))))
+    (export "echo" (func $echo))
+)
+      )END",
+                          REALLOC_AND_FREE);
+  auto func = instantiate(engine, store, text, "echo");
+
+  TypedFunc<std::tuple<std::string_view>, std::string> echo(func);
+  for (std::string_view s : {"", "hello", "hello, world"}) {
+    EXPECT_EQ(echo.call(store, {s}).unwrap(), s);
+    echo.post_return(store).unwrap();
+  }
+}
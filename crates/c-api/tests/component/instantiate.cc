@@ -42,3 +42,53 @@ TEST(component, instantiate) {
   wasmtime_store_delete(store);
   wasm_engine_delete(engine);
 }
+
+TEST(component, instantiate_pre) {
+  static constexpr auto bytes = std::string_view{
+      R"END(
+      (component
+          (core module)
+      )
+      )END",
+  };
+
+  const auto engine = wasm_engine_new();
+  EXPECT_NE(engine, nullptr);
+
+  wasmtime_component_t *component = nullptr;
+  auto error = wasmtime_component_new(
+      engine, reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size(),
+      &component);
+  CHECK_ERR(error);
+
+  const auto linker = wasmtime_component_linker_new(engine);
+  EXPECT_NE(linker, nullptr);
+
+  wasmtime_component_instance_pre_t *instance_pre = nullptr;
+  error = wasmtime_component_linker_instantiate_pre(linker, component,
+                                                    &instance_pre);
+  CHECK_ERR(error);
+  EXPECT_NE(instance_pre, nullptr);
+
+  for (int i = 0; i < 3; i++) {
+    const auto store = wasmtime_store_new(engine, nullptr, nullptr);
+    const auto context = wasmtime_store_context(store);
+
+    wasmtime_component_instance_t instance = {};
+    error = wasmtime_component_instance_pre_instantiate(instance_pre, context,
+                                                        &instance);
+    CHECK_ERR(error);
+
+    wasmtime_store_delete(store);
+  }
+
+  const auto pre_component =
+      wasmtime_component_instance_pre_component(instance_pre);
+  EXPECT_NE(pre_component, nullptr);
+  wasmtime_component_delete(pre_component);
+
+  wasmtime_component_instance_pre_delete(instance_pre);
+  wasmtime_component_linker_delete(linker);
+  wasmtime_component_delete(component);
+  wasm_engine_delete(engine);
+}
@@ -69,6 +69,11 @@ TEST(Config, Smoke) {
   EXPECT_FALSE(config.cache_load("nonexistent"));
 
   PoolAllocationConfig pooling_config;
+#ifdef WASMTIME_FEATURE_MEMORY_PROTECTION_KEYS
+  pooling_config.memory_protection_keys(MpkEnabled::Auto);
+  pooling_config.max_memory_protection_keys(4);
+  PoolAllocationConfig::are_memory_protection_keys_available();
+#endif
   config.pooling_allocation_strategy(pooling_config);
 
   Config config2 = std::move(config);
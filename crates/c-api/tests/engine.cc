@@ -13,3 +13,23 @@ TEST(Engine, Simple) {
   engine2 = Engine();
   engine.is_pulley();
 }
+
+#ifdef WASMTIME_FEATURE_POOLING_ALLOCATOR
+TEST(Engine, PoolingMemoryStripes) {
+  EXPECT_TRUE(Engine().pooling_memory_stripes().empty());
+
+  PoolAllocationConfig pooling;
+  pooling.total_memories(10);
+  pooling.max_memory_size(1 << 16);
+  Config config;
+  config.pooling_allocation_strategy(pooling);
+  Engine engine(std::move(config));
+
+  auto stripes = engine.pooling_memory_stripes();
+  ASSERT_EQ(stripes.size(), 1);
+  EXPECT_FALSE(stripes[0].is_protected);
+  EXPECT_EQ(stripes[0].total_slots, 10);
+  EXPECT_EQ(stripes[0].used_slots, 0);
+  EXPECT_EQ(stripes[0].stores, 0);
+}
+#endif
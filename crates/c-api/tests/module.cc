@@ -1,5 +1,6 @@
 #include <wasmtime/module.hh>
 
+#include <algorithm>
 #include <gtest/gtest.h>
 
 using namespace wasmtime;
@@ -14,3 +15,41 @@ TEST(Module, Simple) {
   auto serialized = m.serialize().unwrap();
   Module::deserialize(engine, serialized).unwrap();
 }
+
+TEST(Module, Streaming) {
+  auto wasm = wat2wasm(R"(
+    (module
+      (func (export "f") (result i32) i32.const 1))
+  )")
+                  .unwrap();
+
+  wasm_engine_t *engine = wasm_engine_new();
+  wasmtime_module_builder_t *builder = wasmtime_module_builder_new(engine);
+  for (size_t i = 0; i < wasm.size(); i += 3) {
+    size_t len = std::min<size_t>(3, wasm.size() - i);
+    wasmtime_error_t *error =
+        wasmtime_module_builder_feed(builder, wasm.data() + i, len);
+    ASSERT_EQ(error, nullptr);
+  }
+  wasmtime_module_t *module = nullptr;
+  wasmtime_error_t *error = wasmtime_module_builder_finish(builder, &module);
+  ASSERT_EQ(error, nullptr);
+  ASSERT_NE(module, nullptr);
+  wasmtime_module_delete(module);
+
+  // A truncated binary fails to compile.
+  builder = wasmtime_module_builder_new(engine);
+  error = wasmtime_module_builder_feed(builder, wasm.data(), wasm.size() - 1);
+  ASSERT_EQ(error, nullptr);
+  error = wasmtime_module_builder_finish(builder, &module);
+  ASSERT_NE(error, nullptr);
+  wasmtime_error_delete(error);
+
+  // A builder can be deleted before the whole binary has arrived.
+  builder = wasmtime_module_builder_new(engine);
+  error = wasmtime_module_builder_feed(builder, wasm.data(), wasm.size() / 2);
+  ASSERT_EQ(error, nullptr);
+  wasmtime_module_builder_delete(builder);
+
+  wasm_engine_delete(engine);
+}
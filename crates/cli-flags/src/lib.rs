@@ -240,6 +240,9 @@ wasmtime_option_group! {
         /// Whether to perform function inlining during compilation.
         pub inlining: Option<bool>,
 
+        /// Whether Winch applies peephole optimizations to generated code.
+        pub winch_peephole: Option<bool>,
+
         #[prefixed = "cranelift"]
         #[serde(default)]
         /// Set a cranelift-specific option. Use `wasmtime settings` to see
@@ -287,6 +290,10 @@ wasmtime_option_group! {
         /// units, as any execution cost associated with them involves other
         /// instructions which do consume fuel.
         pub fuel: Option<u64>,
+        /// Charge fuel approximately, up front when entering each branch-free
+        /// region of code, rather than exactly before every branch, which is
+        /// cheaper at runtime.
+        pub approximate_fuel: Option<bool>,
         /// Yield when a global epoch counter changes, allowing for async
         /// operation without blocking the executor.
         pub epoch_interruption: Option<bool>,
@@ -806,6 +813,9 @@ impl CommonOptions {
         if self.wasm.fuel.is_some() {
             config.consume_fuel(true);
         }
+        if let Some(enable) = self.wasm.approximate_fuel {
+            config.approximate_fuel(enable);
+        }
 
         if let Some(enable) = self.wasm.epoch_interruption {
             config.epoch_interruption(enable);
@@ -828,6 +838,9 @@ impl CommonOptions {
         if let Some(enable) = self.codegen.inlining {
             config.compiler_inlining(enable);
         }
+        if let Some(enable) = self.codegen.winch_peephole {
+            config.winch_peephole(enable);
+        }
 
         // async_stack_size enabled by either async or stack-switching, so
         // cannot directly use match_feature!
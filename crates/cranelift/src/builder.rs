@@ -81,6 +81,15 @@ impl CompilerBuilder for Builder {
             "wasmtime_inlining_sum_size_threshold" => {
                 self.tunables.as_mut().unwrap().inlining_sum_size_threshold = value.parse()?;
             }
+            "wasmtime_inlining_hot_callee_size" => {
+                self.tunables.as_mut().unwrap().inlining_hot_callee_size = value.parse()?;
+            }
+            "wasmtime_inlining_hot_sum_size_threshold" => {
+                self.tunables
+                    .as_mut()
+                    .unwrap()
+                    .inlining_hot_sum_size_threshold = value.parse()?;
+            }
             _ => {
                 self.inner.set(name, value)?;
             }
@@ -14,7 +14,7 @@ use cranelift_codegen::isa::{
     unwind::{UnwindInfo, UnwindInfoKind},
 };
 use cranelift_codegen::print_errors::pretty_error;
-use cranelift_codegen::{CompiledCode, Context};
+use cranelift_codegen::{CompiledCode, Context, timing};
 use cranelift_entity::PrimaryMap;
 use cranelift_frontend::FunctionBuilder;
 use object::write::{Object, StandardSegment, SymbolId};
@@ -30,8 +30,8 @@ use std::sync::{Arc, Mutex};
 use wasmparser::{FuncValidatorAllocations, FunctionBody};
 use wasmtime_environ::{
     AddressMapSection, BuiltinFunctionIndex, CacheStore, CompileError, CompiledFunctionBody,
-    DefinedFuncIndex, FlagValue, FuncKey, FunctionBodyData, FunctionLoc, HostCall,
-    InliningCompiler, ModuleTranslation, ModuleTypesBuilder, PtrSize, StackMapSection,
+    DefinedFuncIndex, FlagValue, FuncKey, FunctionBodyData, FunctionCompileStats, FunctionLoc,
+    HostCall, InliningCompiler, ModuleTranslation, ModuleTypesBuilder, PtrSize, StackMapSection,
     StaticModuleIndex, TrapEncodingBuilder, TrapSentinel, TripleExt, Tunables, VMOffsets,
     WasmFuncType, WasmValType,
 };
@@ -338,9 +338,21 @@ impl wasmtime_environ::Compiler for Compiler {
         log::debug!("`{symbol}` translated to CLIF in {:?}", timing.total());
         log::trace!("`{symbol}` timing info\n{timing}");
 
+        let func = &compiler.cx.codegen_context.func;
+        let mut stats = FunctionCompileStats {
+            ir_size: func
+                .layout
+                .blocks()
+                .map(|block| func.layout.block_insts(block).count())
+                .sum(),
+            ..Default::default()
+        };
+        record_pass_times(&mut stats, &timing);
+
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: func_env.needs_gc_heap(),
+            stats,
         })
     }
 
@@ -426,6 +438,7 @@ impl wasmtime_environ::Compiler for Compiler {
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: false,
+            stats: Default::default(),
         })
     }
 
@@ -503,6 +516,7 @@ impl wasmtime_environ::Compiler for Compiler {
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: false,
+            stats: Default::default(),
         })
     }
 
@@ -746,6 +760,7 @@ impl wasmtime_environ::Compiler for Compiler {
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiler_context(Some(compiler.cx)),
             needs_gc_heap: false,
+            stats: Default::default(),
         })
     }
 
@@ -879,15 +894,17 @@ impl InliningCompiler for Compiler {
             Some(Abi::Array) => Cow::Owned(format!("{symbol}_array_call")),
         };
 
+        let stats = &mut func_body.stats;
         let compiled_func = if let Some(input) = input {
-            compiler.finish_with_info(Some((&input, &self.tunables)), &symbol)?
+            compiler.finish_with_info(Some((&input, &self.tunables)), &symbol, stats)?
         } else {
-            compiler.finish(&symbol)?
+            compiler.finish(&symbol, stats)?
         };
 
         let timing = cranelift_codegen::timing::take_current();
         log::debug!("`{symbol}` compiled in {:?}", timing.total());
         log::trace!("`{symbol}` timing info\n{timing}");
+        record_pass_times(stats, &timing);
 
         func_body.code = box_dyn_any_compiled_function(compiled_func);
         Ok(())
@@ -913,10 +930,10 @@ mod incremental_cache {
         context: &'a mut Context,
         isa: &dyn TargetIsa,
         cache_ctx: Option<&mut IncrementalCacheContext>,
-    ) -> Result<CompiledCode, CompileError> {
+    ) -> Result<(CompiledCode, bool), CompileError> {
         let cache_ctx = match cache_ctx {
             Some(ctx) => ctx,
-            None => return compile_uncached(context, isa),
+            None => return Ok((compile_uncached(context, isa)?, false)),
         };
 
         let mut cache_store = CraneliftCacheStore(cache_ctx.cache_store.clone());
@@ -930,20 +947,34 @@ mod incremental_cache {
             cache_ctx.num_cached += 1;
         }
 
-        Ok(context.take_compiled_code().unwrap())
+        Ok((context.take_compiled_code().unwrap(), from_cache))
     }
 }
 
 #[cfg(feature = "incremental-cache")]
 use incremental_cache::*;
 
+/// Compiles the function in `context`, returning its code and whether that
+/// code was loaded from the incremental compilation cache.
 #[cfg(not(feature = "incremental-cache"))]
 fn compile_maybe_cached<'a>(
     context: &'a mut Context,
     isa: &dyn TargetIsa,
     _cache_ctx: Option<&mut IncrementalCacheContext>,
-) -> Result<CompiledCode, CompileError> {
-    compile_uncached(context, isa)
+) -> Result<(CompiledCode, bool), CompileError> {
+    Ok((compile_uncached(context, isa)?, false))
+}
+
+/// Accumulates the pass timings in `times` into `stats`.
+fn record_pass_times(stats: &mut FunctionCompileStats, times: &timing::PassTimes) {
+    for (pass, time) in times.self_times() {
+        let desc = pass.description();
+        match stats.pass_times.iter_mut().find(|(d, _)| *d == desc) {
+            Some((_, total)) => *total += time,
+            None => stats.pass_times.push((desc, time)),
+        }
+    }
+    stats.regalloc_time += times.get(timing::Pass::regalloc);
 }
 
 fn compile_uncached<'a>(
@@ -1198,14 +1229,19 @@ impl FunctionCompiler<'_> {
         (builder, block0)
     }
 
-    fn finish(self, symbol: &str) -> Result<CompiledFunction, CompileError> {
-        self.finish_with_info(None, symbol)
+    fn finish(
+        self,
+        symbol: &str,
+        stats: &mut FunctionCompileStats,
+    ) -> Result<CompiledFunction, CompileError> {
+        self.finish_with_info(None, symbol, stats)
     }
 
     fn finish_with_info(
         mut self,
         body_and_tunables: Option<(&FunctionBody<'_>, &Tunables)>,
         symbol: &str,
+        stats: &mut FunctionCompileStats,
     ) -> Result<CompiledFunction, CompileError> {
         let context = &mut self.cx.codegen_context;
         let isa = &*self.compiler.isa;
@@ -1233,7 +1269,9 @@ impl FunctionCompiler<'_> {
             write!(output, "{}", context.func.display()).unwrap();
         }
 
-        let compiled_code = compilation_result?;
+        let (compiled_code, from_cache) = compilation_result?;
+        stats.code_size = compiled_code.buffer.data().len();
+        stats.cache_hit = from_cache;
 
         // Give wasm functions, user defined code, a "preferred" alignment
         // instead of the minimum alignment as this can help perf in niche
@@ -20,7 +20,7 @@ use cranelift_frontend::Variable;
 use cranelift_frontend::{FuncInstBuilder, FunctionBuilder};
 use smallvec::SmallVec;
 use std::mem;
-use wasmparser::{Operator, WasmFeatures};
+use wasmparser::{BinaryReader, Operator, OperatorsReader, WasmFeatures};
 use wasmtime_environ::{
     BuiltinFunctionIndex, DataIndex, DefinedFuncIndex, ElemIndex, EngineOrModuleTypeIndex,
     FuncIndex, FuncKey, GlobalIndex, IndexType, Memory, MemoryIndex, Module,
@@ -163,6 +163,16 @@ pub struct FuncEnvironment<'module_environment> {
 
     fuel_consumed: i64,
 
+    /// With approximate fuel, the static cost of each fuel region of the
+    /// function being translated. Index 0 is the code run on function entry
+    /// and index `i` is the code following the `i`-th operator which starts a
+    /// region, see `fuel_starts_region`.
+    fuel_region_costs: Vec<i64>,
+
+    /// With approximate fuel, the index in `fuel_region_costs` of the most
+    /// recently encountered region.
+    fuel_region: usize,
+
     /// A `GlobalValue` in CLIF which represents the stack limit.
     ///
     /// Typically this resides in the `stack_limit` value of `ir::Function` but
@@ -220,6 +230,8 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
             // Start with at least one fuel being consumed because even empty
             // functions should consume at least some fuel.
             fuel_consumed: 1,
+            fuel_region_costs: Vec::new(),
+            fuel_region: 0,
 
             translation,
 
@@ -341,9 +353,58 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         debug_assert!(self.fuel_var.is_reserved_value());
         self.fuel_var = builder.declare_var(ir::types::I64);
         self.fuel_load_into_var(builder);
+        if self.tunables.approximate_fuel {
+            self.fuel_consumed += self.fuel_region_costs[0];
+        }
         self.fuel_check(builder);
     }
 
+    /// Computes `self.fuel_region_costs` for the function body in `body`,
+    /// used when fuel is approximate.
+    ///
+    /// A region is the code following the function entry or an operator
+    /// for which `fuel_starts_region` returns true, up to the next such
+    /// operator. Control only enters a region at its start and only leaves it
+    /// early through an unconditional branch, a trap or a call which doesn't
+    /// return, and code after an unconditional branch isn't charged since it
+    /// is unreachable. Charging each region's cost when it's entered thus
+    /// charges exactly the operators executed, apart from the remainder of a
+    /// region that traps, while the fuel counter is updated once per region
+    /// rather than once per branch.
+    fn fuel_compute_regions(&mut self, body: &BinaryReader<'_>) -> WasmResult<()> {
+        self.fuel_region_costs.clear();
+        self.fuel_region_costs.push(0);
+        self.fuel_region = 0;
+
+        let mut reachable = true;
+        let mut reader = OperatorsReader::new(body.clone());
+        while !reader.eof() {
+            let op = reader.read()?;
+            if reachable {
+                *self.fuel_region_costs.last_mut().unwrap() += fuel_cost(&op);
+            }
+            if fuel_starts_region(&op) {
+                self.fuel_region_costs.push(0);
+                reachable = true;
+                continue;
+            }
+            match op {
+                Operator::Unreachable
+                | Operator::Br { .. }
+                | Operator::BrTable { .. }
+                | Operator::Return
+                | Operator::ReturnCall { .. }
+                | Operator::ReturnCallIndirect { .. }
+                | Operator::ReturnCallRef { .. }
+                | Operator::Throw { .. }
+                | Operator::ThrowRef
+                | Operator::Rethrow { .. } => reachable = false,
+                _ => {}
+            }
+        }
+        Ok(())
+    }
+
     fn fuel_function_exit(&mut self, builder: &mut FunctionBuilder<'_>) {
         // On exiting the function we need to be sure to save the fuel we have
         // cached locally in `self.fuel_var` back into the Store-defined
@@ -357,6 +418,32 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
         builder: &mut FunctionBuilder<'_>,
         reachable: bool,
     ) {
+        if self.tunables.approximate_fuel {
+            // Regions are numbered in the order they appear, including
+            // unreachable ones, to find their cost in `fuel_region_costs`.
+            if fuel_starts_region(op) {
+                self.fuel_region += 1;
+            }
+            if !reachable {
+                return;
+            }
+
+            // All costs are charged when entering a region, so the only thing
+            // to do is to save the fuel counter before control leaves this
+            // function.
+            match op {
+                Operator::Unreachable
+                | Operator::Return
+                | Operator::CallIndirect { .. }
+                | Operator::Call { .. }
+                | Operator::ReturnCall { .. }
+                | Operator::ReturnCallRef { .. }
+                | Operator::ReturnCallIndirect { .. } => self.fuel_save_from_var(builder),
+                _ => {}
+            }
+            return;
+        }
+
         if !reachable {
             // In unreachable code we shouldn't have any leftover fuel we
             // haven't accounted for since the reason for us to become
@@ -365,23 +452,7 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
             return;
         }
 
-        self.fuel_consumed += match op {
-            // Nop and drop generate no code, so don't consume fuel for them.
-            Operator::Nop | Operator::Drop => 0,
-
-            // Control flow may create branches, but is generally cheap and
-            // free, so don't consume fuel. Note the lack of `if` since some
-            // cost is incurred with the conditional check.
-            Operator::Block { .. }
-            | Operator::Loop { .. }
-            | Operator::Unreachable
-            | Operator::Return
-            | Operator::Else
-            | Operator::End => 0,
-
-            // everything else, just call it one operation.
-            _ => 1,
-        };
+        self.fuel_consumed += fuel_cost(op);
 
         match op {
             // Exiting a function (via a return or unreachable) or otherwise
@@ -462,6 +533,17 @@ impl<'module_environment> FuncEnvironment<'module_environment> {
             }
             _ => {}
         }
+
+        // With approximate fuel, charge the region which starts here now that
+        // the translator has switched to its block. Loop bodies are instead
+        // charged in `translate_loop_header` along with the fuel check.
+        if self.tunables.approximate_fuel
+            && fuel_starts_region(op)
+            && !matches!(op, Operator::Loop { .. })
+        {
+            self.fuel_consumed += self.fuel_region_costs[self.fuel_region];
+            self.fuel_increment_var(builder);
+        }
     }
 
     /// Adds `self.fuel_consumed` to the `fuel_var`, zero-ing out the amount of
@@ -3299,6 +3381,9 @@ impl FuncEnvironment<'_> {
         // Additionally if enabled check how much fuel we have remaining to see
         // if we've run out by this point.
         if self.tunables.consume_fuel {
+            if self.tunables.approximate_fuel {
+                self.fuel_consumed += self.fuel_region_costs[self.fuel_region];
+            }
             self.fuel_check(builder);
         }
 
@@ -3348,6 +3433,7 @@ impl FuncEnvironment<'_> {
         &mut self,
         builder: &mut FunctionBuilder,
         _state: &FuncTranslationStacks,
+        body: &BinaryReader<'_>,
     ) -> WasmResult<()> {
         // If an explicit stack limit is requested, emit one here at the start
         // of the function.
@@ -3360,6 +3446,9 @@ impl FuncEnvironment<'_> {
 
         // Additionally we initialize `fuel_var` if it will get used.
         if self.tunables.consume_fuel {
+            if self.tunables.approximate_fuel {
+                self.fuel_compute_regions(body)?;
+            }
             self.fuel_function_entry(builder);
         }
 
@@ -3976,6 +4065,49 @@ impl FuncEnvironment<'_> {
     }
 }
 
+/// Returns the amount of fuel consumed by executing `op`.
+fn fuel_cost(op: &Operator<'_>) -> i64 {
+    match op {
+        // Nop and drop generate no code, so don't consume fuel for them.
+        Operator::Nop | Operator::Drop => 0,
+
+        // Control flow may create branches, but is generally cheap and
+        // free, so don't consume fuel. Note the lack of `if` since some
+        // cost is incurred with the conditional check.
+        Operator::Block { .. }
+        | Operator::Loop { .. }
+        | Operator::Unreachable
+        | Operator::Return
+        | Operator::Else
+        | Operator::End => 0,
+
+        // everything else, just call it one operation.
+        _ => 1,
+    }
+}
+
+/// Whether `op` ends the current fuel region, with the code following it
+/// starting a new one, when fuel is approximate.
+///
+/// These are the operators after which the translator continues in a new
+/// block that may be entered without running the code before the operator:
+/// loop headers, `if` and `else` arms, the continuation of a control frame
+/// and the fallthrough of a conditional branch.
+fn fuel_starts_region(op: &Operator<'_>) -> bool {
+    matches!(
+        op,
+        Operator::Loop { .. }
+            | Operator::If { .. }
+            | Operator::Else
+            | Operator::End
+            | Operator::BrIf { .. }
+            | Operator::BrOnNull { .. }
+            | Operator::BrOnNonNull { .. }
+            | Operator::BrOnCast { .. }
+            | Operator::BrOnCastFail { .. }
+    )
+}
+
 // Helper function to convert an `IndexType` to an `ir::Type`.
 //
 // Implementing From/Into trait for `IndexType` or `ir::Type` would
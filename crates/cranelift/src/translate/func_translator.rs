@@ -240,7 +240,7 @@ fn parse_function_body(
     // The control stack is initialized with a single block representing the whole function.
     debug_assert_eq!(stack.control_stack.len(), 1, "State not initialized");
 
-    environ.before_translate_function(builder, stack)?;
+    environ.before_translate_function(builder, stack, &reader)?;
 
     let mut reader = OperatorsReader::new(reader);
     let mut operand_types = vec![];
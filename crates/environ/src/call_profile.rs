@@ -0,0 +1,188 @@
+//! Runtime call-edge profiles used to guide compilation.
+//!
+//! A [`CallProfile`] records how often each Wasm function was observed on the
+//! stack and how often each caller-to-callee edge between Wasm functions was
+//! observed. Profiles are typically collected in production through
+//! `wasmtime::GuestProfiler`, persisted with [`CallProfile::to_bytes`], and
+//! later fed back into compilation where the inliner uses them to prefer hot
+//! call sites.
+
+use crate::prelude::*;
+use crate::{DefinedFuncIndex, StaticModuleIndex};
+use alloc::collections::BTreeMap;
+use anyhow::{Result, anyhow};
+use serde_derive::{Deserialize, Serialize};
+
+/// A Wasm function identified by its static module and defined function
+/// index, the same way compilation identifies Wasm functions.
+pub type ProfiledFunc = (StaticModuleIndex, DefinedFuncIndex);
+
+/// Sampled call-edge and function hotness counts for a module or component.
+///
+/// Counts are in units of samples. An edge is considered "hot" when it shows
+/// up in at least [`CallProfile::HOT_EDGE_PERCENT`] percent of all recorded
+/// samples.
+#[derive(Clone, Debug, Default, PartialEq, Eq, Hash, Serialize, Deserialize)]
+pub struct CallProfile {
+    total_samples: u64,
+    funcs: BTreeMap<ProfiledFunc, u64>,
+    edges: BTreeMap<(ProfiledFunc, ProfiledFunc), u64>,
+}
+
+impl CallProfile {
+    /// The percentage of all samples an edge must appear in to be hot.
+    pub const HOT_EDGE_PERCENT: u64 = 1;
+
+    /// Creates a new, empty profile.
+    pub fn new() -> CallProfile {
+        CallProfile::default()
+    }
+
+    /// Returns whether this profile contains no samples at all.
+    pub fn is_empty(&self) -> bool {
+        self.total_samples == 0
+    }
+
+    /// Returns the total number of samples recorded in this profile.
+    pub fn total_samples(&self) -> u64 {
+        self.total_samples
+    }
+
+    /// Records a single stack sample.
+    ///
+    /// The `stack` is ordered from the oldest frame to the youngest frame and
+    /// must only contain Wasm functions. Every function on the stack has its
+    /// count bumped once and every adjacent pair of frames is recorded as a
+    /// caller-to-callee edge.
+    pub fn record_stack(&mut self, stack: &[ProfiledFunc]) {
+        if stack.is_empty() {
+            return;
+        }
+        self.total_samples += 1;
+        for func in stack {
+            *self.funcs.entry(*func).or_insert(0) += 1;
+        }
+        for pair in stack.windows(2) {
+            // Self-recursion is never inlined so there's no use in tracking
+            // it.
+            if pair[0] != pair[1] {
+                *self.edges.entry((pair[0], pair[1])).or_insert(0) += 1;
+            }
+        }
+    }
+
+    /// Merges all counts from `other` into this profile.
+    ///
+    /// This is useful to aggregate profiles collected from many stores, or
+    /// many hosts, running the same module.
+    pub fn merge(&mut self, other: &CallProfile) {
+        self.total_samples = self.total_samples.saturating_add(other.total_samples);
+        for (func, count) in other.funcs.iter() {
+            let c = self.funcs.entry(*func).or_insert(0);
+            *c = c.saturating_add(*count);
+        }
+        for (edge, count) in other.edges.iter() {
+            let c = self.edges.entry(*edge).or_insert(0);
+            *c = c.saturating_add(*count);
+        }
+    }
+
+    /// Returns the number of samples in which `func` was on the stack.
+    pub fn func_samples(&self, func: ProfiledFunc) -> u64 {
+        self.funcs.get(&func).copied().unwrap_or(0)
+    }
+
+    /// Returns the number of samples in which `caller` was directly calling
+    /// `callee`.
+    pub fn edge_samples(&self, caller: ProfiledFunc, callee: ProfiledFunc) -> u64 {
+        self.edges.get(&(caller, callee)).copied().unwrap_or(0)
+    }
+
+    /// Returns whether the `caller`-to-`callee` edge is hot.
+    pub fn is_hot_edge(&self, caller: ProfiledFunc, callee: ProfiledFunc) -> bool {
+        Self::is_hot(self.edge_samples(caller, callee), self.total_samples)
+    }
+
+    /// Returns whether `func` is hot, meaning that it was on the stack for a
+    /// significant fraction of all samples.
+    pub fn is_hot_func(&self, func: ProfiledFunc) -> bool {
+        Self::is_hot(self.func_samples(func), self.total_samples)
+    }
+
+    fn is_hot(samples: u64, total: u64) -> bool {
+        samples > 0 && samples.saturating_mul(100) >= total.saturating_mul(Self::HOT_EDGE_PERCENT)
+    }
+
+    /// Iterates over all recorded edges and their sample counts, in sorted
+    /// order.
+    pub fn edges(&self) -> impl Iterator<Item = (ProfiledFunc, ProfiledFunc, u64)> + '_ {
+        self.edges
+            .iter()
+            .map(|((caller, callee), count)| (*caller, *callee, *count))
+    }
+
+    /// Serializes this profile into a compact binary format suitable for
+    /// persisting and later loading with [`CallProfile::from_bytes`].
+    pub fn to_bytes(&self) -> Vec<u8> {
+        postcard::to_allocvec(self).expect("serializing a call profile cannot fail")
+    }
+
+    /// Deserializes a profile previously produced by
+    /// [`CallProfile::to_bytes`].
+    pub fn from_bytes(bytes: &[u8]) -> Result<CallProfile> {
+        postcard::from_bytes(bytes).map_err(|e| anyhow!("failed to deserialize call profile: {e}"))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn f(module: u32, func: u32) -> ProfiledFunc {
+        (
+            StaticModuleIndex::from_u32(module),
+            DefinedFuncIndex::from_u32(func),
+        )
+    }
+
+    #[test]
+    fn record_and_query() {
+        let mut profile = CallProfile::new();
+        assert!(profile.is_empty());
+
+        for _ in 0..99 {
+            profile.record_stack(&[f(0, 0), f(0, 1), f(0, 2)]);
+        }
+        profile.record_stack(&[f(0, 0), f(0, 3)]);
+        profile.record_stack(&[f(0, 4), f(0, 4)]);
+
+        assert_eq!(profile.total_samples(), 101);
+        assert_eq!(profile.func_samples(f(0, 0)), 100);
+        assert_eq!(profile.edge_samples(f(0, 0), f(0, 1)), 99);
+        assert_eq!(profile.edge_samples(f(0, 1), f(0, 2)), 99);
+        assert_eq!(profile.edge_samples(f(0, 4), f(0, 4)), 0);
+        assert!(profile.is_hot_edge(f(0, 1), f(0, 2)));
+        assert!(!profile.is_hot_edge(f(0, 2), f(0, 1)));
+        assert!(profile.is_hot_func(f(0, 2)));
+        assert!(!profile.is_hot_func(f(1, 0)));
+    }
+
+    #[test]
+    fn merge_and_roundtrip() {
+        let mut a = CallProfile::new();
+        a.record_stack(&[f(0, 0), f(1, 0)]);
+        let mut b = CallProfile::new();
+        b.record_stack(&[f(0, 0), f(1, 0)]);
+        b.record_stack(&[f(0, 1)]);
+
+        a.merge(&b);
+        assert_eq!(a.total_samples(), 3);
+        assert_eq!(a.edge_samples(f(0, 0), f(1, 0)), 2);
+        assert_eq!(a.func_samples(f(0, 1)), 1);
+
+        let bytes = a.to_bytes();
+        let c = CallProfile::from_bytes(&bytes).unwrap();
+        assert_eq!(a, c);
+        assert!(CallProfile::from_bytes(&[0xff, 0xff]).is_err());
+    }
+}
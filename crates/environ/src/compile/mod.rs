@@ -15,6 +15,7 @@ use std::borrow::Cow;
 use std::fmt;
 use std::path;
 use std::sync::Arc;
+use std::time::Duration;
 
 mod address_map;
 mod key;
@@ -173,6 +174,33 @@ pub struct CompiledFunctionBody {
     /// Whether the compiled function needs a GC heap to run; that is, whether
     /// it reads a struct field, allocates, an array, or etc...
     pub needs_gc_heap: bool,
+    /// Statistics about how this function was compiled.
+    pub stats: FunctionCompileStats,
+}
+
+/// Statistics about the compilation of a single function body.
+///
+/// Fields which a `Compiler` implementation does not measure are left at
+/// their default values.
+#[derive(Clone, Debug, Default)]
+pub struct FunctionCompileStats {
+    /// The size, in bytes, of the function's original Wasm body.
+    pub wasm_size: usize,
+    /// The number of instructions in the compiler's intermediate
+    /// representation of this function, before optimizations.
+    pub ir_size: usize,
+    /// The size, in bytes, of the generated machine code.
+    pub code_size: usize,
+    /// The wall-clock time spent compiling this function.
+    pub compile_time: Duration,
+    /// The time spent in each compiler pass, excluding time spent in passes
+    /// nested within it, in the order that passes were first run.
+    pub pass_times: Vec<(&'static str, Duration)>,
+    /// The time spent in register allocation.
+    pub regalloc_time: Duration,
+    /// Whether the machine code was loaded from a compilation cache instead of
+    /// being compiled.
+    pub cache_hit: bool,
 }
 
 /// An implementation of a compiler which can compile WebAssembly functions to
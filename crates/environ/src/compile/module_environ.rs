@@ -208,6 +208,34 @@ impl<'a, 'data> ModuleEnvironment<'a, 'data> {
         }
     }
 
+    /// Creates an environment which resumes translating `translation`, a
+    /// partial translation previously returned from
+    /// [`ModuleEnvironment::into_translation`], with the same `validator` and
+    /// `types`.
+    pub fn resume(
+        tunables: &'a Tunables,
+        validator: &'a mut Validator,
+        types: &'a mut ModuleTypesBuilder,
+        translation: ModuleTranslation<'data>,
+    ) -> Self {
+        Self {
+            result: translation,
+            types,
+            tunables,
+            validator,
+        }
+    }
+
+    /// Returns the translation of the payloads seen so far, releasing this
+    /// environment's borrows of its validator and types.
+    ///
+    /// This is used along with [`ModuleEnvironment::translate_payload`] and
+    /// [`ModuleEnvironment::resume`] to translate a module whose bytes arrive
+    /// incrementally.
+    pub fn into_translation(self) -> ModuleTranslation<'data> {
+        self.result
+    }
+
     /// Translate a wasm module using this environment.
     ///
     /// This function will translate the `data` provided with `parser`,
@@ -230,7 +258,12 @@ impl<'a, 'data> ModuleEnvironment<'a, 'data> {
         Ok(self.result)
     }
 
-    fn translate_payload(&mut self, payload: Payload<'data>) -> Result<()> {
+    /// Translates a single `payload` of a wasm module.
+    ///
+    /// This is the incremental counterpart of [`ModuleEnvironment::translate`]
+    /// for modules whose bytes arrive in pieces. Payloads must be supplied in
+    /// the order they were parsed.
+    pub fn translate_payload(&mut self, payload: Payload<'data>) -> Result<()> {
         match payload {
             Payload::Version {
                 num,
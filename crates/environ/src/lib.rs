@@ -21,6 +21,7 @@ pub mod prelude;
 mod address_map;
 #[macro_use]
 mod builtin;
+mod call_profile;
 mod demangling;
 mod error;
 mod ext;
@@ -42,6 +43,7 @@ mod vmoffsets;
 pub use self::ext::*;
 pub use crate::address_map::*;
 pub use crate::builtin::*;
+pub use crate::call_profile::*;
 pub use crate::demangling::*;
 pub use crate::error::*;
 pub use crate::gc::*;
@@ -83,6 +83,10 @@ define_tunables! {
         /// will be consumed every time a wasm instruction is executed.
         pub consume_fuel: bool,
 
+        /// Whether fuel, when enabled, is charged approximately on entry to
+        /// each branch-free region of code rather than before every branch.
+        pub approximate_fuel: bool,
+
         /// Whether or not we use epoch-based interruption.
         pub epoch_interruption: bool,
 
@@ -136,6 +140,18 @@ define_tunables! {
         /// The general size threshold for the sum of the caller's and callee's
         /// sizes, past which we will generally not inline calls anymore.
         pub inlining_sum_size_threshold: u32,
+
+        /// The size of callees that can be inlined, regardless of the caller's
+        /// size, when the call edge is hot according to a `CallProfile`.
+        pub inlining_hot_callee_size: u32,
+
+        /// Like `inlining_sum_size_threshold` but for call edges that are hot
+        /// according to a `CallProfile`.
+        pub inlining_hot_sum_size_threshold: u32,
+
+        /// Whether Winch applies peephole optimizations to the machine code it
+        /// emits.
+        pub winch_peephole: bool,
     }
 
     pub struct ConfigTunables {
@@ -196,6 +212,7 @@ impl Tunables {
             generate_native_debuginfo: false,
             parse_wasm_debuginfo: true,
             consume_fuel: false,
+            approximate_fuel: false,
             epoch_interruption: false,
             memory_may_move: true,
             guard_before_linear_memory: true,
@@ -210,6 +227,9 @@ impl Tunables {
             inlining_intra_module: IntraModuleInlining::WhenUsingGc,
             inlining_small_callee_size: 50,
             inlining_sum_size_threshold: 2000,
+            inlining_hot_callee_size: 500,
+            inlining_hot_sum_size_threshold: 8000,
+            winch_peephole: false,
         }
     }
 
@@ -0,0 +1,27 @@
+use std::sync::atomic::{AtomicU32, Ordering};
+use test_programs::proxy;
+use test_programs::wasi::http::types::{
+    Fields, IncomingRequest, OutgoingResponse, ResponseOutparam,
+};
+
+struct T;
+
+proxy::export!(T);
+
+/// The number of requests this instance has handled, which is returned in the
+/// `count` header of each response.
+static COUNT: AtomicU32 = AtomicU32::new(0);
+
+impl proxy::exports::wasi::http::incoming_handler::Guest for T {
+    fn handle(_request: IncomingRequest, outparam: ResponseOutparam) {
+        let count = COUNT.fetch_add(1, Ordering::Relaxed) + 1;
+        let fields = Fields::new();
+        fields
+            .set(&"count".to_string(), &[count.to_string().into_bytes()])
+            .unwrap();
+        let resp = OutgoingResponse::new(fields);
+        ResponseOutparam::set(outparam, Ok(resp));
+    }
+}
+
+fn main() {}
@@ -185,6 +185,110 @@ unsafe fn test_file_write_and_file_pos(dir_fd: wasip1::Fd) {
     wasip1::path_unlink_file(dir_fd, path).expect("removing a file");
 }
 
+unsafe fn test_file_vectored_read_write(dir_fd: wasip1::Fd) {
+    let file_fd = wasip1::path_open(
+        dir_fd,
+        0,
+        "file3",
+        wasip1::OFLAGS_CREAT,
+        wasip1::RIGHTS_FD_READ | wasip1::RIGHTS_FD_WRITE,
+        0,
+        0,
+    )
+    .expect("opening a file");
+
+    // Gather a write from several buffers, some of them empty. A short write
+    // resumes partway through a buffer.
+    let contents = [1u8, 2, 3, 4, 5, 6, 7, 8];
+    let mut bufs: [&[u8]; 5] = [&[], &contents[..3], &[], &contents[3..], &[]];
+    while bufs.iter().any(|buf| !buf.is_empty()) {
+        let ciovecs = bufs.map(|buf| wasip1::Ciovec {
+            buf: buf.as_ptr(),
+            buf_len: buf.len(),
+        });
+        let mut nwritten = wasip1::fd_write(file_fd, &ciovecs).expect("writing iovecs");
+        assert!(nwritten > 0, "nwritten bytes check");
+        for buf in bufs.iter_mut() {
+            let n = nwritten.min(buf.len());
+            *buf = &buf[n..];
+            nwritten -= n;
+        }
+        assert_eq!(nwritten, 0, "nwritten bytes check");
+    }
+    assert_eq!(wasip1::fd_tell(file_fd).unwrap(), 8, "file position check");
+
+    // Only empty buffers write nothing and don't move the file position.
+    let ciovecs = [wasip1::Ciovec {
+        buf: contents.as_ptr(),
+        buf_len: 0,
+    }; 3];
+    let nwritten = wasip1::fd_write(file_fd, &ciovecs).expect("writing empty iovecs");
+    assert_eq!(nwritten, 0, "nwritten bytes check");
+    assert_eq!(wasip1::fd_tell(file_fd).unwrap(), 8, "file position check");
+
+    // Scatter a read into several buffers, some of them empty, with more
+    // room than the file has left. Buffers are filled in order and the last
+    // one is only partially filled.
+    wasip1::fd_seek(file_fd, 1, wasip1::WHENCE_SET).expect("seeking to offset 1");
+    let mut empty = [0u8; 0];
+    let mut first = [0xffu8; 2];
+    let mut second = [0xffu8; 3];
+    let mut third = [0xffu8; 8];
+    let mut read = Vec::new();
+    loop {
+        let iovecs = [
+            wasip1::Iovec {
+                buf: empty.as_mut_ptr(),
+                buf_len: 0,
+            },
+            wasip1::Iovec {
+                buf: first.as_mut_ptr(),
+                buf_len: first.len(),
+            },
+            wasip1::Iovec {
+                buf: empty.as_mut_ptr(),
+                buf_len: 0,
+            },
+            wasip1::Iovec {
+                buf: second.as_mut_ptr(),
+                buf_len: second.len(),
+            },
+            wasip1::Iovec {
+                buf: third.as_mut_ptr(),
+                buf_len: third.len(),
+            },
+        ];
+        let nread = wasip1::fd_read(file_fd, &iovecs).expect("reading iovecs");
+        let bufs: Vec<u8> = first.iter().chain(&second).chain(&third).copied().collect();
+        assert!(
+            bufs[nread..].iter().all(|b| *b == 0xff),
+            "bytes past the amount read are untouched",
+        );
+        if nread == 0 {
+            break;
+        }
+        read.extend_from_slice(&bufs[..nread]);
+        first.fill(0xff);
+        second.fill(0xff);
+        third.fill(0xff);
+    }
+    assert_eq!(read, &contents[1..], "written bytes equal read bytes");
+    assert_eq!(wasip1::fd_tell(file_fd).unwrap(), 8, "file position check");
+
+    // Only empty buffers read nothing and don't move the file position.
+    wasip1::fd_seek(file_fd, 2, wasip1::WHENCE_SET).expect("seeking to offset 2");
+    let iovecs = [wasip1::Iovec {
+        buf: empty.as_mut_ptr(),
+        buf_len: 0,
+    }; 2];
+    let nread = wasip1::fd_read(file_fd, &iovecs).expect("reading empty iovecs");
+    assert_eq!(nread, 0, "nread bytes check");
+    assert_eq!(wasip1::fd_tell(file_fd).unwrap(), 2, "file position check");
+
+    wasip1::fd_close(file_fd).expect("closing a file");
+    wasip1::path_unlink_file(dir_fd, "file3").expect("removing a file");
+}
+
 fn main() {
     let mut args = env::args();
     let prog = args.next().unwrap();
@@ -208,5 +312,6 @@ fn main() {
     unsafe {
         test_file_read_write(dir_fd);
         test_file_write_and_file_pos(dir_fd);
+        test_file_vectored_read_write(dir_fd);
     }
 }
@@ -9,7 +9,38 @@ unsafe fn test_stdio() {
     }
 }
 
+unsafe fn test_stdout_vectored() {
+    // Gather a write from several buffers, some of them empty. A short write
+    // resumes partway through a buffer.
+    let mut bufs: [&[u8]; 5] = [&[], b"gathered ", &[], b"stdout\n", &[]];
+    while bufs.iter().any(|buf| !buf.is_empty()) {
+        let ciovecs = bufs.map(|buf| wasip1::Ciovec {
+            buf: buf.as_ptr(),
+            buf_len: buf.len(),
+        });
+        let mut nwritten = wasip1::fd_write(STDOUT_FD, &ciovecs).expect("writing iovecs");
+        assert!(nwritten > 0, "nwritten bytes check");
+        for buf in bufs.iter_mut() {
+            let n = nwritten.min(buf.len());
+            *buf = &buf[n..];
+            nwritten -= n;
+        }
+        assert_eq!(nwritten, 0, "nwritten bytes check");
+    }
+
+    // Only empty buffers write nothing.
+    let ciovecs = [wasip1::Ciovec {
+        buf: b"".as_ptr(),
+        buf_len: 0,
+    }; 2];
+    let nwritten = wasip1::fd_write(STDOUT_FD, &ciovecs).expect("writing empty iovecs");
+    assert_eq!(nwritten, 0, "nwritten bytes check");
+}
+
 fn main() {
     // Run the tests.
-    unsafe { test_stdio() }
+    unsafe {
+        test_stdout_vectored();
+        test_stdio();
+    }
 }
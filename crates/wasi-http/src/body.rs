@@ -2,7 +2,7 @@
 
 use crate::{bindings::http::types, types::FieldMap};
 use anyhow::anyhow;
-use bytes::Bytes;
+use bytes::{Buf, Bytes};
 use http_body::{Body, Frame};
 use http_body_util::BodyExt;
 use http_body_util::combinators::BoxBody;
@@ -168,6 +168,42 @@ pub struct HostIncomingBodyStream {
 }
 
 impl HostIncomingBodyStream {
+    /// Ensures that `self.buffer` holds the next data frame of the body, if
+    /// one is available without blocking.
+    ///
+    /// Returns `Ok(true)` if there's buffered data to read and `Ok(false)` if
+    /// no data is available at this time.
+    fn fill_buffer(&mut self) -> Result<bool, StreamError> {
+        loop {
+            // Handle buffered data/errors if any
+            if !self.buffer.is_empty() {
+                return Ok(true);
+            }
+
+            if let Some(e) = self.error.take() {
+                return Err(StreamError::LastOperationFailed(e));
+            }
+
+            // Extract the body that we're reading from. If present perform a
+            // non-blocking poll to see if a frame is already here. If it is
+            // then turn the loop again to operate on the results. If it's not
+            // here then report that no data is available at this time.
+            let body = match &mut self.state {
+                IncomingBodyStreamState::Open { body, .. } => body,
+                IncomingBodyStreamState::Closed => return Err(StreamError::Closed),
+            };
+
+            let future = body.frame();
+            futures::pin_mut!(future);
+            match poll_noop(future) {
+                Some(result) => {
+                    self.record_frame(result);
+                }
+                None => return Ok(false),
+            }
+        }
+    }
+
     fn record_frame(&mut self, frame: Option<Result<Frame<Bytes>, types::ErrorCode>>) {
         match frame {
             Some(Ok(frame)) => match frame.into_data() {
@@ -234,37 +270,34 @@ enum IncomingBodyStreamState {
 #[async_trait::async_trait]
 impl InputStream for HostIncomingBodyStream {
     fn read(&mut self, size: usize) -> Result<Bytes, StreamError> {
-        loop {
-            // Handle buffered data/errors if any
-            if !self.buffer.is_empty() {
-                let len = size.min(self.buffer.len());
-                let chunk = self.buffer.split_to(len);
-                return Ok(chunk);
-            }
-
-            if let Some(e) = self.error.take() {
-                return Err(StreamError::LastOperationFailed(e));
-            }
+        if !self.fill_buffer()? {
+            return Ok(Bytes::new());
+        }
+        // Hand out the rest of the frame as-is when it all fits instead of
+        // splitting it, which leaves the `Bytes` as the sole owner of hyper's
+        // buffer when it was, so converting it into the guest's `Vec<u8>`
+        // won't need to copy.
+        if size >= self.buffer.len() {
+            return Ok(mem::take(&mut self.buffer));
+        }
+        Ok(self.buffer.split_to(size))
+    }
 
-            // Extract the body that we're reading from. If present perform a
-            // non-blocking poll to see if a frame is already here. If it is
-            // then turn the loop again to operate on the results. If it's not
-            // here then return an empty buffer as no data is available at this
-            // time.
-            let body = match &mut self.state {
-                IncomingBodyStreamState::Open { body, .. } => body,
-                IncomingBodyStreamState::Closed => return Err(StreamError::Closed),
-            };
+    fn buffered_len(&mut self) -> Result<Option<usize>, StreamError> {
+        self.fill_buffer()?;
+        Ok(Some(self.buffer.len()))
+    }
 
-            let future = body.frame();
-            futures::pin_mut!(future);
-            match poll_noop(future) {
-                Some(result) => {
-                    self.record_frame(result);
-                }
-                None => return Ok(Bytes::new()),
-            }
+    fn read_into(&mut self, buf: &mut [u8]) -> Result<usize, StreamError> {
+        // Copy straight out of the frame received from hyper instead of
+        // splitting off a `Bytes` handle which is then copied again.
+        if !self.fill_buffer()? {
+            return Ok(0);
         }
+        let len = buf.len().min(self.buffer.len());
+        buf[..len].copy_from_slice(&self.buffer[..len]);
+        self.buffer.advance(len);
+        Ok(len)
     }
 }
 
@@ -671,3 +704,39 @@ impl Pollable for BodyWriteStream {
         let _ = self.writer.reserve().await;
     }
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use http_body_util::StreamBody;
+    use wasmtime::component::{Resource, ResourceTable};
+    use wasmtime_wasi::p2::DynInputStream;
+    use wasmtime_wasi_io::bindings::wasi::io::streams::HostInputStream;
+
+    #[tokio::test]
+    async fn guest_reads_stay_within_frames() {
+        let frames = [&b"hello "[..], b"incoming ", b"body"]
+            .map(|data| Ok(Frame::data(Bytes::from_static(data))));
+        let body = StreamBody::new(futures::stream::iter(frames)).boxed();
+        let mut body = HostIncomingBody::new(body, Duration::from_secs(10));
+        let stream: DynInputStream = Box::new(body.take_stream().unwrap());
+        let mut table = ResourceTable::new();
+        let stream = table.push(stream).unwrap();
+        let stream = || Resource::<DynInputStream>::new_borrow(stream.rep());
+
+        // Reads return no more than was asked for, and no more than what's
+        // left of the current frame, however large the guest's request.
+        let read = HostInputStream::blocking_read(&mut table, stream(), 3).await;
+        assert_eq!(read.unwrap(), b"hel");
+        let read = HostInputStream::read(&mut table, stream(), u64::MAX);
+        assert_eq!(read.unwrap(), b"lo ");
+        let read = HostInputStream::blocking_read(&mut table, stream(), u64::MAX).await;
+        assert_eq!(read.unwrap(), b"incoming ");
+        let read = HostInputStream::blocking_read(&mut table, stream(), 0).await;
+        assert_eq!(read.unwrap(), b"");
+        let read = HostInputStream::blocking_read(&mut table, stream(), 100).await;
+        assert_eq!(read.unwrap(), b"body");
+        let read = HostInputStream::blocking_read(&mut table, stream(), 100).await;
+        assert!(matches!(read, Err(StreamError::Closed)));
+    }
+}
@@ -53,6 +53,55 @@ pub trait InputStream: Pollable {
         }
     }
 
+    /// Reads up to `buf.len()` bytes directly into `buf`, returning the
+    /// number of bytes read.
+    ///
+    /// This is the same as `read` except that data is copied into a buffer
+    /// provided by the caller, such as a region of guest linear memory,
+    /// instead of being returned as `Bytes`. The default implementation
+    /// delegates to `read`, but streams which already buffer their data may
+    /// override this to copy it out without creating an intermediate `Bytes`.
+    fn read_into(&mut self, buf: &mut [u8]) -> StreamResult<usize> {
+        let bytes = self.read(buf.len())?;
+        buf[..bytes.len()].copy_from_slice(&bytes);
+        Ok(bytes.len())
+    }
+
+    /// Returns how many bytes `read_into` can copy out right now without
+    /// waiting, or `None` if this stream doesn't track that.
+    ///
+    /// Streams which override `read_into` to copy out of data they've already
+    /// buffered should return the size of that data here, so that callers
+    /// filling several buffers can tell whether another `read_into` would
+    /// return more data straight away. Like `read`, this may make progress on
+    /// the stream and returns the same errors.
+    fn buffered_len(&mut self) -> StreamResult<Option<usize>> {
+        Ok(None)
+    }
+
+    /// Similar to `read_into`, except that it blocks until at least one byte
+    /// can be read.
+    async fn blocking_read_into(&mut self, buf: &mut [u8]) -> StreamResult<usize> {
+        if buf.is_empty() {
+            self.ready().await;
+            return self.read_into(buf);
+        }
+
+        let mut i = 0;
+        loop {
+            // This `ready` call may return prematurely due to `io::ErrorKind::WouldBlock`.
+            self.ready().await;
+            let n = self.read_into(buf)?;
+            if n > 0 {
+                return Ok(n);
+            }
+            if i >= MAX_BLOCKING_ATTEMPTS {
+                return Err(StreamError::trap("max blocking attempts exceeded"));
+            }
+            i += 1;
+        }
+    }
+
     /// Same as the `read` method except that bytes are skipped.
     ///
     /// Note that this method is non-blocking like `read` and returns the same
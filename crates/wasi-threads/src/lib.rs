@@ -4,10 +4,12 @@
 
 use anyhow::{Result, anyhow};
 use std::panic::{AssertUnwindSafe, catch_unwind};
-use std::sync::Arc;
 use std::sync::atomic::{AtomicI32, Ordering};
-use std::thread;
-use wasmtime::{Caller, ExternType, InstancePre, Linker, Module, SharedMemory, Store};
+use std::sync::mpsc::{self, RecvTimeoutError, Sender};
+use std::sync::{Arc, Mutex, Weak};
+use std::thread::{self, ThreadId};
+use std::time::Duration;
+use wasmtime::{Caller, ExternType, InstancePre, Linker, Module, SharedMemory, Store, TypedFunc};
 
 // This name is a function export designated by the wasi-threads specification:
 // https://github.com/WebAssembly/wasi-threads/#detailed-design-discussion
@@ -16,13 +18,134 @@ const WASI_ENTRY_POINT: &str = "wasi_thread_start";
 pub struct WasiThreadsCtx<T> {
     instance_pre: Arc<InstancePre<T>>,
     tid: AtomicI32,
+    pool: Arc<ThreadPool<T>>,
+}
+
+/// Configuration for reusing the threads spawned by a [`WasiThreadsCtx`].
+///
+/// By default every `thread-spawn` creates a new OS thread which exits along
+/// with the wasm thread. Guests which repeatedly spawn short-lived threads can
+/// instead have finished threads parked and handed the next `thread-spawn`.
+///
+/// Parked threads exit when the [`WasiThreadsCtx`] is dropped, when
+/// [`WasiThreadsCtx::clear_idle_threads`] is called, or once they've been idle
+/// for the configured [`ThreadPoolConfig::idle_timeout`].
+#[derive(Clone, Debug)]
+pub struct ThreadPoolConfig {
+    max_idle_threads: usize,
+    reuse_instances: bool,
+    idle_timeout: Option<Duration>,
+}
+
+impl Default for ThreadPoolConfig {
+    fn default() -> Self {
+        Self {
+            max_idle_threads: 0,
+            reuse_instances: false,
+            idle_timeout: Some(Duration::from_secs(10)),
+        }
+    }
+}
+
+impl ThreadPoolConfig {
+    /// Creates a configuration which doesn't keep any threads for reuse.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Configures how many finished threads are kept parked for reuse.
+    ///
+    /// Threads beyond this limit exit when their wasm thread finishes, and
+    /// `thread-spawn` creates a new thread whenever no parked thread is
+    /// available, so this doesn't limit the number of running threads.
+    ///
+    /// Defaults to 0.
+    pub fn max_idle_threads(&mut self, max: usize) -> &mut Self {
+        self.max_idle_threads = max;
+        self
+    }
+
+    /// Configures whether a parked thread keeps its store and instance and
+    /// reuses them for the next `thread-spawn`, skipping instantiation.
+    ///
+    /// The wasi-threads specification gives every thread a fresh instance, so
+    /// this is only correct for modules whose `wasi_thread_start` reinitializes
+    /// all of its instance-local state, such as the stack pointer and
+    /// thread-local storage set up by wasi-libc. The store's data is replaced
+    /// with the new thread's host state.
+    ///
+    /// Parked stores, and so their host state, stay alive until their thread
+    /// is reused or exits. If the host state owns the [`WasiThreadsCtx`] then
+    /// the parked stores keep the context alive too, so dropping the last
+    /// other reference to it doesn't stop them. In that case they're only
+    /// released by [`WasiThreadsCtx::clear_idle_threads`] or the
+    /// [`ThreadPoolConfig::idle_timeout`].
+    ///
+    /// Defaults to `false`.
+    pub fn reuse_instances(&mut self, enable: bool) -> &mut Self {
+        self.reuse_instances = enable;
+        self
+    }
+
+    /// Configures how long a parked thread waits to be reused before it
+    /// exits, or `None` to wait indefinitely.
+    ///
+    /// Defaults to 10 seconds.
+    pub fn idle_timeout(&mut self, timeout: Option<Duration>) -> &mut Self {
+        self.idle_timeout = timeout;
+        self
+    }
+}
+
+/// Threads which have finished running a wasm thread and are waiting for
+/// another one.
+struct ThreadPool<T> {
+    config: ThreadPoolConfig,
+    idle: Mutex<Vec<Parked<T>>>,
+}
+
+/// A thread parked in a [`ThreadPool`].
+struct Parked<T> {
+    thread: ThreadId,
+    sender: Sender<Job<T>>,
+}
+
+/// A request to run `wasi_thread_start` on a thread.
+struct Job<T> {
+    host: T,
+    wasi_thread_id: i32,
+    thread_start_arg: i32,
+}
+
+/// A store and instance kept by a parked thread for reuse.
+struct Instantiated<T: 'static> {
+    store: Store<T>,
+    entry_point: TypedFunc<(i32, i32), ()>,
 }
 
 impl<T: Clone + Send + 'static> WasiThreadsCtx<T> {
     pub fn new(module: Module, linker: Arc<Linker<T>>) -> Result<Self> {
+        Self::new_with_pool(module, linker, &ThreadPoolConfig::default())
+    }
+
+    /// Same as [`WasiThreadsCtx::new`] except that finished threads are kept
+    /// for reuse as configured by `pool`.
+    pub fn new_with_pool(
+        module: Module,
+        linker: Arc<Linker<T>>,
+        pool: &ThreadPoolConfig,
+    ) -> Result<Self> {
         let instance_pre = Arc::new(linker.instantiate_pre(&module)?);
         let tid = AtomicI32::new(0);
-        Ok(Self { instance_pre, tid })
+        let pool = Arc::new(ThreadPool {
+            config: pool.clone(),
+            idle: Mutex::new(Vec::new()),
+        });
+        Ok(Self {
+            instance_pre,
+            tid,
+            pool,
+        })
     }
 
     pub fn spawn(&self, host: T, thread_start_arg: i32) -> Result<i32> {
@@ -57,62 +180,49 @@ impl<T: Clone + Send + 'static> WasiThreadsCtx<T> {
         }
         let wasi_thread_id = wasi_thread_id.unwrap();
 
-        // Start a Rust thread running a new instance of the current module.
-        let builder = thread::Builder::new().name(format!("wasi-thread-{wasi_thread_id}"));
-        builder.spawn(move || {
-            // Catch any panic failures in host code; e.g., if a WASI module
-            // were to crash, we want all threads to exit, not just this one.
-            let result = catch_unwind(AssertUnwindSafe(|| {
-                // Each new instance is created in its own store.
-                let mut store = Store::new(&instance_pre.module().engine(), host);
-
-                let instance = if instance_pre.module().engine().is_async() {
-                    wasmtime_wasi::runtime::in_tokio(instance_pre.instantiate_async(&mut store))
-                } else {
-                    instance_pre.instantiate(&mut store)
-                }
-                .unwrap();
+        let mut job = Job {
+            host,
+            wasi_thread_id,
+            thread_start_arg,
+        };
 
-                let thread_entry_point = instance
-                    .get_typed_func::<(i32, i32), ()>(&mut store, WASI_ENTRY_POINT)
-                    .unwrap();
-
-                // Start the thread's entry point. Any traps or calls to
-                // `proc_exit`, by specification, should end execution for all
-                // threads. This code uses `process::exit` to do so, which is
-                // what the user expects from the CLI but probably not in a
-                // Wasmtime embedding.
-                log::trace!(
-                    "spawned thread id = {wasi_thread_id}; calling start function `{WASI_ENTRY_POINT}` with: {thread_start_arg}"
-                );
-                let res = if instance_pre.module().engine().is_async() {
-                    wasmtime_wasi::runtime::in_tokio(
-                        thread_entry_point
-                            .call_async(&mut store, (wasi_thread_id, thread_start_arg)),
-                    )
-                } else {
-                    thread_entry_point.call(&mut store, (wasi_thread_id, thread_start_arg))
-                };
-                match res {
-                    Ok(_) => log::trace!("exiting thread id = {wasi_thread_id} normally"),
-                    Err(e) => {
-                        log::trace!("exiting thread id = {wasi_thread_id} due to error");
-                        let e = wasi_common::maybe_exit_on_error(e);
-                        eprintln!("Error: {e:?}");
-                        std::process::exit(1);
-                    }
+        // Hand the job to a parked thread if there is one. A send only fails
+        // if that thread has since exited, in which case try the next one.
+        loop {
+            let idle = self.pool.idle.lock().unwrap().pop();
+            let Some(idle) = idle else { break };
+            match idle.sender.send(job) {
+                Ok(()) => {
+                    log::trace!("reusing a parked thread for thread id = {wasi_thread_id}");
+                    return Ok(wasi_thread_id);
                 }
-            }));
-
-            if let Err(e) = result {
-                eprintln!("wasi-thread-{wasi_thread_id} panicked: {e:?}");
-                std::process::exit(1);
+                Err(mpsc::SendError(j)) => job = j,
             }
-        })?;
+        }
+
+        // Otherwise start a Rust thread running a new instance of the current
+        // module. Threads which may be reused for other wasi threads aren't
+        // named after this one as their name can't be changed later.
+        let name = if self.pool.config.max_idle_threads == 0 {
+            format!("wasi-thread-{wasi_thread_id}")
+        } else {
+            "wasi-thread".to_string()
+        };
+        let pool = Arc::downgrade(&self.pool);
+        let builder = thread::Builder::new().name(name);
+        builder.spawn(move || run_thread(pool, instance_pre, job))?;
 
         Ok(wasi_thread_id)
     }
 
+    /// Stops all threads which are parked waiting for reuse, dropping any
+    /// stores they kept.
+    pub fn clear_idle_threads(&self) {
+        // Drop the senders outside of the lock as that wakes the threads up.
+        let idle = std::mem::take(&mut *self.pool.idle.lock().unwrap());
+        drop(idle);
+    }
+
     /// Helper for generating valid WASI thread IDs (TID).
     ///
     /// Callers of `wasi_thread_spawn` expect a TID in range of 0 < TID <= 0x1FFFFFFF
@@ -131,6 +241,144 @@ impl<T: Clone + Send + 'static> WasiThreadsCtx<T> {
     }
 }
 
+/// Body of a thread spawned for wasi-threads, which runs `job` and then parks
+/// itself in `pool` to run more jobs if there's room.
+fn run_thread<T: Clone + Send + 'static>(
+    pool: Weak<ThreadPool<T>>,
+    instance_pre: Arc<InstancePre<T>>,
+    mut job: Job<T>,
+) {
+    let mut instantiated = None;
+    loop {
+        let wasi_thread_id = job.wasi_thread_id;
+
+        // Catch any panic failures in host code; e.g., if a WASI module
+        // were to crash, we want all threads to exit, not just this one.
+        let result = catch_unwind(AssertUnwindSafe(|| {
+            run_job(&instance_pre, instantiated.take(), job)
+        }));
+        let finished = match result {
+            Ok(finished) => finished,
+            Err(e) => {
+                eprintln!("wasi-thread-{wasi_thread_id} panicked: {e:?}");
+                std::process::exit(1);
+            }
+        };
+
+        // Park this thread for reuse, unless the pool is full or its
+        // `WasiThreadsCtx` is gone. The pool isn't kept alive while parked so
+        // dropping the context drops the sender and wakes this thread to exit.
+        let Some(strong) = pool.upgrade() else { return };
+        if strong.config.reuse_instances {
+            instantiated = Some(finished);
+        } else {
+            drop(finished);
+        }
+        let (sender, receiver) = mpsc::channel();
+        let this_thread = thread::current().id();
+        {
+            let mut idle = strong.idle.lock().unwrap();
+            if idle.len() >= strong.config.max_idle_threads {
+                return;
+            }
+            idle.push(Parked {
+                thread: this_thread,
+                sender,
+            });
+        }
+        let idle_timeout = strong.config.idle_timeout;
+        drop(strong);
+        let received = match idle_timeout {
+            Some(timeout) => receiver.recv_timeout(timeout),
+            None => receiver.recv().map_err(|_| RecvTimeoutError::Disconnected),
+        };
+        job = match received {
+            Ok(job) => job,
+            Err(RecvTimeoutError::Disconnected) => return,
+            Err(RecvTimeoutError::Timeout) => {
+                // Stop being handed jobs, but run one that was handed to this
+                // thread just before that.
+                if let Some(strong) = pool.upgrade() {
+                    strong
+                        .idle
+                        .lock()
+                        .unwrap()
+                        .retain(|p| p.thread != this_thread);
+                }
+                match receiver.try_recv() {
+                    Ok(job) => job,
+                    Err(_) => return,
+                }
+            }
+        };
+    }
+}
+
+/// Runs the thread entry point for `job`, in `instantiated` if provided or
+/// otherwise in a new instance, returning the instance afterwards.
+fn run_job<T: Clone + Send + 'static>(
+    instance_pre: &InstancePre<T>,
+    instantiated: Option<Instantiated<T>>,
+    job: Job<T>,
+) -> Instantiated<T> {
+    let Job {
+        host,
+        wasi_thread_id,
+        thread_start_arg,
+    } = job;
+    let is_async = instance_pre.module().engine().is_async();
+
+    let mut instantiated = match instantiated {
+        Some(mut instantiated) => {
+            *instantiated.store.data_mut() = host;
+            instantiated
+        }
+        None => {
+            // Each new instance is created in its own store.
+            let mut store = Store::new(&instance_pre.module().engine(), host);
+
+            let instance = if is_async {
+                wasmtime_wasi::runtime::in_tokio(instance_pre.instantiate_async(&mut store))
+            } else {
+                instance_pre.instantiate(&mut store)
+            }
+            .unwrap();
+
+            let entry_point = instance
+                .get_typed_func::<(i32, i32), ()>(&mut store, WASI_ENTRY_POINT)
+                .unwrap();
+            Instantiated { store, entry_point }
+        }
+    };
+
+    // Start the thread's entry point. Any traps or calls to
+    // `proc_exit`, by specification, should end execution for all
+    // threads. This code uses `process::exit` to do so, which is
+    // what the user expects from the CLI but probably not in a
+    // Wasmtime embedding.
+    log::trace!(
+        "spawned thread id = {wasi_thread_id}; calling start function `{WASI_ENTRY_POINT}` with: {thread_start_arg}"
+    );
+    let Instantiated { store, entry_point } = &mut instantiated;
+    let res = if is_async {
+        wasmtime_wasi::runtime::in_tokio(
+            entry_point.call_async(&mut *store, (wasi_thread_id, thread_start_arg)),
+        )
+    } else {
+        entry_point.call(&mut *store, (wasi_thread_id, thread_start_arg))
+    };
+    match res {
+        Ok(_) => log::trace!("exiting thread id = {wasi_thread_id} normally"),
+        Err(e) => {
+            log::trace!("exiting thread id = {wasi_thread_id} due to error");
+            let e = wasi_common::maybe_exit_on_error(e);
+            eprintln!("Error: {e:?}");
+            std::process::exit(1);
+        }
+    }
+    instantiated
+}
+
 /// Manually add the WASI `thread_spawn` function to the linker.
 ///
 /// It is unclear what namespace the `wasi-threads` proposal should live under:
@@ -197,3 +445,168 @@ fn has_correct_signature(module: &Module) -> bool {
         _ => false,
     }
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+    use std::sync::Barrier;
+    use std::time::Instant;
+
+    #[derive(Clone)]
+    struct Host {
+        /// The thread and the value of the instance's counter for each call
+        /// of `wasi_thread_start`.
+        calls: Arc<Mutex<Vec<(ThreadId, i32)>>>,
+        barrier: Option<Arc<Barrier>>,
+    }
+
+    impl Host {
+        fn new(barrier: Option<Arc<Barrier>>) -> Host {
+            Host {
+                calls: Default::default(),
+                barrier,
+            }
+        }
+    }
+
+    fn ctx(config: &ThreadPoolConfig) -> WasiThreadsCtx<Host> {
+        let engine = wasmtime::Engine::default();
+        let module = Module::new(
+            &engine,
+            r#"
+                (module
+                    (import "" "record" (func $record (param i32)))
+                    (global $count (mut i32) (i32.const 0))
+                    (func (export "wasi_thread_start") (param i32 i32)
+                        (global.set $count (i32.add (global.get $count) (i32.const 1)))
+                        (call $record (global.get $count))
+                    )
+                )
+            "#,
+        )
+        .unwrap();
+        let mut linker = Linker::<Host>::new(&engine);
+        linker
+            .func_wrap("", "record", |caller: Caller<'_, Host>, count: i32| {
+                let host = caller.data();
+                host.calls
+                    .lock()
+                    .unwrap()
+                    .push((thread::current().id(), count));
+                if let Some(barrier) = &host.barrier {
+                    barrier.wait();
+                }
+            })
+            .unwrap();
+        WasiThreadsCtx::new_with_pool(module, Arc::new(linker), config).unwrap()
+    }
+
+    /// Waits for `f` to return `true`, panicking if that takes too long.
+    fn wait_for(mut f: impl FnMut() -> bool) {
+        let start = Instant::now();
+        while !f() {
+            assert!(start.elapsed() < Duration::from_secs(30), "timed out");
+            thread::sleep(Duration::from_millis(1));
+        }
+    }
+
+    fn idle(ctx: &WasiThreadsCtx<Host>) -> usize {
+        ctx.pool.idle.lock().unwrap().len()
+    }
+
+    #[test]
+    fn reuses_threads() {
+        let ctx = ctx(ThreadPoolConfig::new().max_idle_threads(1));
+        let host = Host::new(None);
+        for _ in 0..3 {
+            assert!(ctx.spawn(host.clone(), 0).unwrap() > 0);
+            wait_for(|| idle(&ctx) == 1);
+        }
+        let calls = host.calls.lock().unwrap();
+        assert_eq!(calls.len(), 3);
+        assert!(calls.iter().all(|(thread, _)| *thread == calls[0].0));
+        // Each call ran in a new instance.
+        assert!(calls.iter().all(|(_, count)| *count == 1));
+    }
+
+    #[test]
+    fn reuses_instances() {
+        let ctx = ctx(ThreadPoolConfig::new()
+            .max_idle_threads(1)
+            .reuse_instances(true));
+        let host = Host::new(None);
+        for _ in 0..3 {
+            ctx.spawn(host.clone(), 0).unwrap();
+            wait_for(|| idle(&ctx) == 1);
+        }
+        let counts = host
+            .calls
+            .lock()
+            .unwrap()
+            .iter()
+            .map(|(_, count)| *count)
+            .collect::<Vec<_>>();
+        assert_eq!(counts, [1, 2, 3]);
+    }
+
+    #[test]
+    fn limits_idle_threads() {
+        let ctx = ctx(ThreadPoolConfig::new().max_idle_threads(2));
+
+        // Run four threads at once, which all finish together.
+        let barrier = Arc::new(Barrier::new(5));
+        let host = Host::new(Some(barrier.clone()));
+        for _ in 0..4 {
+            ctx.spawn(host.clone(), 0).unwrap();
+        }
+        barrier.wait();
+        wait_for(|| idle(&ctx) == 2);
+        thread::sleep(Duration::from_millis(100));
+        assert_eq!(idle(&ctx), 2);
+    }
+
+    #[test]
+    fn drop_stops_idle_threads() {
+        let ctx = ctx(ThreadPoolConfig::new()
+            .max_idle_threads(1)
+            .reuse_instances(true));
+        let host = Host::new(None);
+        ctx.spawn(host.clone(), 0).unwrap();
+        wait_for(|| idle(&ctx) == 1);
+
+        // The parked store holds on to a clone of the host state until the
+        // thread exits.
+        assert_eq!(Arc::strong_count(&host.calls), 2);
+        drop(ctx);
+        wait_for(|| Arc::strong_count(&host.calls) == 1);
+    }
+
+    #[test]
+    fn clear_idle_threads() {
+        let ctx = ctx(ThreadPoolConfig::new()
+            .max_idle_threads(1)
+            .reuse_instances(true));
+        let host = Host::new(None);
+        ctx.spawn(host.clone(), 0).unwrap();
+        wait_for(|| idle(&ctx) == 1);
+        ctx.clear_idle_threads();
+        assert_eq!(idle(&ctx), 0);
+        wait_for(|| Arc::strong_count(&host.calls) == 1);
+    }
+
+    #[test]
+    fn idle_threads_time_out() {
+        let ctx = ctx(ThreadPoolConfig::new()
+            .max_idle_threads(1)
+            .reuse_instances(true)
+            .idle_timeout(Some(Duration::from_millis(10))));
+        let host = Host::new(None);
+        ctx.spawn(host.clone(), 0).unwrap();
+        wait_for(|| Arc::strong_count(&host.calls) == 1);
+        assert_eq!(idle(&ctx), 0);
+
+        // New threads are still spawned once the idle ones have gone.
+        ctx.spawn(host.clone(), 0).unwrap();
+        wait_for(|| host.calls.lock().unwrap().len() == 2);
+    }
+}
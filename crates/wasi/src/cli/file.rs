@@ -131,6 +131,20 @@ impl InputStream for InputFile {
         buf.truncate(bytes_read);
         StreamResult::Ok(buf.into())
     }
+
+    fn read_into(&mut self, buf: &mut [u8]) -> StreamResult<usize> {
+        if buf.is_empty() {
+            return Ok(0);
+        }
+        let bytes_read = self
+            .file
+            .read(buf)
+            .map_err(|e| StreamError::LastOperationFailed(anyhow::anyhow!(e)))?;
+        if bytes_read == 0 {
+            return Err(StreamError::Closed);
+        }
+        Ok(bytes_read)
+    }
 }
 
 impl AsyncRead for InputFile {
@@ -1,6 +1,7 @@
 use crate::clocks::Datetime;
 use crate::runtime::{AbortOnDropJoinHandle, spawn_blocking};
 use anyhow::Context as _;
+use bytes::Bytes;
 use cap_fs_ext::{FileTypeExt as _, MetadataExt as _};
 use fs_set_times::SystemTimeSpec;
 use std::collections::hash_map;
@@ -17,6 +18,7 @@ impl HasData for WasiFilesystem {
 #[derive(Clone, Default)]
 pub struct WasiFilesystemCtx {
     pub allow_blocking_current_thread: bool,
+    pub io_uring: bool,
     pub preopens: Vec<(Dir, String)>,
 }
 
@@ -618,6 +620,13 @@ impl Descriptor {
     }
 }
 
+/// The largest number of bytes that [`File::read_at`] reads at once.
+///
+/// The length of a read is chosen by the guest, so the buffer allocated for
+/// it is clamped to this. Reads are allowed to return fewer bytes than
+/// requested.
+pub(crate) const MAX_READ_SIZE: usize = 1024 * 1024;
+
 #[derive(Clone)]
 pub struct File {
     /// The operating system File this struct is mediating access to.
@@ -639,6 +648,7 @@ pub struct File {
     pub open_mode: OpenMode,
 
     allow_blocking_current_thread: bool,
+    io_uring: bool,
 }
 
 impl File {
@@ -653,6 +663,7 @@ impl File {
             perms,
             open_mode,
             allow_blocking_current_thread,
+            io_uring: false,
         }
     }
 
@@ -701,6 +712,96 @@ impl File {
         }
     }
 
+    /// Returns whether reads and writes of this file are submitted to
+    /// io_uring rather than performed with [`spawn_blocking`].
+    ///
+    /// See [`crate::WasiCtxBuilder::io_uring`].
+    ///
+    /// [`spawn_blocking`]: Self::spawn_blocking
+    pub(crate) fn uses_io_uring(&self) -> bool {
+        #[cfg(all(feature = "io-uring", target_os = "linux"))]
+        return self.ring().is_some();
+        #[cfg(not(all(feature = "io-uring", target_os = "linux")))]
+        return false;
+    }
+
+    /// Returns the ring that reads and writes of this file are submitted to,
+    /// if any.
+    #[cfg(all(feature = "io-uring", target_os = "linux"))]
+    fn ring(&self) -> Option<&'static crate::uring::Ring> {
+        if self.io_uring && !self.allow_blocking_current_thread {
+            crate::uring::Ring::get()
+        } else {
+            None
+        }
+    }
+
+    /// Reads up to `len` bytes of this file at `offset`, returning an empty
+    /// buffer at the end of the file.
+    ///
+    /// At most [`MAX_READ_SIZE`] bytes are read at once, regardless of `len`,
+    /// to bound the size of the buffer allocated for the read.
+    pub(crate) async fn read_at(&self, len: usize, offset: u64) -> std::io::Result<Vec<u8>> {
+        let len = len.min(MAX_READ_SIZE);
+        #[cfg(all(feature = "io-uring", target_os = "linux"))]
+        if let Some(ring) = self.ring() {
+            if let Some(op) = ring.read_at(&self.file, len, offset) {
+                // Reads are retried below if the ring failed while this one
+                // was in flight.
+                if let Some(result) = op.read().await {
+                    return result;
+                }
+            }
+        }
+        self.run_blocking(move |f| {
+            use system_interface::fs::FileIoExt;
+
+            let mut buf = vec![0; len];
+            loop {
+                match f.read_at(&mut buf, offset) {
+                    Ok(n) => {
+                        buf.truncate(n);
+                        return Ok(buf);
+                    }
+                    Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {}
+                    Err(e) => return Err(e),
+                }
+            }
+        })
+        .await
+    }
+
+    /// Writes `buf` to this file at `offset`, or appends it to the end of the
+    /// file if `offset` is `None`, returning the number of bytes written.
+    pub(crate) async fn write_at(&self, buf: Bytes, offset: Option<u64>) -> std::io::Result<usize> {
+        #[cfg(all(feature = "io-uring", target_os = "linux"))]
+        if let Some(ring) = self.ring() {
+            if let Some(op) = ring.write_at(&self.file, buf.clone(), offset) {
+                // If the ring failed while this write was in flight then it may
+                // or may not have happened. Writing the same bytes at the same
+                // offset again is harmless, but appending them again isn't.
+                match op.write().await {
+                    Some(result) => return result,
+                    None if offset.is_none() => {
+                        return Err(std::io::Error::other(
+                            "io_uring failed during an append to this file",
+                        ));
+                    }
+                    None => {}
+                }
+            }
+        }
+        self.run_blocking(move |f| {
+            use system_interface::fs::FileIoExt;
+
+            match offset {
+                Some(offset) => f.write_at(&buf, offset),
+                None => f.append(&buf),
+            }
+        })
+        .await
+    }
+
     pub(crate) async fn advise(
         &self,
         offset: u64,
@@ -747,6 +848,7 @@ pub struct Dir {
     pub open_mode: OpenMode,
 
     allow_blocking_current_thread: bool,
+    pub(crate) io_uring: bool,
 }
 
 impl Dir {
@@ -763,6 +865,7 @@ impl Dir {
             file_perms,
             open_mode,
             allow_blocking_current_thread,
+            io_uring: false,
         }
     }
 
@@ -971,14 +1074,16 @@ impl Dir {
         // manipulate the table.
         enum OpenResult {
             Dir(cap_std::fs::Dir),
-            File(cap_std::fs::File),
+            /// A file, and whether it's a regular file.
+            File(cap_std::fs::File, bool),
             NotDir,
         }
 
         let opened = self
             .run_blocking::<_, std::io::Result<OpenResult>>(move |d| {
                 let mut opened = d.open_with(&path, &opts)?;
-                if opened.metadata()?.is_dir() {
+                let metadata = opened.metadata()?;
+                if metadata.is_dir() {
                     Ok(OpenResult::Dir(cap_std::fs::Dir::from_std_file(
                         opened.into_std(),
                     )))
@@ -989,26 +1094,35 @@ impl Dir {
                     // are nonblocking. Instead we set it after opening here:
                     let set_fd_flags = opened.new_set_fd_flags(FdFlags::NONBLOCK)?;
                     opened.set_fd_flags(set_fd_flags)?;
-                    Ok(OpenResult::File(opened))
+                    Ok(OpenResult::File(opened, metadata.is_file()))
                 }
             })
             .await?;
 
         match opened {
-            OpenResult::Dir(dir) => Ok(Descriptor::Dir(Dir::new(
-                dir,
-                self.perms,
-                self.file_perms,
-                open_mode,
-                allow_blocking_current_thread,
-            ))),
-
-            OpenResult::File(file) => Ok(Descriptor::File(File::new(
-                file,
-                self.file_perms,
-                open_mode,
-                allow_blocking_current_thread,
-            ))),
+            OpenResult::Dir(dir) => Ok(Descriptor::Dir(Dir {
+                io_uring: self.io_uring,
+                ..Dir::new(
+                    dir,
+                    self.perms,
+                    self.file_perms,
+                    open_mode,
+                    allow_blocking_current_thread,
+                )
+            })),
+
+            // Only regular files use io_uring: reads of FIFOs and devices can
+            // wait indefinitely, which would tie up the kernel's io_uring
+            // workers.
+            OpenResult::File(file, is_regular) => Ok(Descriptor::File(File {
+                io_uring: self.io_uring && is_regular,
+                ..File::new(
+                    file,
+                    self.file_perms,
+                    open_mode,
+                    allow_blocking_current_thread,
+                )
+            })),
 
             OpenResult::NotDir => Err(ErrorCode::NotDirectory),
         }
@@ -1113,3 +1227,60 @@ impl WasiFilesystemCtxView<'_> {
         Ok(results)
     }
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    fn temp_file(io_uring: bool) -> File {
+        let file = cap_std::fs::File::from_std(tempfile::tempfile().unwrap());
+        let mut file = File::new(
+            file,
+            FilePerms::all(),
+            OpenMode::READ | OpenMode::WRITE,
+            false,
+        );
+        file.io_uring = io_uring;
+        file
+    }
+
+    // With `io_uring` enabled this uses io_uring if the host supports it and
+    // otherwise falls back to the thread pool, which must behave the same.
+    #[test_log::test(tokio::test(flavor = "multi_thread"))]
+    async fn read_and_write() {
+        for io_uring in [false, true] {
+            let file = temp_file(io_uring);
+            assert_eq!(
+                file.write_at(Bytes::from_static(b"abc"), Some(0))
+                    .await
+                    .unwrap(),
+                3
+            );
+            assert_eq!(
+                file.write_at(Bytes::from_static(b"def"), None)
+                    .await
+                    .unwrap(),
+                3
+            );
+            assert_eq!(
+                file.write_at(Bytes::from_static(b"C"), Some(2))
+                    .await
+                    .unwrap(),
+                1
+            );
+            assert_eq!(file.read_at(100, 0).await.unwrap(), b"abCdef");
+            assert_eq!(file.read_at(2, 3).await.unwrap(), b"de");
+            assert!(file.read_at(2, 6).await.unwrap().is_empty());
+        }
+    }
+
+    #[test_log::test(tokio::test(flavor = "multi_thread"))]
+    async fn read_is_clamped() {
+        for io_uring in [false, true] {
+            let file = temp_file(io_uring);
+            file.file.set_len(MAX_READ_SIZE as u64 + 1).unwrap();
+            let buf = file.read_at(usize::MAX, 0).await.unwrap();
+            assert_eq!(buf.len(), MAX_READ_SIZE);
+        }
+    }
+}
@@ -30,6 +30,8 @@ pub mod p3;
 pub mod random;
 pub mod runtime;
 pub mod sockets;
+#[cfg(all(feature = "io-uring", target_os = "linux"))]
+mod uring;
 mod view;
 
 pub use self::clocks::{HostMonotonicClock, HostWallClock};
@@ -77,7 +77,9 @@ use crate::p2::bindings::{
 use crate::p2::{FsError, IsATTY};
 use crate::{ResourceTable, WasiCtx, WasiCtxView, WasiView};
 use anyhow::{Context, bail};
+use bytes::BytesMut;
 use std::collections::{BTreeMap, BTreeSet, HashSet, btree_map};
+use std::io::{IoSlice, IoSliceMut};
 use std::mem::{self, size_of, size_of_val};
 use std::slice;
 use std::sync::Arc;
@@ -86,7 +88,7 @@ use system_interface::fs::FileIoExt;
 use wasmtime::component::Resource;
 use wasmtime_wasi_io::{
     bindings::wasi::io::streams,
-    streams::{StreamError, StreamResult},
+    streams::{DynInputStream, StreamError},
 };
 use wiggle::tracing::instrument;
 use wiggle::{GuestError, GuestMemory, GuestPtr, GuestType};
@@ -218,29 +220,29 @@ impl BlockingMode {
     }
     async fn write(
         &self,
-        memory: &mut GuestMemory<'_>,
-        host: &mut impl streams::HostOutputStream,
+        memory: &GuestMemory<'_>,
+        table: &mut ResourceTable,
         output_stream: Resource<streams::OutputStream>,
-        bytes: GuestPtr<[u8]>,
-    ) -> StreamResult<usize> {
-        use streams::HostOutputStream as Streams;
-
-        let bytes = memory
-            .as_cow(bytes)
-            .map_err(|e| StreamError::Trap(e.into()))?;
-        let mut bytes = &bytes[..];
-
-        let total = bytes.len();
-        while !bytes.is_empty() {
-            // NOTE: blocking_write_and_flush takes at most one 4k buffer.
-            let len = bytes.len().min(4096);
-            let (chunk, rest) = bytes.split_at(len);
-            bytes = rest;
-
-            Streams::blocking_write_and_flush(host, output_stream.borrowed(), Vec::from(chunk))
-                .await?
+        ciovs: types::CiovecArray,
+    ) -> Result<usize, types::Error> {
+        // Gather all of the guest's buffers into a single allocation which is
+        // handed to the stream at once. This bypasses the 4k limit of
+        // `blocking-write-and-flush` in the `wasi:io` bindings which would
+        // otherwise require a copy and a write per 4k chunk.
+        let mut bytes = BytesMut::new();
+        for iov in ciovs.iter() {
+            let iov = memory.read(iov?)?;
+            bytes.extend_from_slice(&memory.as_cow(iov.buf.as_array(iov.buf_len))?);
+        }
+        if bytes.is_empty() {
+            return Ok(0);
         }
 
+        let total = bytes.len();
+        table
+            .get_mut(&output_stream)?
+            .blocking_write_and_flush(bytes.freeze())
+            .await?;
         Ok(total)
     }
 }
@@ -579,27 +581,41 @@ impl WasiP1Ctx {
                 let append = *append;
                 drop(t);
                 let f = self.table.get(&fd)?.file()?;
-                let buf = first_non_empty_ciovec(memory, ciovs)?;
-
-                let do_write = move |f: &cap_std::fs::File, buf: &[u8]| match (append, write) {
-                    // Note that this is implementing Linux semantics of
-                    // `pwrite` where the offset is ignored if the file was
-                    // opened in append mode.
-                    (true, _) => f.append(&buf),
-                    (false, FdWrite::At(pos)) => f.write_at(&buf, pos),
-                    (false, FdWrite::AtCur) => f.write_at(&buf, pos),
-                };
 
-                let nwritten = match f.as_blocking_file() {
-                    // If we can block then skip the copy out of wasm memory and
-                    // write directly to `f`.
-                    Some(f) => do_write(f, &memory.as_cow(buf)?),
-                    // ... otherwise copy out of wasm memory and use
-                    // `spawn_blocking` to do this write in a thread that can
-                    // block.
+                // If we can block and wasm memory isn't shared then skip the
+                // copy out of wasm memory and write all of the guest's buffers
+                // directly to `f`.
+                let direct = match f.as_blocking_file() {
+                    Some(f) => match ciovec_slices(memory, ciovs)? {
+                        Some(bufs) => {
+                            let bufs = bufs.iter().map(|b| IoSlice::new(b)).collect::<Vec<_>>();
+                            Some(match (append, write) {
+                                // Note that this is implementing Linux
+                                // semantics of `pwrite` where the offset is
+                                // ignored if the file was opened in append
+                                // mode.
+                                (true, _) => f.append_vectored(&bufs),
+                                (false, FdWrite::At(pos)) => f.write_vectored_at(&bufs, pos),
+                                (false, FdWrite::AtCur) => f.write_vectored_at(&bufs, pos),
+                            })
+                        }
+                        None => None,
+                    },
+                    None => None,
+                };
+                let nwritten = match direct {
+                    Some(nwritten) => nwritten,
+                    // ... otherwise copy out of wasm memory and perform the
+                    // write asynchronously, either through io_uring or on a
+                    // thread that can block.
                     None => {
-                        let buf = memory.to_vec(buf)?;
-                        f.run_blocking(move |f| do_write(f, &buf)).await
+                        let buf = memory.to_vec(first_non_empty_ciovec(memory, ciovs)?)?;
+                        let offset = match (append, write) {
+                            (true, _) => None,
+                            (false, FdWrite::At(pos)) => Some(pos),
+                            (false, FdWrite::AtCur) => Some(pos),
+                        };
+                        f.write_at(buf.into(), offset).await
                     }
                 };
 
@@ -630,9 +646,8 @@ impl WasiP1Ctx {
                 }
                 let stream = stream.borrowed();
                 drop(t);
-                let buf = first_non_empty_ciovec(memory, ciovs)?;
                 let n = BlockingMode::Blocking
-                    .write(memory, &mut self.table, stream, buf)
+                    .write(memory, &mut self.table, stream, ciovs)
                     .await?
                     .try_into()?;
                 Ok(n)
@@ -1160,6 +1175,120 @@ fn first_non_empty_iovec(
     Ok(GuestPtr::new((0, 0)))
 }
 
+// Returns all non-empty buffers in `ciovs` as slices of guest memory, or
+// `None` if they're all empty or guest memory is shared and can't be
+// borrowed.
+fn ciovec_slices<'a>(
+    memory: &'a GuestMemory<'_>,
+    ciovs: types::CiovecArray,
+) -> Result<Option<Vec<&'a [u8]>>> {
+    let mut ptrs = Vec::new();
+    for iov in ciovs.iter() {
+        let iov = memory.read(iov?)?;
+        if iov.buf_len != 0 {
+            ptrs.push(iov.buf.as_array(iov.buf_len));
+        }
+    }
+    let mut slices = Vec::with_capacity(ptrs.len());
+    for ptr in ptrs {
+        match memory.as_slice(ptr)? {
+            Some(slice) => slices.push(slice),
+            None => return Ok(None),
+        }
+    }
+    Ok(if slices.is_empty() {
+        None
+    } else {
+        Some(slices)
+    })
+}
+
+// Returns all non-empty buffers in `iovs` as disjoint mutable slices of guest
+// memory, in the same order as `iovs`, or `None` if they're all empty, guest
+// memory is shared, or the buffers overlap.
+fn iovec_slices_mut<'a>(
+    memory: &'a mut GuestMemory<'_>,
+    iovs: types::IovecArray,
+) -> Result<Option<Vec<&'a mut [u8]>>> {
+    let mut ranges = Vec::new();
+    for iov in iovs.iter() {
+        let iov = memory.read(iov?)?;
+        if iov.buf_len != 0 {
+            // Bounds-check the buffer before slicing below.
+            memory.as_slice(iov.buf.as_array(iov.buf_len))?;
+            let start = usize::try_from(iov.buf.offset())?;
+            ranges.push(start..start + usize::try_from(iov.buf_len)?);
+        }
+    }
+    let GuestMemory::Unshared(mem) = memory else {
+        return Ok(None);
+    };
+    if ranges.is_empty() {
+        return Ok(None);
+    }
+    let mut rest: &mut [u8] = &mut **mem;
+
+    // Split guest memory in order of increasing address, then put the
+    // resulting slices back in the order the guest specified them.
+    let mut order = (0..ranges.len()).collect::<Vec<_>>();
+    order.sort_by_key(|i| ranges[*i].start);
+    let mut slices = ranges.iter().map(|_| None).collect::<Vec<_>>();
+    let mut base = 0;
+    for i in order {
+        let range = &ranges[i];
+        if range.start < base {
+            return Ok(None);
+        }
+        let (_, tail) = mem::take(&mut rest).split_at_mut(range.start - base);
+        let (slice, tail) = tail.split_at_mut(range.len());
+        slices[i] = Some(slice);
+        rest = tail;
+        base = range.end;
+    }
+    Ok(Some(slices.into_iter().map(Option::unwrap).collect()))
+}
+
+// Reads from `stream` directly into the guest buffers `bufs`. This blocks
+// until the first buffer receives at least one byte. Once it's full the
+// following buffers are only filled from data which the stream reports as
+// already buffered, so that a `readv` never issues more than one read of the
+// underlying stream.
+async fn read_into_iovecs(
+    stream: &mut DynInputStream,
+    bufs: Vec<&mut [u8]>,
+) -> Result<usize, types::Error> {
+    let mut bufs = bufs.into_iter();
+    let Some(first) = bufs.next() else {
+        return Ok(0);
+    };
+    let mut total = match stream.blocking_read_into(first).await {
+        Ok(n) if n < first.len() => return Ok(n),
+        Ok(n) => n,
+        Err(StreamError::Closed) => return Ok(0),
+        Err(e) => return Err(e.into()),
+    };
+    for buf in bufs {
+        let read = match stream.buffered_len() {
+            Ok(Some(buffered)) if buffered > 0 => stream.read_into(buf),
+            Ok(_) => break,
+            Err(e) => Err(e),
+        };
+        match read {
+            Ok(n) => {
+                total += n;
+                if n < buf.len() {
+                    break;
+                }
+            }
+            Err(StreamError::Trap(e)) => return Err(types::Error::trap(e)),
+            // Like `readv`, a read which transferred some bytes succeeds
+            // with a short count rather than failing.
+            Err(_) => break,
+        }
+    }
+    Ok(total)
+}
+
 #[async_trait::async_trait]
 // Implement the WasiSnapshotPreview1 trait using only the traits that are
 // required for T, i.e., in terms of the preview 2 wit interface, and state
@@ -1662,29 +1791,36 @@ impl wasi_snapshot_preview1::WasiSnapshotPreview1 for WasiP1Ctx {
                 drop(t);
                 let pos = position.load(Ordering::Relaxed);
                 let file = self.table.get(&fd)?.file()?;
-                let iov = first_non_empty_iovec(memory, iovs)?;
-                let bytes_read = match (file.as_blocking_file(), memory.as_slice_mut(iov)?) {
-                    // Try to read directly into wasm memory where possible
-                    // when the current thread can block and additionally wasm
-                    // memory isn't shared.
-                    (Some(file), Some(mut buf)) => file
-                        .read_at(&mut buf, pos)
-                        .map_err(|e| StreamError::LastOperationFailed(e.into()))?,
-                    // ... otherwise fall back to performing the read on a
-                    // blocking thread and which copies the data back into wasm
-                    // memory.
-                    (_, buf) => {
-                        drop(buf);
-                        let mut buf = vec![0; iov.len() as usize];
+                // Try to read directly into all of the guest's buffers where
+                // possible when the current thread can block and additionally
+                // wasm memory isn't shared.
+                let direct = match file.as_blocking_file() {
+                    Some(file) => match iovec_slices_mut(memory, iovs)? {
+                        Some(mut bufs) => {
+                            let mut bufs = bufs
+                                .iter_mut()
+                                .map(|b| IoSliceMut::new(b))
+                                .collect::<Vec<_>>();
+                            Some(
+                                file.read_vectored_at(&mut bufs, pos)
+                                    .map_err(|e| StreamError::LastOperationFailed(e.into()))?,
+                            )
+                        }
+                        None => None,
+                    },
+                    None => None,
+                };
+                let bytes_read = match direct {
+                    Some(n) => n,
+                    // ... otherwise fall back to performing the read
+                    // asynchronously, either through io_uring or on a blocking
+                    // thread, and copy the data back into wasm memory.
+                    None => {
+                        let iov = first_non_empty_iovec(memory, iovs)?;
                         let buf = file
-                            .run_blocking(move |file| -> Result<_, types::Error> {
-                                let bytes_read = file
-                                    .read_at(&mut buf, pos)
-                                    .map_err(|e| StreamError::LastOperationFailed(e.into()))?;
-                                buf.truncate(bytes_read);
-                                Ok(buf)
-                            })
-                            .await?;
+                            .read_at(iov.len() as usize, pos)
+                            .await
+                            .map_err(|e| StreamError::LastOperationFailed(e.into()))?;
                         let iov = iov.get_range(0..u32::try_from(buf.len())?).unwrap();
                         memory.copy_from_slice(&buf, iov)?;
                         buf.len()
@@ -1701,6 +1837,12 @@ impl wasi_snapshot_preview1::WasiSnapshotPreview1 for WasiP1Ctx {
             Descriptor::Stdin { stream, .. } => {
                 let stream = stream.borrowed();
                 drop(t);
+                // Read straight into the guest's buffers unless wasm memory
+                // is shared, in which case data is copied in below.
+                if let Some(bufs) = iovec_slices_mut(memory, iovs)? {
+                    let n = read_into_iovecs(self.table.get_mut(&stream)?, bufs).await?;
+                    return Ok(n.try_into()?);
+                }
                 let buf = first_non_empty_iovec(memory, iovs)?;
                 let read = BlockingMode::Blocking
                     .read(&mut self.table, stream, buf.len().try_into()?)
@@ -102,6 +102,27 @@ impl FileInputStream {
         }
     }
 
+    /// Starts a background read of up to `size` bytes at the current
+    /// position, using io_uring if the file is configured to do so.
+    fn start_read(&self, size: usize) -> AbortOnDropJoinHandle<ReadState> {
+        let p = self.position;
+        if self.file.uses_io_uring() {
+            let file = self.file.clone();
+            crate::runtime::spawn(async move { Self::read_result(file.read_at(size, p).await) })
+        } else {
+            self.file
+                .spawn_blocking(move |f| Self::blocking_read(f, p, size))
+        }
+    }
+
+    fn read_result(result: io::Result<Vec<u8>>) -> ReadState {
+        match result {
+            Ok(buf) if buf.is_empty() => ReadState::Closed,
+            Ok(buf) => ReadState::DataAvailable(buf.into()),
+            Err(e) => ReadState::Error(e),
+        }
+    }
+
     /// Wait for existing background task to finish, without starting any new background reads.
     async fn wait_ready(&mut self) {
         match &mut self.state {
@@ -121,11 +142,7 @@ impl InputStream for FileInputStream {
                     return Ok(Bytes::new());
                 }
 
-                let p = self.position;
-                self.state = ReadState::Waiting(
-                    self.file
-                        .spawn_blocking(move |f| Self::blocking_read(f, p, size)),
-                );
+                self.state = ReadState::Waiting(self.start_read(size));
                 Ok(Bytes::new())
             }
             ReadState::DataAvailable(b) => {
@@ -153,10 +170,13 @@ impl InputStream for FileInputStream {
         // Before we defer to the regular `read`, make sure it has data ready to go:
         if let ReadState::Idle = self.state {
             let p = self.position;
-            self.state = self
-                .file
-                .run_blocking(move |f| Self::blocking_read(f, p, size))
-                .await;
+            self.state = if self.file.uses_io_uring() {
+                Self::read_result(self.file.read_at(size, p).await)
+            } else {
+                self.file
+                    .run_blocking(move |f| Self::blocking_read(f, p, size))
+                    .await
+            };
         }
 
         self.read(size)
@@ -188,11 +208,7 @@ impl Pollable for FileInputStream {
             // for data to be available. We'll start a read for them:
 
             const DEFAULT_READ_SIZE: usize = 4096;
-            let p = self.position;
-            self.state = ReadState::Waiting(
-                self.file
-                    .spawn_blocking(move |f| Self::blocking_read(f, p, DEFAULT_READ_SIZE)),
-            );
+            self.state = ReadState::Waiting(self.start_read(DEFAULT_READ_SIZE));
         }
 
         self.wait_ready().await
@@ -274,6 +290,27 @@ impl FileOutputStream {
             }
         }
     }
+
+    /// Same as `blocking_write`, but submits each write to io_uring.
+    async fn uring_write(file: File, mut buf: Bytes, mode: FileOutputMode) -> io::Result<usize> {
+        let mut offset = match mode {
+            FileOutputMode::Position(p) => Some(p),
+            FileOutputMode::Append => None,
+        };
+        let mut total = 0;
+        while !buf.is_empty() {
+            let nwritten = file.write_at(buf.clone(), offset).await?;
+            if nwritten == 0 {
+                return Err(io::ErrorKind::WriteZero.into());
+            }
+            let _ = buf.split_to(nwritten);
+            if let Some(p) = &mut offset {
+                *p += nwritten as u64;
+            }
+            total += nwritten;
+        }
+        Ok(total)
+    }
 }
 
 // FIXME: configurable? determine from how much space left in file?
@@ -294,10 +331,12 @@ impl OutputStream for FileOutputStream {
         }
 
         let m = self.mode;
-        self.state = OutputState::Waiting(
+        self.state = OutputState::Waiting(if self.file.uses_io_uring() {
+            crate::runtime::spawn(Self::uring_write(self.file.clone(), buf, m))
+        } else {
             self.file
-                .spawn_blocking(move |f| Self::blocking_write(f, buf, m)),
-        );
+                .spawn_blocking(move |f| Self::blocking_write(f, buf, m))
+        });
         Ok(())
     }
     /// Specialized blocking_* variant to bypass tokio's task spawning & joining
@@ -316,11 +355,14 @@ impl OutputStream for FileOutputStream {
         }
 
         let m = self.mode;
-        match self
-            .file
-            .run_blocking(move |f| Self::blocking_write(f, buf, m))
-            .await
-        {
+        let result = if self.file.uses_io_uring() {
+            Self::uring_write(self.file.clone(), buf, m).await
+        } else {
+            self.file
+                .run_blocking(move |f| Self::blocking_write(f, buf, m))
+                .await
+        };
+        match result {
             Ok(nwritten) => {
                 if let FileOutputMode::Position(p) = &mut self.mode {
                     *p += nwritten as u64;
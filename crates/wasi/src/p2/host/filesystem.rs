@@ -105,28 +105,15 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         len: types::Filesize,
         offset: types::Filesize,
     ) -> FsResult<(Vec<u8>, bool)> {
-        use std::io::IoSliceMut;
-        use system_interface::fs::FileIoExt;
-
         let f = self.table.get(&fd)?.file()?;
         if !f.perms.contains(FilePerms::READ) {
             return Err(ErrorCode::NotPermitted.into());
         }
 
-        let (mut buffer, r) = f
-            .run_blocking(move |f| {
-                let mut buffer = vec![0; len.try_into().unwrap_or(usize::MAX)];
-                let r = f.read_vectored_at(&mut [IoSliceMut::new(&mut buffer)], offset);
-                (buffer, r)
-            })
-            .await;
-
-        let (bytes_read, state) = match r? {
-            0 => (0, true),
-            n => (n, false),
-        };
-
-        buffer.truncate(bytes_read);
+        let buffer = f
+            .read_at(len.try_into().unwrap_or(usize::MAX), offset)
+            .await?;
+        let state = buffer.is_empty();
 
         Ok((buffer, state))
     }
@@ -137,17 +124,12 @@ impl HostDescriptor for WasiFilesystemCtxView<'_> {
         buf: Vec<u8>,
         offset: types::Filesize,
     ) -> FsResult<types::Filesize> {
-        use std::io::IoSlice;
-        use system_interface::fs::FileIoExt;
-
         let f = self.table.get(&fd)?.file()?;
         if !f.perms.contains(FilePerms::WRITE) {
             return Err(ErrorCode::NotPermitted.into());
         }
 
-        let bytes_written = f
-            .run_blocking(move |f| f.write_vectored_at(&[IoSlice::new(&buf)], offset))
-            .await?;
+        let bytes_written = f.write_at(buf.into(), Some(offset)).await?;
 
         Ok(types::Filesize::try_from(bytes_written).expect("usize fits in Filesize"))
     }
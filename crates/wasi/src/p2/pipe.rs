@@ -8,7 +8,7 @@
 //! but the virtual pipes can be instantiated with any `Read` or `Write` type.
 //!
 use anyhow::anyhow;
-use bytes::Bytes;
+use bytes::{Buf, Bytes};
 use std::pin::{Pin, pin};
 use std::sync::{Arc, Mutex};
 use std::task::{Context, Poll};
@@ -50,6 +50,26 @@ impl InputStream for MemoryInputPipe {
         let read = buffer.split_to(size);
         Ok(read)
     }
+
+    fn read_into(&mut self, buf: &mut [u8]) -> Result<usize, StreamError> {
+        let mut buffer = self.buffer.lock().unwrap();
+        if buffer.is_empty() {
+            return Err(StreamError::Closed);
+        }
+
+        let size = buf.len().min(buffer.len());
+        buf[..size].copy_from_slice(&buffer[..size]);
+        buffer.advance(size);
+        Ok(size)
+    }
+
+    fn buffered_len(&mut self) -> Result<Option<usize>, StreamError> {
+        let buffer = self.buffer.lock().unwrap();
+        if buffer.is_empty() {
+            return Err(StreamError::Closed);
+        }
+        Ok(Some(buffer.len()))
+    }
 }
 
 #[async_trait::async_trait]
@@ -246,6 +266,15 @@ impl InputStream for AsyncReadStream {
         }
     }
 
+    fn buffered_len(&mut self) -> Result<Option<usize>, StreamError> {
+        // Only count what's left over from a previous read, without taking
+        // anything new from the background task.
+        match &self.buffer {
+            Some(Ok(bytes)) => Ok(Some(bytes.len())),
+            _ => Ok(Some(0)),
+        }
+    }
+
     async fn cancel(&mut self) {
         match self.join_handle.take() {
             Some(task) => _ = task.cancel().await,
@@ -367,6 +396,27 @@ mod test {
         (read_half, write_half)
     }
 
+    #[test]
+    fn memory_input_pipe_read_into() {
+        let mut reader = MemoryInputPipe::new("hello, world");
+
+        let mut buf = [0; 5];
+        assert_eq!(reader.buffered_len().unwrap(), Some(12));
+        assert_eq!(reader.read_into(&mut buf).unwrap(), 5);
+        assert_eq!(&buf, b"hello");
+
+        let mut buf = [0; 16];
+        assert_eq!(reader.buffered_len().unwrap(), Some(7));
+        assert_eq!(reader.read_into(&mut buf).unwrap(), 7);
+        assert_eq!(&buf[..7], b", world");
+
+        assert!(matches!(reader.buffered_len(), Err(StreamError::Closed)));
+        assert!(matches!(
+            reader.read_into(&mut buf),
+            Err(StreamError::Closed)
+        ));
+    }
+
     #[test_log::test(tokio::test(flavor = "multi_thread"))]
     async fn empty_read_stream() {
         let mut reader = AsyncReadStream::new(tokio::io::empty());
@@ -0,0 +1,746 @@
+//! An io_uring backend for reads and writes of regular files on Linux.
+//!
+//! By default filesystem operations are moved onto Tokio's blocking thread
+//! pool with `spawn_blocking`, which costs a thread handoff for every read and
+//! write. When enabled with
+//! [`WasiCtxBuilder::io_uring`](crate::WasiCtxBuilder::io_uring), reads and
+//! writes are instead submitted to an io_uring directly from the async context
+//! performing them.
+//!
+//! The process has one ring per core, created on first use, and each thread
+//! submits to the same ring every time. Rings are locked only to update their
+//! bookkeeping, and never while entering the kernel. Operations which the
+//! kernel completes while submitting them, such as reads served from the page
+//! cache, are reaped by the task which submitted them the first time it's
+//! polled, without leaving its thread. Each ring also has a thread which waits
+//! for the remaining completions and wakes the tasks which submitted them.
+//! Completions don't depend on any particular Tokio runtime, so operations
+//! may be submitted from any number of runtimes, including ones created one
+//! after another on the same thread.
+//!
+//! If io_uring isn't available, for example because the kernel is too old to
+//! support reads and writes through it or because it's disabled by a seccomp
+//! policy, then `Ring::get` returns `None` and callers fall back to
+//! `spawn_blocking`. The same happens once a ring has failed: its pending
+//! operations complete with `None`, and callers retry them the same way.
+
+use bytes::Bytes;
+use rustix::io_uring::{
+    IORING_OFF_CQ_RING, IORING_OFF_SQ_RING, IORING_OFF_SQES, IoringEnterFlags, IoringOp,
+    IoringOpFlags, IoringRegisterOp, io_uring_cqe, io_uring_enter, io_uring_params,
+    io_uring_register, io_uring_setup, io_uring_sqe, io_uring_user_data,
+};
+use rustix::mm::{MapFlags, ProtFlags, mmap, munmap};
+use std::ffi::c_void;
+use std::future::Future;
+use std::io;
+use std::mem;
+use std::os::fd::{AsFd, AsRawFd, OwnedFd};
+use std::pin::Pin;
+use std::sync::atomic::{AtomicBool, AtomicU32, AtomicUsize, Ordering};
+use std::sync::{Arc, Mutex, MutexGuard, OnceLock};
+use std::task::{Context, Poll, Waker};
+
+/// Number of submission queue entries requested for each ring.
+///
+/// This bounds the number of operations which have been queued but not yet
+/// consumed by the kernel, while the number of operations in flight is
+/// bounded by the size of the completion queue.
+const ENTRIES: u32 = 64;
+
+/// Maximum number of rings created, regardless of the number of cores.
+const MAX_RINGS: usize = 16;
+
+/// One of the process's io_uring instances.
+pub(crate) struct Ring {
+    fd: OwnedFd,
+    /// Set once waiting for completions has failed, after which nothing more
+    /// is submitted to this ring.
+    dead: AtomicBool,
+    inner: Mutex<Inner>,
+}
+
+struct Inner {
+    _sq_ring: Mapping,
+    _cq_ring: Mapping,
+    _sqes: Mapping,
+    sq_head: *const AtomicU32,
+    sq_tail: *const AtomicU32,
+    sq_mask: u32,
+    sq_entries: u32,
+    sq_array: *mut u32,
+    sqes: *mut io_uring_sqe,
+    cq_head: *const AtomicU32,
+    cq_tail: *const AtomicU32,
+    cq_mask: u32,
+    cqes: *const io_uring_cqe,
+    cq_entries: usize,
+    ops: Vec<Op>,
+    free: Vec<usize>,
+    in_flight: usize,
+}
+
+// SAFETY: the raw pointers in `Inner` point into mappings of the ring which
+// are owned by `Inner` itself and only accessed while holding the mutex.
+unsafe impl Send for Inner {}
+
+/// State of an operation submitted to the ring.
+enum Op {
+    Free,
+    /// The operation is in flight and the `Completion` for it is waiting.
+    Pending {
+        waker: Option<Waker>,
+        buf: Buffer,
+    },
+    /// The operation has finished but its `Completion` hasn't observed it
+    /// yet.
+    Done {
+        result: i32,
+        buf: Buffer,
+    },
+    /// The ring failed while the operation was in flight, so it may or may
+    /// not have been performed. Its resources have been leaked as the kernel
+    /// may still be using them.
+    Failed,
+    /// The `Completion` for this in-flight operation was dropped. The
+    /// operation's resources are kept alive until the kernel is done with
+    /// them.
+    Abandoned {
+        _buf: Buffer,
+    },
+}
+
+/// The resources used by an operation, which must outlive it.
+pub(crate) struct Buffer {
+    _file: Arc<cap_std::fs::File>,
+    data: Data,
+}
+
+enum Data {
+    Read(Vec<u8>),
+    Write { _buf: Bytes },
+}
+
+impl Ring {
+    /// Returns the ring for the current thread, creating it if necessary.
+    ///
+    /// Returns `None` if io_uring, or reading and writing through it, isn't
+    /// available on this host, or if the ring has failed.
+    pub(crate) fn get() -> Option<&'static Ring> {
+        static RINGS: OnceLock<Vec<OnceLock<Option<&'static Ring>>>> = OnceLock::new();
+        static NEXT_RING: AtomicUsize = AtomicUsize::new(0);
+        thread_local! {
+            static RING_INDEX: usize = NEXT_RING.fetch_add(1, Ordering::Relaxed);
+        }
+
+        let rings = RINGS.get_or_init(|| {
+            let n = std::thread::available_parallelism().map_or(1, |n| n.get());
+            (0..n.min(MAX_RINGS)).map(|_| OnceLock::new()).collect()
+        });
+        let index = RING_INDEX.with(|i| *i) % rings.len();
+        let ring = rings[index].get_or_init(|| match Ring::new() {
+            Ok(ring) => Some(ring),
+            Err(e) => {
+                tracing::debug!("io_uring is unavailable, falling back: {e}");
+                None
+            }
+        })?;
+        if ring.dead.load(Ordering::Relaxed) {
+            return None;
+        }
+        Some(ring)
+    }
+
+    fn new() -> io::Result<&'static Ring> {
+        let mut params = io_uring_params::default();
+        // SAFETY: `params` is a valid, zero-initialized parameter block.
+        let fd = unsafe { io_uring_setup(ENTRIES, &mut params)? };
+
+        // `IORING_OP_READ` and `IORING_OP_WRITE` are newer than io_uring
+        // itself, and on kernels which don't support them each operation
+        // fails with `EINVAL`, so check for them up front.
+        for op in [IoringOp::Read, IoringOp::Write] {
+            if !probe(&fd, op) {
+                return Err(io::Error::new(
+                    io::ErrorKind::Unsupported,
+                    format!("io_uring doesn't support {op:?}"),
+                ));
+            }
+        }
+
+        let sq_len = params.sq_off.array as usize + params.sq_entries as usize * 4;
+        let cq_len = params.cq_off.cqes as usize
+            + params.cq_entries as usize * mem::size_of::<io_uring_cqe>();
+        let sqes_len = params.sq_entries as usize * mem::size_of::<io_uring_sqe>();
+        let sq_ring = Mapping::new(&fd, sq_len, IORING_OFF_SQ_RING)?;
+        let cq_ring = Mapping::new(&fd, cq_len, IORING_OFF_CQ_RING)?;
+        let sqes = Mapping::new(&fd, sqes_len, IORING_OFF_SQES)?;
+
+        // SAFETY: the offsets are provided by the kernel and are in-bounds
+        // of the mappings created above.
+        let inner = unsafe {
+            let sq = |off: u32| sq_ring.ptr.byte_add(off as usize);
+            let cq = |off: u32| cq_ring.ptr.byte_add(off as usize);
+            Inner {
+                sq_head: sq(params.sq_off.head).cast(),
+                sq_tail: sq(params.sq_off.tail).cast(),
+                sq_mask: *sq(params.sq_off.ring_mask).cast::<u32>(),
+                sq_entries: params.sq_entries,
+                sq_array: sq(params.sq_off.array).cast(),
+                sqes: sqes.ptr.cast(),
+                cq_head: cq(params.cq_off.head).cast(),
+                cq_tail: cq(params.cq_off.tail).cast(),
+                cq_mask: *cq(params.cq_off.ring_mask).cast::<u32>(),
+                cqes: cq(params.cq_off.cqes).cast(),
+                cq_entries: params.cq_entries as usize,
+                _sq_ring: sq_ring,
+                _cq_ring: cq_ring,
+                _sqes: sqes,
+                ops: Vec::new(),
+                free: Vec::new(),
+                in_flight: 0,
+            }
+        };
+
+        // The ring lives for the rest of the process, as does the thread
+        // which waits for its completions.
+        let ring: &'static Ring = Box::leak(Box::new(Ring {
+            fd,
+            dead: AtomicBool::new(false),
+            inner: Mutex::new(inner),
+        }));
+        std::thread::Builder::new()
+            .name("wasi-io-uring".to_string())
+            .spawn(move || ring.drive())?;
+        Ok(ring)
+    }
+
+    /// Waits for completions and reaps them until waiting fails.
+    fn drive(&self) {
+        loop {
+            // SAFETY: this doesn't submit anything, it only waits for at least
+            // one completion to be available.
+            let result = unsafe { io_uring_enter(&self.fd, 0, 1, IoringEnterFlags::GETEVENTS) };
+            match result {
+                Ok(_) | Err(rustix::io::Errno::INTR) => {}
+                Err(e) => {
+                    tracing::error!("failed to wait for io_uring completions: {e}");
+                    self.fail();
+                    return;
+                }
+            }
+            if self.dead.load(Ordering::Relaxed) {
+                return;
+            }
+            self.reap();
+        }
+    }
+
+    fn lock(&self) -> MutexGuard<'_, Inner> {
+        self.inner.lock().unwrap()
+    }
+
+    fn reap(&self) {
+        let wakers = self.reap_locked(&mut self.lock());
+        for waker in wakers {
+            waker.wake();
+        }
+    }
+
+    /// Records all available completions, returning the wakers of the tasks
+    /// waiting for them.
+    ///
+    /// Nothing is reaped once the ring has failed, as the operations which
+    /// were pending then have already been failed and their buffers leaked.
+    fn reap_locked(&self, inner: &mut Inner) -> Vec<Waker> {
+        if self.dead.load(Ordering::Relaxed) {
+            return Vec::new();
+        }
+        inner.reap()
+    }
+
+    /// Marks this ring as dead and fails all of its pending operations, whose
+    /// resources are leaked as the kernel may never release them.
+    fn fail(&self) {
+        self.dead.store(true, Ordering::Relaxed);
+        let mut wakers = Vec::new();
+        {
+            let mut inner = self.lock();
+            for index in 0..inner.ops.len() {
+                match mem::replace(&mut inner.ops[index], Op::Failed) {
+                    Op::Pending { waker, buf } => {
+                        mem::forget(buf);
+                        wakers.extend(waker);
+                    }
+                    Op::Abandoned { _buf: buf } => {
+                        mem::forget(buf);
+                        inner.release(index);
+                    }
+                    op @ (Op::Free | Op::Done { .. } | Op::Failed) => inner.ops[index] = op,
+                }
+            }
+        }
+        for waker in wakers {
+            waker.wake();
+        }
+    }
+
+    /// Reads up to `len` bytes of `file` at `offset`.
+    ///
+    /// Returns `None` if the operation couldn't be submitted, in which case
+    /// the caller should fall back to performing it some other way.
+    pub(crate) fn read_at(
+        &'static self,
+        file: &Arc<cap_std::fs::File>,
+        len: usize,
+        offset: u64,
+    ) -> Option<Completion> {
+        let mut buf = vec![0; len.min(u32::MAX as usize)];
+        let mut sqe = io_uring_sqe::default();
+        sqe.opcode = IoringOp::Read;
+        sqe.fd = file.as_fd().as_raw_fd();
+        sqe.off_or_addr2.off = offset;
+        sqe.addr_or_splice_off_in.addr = buf.as_mut_ptr().cast::<c_void>().into();
+        sqe.len.len = buf.len() as u32;
+        self.submit(
+            sqe,
+            Buffer {
+                _file: file.clone(),
+                data: Data::Read(buf),
+            },
+        )
+    }
+
+    /// Writes `buf` to `file` at `offset`, or appends it to the end of the
+    /// file if `offset` is `None`.
+    ///
+    /// Returns `None` if the operation couldn't be submitted, in which case
+    /// the caller should fall back to performing it some other way.
+    pub(crate) fn write_at(
+        &'static self,
+        file: &Arc<cap_std::fs::File>,
+        buf: Bytes,
+        offset: Option<u64>,
+    ) -> Option<Completion> {
+        let mut sqe = io_uring_sqe::default();
+        sqe.opcode = IoringOp::Write;
+        sqe.fd = file.as_fd().as_raw_fd();
+        match offset {
+            Some(offset) => sqe.off_or_addr2.off = offset,
+            None => sqe.op_flags.rw_flags = rustix::io::ReadWriteFlags::APPEND,
+        }
+        sqe.addr_or_splice_off_in.addr = buf.as_ptr().cast_mut().cast::<c_void>().into();
+        sqe.len.len = buf.len().min(u32::MAX as usize) as u32;
+        self.submit(
+            sqe,
+            Buffer {
+                _file: file.clone(),
+                data: Data::Write { _buf: buf },
+            },
+        )
+    }
+
+    fn submit(&'static self, mut sqe: io_uring_sqe, buf: Buffer) -> Option<Completion> {
+        let index = {
+            let mut inner = self.lock();
+            if self.dead.load(Ordering::Relaxed) {
+                return None;
+            }
+            // Don't allow more operations in flight than there are completion
+            // queue entries so completions are never dropped, nor more queued
+            // than fit in the submission queue.
+            //
+            // SAFETY: the head and tail point into the submission ring.
+            let queued = unsafe {
+                (*inner.sq_tail)
+                    .load(Ordering::Relaxed)
+                    .wrapping_sub((*inner.sq_head).load(Ordering::Acquire))
+            };
+            if inner.in_flight >= inner.cq_entries || queued >= inner.sq_entries {
+                return None;
+            }
+            let index = match inner.free.pop() {
+                Some(index) => index,
+                None => {
+                    inner.ops.push(Op::Free);
+                    inner.ops.len() - 1
+                }
+            };
+            sqe.user_data = io_uring_user_data::from_u64(index as u64);
+
+            // The operation is recorded before the kernel can see it, as it
+            // may complete as soon as it's submitted by another thread.
+            inner.ops[index] = Op::Pending { waker: None, buf };
+            inner.in_flight += 1;
+
+            // SAFETY: the tail of the submission ring is only modified while
+            // holding the lock, and there's space for a new entry as checked
+            // above. The buffer pointed to by `sqe` is kept alive in
+            // `inner.ops` until the operation completes, or leaked if the
+            // ring fails.
+            unsafe {
+                let tail = (*inner.sq_tail).load(Ordering::Relaxed);
+                let slot = tail & inner.sq_mask;
+                *inner.sqes.add(slot as usize) = sqe;
+                *inner.sq_array.add(slot as usize) = slot;
+                (*inner.sq_tail).store(tail.wrapping_add(1), Ordering::Release);
+            }
+            index
+        };
+
+        // Enter the kernel without holding the lock. The kernel consumes
+        // entries in order up to the tail, so this may submit entries queued
+        // by other threads and theirs may submit this one, but each queued
+        // entry is followed by a call here so none are left behind.
+        loop {
+            // SAFETY: the entries in the submission ring are all valid, see
+            // above.
+            match unsafe { io_uring_enter(&self.fd, 1, 0, IoringEnterFlags::empty()) } {
+                Ok(_) => break,
+                Err(rustix::io::Errno::INTR) => {}
+                Err(e) => {
+                    tracing::error!("failed to submit to io_uring: {e}");
+                    self.fail();
+                    break;
+                }
+            }
+        }
+
+        Some(Completion {
+            ring: self,
+            index,
+            done: false,
+        })
+    }
+}
+
+impl Inner {
+    /// See `Ring::reap_locked`.
+    fn reap(&mut self) -> Vec<Waker> {
+        let mut wakers = Vec::new();
+        // SAFETY: the head and tail point into the completion ring, and the
+        // entries between them have been filled in by the kernel.
+        unsafe {
+            let mut head = (*self.cq_head).load(Ordering::Relaxed);
+            let tail = (*self.cq_tail).load(Ordering::Acquire);
+            while head != tail {
+                let cqe = &*self.cqes.add((head & self.cq_mask) as usize);
+                let index = cqe.user_data.u64_() as usize;
+                let result = cqe.res;
+                wakers.extend(self.complete(index, result));
+                head = head.wrapping_add(1);
+            }
+            (*self.cq_head).store(head, Ordering::Release);
+        }
+        wakers
+    }
+
+    fn complete(&mut self, index: usize, result: i32) -> Option<Waker> {
+        match mem::replace(&mut self.ops[index], Op::Free) {
+            Op::Pending { waker, buf } => {
+                self.ops[index] = Op::Done { result, buf };
+                waker
+            }
+            Op::Abandoned { .. } => {
+                self.release(index);
+                None
+            }
+            // Nothing is reaped after the ring fails, see `Ring::reap_locked`.
+            Op::Free | Op::Done { .. } | Op::Failed => unreachable!(),
+        }
+    }
+
+    fn release(&mut self, index: usize) {
+        self.ops[index] = Op::Free;
+        self.free.push(index);
+        self.in_flight -= 1;
+    }
+}
+
+/// A future for the completion of an operation submitted to a `Ring`.
+///
+/// This resolves to `None` if the ring failed before the operation completed,
+/// in which case it may or may not have been performed.
+pub(crate) struct Completion {
+    ring: &'static Ring,
+    index: usize,
+    done: bool,
+}
+
+impl Completion {
+    /// Waits for a read to complete, returning the bytes read.
+    pub(crate) async fn read(self) -> Option<io::Result<Vec<u8>>> {
+        let (n, buf) = self.await?;
+        match buf.data {
+            Data::Read(mut buf) => Some(n.map(|n| {
+                buf.truncate(n);
+                buf
+            })),
+            Data::Write { .. } => unreachable!(),
+        }
+    }
+
+    /// Waits for a write to complete, returning the number of bytes written.
+    pub(crate) async fn write(self) -> Option<io::Result<usize>> {
+        Some(self.await?.0)
+    }
+}
+
+impl Future for Completion {
+    type Output = Option<(io::Result<usize>, Buffer)>;
+
+    fn poll(mut self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let ring = self.ring;
+        let mut inner = ring.lock();
+        // Reap here first, so that operations which completed while being
+        // submitted don't have to wait for the ring's thread.
+        let wakers = ring.reap_locked(&mut inner);
+        let output = match &mut inner.ops[self.index] {
+            Op::Pending { waker, .. } => {
+                if !waker.as_ref().is_some_and(|w| w.will_wake(cx.waker())) {
+                    *waker = Some(cx.waker().clone());
+                }
+                Poll::Pending
+            }
+            op @ Op::Done { .. } => {
+                let Op::Done { result, buf } = mem::replace(op, Op::Free) else {
+                    unreachable!()
+                };
+                inner.release(self.index);
+                self.done = true;
+                let result = if result < 0 {
+                    Err(io::Error::from_raw_os_error(-result))
+                } else {
+                    Ok(result as usize)
+                };
+                Poll::Ready(Some((result, buf)))
+            }
+            Op::Failed => {
+                inner.release(self.index);
+                self.done = true;
+                Poll::Ready(None)
+            }
+            Op::Free | Op::Abandoned { .. } => unreachable!(),
+        };
+        drop(inner);
+        for waker in wakers {
+            if !waker.will_wake(cx.waker()) {
+                waker.wake();
+            }
+        }
+        output
+    }
+}
+
+impl Drop for Completion {
+    fn drop(&mut self) {
+        if self.done {
+            return;
+        }
+        let mut inner = self.ring.lock();
+        match mem::replace(&mut inner.ops[self.index], Op::Free) {
+            Op::Pending { buf, .. } => inner.ops[self.index] = Op::Abandoned { _buf: buf },
+            Op::Done { .. } | Op::Failed => inner.release(self.index),
+            Op::Free | Op::Abandoned { .. } => unreachable!(),
+        }
+    }
+}
+
+/// Returns whether the kernel supports `op` on the ring `fd`.
+fn probe(fd: &OwnedFd, op: IoringOp) -> bool {
+    // This mirrors `io_uring_probe` with room for every possible operation,
+    // using plain integers as the kernel may report operations which don't
+    // have an `IoringOp` variant.
+    #[repr(C)]
+    #[allow(dead_code, reason = "filled in by the kernel")]
+    struct Probe {
+        last_op: u8,
+        ops_len: u8,
+        resv: u16,
+        resv2: [u32; 3],
+        ops: [ProbeOp; 256],
+    }
+    #[repr(C)]
+    #[derive(Clone, Copy)]
+    #[allow(dead_code, reason = "filled in by the kernel")]
+    struct ProbeOp {
+        op: u8,
+        resv: u8,
+        flags: u16,
+        resv2: u32,
+    }
+
+    let mut probe = Box::new(Probe {
+        last_op: 0,
+        ops_len: 0,
+        resv: 0,
+        resv2: [0; 3],
+        ops: [ProbeOp {
+            op: 0,
+            resv: 0,
+            flags: 0,
+            resv2: 0,
+        }; 256],
+    });
+    // SAFETY: `IORING_REGISTER_PROBE` fills in a probe followed by at most
+    // the given number of operations, which fit in `probe`. Kernels which
+    // predate `IORING_OP_READ` and `IORING_OP_WRITE` don't support probing
+    // either, so an error means the operation isn't supported.
+    let result = unsafe {
+        io_uring_register(
+            fd,
+            IoringRegisterOp::RegisterProbe,
+            (&raw mut *probe).cast(),
+            probe.ops.len() as u32,
+        )
+    };
+    if result.is_err() {
+        return false;
+    }
+    let index = op as usize;
+    index < usize::from(probe.ops_len)
+        && IoringOpFlags::from_bits_retain(probe.ops[index].flags)
+            .contains(IoringOpFlags::SUPPORTED)
+}
+
+/// A shared mapping of one of the regions of a ring.
+struct Mapping {
+    ptr: *mut c_void,
+    len: usize,
+}
+
+impl Mapping {
+    fn new(fd: &OwnedFd, len: usize, offset: u64) -> io::Result<Mapping> {
+        // SAFETY: this creates a new mapping which doesn't alias any other
+        // memory.
+        let ptr = unsafe {
+            mmap(
+                std::ptr::null_mut(),
+                len,
+                ProtFlags::READ | ProtFlags::WRITE,
+                MapFlags::SHARED | MapFlags::POPULATE,
+                fd,
+                offset,
+            )?
+        };
+        Ok(Mapping { ptr, len })
+    }
+}
+
+impl Drop for Mapping {
+    fn drop(&mut self) {
+        // SAFETY: this mapping was created in `Mapping::new` and is no longer
+        // used.
+        unsafe {
+            let _ = munmap(self.ptr, self.len);
+        }
+    }
+}
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    fn temp_file() -> Arc<cap_std::fs::File> {
+        Arc::new(cap_std::fs::File::from_std(tempfile::tempfile().unwrap()))
+    }
+
+    #[test_log::test(tokio::test(flavor = "multi_thread"))]
+    async fn read_and_write() {
+        let Some(ring) = Ring::get() else {
+            return;
+        };
+        let file = temp_file();
+
+        let op = ring.write_at(&file, Bytes::from_static(b"hello"), Some(0));
+        assert_eq!(op.unwrap().write().await.unwrap().unwrap(), 5);
+        let op = ring.write_at(&file, Bytes::from_static(b" world"), None);
+        assert_eq!(op.unwrap().write().await.unwrap().unwrap(), 6);
+
+        let op = ring.read_at(&file, 100, 0);
+        assert_eq!(op.unwrap().read().await.unwrap().unwrap(), b"hello world");
+        let op = ring.read_at(&file, 5, 6);
+        assert_eq!(op.unwrap().read().await.unwrap().unwrap(), b"world");
+        let op = ring.read_at(&file, 5, 100);
+        assert!(op.unwrap().read().await.unwrap().unwrap().is_empty());
+    }
+
+    #[test_log::test]
+    fn runtimes_on_one_thread() {
+        let Some(ring) = Ring::get() else {
+            return;
+        };
+        let file = temp_file();
+
+        // Completions must not depend on the runtime which first used the
+        // ring, which is gone by the time the later ones submit operations.
+        for i in 0..3u8 {
+            let rt = tokio::runtime::Builder::new_current_thread()
+                .build()
+                .unwrap();
+            rt.block_on(async {
+                let op = ring.write_at(&file, Bytes::from(vec![i]), Some(u64::from(i)));
+                assert_eq!(op.unwrap().write().await.unwrap().unwrap(), 1);
+                let op = ring.read_at(&file, 1, u64::from(i));
+                assert_eq!(op.unwrap().read().await.unwrap().unwrap(), [i]);
+            });
+        }
+    }
+
+    #[test_log::test(tokio::test(flavor = "multi_thread"))]
+    async fn many_in_flight() {
+        let Some(ring) = Ring::get() else {
+            return;
+        };
+        let file = temp_file();
+        let op = ring.write_at(&file, Bytes::from(vec![1; 4096]), Some(0));
+        op.unwrap().write().await.unwrap().unwrap();
+
+        // More reads than there are completion queue entries are submitted,
+        // and the ones which can't be are performed by the caller instead.
+        let ops = (0..1000)
+            .map(|_| ring.read_at(&file, 4096, 0))
+            .collect::<Vec<_>>();
+        for op in ops.into_iter().flatten() {
+            assert_eq!(op.read().await.unwrap().unwrap().len(), 4096);
+        }
+
+        // Dropping operations before they complete is fine too.
+        for _ in 0..1000 {
+            drop(ring.read_at(&file, 4096, 0));
+        }
+        let op = loop {
+            // Wait for the abandoned reads to leave room for another.
+            match ring.read_at(&file, 4, 0) {
+                Some(op) => break op,
+                None => tokio::task::yield_now().await,
+            }
+        };
+        assert_eq!(op.read().await.unwrap().unwrap(), [1; 4]);
+    }
+
+    #[test_log::test(tokio::test(flavor = "multi_thread"))]
+    async fn failed_ring() {
+        if Ring::get().is_none() {
+            return;
+        }
+        // Use a ring of its own rather than failing the one other tests use.
+        let ring = Ring::new().unwrap();
+
+        // A read of an empty pipe, at its current position, stays in flight
+        // until the ring fails, and then completes without a result so that
+        // the caller falls back.
+        let (reader, _writer) = std::io::pipe().unwrap();
+        let pipe = Arc::new(cap_std::fs::File::from_std(std::fs::File::from(
+            OwnedFd::from(reader),
+        )));
+        let op = ring.read_at(&pipe, 1, u64::MAX).unwrap();
+        let abandoned = ring.read_at(&pipe, 1, u64::MAX).unwrap();
+        drop(abandoned);
+        ring.fail();
+        assert!(op.read().await.is_none());
+
+        // Nothing more is submitted to a failed ring.
+        assert!(ring.read_at(&temp_file(), 1, 0).is_none());
+    }
+}
@@ -32,14 +32,17 @@ use std::{
     collections::{BTreeMap, BTreeSet},
     mem,
     ops::Range,
+    sync::Mutex,
+    time::Instant,
 };
 
 use call_graph::CallGraph;
 use wasmtime_environ::{
-    BuiltinFunctionIndex, CompiledFunctionBody, CompiledFunctionInfo, CompiledModuleInfo, Compiler,
-    DefinedFuncIndex, FilePos, FinishedObject, FuncKey, FunctionBodyData, InliningCompiler,
-    IntraModuleInlining, ModuleEnvironment, ModuleTranslation, ModuleTypes, ModuleTypesBuilder,
-    ObjectKind, PrimaryMap, SecondaryMap, StaticModuleIndex, Tunables,
+    BuiltinFunctionIndex, CallProfile, CompiledFunctionBody, CompiledFunctionInfo,
+    CompiledModuleInfo, Compiler, DefinedFuncIndex, FilePos, FinishedObject, FuncKey,
+    FunctionBodyData, InliningCompiler, IntraModuleInlining, ModuleEnvironment, ModuleTranslation,
+    ModuleTypes, ModuleTypesBuilder, ObjectKind, PrimaryMap, SecondaryMap, StaticModuleIndex,
+    Tunables,
 };
 #[cfg(feature = "component-model")]
 use wasmtime_environ::{FunctionLoc, component::Translator};
@@ -51,6 +54,14 @@ mod stratify;
 mod code_builder;
 pub use self::code_builder::{CodeBuilder, CodeHint, HashedEngineCompileEnv};
 
+mod report;
+pub use self::report::{CompileReport, FunctionCompileReport};
+
+#[cfg(feature = "runtime")]
+mod stream;
+#[cfg(feature = "runtime")]
+pub use self::stream::StreamingModuleBuilder;
+
 #[cfg(feature = "runtime")]
 mod runtime;
 
@@ -66,10 +77,16 @@ mod runtime;
 /// Additionally compilation returns an `Option` here which is always
 /// `Some`, notably compiled metadata about the module in addition to the
 /// type information found within.
+///
+/// The optional `profile` is a runtime call-edge profile of this module which
+/// guides inlining decisions, and the optional `report` is filled in with
+/// statistics about how each function was compiled.
 pub(crate) fn build_artifacts<T: FinishedObject>(
     engine: &Engine,
     wasm: &[u8],
     dwarf_package: Option<&[u8]>,
+    profile: Option<&CallProfile>,
+    report: Option<&Mutex<CompileReport>>,
     obj_state: &T::State,
 ) -> Result<(T, Option<(CompiledModuleInfo, ModuleTypes)>)> {
     let tunables = engine.tunables();
@@ -93,12 +110,33 @@ pub(crate) fn build_artifacts<T: FinishedObject>(
     let functions = mem::take(&mut translation.function_body_inputs);
 
     let compile_inputs = CompileInputs::for_module(&types, &translation, functions);
-    let unlinked_compile_outputs = compile_inputs.compile(engine)?;
+    let unlinked_compile_outputs = compile_inputs.compile(engine, profile)?;
+    let pre_link_output = unlinked_compile_outputs.pre_link(report);
+    link_module_artifacts(
+        engine,
+        types,
+        translation,
+        pre_link_output,
+        dwarf_package,
+        obj_state,
+    )
+}
+
+/// Links the functions compiled for the module described by `translation` into
+/// an object file, the last step of `build_artifacts`.
+fn link_module_artifacts<T: FinishedObject>(
+    engine: &Engine,
+    types: ModuleTypesBuilder,
+    mut translation: ModuleTranslation<'_>,
+    pre_link_output: PreLinkOutput,
+    dwarf_package: Option<&[u8]>,
+    obj_state: &T::State,
+) -> Result<(T, Option<(CompiledModuleInfo, ModuleTypes)>)> {
     let PreLinkOutput {
         needs_gc_heap,
         compiled_funcs,
         indices,
-    } = unlinked_compile_outputs.pre_link();
+    } = pre_link_output;
     translation.module.needs_gc_heap |= needs_gc_heap;
 
     // Emplace all compiled functions into the object file with any other
@@ -145,6 +183,8 @@ pub(crate) fn build_component_artifacts<T: FinishedObject>(
     engine: &Engine,
     binary: &[u8],
     _dwarf_package: Option<&[u8]>,
+    profile: Option<&CallProfile>,
+    report: Option<&Mutex<CompileReport>>,
     obj_state: &T::State,
 ) -> Result<(T, Option<wasmtime_environ::component::ComponentArtifacts>)> {
     use wasmtime_environ::ScopeVec;
@@ -172,13 +212,13 @@ pub(crate) fn build_component_artifacts<T: FinishedObject>(
             (i, &*translation, functions)
         }),
     );
-    let unlinked_compile_outputs = compile_inputs.compile(&engine)?;
+    let unlinked_compile_outputs = compile_inputs.compile(&engine, profile)?;
 
     let PreLinkOutput {
         needs_gc_heap,
         compiled_funcs,
         indices,
-    } = unlinked_compile_outputs.pre_link();
+    } = unlinked_compile_outputs.pre_link(report);
     for (_, t) in &mut module_translations {
         t.module.needs_gc_heap |= needs_gc_heap
     }
@@ -277,9 +317,80 @@ struct CompileOutput<'a> {
     func_body: Option<wasmparser::FunctionBody<'a>>,
 }
 
+impl<'a> CompileOutput<'a> {
+    /// Runs the compile input `f`, recording the time it took in the
+    /// statistics of its output.
+    fn run(f: CompileInput<'a>, compiler: &dyn Compiler) -> Result<Self> {
+        let start = Instant::now();
+        let mut output = f(compiler)?;
+        output.record_compile_time(start);
+        Ok(output)
+    }
+
+    /// Compiles the body of the defined wasm function `def_func_index` of the
+    /// module described by `translation`.
+    ///
+    /// The output's `translation` is left unset, for the caller to fill in,
+    /// as translation of the rest of the module may still be in progress.
+    fn wasm_function(
+        compiler: &dyn Compiler,
+        types: &ModuleTypesBuilder,
+        translation: &ModuleTranslation<'_>,
+        def_func_index: DefinedFuncIndex,
+        func_body_data: FunctionBodyData<'a>,
+    ) -> Result<Self> {
+        let module = translation.module_index;
+        let key = FuncKey::DefinedWasmFunction(module, def_func_index);
+        let symbol = CompileInputs::wasm_function_symbol(translation, def_func_index);
+        let func_body = func_body_data.body.clone();
+        let data = func_body.get_binary_reader();
+        let offset = data.original_position();
+        let start_srcloc = FilePos::new(u32::try_from(offset).unwrap());
+        let mut function = compiler
+            .compile_function(translation, key, func_body_data, types, &symbol)
+            .with_context(|| format!("failed to compile: {symbol}"))?;
+        function.stats.wasm_size = data.bytes_remaining();
+
+        Ok(CompileOutput {
+            key,
+            symbol,
+            function: CompiledFunction::Function(function),
+            start_srcloc,
+            translation: None,
+            func_body: Some(func_body),
+        })
+    }
+
+    /// Finishes compiling this output with `inlining_compiler`, recording the
+    /// time it took in the statistics of this output.
+    fn finish(&mut self, inlining_compiler: &dyn InliningCompiler) -> Result<()> {
+        let start = Instant::now();
+        match &mut self.function {
+            CompiledFunction::Function(f) => {
+                inlining_compiler.finish_compiling(f, self.func_body.take(), &self.symbol)?
+            }
+            #[cfg(feature = "component-model")]
+            CompiledFunction::AllCallFunc(f) => {
+                debug_assert!(self.func_body.is_none());
+                inlining_compiler.finish_compiling(&mut f.array_call, None, &self.symbol)?;
+                inlining_compiler.finish_compiling(&mut f.wasm_call, None, &self.symbol)?;
+            }
+        };
+        self.record_compile_time(start);
+        Ok(())
+    }
+
+    fn record_compile_time(&mut self, start: Instant) {
+        if let CompiledFunction::Function(f) = &mut self.function {
+            f.stats.compile_time += start.elapsed();
+        }
+    }
+}
+
 /// Inputs to our inlining heuristics.
 struct InlineHeuristicParams<'a> {
     tunables: &'a Tunables,
+    profile: Option<&'a CallProfile>,
     caller_size: u32,
     caller_module: StaticModuleIndex,
     caller_def_func: DefinedFuncIndex,
@@ -318,6 +429,33 @@ impl<'a> CompileInputs<'a> {
         ret
     }
 
+    /// Create the `CompileInputs` for a core Wasm module which was translated
+    /// as its bytes arrived.
+    ///
+    /// The bodies in `compiled` were already compiled while the rest of the
+    /// module was still arriving; they're given their final symbol names here,
+    /// as the name section may only have arrived after them. The bodies in
+    /// `functions` still need to be compiled.
+    #[cfg(feature = "runtime")]
+    fn for_streamed_module(
+        types: &'a ModuleTypesBuilder,
+        translation: &'a ModuleTranslation<'a>,
+        functions: PrimaryMap<DefinedFuncIndex, FunctionBodyData<'a>>,
+        compiled: Vec<CompileOutput<'a>>,
+    ) -> Self {
+        let mut ret = Self::for_module(types, translation, functions);
+
+        for mut output in compiled {
+            let (module, def_func_index) = output.key.unwrap_defined_wasm_function();
+            output.symbol = Self::wasm_function_symbol(translation, def_func_index);
+            output.translation = Some(translation);
+            ret.push_input(move |_compiler| Ok(output));
+            ret.push_array_to_wasm_trampoline(types, module, translation, def_func_index);
+        }
+
+        ret
+    }
+
     /// Create a `CompileInputs` for a component.
     #[cfg(feature = "component-model")]
     fn for_component(
@@ -415,6 +553,68 @@ impl<'a> CompileInputs<'a> {
         }
     }
 
+    /// Returns the symbol name of the defined wasm function `def_func_index`
+    /// of the module described by `translation`.
+    fn wasm_function_symbol(
+        translation: &ModuleTranslation<'_>,
+        def_func_index: DefinedFuncIndex,
+    ) -> String {
+        let module = translation.module_index;
+        let func_index = translation.module.func_index(def_func_index);
+        match translation
+            .debuginfo
+            .name_section
+            .func_names
+            .get(&func_index)
+        {
+            Some(name) => format!(
+                "wasm[{}]::function[{}]::{}",
+                module.as_u32(),
+                func_index.as_u32(),
+                Self::clean_symbol(&name)
+            ),
+            None => format!(
+                "wasm[{}]::function[{}]",
+                module.as_u32(),
+                func_index.as_u32()
+            ),
+        }
+    }
+
+    /// Pushes the input compiling the array-to-wasm trampoline of the defined
+    /// wasm function `def_func_index`, if it can be called from the host.
+    fn push_array_to_wasm_trampoline(
+        &mut self,
+        types: &'a ModuleTypesBuilder,
+        module: StaticModuleIndex,
+        translation: &'a ModuleTranslation<'a>,
+        def_func_index: DefinedFuncIndex,
+    ) {
+        let func_index = translation.module.func_index(def_func_index);
+        if !translation.module.functions[func_index].is_escaping() {
+            return;
+        }
+        self.push_input(move |compiler| {
+            let key = FuncKey::ArrayToWasmTrampoline(module, def_func_index);
+            let symbol = format!(
+                "wasm[{}]::array_to_wasm_trampoline[{}]",
+                module.as_u32(),
+                func_index.as_u32()
+            );
+            let trampoline = compiler
+                .compile_array_to_wasm_trampoline(translation, types, key, &symbol)
+                .with_context(|| format!("failed to compile: {symbol}"))?;
+            Ok(CompileOutput {
+                key,
+                symbol,
+                function: CompiledFunction::Function(trampoline),
+                start_srcloc: FilePos::default(),
+                translation: None,
+                func_body: None,
+            })
+        });
+    }
+
     fn collect_inputs_in_translations(
         &mut self,
         types: &'a ModuleTypesBuilder,
@@ -429,67 +629,17 @@ impl<'a> CompileInputs<'a> {
         for (module, translation, functions) in translations {
             for (def_func_index, func_body_data) in functions {
                 self.push_input(move |compiler| {
-                    let key = FuncKey::DefinedWasmFunction(module, def_func_index);
-                    let func_index = translation.module.func_index(def_func_index);
-                    let symbol = match translation
-                        .debuginfo
-                        .name_section
-                        .func_names
-                        .get(&func_index)
-                    {
-                        Some(name) => format!(
-                            "wasm[{}]::function[{}]::{}",
-                            module.as_u32(),
-                            func_index.as_u32(),
-                            Self::clean_symbol(&name)
-                        ),
-                        None => format!(
-                            "wasm[{}]::function[{}]",
-                            module.as_u32(),
-                            func_index.as_u32()
-                        ),
-                    };
-                    let func_body = func_body_data.body.clone();
-                    let data = func_body.get_binary_reader();
-                    let offset = data.original_position();
-                    let start_srcloc = FilePos::new(u32::try_from(offset).unwrap());
-                    let function = compiler
-                        .compile_function(translation, key, func_body_data, types, &symbol)
-                        .with_context(|| format!("failed to compile: {symbol}"))?;
-
-                    Ok(CompileOutput {
-                        key,
-                        symbol,
-                        function: CompiledFunction::Function(function),
-                        start_srcloc,
-                        translation: Some(translation),
-                        func_body: Some(func_body),
-                    })
+                    let mut output = CompileOutput::wasm_function(
+                        compiler,
+                        types,
+                        translation,
+                        def_func_index,
+                        func_body_data,
+                    )?;
+                    output.translation = Some(translation);
+                    Ok(output)
                 });
-
-                let func_index = translation.module.func_index(def_func_index);
-                if translation.module.functions[func_index].is_escaping() {
-                    self.push_input(move |compiler| {
-                        let key = FuncKey::ArrayToWasmTrampoline(module, def_func_index);
-                        let func_index = translation.module.func_index(def_func_index);
-                        let symbol = format!(
-                            "wasm[{}]::array_to_wasm_trampoline[{}]",
-                            module.as_u32(),
-                            func_index.as_u32()
-                        );
-                        let trampoline = compiler
-                            .compile_array_to_wasm_trampoline(translation, types, key, &symbol)
-                            .with_context(|| format!("failed to compile: {symbol}"))?;
-                        Ok(CompileOutput {
-                            key,
-                            symbol,
-                            function: CompiledFunction::Function(trampoline),
-                            start_srcloc: FilePos::default(),
-                            translation: None,
-                            func_body: None,
-                        })
-                    });
-                }
+                self.push_array_to_wasm_trampoline(types, module, translation, def_func_index);
             }
         }
 
@@ -523,7 +673,11 @@ impl<'a> CompileInputs<'a> {
 
     /// Compile these `CompileInput`s (maybe in parallel) and return the
     /// resulting `UnlinkedCompileOutput`s.
-    fn compile(self, engine: &Engine) -> Result<UnlinkedCompileOutputs<'a>> {
+    fn compile(
+        self,
+        engine: &Engine,
+        profile: Option<&CallProfile>,
+    ) -> Result<UnlinkedCompileOutputs<'a>> {
         let compiler = engine.compiler();
 
         if self.inputs.len() > 0 && cfg!(miri) {
@@ -546,40 +700,20 @@ the use case.
 
         let mut raw_outputs = if let Some(inlining_compiler) = compiler.inlining_compiler() {
             if engine.tunables().inlining {
-                self.compile_with_inlining(engine, compiler, inlining_compiler)?
+                self.compile_with_inlining(engine, compiler, inlining_compiler, profile)?
             } else {
                 // Inlining compiler but inlining is disabled: compile each
                 // input and immediately finish its output in parallel, skipping
                 // call graph computation and all that.
                 engine.run_maybe_parallel::<_, _, Error, _>(self.inputs, |f| {
-                    let mut compiled = f(compiler)?;
-                    match &mut compiled.function {
-                        CompiledFunction::Function(f) => inlining_compiler.finish_compiling(
-                            f,
-                            compiled.func_body.take(),
-                            &compiled.symbol,
-                        )?,
-                        #[cfg(feature = "component-model")]
-                        CompiledFunction::AllCallFunc(f) => {
-                            debug_assert!(compiled.func_body.is_none());
-                            inlining_compiler.finish_compiling(
-                                &mut f.array_call,
-                                None,
-                                &compiled.symbol,
-                            )?;
-                            inlining_compiler.finish_compiling(
-                                &mut f.wasm_call,
-                                None,
-                                &compiled.symbol,
-                            )?;
-                        }
-                    };
+                    let mut compiled = CompileOutput::run(f, compiler)?;
+                    compiled.finish(inlining_compiler)?;
                     Ok(compiled)
                 })?
             }
         } else {
             // No inlining: just compile each individual input in parallel.
-            engine.run_maybe_parallel(self.inputs, |f| f(compiler))?
+            engine.run_maybe_parallel(self.inputs, |f| CompileOutput::run(f, compiler))?
         };
 
         // Now that all functions have been compiled see if any
@@ -602,6 +736,7 @@ the use case.
         engine: &Engine,
         compiler: &dyn Compiler,
         inlining_compiler: &dyn InliningCompiler,
+        profile: Option<&CallProfile>,
     ) -> Result<Vec<CompileOutput<'a>>, Error> {
         /// The index of a function (of any kind: Wasm function, trampoline, or
         /// etc...) in our list of unlinked outputs.
@@ -611,7 +746,8 @@ the use case.
 
         // Our list of unlinked outputs.
         let mut outputs = PrimaryMap::<OutputIndex, Option<CompileOutput<'_>>>::from(
-            engine.run_maybe_parallel(self.inputs, |f| f(compiler).map(Some))?,
+            engine
+                .run_maybe_parallel(self.inputs, |f| CompileOutput::run(f, compiler).map(Some))?,
         );
 
         /// Get just the output indices of the Wasm functions from our unlinked
@@ -755,6 +891,7 @@ the use case.
 
                         if Self::should_inline(InlineHeuristicParams {
                             tunables: engine.tunables(),
+                            profile,
                             caller_size,
                             caller_module,
                             caller_def_func,
@@ -782,19 +919,7 @@ the use case.
         // Fan out in parallel again and finish compiling each function.
         engine.run_maybe_parallel(outputs.into(), |output| {
             let mut output = output.unwrap();
-            match &mut output.function {
-                CompiledFunction::Function(f) => inlining_compiler.finish_compiling(
-                    f,
-                    output.func_body.take(),
-                    &output.symbol,
-                )?,
-                #[cfg(feature = "component-model")]
-                CompiledFunction::AllCallFunc(f) => {
-                    debug_assert!(output.func_body.is_none());
-                    inlining_compiler.finish_compiling(&mut f.array_call, None, &output.symbol)?;
-                    inlining_compiler.finish_compiling(&mut f.wasm_call, None, &output.symbol)?;
-                }
-            };
+            output.finish(inlining_compiler)?;
             Ok(output)
         })
     }
@@ -821,9 +946,18 @@ the use case.
     ///   effectively allow reprioritizing the relative importance of different
     ///   hint sources, rather than being stuck with the sequence hard-coded in
     ///   the decision tree below.
+    ///
+    /// When a runtime `CallProfile` is available then call edges it reports as
+    /// hot are treated specially: they bypass the default intra-module
+    /// restriction (the toolchain that produced the module had no runtime
+    /// information either) and use the larger `inlining_hot_*` size
+    /// thresholds. Edges that are not hot, or that are intra-module while
+    /// intra-module inlining is explicitly disabled, fall through to the
+    /// static heuristics.
     fn should_inline(
         InlineHeuristicParams {
             tunables,
+            profile,
             caller_size,
             caller_module,
             caller_def_func,
@@ -853,6 +987,39 @@ the use case.
             "we never inline recursion"
         );
 
+        let hot = profile.is_some_and(|p| {
+            p.is_hot_edge(
+                (caller_module, caller_def_func),
+                (callee_module, callee_def_func),
+            )
+        });
+        // Hot edges only override the default intra-module restriction, not
+        // intra-module inlining being explicitly disabled.
+        let intra_module_disabled = caller_module == callee_module
+            && tunables.inlining_intra_module == IntraModuleInlining::No;
+        if hot && !intra_module_disabled {
+            if callee_size <= tunables.inlining_hot_callee_size {
+                log::trace!(
+                    "  --> inlining: hot edge and callee's size is less than the hot-callee \
+                     size: {callee_size} <= {}",
+                    tunables.inlining_hot_callee_size
+                );
+                return true;
+            }
+            let sum_size = caller_size.saturating_add(callee_size);
+            if sum_size <= tunables.inlining_hot_sum_size_threshold {
+                log::trace!(
+                    "  --> inlining: hot edge and the sum of the caller's and callee's sizes \
+                     is less than the hot inlining-sum-size threshold: \
+                     {callee_size} + {caller_size} <= {}",
+                    tunables.inlining_hot_sum_size_threshold
+                );
+                return true;
+            }
+            log::trace!("  --> not inlining: hot edge but callee is too large");
+            return false;
+        }
+
         // Consider whether this is an intra-module call.
         //
         // Inlining within a single core module has most often already been done
@@ -960,7 +1127,10 @@ struct UnlinkedCompileOutputs<'a> {
 impl UnlinkedCompileOutputs<'_> {
     /// Flatten all our functions into a single list and remember each of their
     /// indices within it.
-    fn pre_link(self) -> PreLinkOutput {
+    ///
+    /// The compilation statistics of all Wasm functions are appended to
+    /// `report`, if given.
+    fn pre_link(self, report: Option<&Mutex<CompileReport>>) -> PreLinkOutput {
         // The order the functions end up within `compiled_funcs` is the order
         // that they will be laid out in the ELF file, so try and group hot and
         // cold functions together as best we can. However, because we bucket by
@@ -969,8 +1139,24 @@ impl UnlinkedCompileOutputs<'_> {
         let mut compiled_funcs = vec![];
         let mut indices = FunctionIndices::default();
         let mut needs_gc_heap = false;
+        let mut report = report.map(|r| r.lock().unwrap());
+
+        for mut output in self.outputs.into_values() {
+            if let (Some(report), FuncKey::DefinedWasmFunction(_, def_func), Some(translation)) =
+                (&mut report, output.key, output.translation)
+            {
+                let stats = match &mut output.function {
+                    CompiledFunction::Function(f) => mem::take(&mut f.stats),
+                    #[cfg(feature = "component-model")]
+                    CompiledFunction::AllCallFunc(_) => unreachable!(),
+                };
+                report.push_function(
+                    translation.module.func_index(def_func),
+                    &output.symbol,
+                    stats,
+                );
+            }
 
-        for output in self.outputs.into_values() {
             let index = match output.function {
                 CompiledFunction::Function(f) => {
                     needs_gc_heap |= f.needs_gc_heap;
@@ -1,5 +1,5 @@
-use crate::Engine;
 use crate::prelude::*;
+use crate::{CallProfile, Engine};
 use std::borrow::Cow;
 use std::path::Path;
 
@@ -40,6 +40,7 @@ pub struct CodeBuilder<'a> {
     wasm_path: Option<Cow<'a, Path>>,
     dwarf_package: Option<Cow<'a, [u8]>>,
     dwarf_package_path: Option<Cow<'a, Path>>,
+    call_profile: Option<&'a CallProfile>,
 }
 
 /// Return value of [`CodeBuilder::hint`]
@@ -60,6 +61,7 @@ impl<'a> CodeBuilder<'a> {
             wasm_path: None,
             dwarf_package: None,
             dwarf_package_path: None,
+            call_profile: None,
         }
     }
 
@@ -236,6 +238,42 @@ impl<'a> CodeBuilder<'a> {
         Ok(self)
     }
 
+    /// Configures a runtime call profile to guide optimization of the code
+    /// being compiled.
+    ///
+    /// The `profile` is typically collected from previous executions of the
+    /// same module or component with
+    /// [`GuestProfiler::call_profile`](crate::GuestProfiler::call_profile),
+    /// possibly merged across many stores and persisted with
+    /// [`CallProfile::to_bytes`]. Call edges that the profile reports as hot
+    /// are favored by the inliner, including calls within a single core
+    /// module which are otherwise not inlined by default. Hot intra-module
+    /// calls are still not inlined if intra-module inlining has been
+    /// explicitly disabled with the `wasmtime_inlining_intra_module=no`
+    /// compiler flag.
+    ///
+    /// The profile only has an effect when inlining is enabled with
+    /// [`Config::compiler_inlining`](crate::Config::compiler_inlining). A
+    /// profile recorded for different wasm bytes is not an error, but results
+    /// in arbitrary (though still correct) inlining decisions.
+    ///
+    /// # Errors
+    ///
+    /// This method will return an error if a profile has already been
+    /// configured.
+    pub fn call_profile(&mut self, profile: &'a CallProfile) -> Result<&mut Self> {
+        if self.call_profile.is_some() {
+            bail!("cannot configure a call profile twice");
+        }
+        self.call_profile = Some(profile);
+        Ok(self)
+    }
+
+    /// Gets the configured call profile, if any.
+    pub(super) fn get_call_profile(&self) -> Option<&CallProfile> {
+        self.call_profile
+    }
+
     /// Returns a hint, if possible, of what the provided bytes are.
     ///
     /// This method can be use to detect what the previously supplied bytes to
@@ -274,7 +312,14 @@ impl<'a> CodeBuilder<'a> {
     pub fn compile_module_serialized(&self) -> Result<Vec<u8>> {
         let wasm = self.get_wasm()?;
         let dwarf_package = self.get_dwarf_package();
-        let (v, _) = super::build_artifacts(self.engine, &wasm, dwarf_package.as_deref(), &())?;
+        let (v, _) = super::build_artifacts(
+            self.engine,
+            &wasm,
+            dwarf_package.as_deref(),
+            self.get_call_profile(),
+            None,
+            &(),
+        )?;
         Ok(v)
     }
 
@@ -284,7 +329,14 @@ impl<'a> CodeBuilder<'a> {
     #[cfg(feature = "component-model")]
     pub fn compile_component_serialized(&self) -> Result<Vec<u8>> {
         let bytes = self.get_wasm()?;
-        let (v, _) = super::build_component_artifacts(self.engine, &bytes, None, &())?;
+        let (v, _) = super::build_component_artifacts(
+            self.engine,
+            &bytes,
+            None,
+            self.get_call_profile(),
+            None,
+            &(),
+        )?;
         Ok(v)
     }
 }
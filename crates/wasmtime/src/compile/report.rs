@@ -0,0 +1,127 @@
+use crate::prelude::*;
+use core::time::Duration;
+use wasmtime_environ::{FuncIndex, FunctionCompileStats};
+
+/// A report on where time and space went while compiling a WebAssembly
+/// module.
+///
+/// This is produced by [`CodeBuilder::compile_module_with_report`] and is
+/// intended to help identify functions whose compilation is unexpectedly
+/// expensive, for example because they are very large or trigger pathological
+/// behavior in the compiler.
+///
+/// [`CodeBuilder::compile_module_with_report`]: crate::CodeBuilder::compile_module_with_report
+#[derive(Clone, Debug, Default)]
+pub struct CompileReport {
+    functions: Vec<FunctionCompileReport>,
+    module_cache_hit: bool,
+}
+
+impl CompileReport {
+    /// Returns the reports of all functions defined in the module, ordered by
+    /// their function index.
+    ///
+    /// This is empty if the module was loaded from Wasmtime's module cache,
+    /// see [`CompileReport::module_cache_hit`].
+    pub fn functions(&self) -> &[FunctionCompileReport] {
+        &self.functions
+    }
+
+    /// Returns whether the whole module was loaded from Wasmtime's module
+    /// cache, in which case no function was compiled at all.
+    pub fn module_cache_hit(&self) -> bool {
+        self.module_cache_hit
+    }
+
+    /// Returns the sum of the time spent compiling each function.
+    ///
+    /// Functions are typically compiled in parallel so this can be larger
+    /// than the wall-clock time taken to compile the module.
+    pub fn total_compile_time(&self) -> Duration {
+        self.functions.iter().map(|f| f.compile_time()).sum()
+    }
+
+    pub(crate) fn push_function(
+        &mut self,
+        index: FuncIndex,
+        name: &str,
+        stats: FunctionCompileStats,
+    ) {
+        self.functions.push(FunctionCompileReport {
+            index: index.as_u32(),
+            name: name.to_string(),
+            stats,
+        });
+    }
+
+    pub(crate) fn set_module_cache_hit(&mut self) {
+        self.module_cache_hit = true;
+    }
+}
+
+/// Statistics about the compilation of a single WebAssembly function, as
+/// part of a [`CompileReport`].
+///
+/// Not all compilation strategies are able to measure every statistic; those
+/// which are not measured are reported as zero.
+#[derive(Clone, Debug)]
+pub struct FunctionCompileReport {
+    index: u32,
+    name: String,
+    stats: FunctionCompileStats,
+}
+
+impl FunctionCompileReport {
+    /// Returns the index of this function in the module's function index
+    /// space, which includes imported functions.
+    pub fn index(&self) -> u32 {
+        self.index
+    }
+
+    /// Returns the symbol name of this function, which includes its name
+    /// from the `name` custom section, if any.
+    pub fn name(&self) -> &str {
+        &self.name
+    }
+
+    /// Returns the size, in bytes, of this function's WebAssembly body.
+    pub fn wasm_size(&self) -> usize {
+        self.stats.wasm_size
+    }
+
+    /// Returns the number of instructions in the compiler's intermediate
+    /// representation of this function, before optimizations.
+    pub fn ir_size(&self) -> usize {
+        self.stats.ir_size
+    }
+
+    /// Returns the size, in bytes, of the machine code generated for this
+    /// function.
+    pub fn code_size(&self) -> usize {
+        self.stats.code_size
+    }
+
+    /// Returns the wall-clock time spent compiling this function.
+    pub fn compile_time(&self) -> Duration {
+        self.stats.compile_time
+    }
+
+    /// Returns the time spent in register allocation for this function.
+    pub fn regalloc_time(&self) -> Duration {
+        self.stats.regalloc_time
+    }
+
+    /// Returns the time spent in each compiler pass for this function,
+    /// excluding time spent in passes nested within it.
+    ///
+    /// Passes are identified by a human-readable description.
+    pub fn pass_times(&self) -> &[(&'static str, Duration)] {
+        &self.stats.pass_times
+    }
+
+    /// Returns whether this function's machine code was loaded from the
+    /// incremental compilation cache instead of being compiled.
+    pub fn cache_hit(&self) -> bool {
+        self.stats.cache_hit
+    }
+}
@@ -2,9 +2,9 @@
 use crate::component::Component;
 use crate::prelude::*;
 use crate::runtime::vm::MmapVec;
-use crate::{CodeBuilder, CodeMemory, Engine, Module};
+use crate::{CallProfile, CodeBuilder, CodeMemory, CompileReport, Engine, Module};
 use object::write::WritableBuffer;
-use std::sync::Arc;
+use std::sync::{Arc, Mutex};
 use wasmtime_environ::{FinishedObject, ObjectBuilder};
 
 impl<'a> CodeBuilder<'a> {
@@ -14,12 +14,16 @@ impl<'a> CodeBuilder<'a> {
             &Engine,
             &[u8],
             Option<&[u8]>,
+            Option<&CallProfile>,
+            Option<&Mutex<CompileReport>>,
             &S,
         ) -> Result<(MmapVecWrapper, Option<T>)>,
         state: &S,
+        report: Option<&Mutex<CompileReport>>,
     ) -> Result<(Arc<CodeMemory>, Option<T>)> {
         let wasm = self.get_wasm()?;
         let dwarf_package = self.get_dwarf_package();
+        let call_profile = self.get_call_profile();
 
         self.engine
             .check_compatible_with_native_host()
@@ -31,8 +35,12 @@ impl<'a> CodeBuilder<'a> {
                 crate::compile::HashedEngineCompileEnv(self.engine),
                 &wasm,
                 &dwarf_package,
+                call_profile,
                 // Don't hash this as it's just its own "pure" function pointer.
                 NotHashed(build_artifacts),
+                // Don't hash the report: it only collects information about
+                // the compilation and doesn't influence it.
+                NotHashed(report),
                 // Don't hash the FinishedObject state: this contains
                 // things like required runtime alignment, and does
                 // not impact the compilation result itself.
@@ -43,28 +51,33 @@ impl<'a> CodeBuilder<'a> {
                     .get_data_raw(
                         &state,
                         // Cache miss, compute the actual artifacts
-                        |(engine, wasm, dwarf_package, build_artifacts, state)| -> Result<_> {
-                            let (mmap, info) = (build_artifacts.0)(
+                        |(engine, wasm, dwarf, profile, build, report, state)| -> Result<_> {
+                            let (mmap, info) = (build.0)(
                                 engine.0,
                                 wasm,
-                                dwarf_package.as_deref(),
+                                dwarf.as_deref(),
+                                *profile,
+                                report.0,
                                 state.0,
                             )?;
                             let code = publish_mmap(engine.0, mmap.0)?;
                             Ok((code, info))
                         },
                         // Implementation of how to serialize artifacts
-                        |(_engine, _wasm, _, _, _), (code, _info_and_types)| {
+                        |(_engine, _wasm, _, _, _, _, _), (code, _info_and_types)| {
                             Some(code.mmap().to_vec())
                         },
                         // Cache hit, deserialize the provided artifacts
-                        |(engine, wasm, _, _, _), serialized_bytes| {
+                        |(engine, wasm, _, _, _, report, _), serialized_bytes| {
                             let kind = if wasmparser::Parser::is_component(&wasm) {
                                 wasmtime_environ::ObjectKind::Component
                             } else {
                                 wasmtime_environ::ObjectKind::Module
                             };
                             let code = engine.0.load_code_bytes(&serialized_bytes, kind).ok()?;
+                            if let Some(report) = report.0 {
+                                report.lock().unwrap().set_module_cache_hit();
+                            }
                             Some((code, None))
                         },
                     )?;
@@ -79,8 +92,14 @@ impl<'a> CodeBuilder<'a> {
 
         #[cfg(not(feature = "cache"))]
         {
-            let (mmap, info_and_types) =
-                build_artifacts(self.engine, &wasm, dwarf_package.as_deref(), state)?;
+            let (mmap, info_and_types) = build_artifacts(
+                self.engine,
+                &wasm,
+                dwarf_package.as_deref(),
+                call_profile,
+                report,
+                state,
+            )?;
             let code = publish_mmap(self.engine, mmap.0)?;
             return Ok((code, info_and_types));
         }
@@ -94,32 +113,42 @@ impl<'a> CodeBuilder<'a> {
     pub fn compile_module(&self) -> Result<Module> {
         let custom_alignment = self.custom_alignment();
         let (code, info_and_types) =
-            self.compile_cached(super::build_artifacts, &custom_alignment)?;
+            self.compile_cached(super::build_artifacts, &custom_alignment, None)?;
         Module::from_parts(self.engine, code, info_and_types)
     }
 
+    /// Same as [`CodeBuilder::compile_module`] except that a [`CompileReport`]
+    /// describing how each function of the module was compiled is returned as
+    /// well.
+    ///
+    /// Collecting the report adds a small amount of overhead to compilation,
+    /// so this is intended for diagnosing slow compilations rather than for
+    /// general use.
+    pub fn compile_module_with_report(&self) -> Result<(Module, CompileReport)> {
+        let custom_alignment = self.custom_alignment();
+        let report = Mutex::new(CompileReport::default());
+        let (code, info_and_types) =
+            self.compile_cached(super::build_artifacts, &custom_alignment, Some(&report))?;
+        let module = Module::from_parts(self.engine, code, info_and_types)?;
+        Ok((module, report.into_inner().unwrap()))
+    }
+
     /// Same as [`CodeBuilder::compile_module`] except that it compiles a
     /// [`Component`] instead of a module.
     #[cfg(feature = "component-model")]
     pub fn compile_component(&self) -> Result<Component> {
         let custom_alignment = self.custom_alignment();
         let (code, artifacts) =
-            self.compile_cached(super::build_component_artifacts, &custom_alignment)?;
+            self.compile_cached(super::build_component_artifacts, &custom_alignment, None)?;
         Component::from_parts(self.engine, code, artifacts)
     }
 
     fn custom_alignment(&self) -> CustomAlignment {
-        CustomAlignment {
-            alignment: self
-                .engine
-                .custom_code_memory()
-                .map(|c| c.required_alignment())
-                .unwrap_or(1),
-        }
+        CustomAlignment::new(self.engine)
     }
 }
 
-fn publish_mmap(engine: &Engine, mmap: MmapVec) -> Result<Arc<CodeMemory>> {
+pub(super) fn publish_mmap(engine: &Engine, mmap: MmapVec) -> Result<Arc<CodeMemory>> {
     let mut code = CodeMemory::new(engine, mmap)?;
     code.publish()?;
     Ok(Arc::new(code))
@@ -133,6 +162,17 @@ pub(crate) struct CustomAlignment {
     alignment: usize,
 }
 
+impl CustomAlignment {
+    pub(crate) fn new(engine: &Engine) -> CustomAlignment {
+        CustomAlignment {
+            alignment: engine
+                .custom_code_memory()
+                .map(|c| c.required_alignment())
+                .unwrap_or(1),
+        }
+    }
+}
+
 impl FinishedObject for MmapVecWrapper {
     type State = CustomAlignment;
     fn finish_object(obj: ObjectBuilder<'_>, align: &CustomAlignment) -> Result<Self> {
@@ -0,0 +1,396 @@
+use super::runtime::{CustomAlignment, MmapVecWrapper, publish_mmap};
+use super::{CompileInputs, CompileOutput, link_module_artifacts};
+use crate::prelude::*;
+use crate::{Engine, Module};
+use std::mem;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::mpsc::{self, Receiver, Sender};
+use std::sync::{Arc, Mutex};
+use std::thread::{self, JoinHandle};
+use std::time::Instant;
+use wasmparser::{Chunk, Parser, Payload, Validator};
+use wasmtime_environ::{
+    CompiledModuleInfo, DefinedFuncIndex, FunctionBodyData, ModuleEnvironment, ModuleTranslation,
+    ModuleTypes, ModuleTypesBuilder, ScopeVec, StaticModuleIndex,
+};
+
+const PARSE_ERROR: &str = "failed to parse WebAssembly module";
+
+/// Builder used to compile a [`Module`] from a WebAssembly binary which
+/// arrives in pieces, for example while it's still being downloaded.
+///
+/// Bytes are supplied with [`StreamingModuleBuilder::feed`] in chunks of any
+/// size and handed to a background thread, which parses, validates and
+/// translates each section as soon as it's complete. Each function body in the
+/// code section is compiled as soon as it has fully arrived, in parallel if
+/// [`Config::parallel_compilation`](crate::Config::parallel_compilation) is
+/// enabled, so compilation overlaps with receiving the rest of the binary.
+/// Once all bytes have been supplied [`StreamingModuleBuilder::finish`] waits
+/// for the remaining work and links the compiled functions into a [`Module`]
+/// without parsing or validating anything again.
+///
+/// Function bodies are only compiled after the whole binary has arrived if
+/// native DWARF debug information or `wmemcheck` is enabled, as both need the
+/// module's name section, which usually follows the code section. Modules
+/// built this way are not stored in or looked up from the compilation cache.
+///
+/// # Examples
+///
+/// ```
+/// # use wasmtime::*;
+/// # fn main() -> Result<()> {
+/// let engine = Engine::default();
+/// // An empty module: just the magic number and version.
+/// let wasm = b"\0asm\x01\0\0\0";
+///
+/// let mut builder = StreamingModuleBuilder::new(&engine);
+/// for chunk in wasm.chunks(4) {
+///     builder.feed(chunk)?;
+/// }
+/// let module = builder.finish()?;
+/// # let _ = module;
+/// # Ok(())
+/// # }
+/// ```
+pub struct StreamingModuleBuilder {
+    engine: Engine,
+    /// Sends the bytes of the binary to the background thread, which sees the
+    /// end of the binary once this is dropped.
+    chunks: Option<Sender<Vec<u8>>>,
+    /// Set once the background thread hits an error, or when this builder is
+    /// dropped, to stop translation early.
+    abort: Arc<AtomicBool>,
+    thread: Option<JoinHandle<Result<Artifacts>>>,
+}
+
+type Artifacts = (MmapVecWrapper, Option<(CompiledModuleInfo, ModuleTypes)>);
+
+impl StreamingModuleBuilder {
+    /// Creates a new builder which will compile a module for the specified
+    /// [`Engine`].
+    ///
+    /// # Panics
+    ///
+    /// Panics if the background thread can't be spawned.
+    pub fn new(engine: &Engine) -> StreamingModuleBuilder {
+        let (sender, chunks) = mpsc::channel();
+        let abort = Arc::new(AtomicBool::new(false));
+        let thread = thread::Builder::new()
+            .name("wasmtime-streaming-compile".to_string())
+            .spawn({
+                let engine = engine.clone();
+                let abort = abort.clone();
+                move || {
+                    let result = translate_and_compile(&engine, chunks, &abort);
+                    if result.is_err() {
+                        abort.store(true, Ordering::Relaxed);
+                    }
+                    result
+                }
+            })
+            .expect("failed to spawn streaming compilation thread");
+        StreamingModuleBuilder {
+            engine: engine.clone(),
+            chunks: Some(sender),
+            abort,
+            thread: Some(thread),
+        }
+    }
+
+    /// Supplies the next chunk of the WebAssembly binary.
+    ///
+    /// This returns without waiting for `bytes` to be parsed or compiled.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the bytes received so far have already been found
+    /// not to be a valid prefix of a WebAssembly module, or if a function body
+    /// failed to compile. Errors found in the bytes of this call are returned
+    /// by a later call to `feed` or by [`StreamingModuleBuilder::finish`].
+    /// After an error is returned this builder should be discarded.
+    pub fn feed(&mut self, bytes: &[u8]) -> Result<()> {
+        if self.abort.load(Ordering::Relaxed) {
+            return match self.join() {
+                Ok(_) => unreachable!("translation only stops early on errors"),
+                Err(e) => Err(e),
+            };
+        }
+        if let Some(chunks) = &self.chunks {
+            // If the background thread has just stopped then the error it hit
+            // is returned from the next call to `feed` or `finish`.
+            let _ = chunks.send(bytes.to_vec());
+        }
+        Ok(())
+    }
+
+    /// Signals that the whole binary has been supplied, waits for it to be
+    /// compiled and returns the resulting [`Module`].
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the binary is truncated or invalid, or if
+    /// compilation fails.
+    pub fn finish(mut self) -> Result<Module> {
+        let (mmap, info_and_types) = self.join()?;
+        let code = publish_mmap(&self.engine, mmap.0)?;
+        Module::from_parts(&self.engine, code, info_and_types)
+    }
+
+    /// Signals the end of the binary and waits for the background thread.
+    fn join(&mut self) -> Result<Artifacts> {
+        drop(self.chunks.take());
+        match self.thread.take() {
+            Some(thread) => match thread.join() {
+                Ok(result) => result,
+                Err(panic) => std::panic::resume_unwind(panic),
+            },
+            None => bail!("this module builder has already failed"),
+        }
+    }
+}
+
+impl Drop for StreamingModuleBuilder {
+    fn drop(&mut self) {
+        self.abort.store(true, Ordering::Relaxed);
+        drop(self.chunks.take());
+        if let Some(thread) = self.thread.take() {
+            let _ = thread.join();
+        }
+    }
+}
+
+/// Translates and compiles the module whose bytes arrive on `chunks`, on the
+/// background thread of a [`StreamingModuleBuilder`].
+///
+/// This mirrors `build_artifacts`, except that the translation is driven one
+/// payload at a time and the code section is handled by
+/// `compile_code_section`.
+fn translate_and_compile(
+    engine: &Engine,
+    chunks: Receiver<Vec<u8>>,
+    abort: &AtomicBool,
+) -> Result<Artifacts> {
+    engine
+        .check_compatible_with_native_host()
+        .context("compilation settings are not compatible with the native host")?;
+
+    let tunables = engine.tunables();
+    let scope = ScopeVec::new();
+    let mut validator = Validator::new_with_features(engine.features());
+    let mut parser = Parser::new(0);
+    parser.set_features(*validator.features());
+    let mut types = ModuleTypesBuilder::new(&validator);
+    let mut payloads = Payloads {
+        chunks,
+        abort,
+        scope: &scope,
+        parser,
+        pending: Vec::new(),
+        start: 0,
+        eof: false,
+        done: false,
+    };
+    let compile_early = !tunables.generate_native_debuginfo && !engine.config().wmemcheck;
+
+    // Translate everything up to the start of the code section...
+    let mut env = ModuleEnvironment::new(
+        tunables,
+        &mut validator,
+        &mut types,
+        StaticModuleIndex::from_u32(0),
+    );
+    let mut in_code_section = false;
+    while let Some(payload) = payloads.next()? {
+        in_code_section = compile_early && matches!(payload, Payload::CodeSectionStart { .. });
+        env.translate_payload(payload).context(PARSE_ERROR)?;
+        if in_code_section {
+            break;
+        }
+    }
+    let translation = env.into_translation();
+
+    // ... then compile each function body as it arrives ...
+    let (compiled, next) = if in_code_section {
+        compile_code_section(engine, &mut payloads, &mut validator, &types, &translation)?
+    } else {
+        (Vec::new(), None)
+    };
+
+    // ... and finally translate the rest of the module. Note that
+    // `translation.wasm` is left empty as the binary is never contiguous in
+    // memory; nothing compiling a core module reads it.
+    let mut env = ModuleEnvironment::resume(tunables, &mut validator, &mut types, translation);
+    if let Some(payload) = next {
+        env.translate_payload(payload).context(PARSE_ERROR)?;
+    }
+    while let Some(payload) = payloads.next()? {
+        env.translate_payload(payload).context(PARSE_ERROR)?;
+    }
+    let mut translation = env.into_translation();
+    let functions = mem::take(&mut translation.function_body_inputs);
+
+    let compile_inputs =
+        CompileInputs::for_streamed_module(&types, &translation, functions, compiled);
+    let unlinked_compile_outputs = compile_inputs.compile(engine, None)?;
+    let pre_link_output = unlinked_compile_outputs.pre_link(None);
+    link_module_artifacts(
+        engine,
+        types,
+        translation,
+        pre_link_output,
+        None,
+        &CustomAlignment::new(engine),
+    )
+}
+
+/// Validates and compiles the entries of the code section, whose start was
+/// the last payload returned from `payloads`, as they arrive.
+///
+/// Returns the compiled functions along with the first payload after the code
+/// section, if any.
+fn compile_code_section<'a>(
+    engine: &Engine,
+    payloads: &mut Payloads<'a>,
+    validator: &mut Validator,
+    types: &ModuleTypesBuilder,
+    translation: &ModuleTranslation<'_>,
+) -> Result<(Vec<CompileOutput<'a>>, Option<Payload<'a>>)> {
+    let compiler = engine.compiler();
+    let abort = payloads.abort;
+    let compiled = Mutex::new(Vec::new());
+    let compile = |def_func_index: DefinedFuncIndex, func_body_data: FunctionBodyData<'a>| {
+        let start = Instant::now();
+        let result = CompileOutput::wasm_function(
+            compiler,
+            types,
+            translation,
+            def_func_index,
+            func_body_data,
+        );
+        let result = result.map(|mut output| {
+            output.record_compile_time(start);
+            output
+        });
+        if result.is_err() {
+            abort.store(true, Ordering::Relaxed);
+        }
+        compiled.lock().unwrap().push((def_func_index, result));
+    };
+
+    let next = with_compile_jobs(engine, |spawn| -> Result<Option<Payload<'a>>> {
+        let mut def_func_index = DefinedFuncIndex::from_u32(0);
+        loop {
+            let body = match payloads.next()? {
+                Some(Payload::CodeSectionEntry(body)) => body,
+                other => return Ok(other),
+            };
+            let func_validator = validator.code_section_entry(&body).context(PARSE_ERROR)?;
+            let compile = &compile;
+            spawn(Box::new(move || {
+                compile(
+                    def_func_index,
+                    FunctionBodyData {
+                        validator: func_validator,
+                        body,
+                    },
+                )
+            }));
+            def_func_index = DefinedFuncIndex::from_u32(def_func_index.as_u32() + 1);
+        }
+    });
+
+    // A function that failed to compile comes before anything that failed to
+    // parse after it, so report the first such function ahead of `next`.
+    let mut compiled = compiled.into_inner().unwrap();
+    compiled.sort_unstable_by_key(|(index, _)| *index);
+    let compiled = compiled
+        .into_iter()
+        .map(|(_, output)| output)
+        .collect::<Result<Vec<_>>>()?;
+    Ok((compiled, next?))
+}
+
+type CompileJob<'a> = Box<dyn FnOnce() + Send + 'a>;
+
+/// Calls `f` with a function to run compilation jobs, which runs them on the
+/// compilation workers while `f` carries on if parallel compilation is
+/// enabled, and returns once all jobs have finished.
+fn with_compile_jobs<'a, R>(
+    engine: &Engine,
+    f: impl FnOnce(&mut dyn FnMut(CompileJob<'a>)) -> R,
+) -> R {
+    if engine.config().parallel_compilation {
+        #[cfg(feature = "parallel-compilation")]
+        return rayon::in_place_scope(|scope| {
+            f(&mut |job: CompileJob<'a>| scope.spawn(move |_| job()))
+        });
+    }
+    f(&mut |job: CompileJob<'a>| job())
+}
+
+/// The payloads of a module whose bytes arrive on a channel.
+///
+/// Each payload's bytes are moved into `scope` once it has been parsed so that
+/// the translation can borrow them until it's finished.
+struct Payloads<'a> {
+    chunks: Receiver<Vec<u8>>,
+    abort: &'a AtomicBool,
+    scope: &'a ScopeVec<u8>,
+    parser: Parser,
+    /// Bytes which have been received but not parsed yet, starting at
+    /// `pending[start]`.
+    pending: Vec<u8>,
+    start: usize,
+    /// Whether all bytes have been received.
+    eof: bool,
+    /// Whether the end of the module has been parsed.
+    done: bool,
+}
+
+impl<'a> Payloads<'a> {
+    /// Returns the next payload of the module, waiting for more bytes to
+    /// arrive if necessary, or `None` once the end of the module has been
+    /// parsed.
+    fn next(&mut self) -> Result<Option<Payload<'a>>> {
+        loop {
+            if self.abort.load(Ordering::Relaxed) {
+                bail!("streaming compilation was aborted");
+            }
+            if self.done {
+                return Ok(None);
+            }
+
+            // Find out whether the next payload has arrived in full, without
+            // advancing the parser past it yet.
+            let consumed = match self
+                .parser
+                .clone()
+                .parse(&self.pending[self.start..], self.eof)
+                .context(PARSE_ERROR)?
+            {
+                Chunk::Parsed { consumed, .. } => Some(consumed),
+                Chunk::NeedMoreData(_) => None,
+            };
+            let Some(consumed) = consumed else {
+                self.pending.drain(..self.start);
+                self.start = 0;
+                match self.chunks.recv() {
+                    Ok(chunk) => self.pending.extend_from_slice(&chunk),
+                    Err(_) => self.eof = true,
+                }
+                continue;
+            };
+
+            // Then move its bytes into `scope` and parse it again from there.
+            let scope: &'a ScopeVec<u8> = self.scope;
+            let bytes: &'a [u8] = scope.push(self.pending[self.start..][..consumed].to_vec());
+            self.start += consumed;
+            let payload = match self.parser.parse(bytes, self.eof).context(PARSE_ERROR)? {
+                Chunk::Parsed { payload, .. } => payload,
+                Chunk::NeedMoreData(_) => unreachable!(),
+            };
+            self.done = matches!(payload, Payload::End(_));
+            return Ok(Some(payload));
+        }
+    }
+}
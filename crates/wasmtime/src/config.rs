@@ -555,6 +555,36 @@ impl Config {
         self
     }
 
+    /// Configures whether fuel, when enabled with
+    /// [`Config::consume_fuel`], is metered approximately in exchange for
+    /// lower overhead.
+    ///
+    /// By default fuel is added up per basic block, which keeps the amount of
+    /// fuel consumed exact but costs an update of the fuel counter before
+    /// every branch. In approximate mode the code of a function is split into
+    /// regions without any branches into or conditionally out of them: the
+    /// function entry, loop bodies, `if` and `else` arms, the code after each
+    /// block and the fallthrough of each conditional branch. The cost of each
+    /// region is computed at compile time and charged up front when the
+    /// region is entered, so a block reached from many branches, such as the
+    /// targets of a `br_table`, is charged once rather than on every edge
+    /// into it, and unconditional branches don't update fuel at all.
+    ///
+    /// This over-approximates the amount of fuel consumed: the rest of a
+    /// region is still charged when it traps or calls a function which
+    /// doesn't return. Code skipped by a branch is never charged, so the
+    /// amount charged stays within the size of one region of the amount
+    /// executed, making this suitable for billing and for bounding execution
+    /// time, but not where exact instruction counts are needed.
+    ///
+    /// This setting only has an effect with Cranelift.
+    ///
+    /// By default this option is `false`.
+    pub fn approximate_fuel(&mut self, enable: bool) -> &mut Self {
+        self.tunables.approximate_fuel = Some(enable);
+        self
+    }
+
     /// Enables epoch-based interruption.
     ///
     /// When executing code in async mode, we sometimes want to
@@ -655,6 +685,11 @@ impl Config {
     /// deterministically, then fuel with a fixed bound should be
     /// used.
     ///
+    /// On Unix platforms WebAssembly which only ever needs to be stopped, and
+    /// never resumed, can instead be interrupted with a signal through
+    /// `wasmtime::unix::StoreExt::interrupt_handle`. That doesn't require
+    /// this option or any checks in compiled code.
+    ///
     /// **Note** Enabling this option is not compatible with the Winch compiler.
     ///
     /// # See Also
@@ -1325,6 +1360,25 @@ impl Config {
         self
     }
 
+    /// Configures whether Cranelift should vectorize simple counted loops.
+    ///
+    /// When enabled, single-block loops which fold integers loaded from linear
+    /// memory into an accumulator with `add`, `and`, `or` or `xor`, such as
+    /// summing up an array, are rewritten to process a full 128-bit vector of
+    /// elements per iteration. The results of such loops are unchanged. This
+    /// currently only has an effect on x86-64 hosts supporting SSE4.1 and when
+    /// [`Config::cranelift_opt_level`] is not [`OptLevel::None`].
+    ///
+    /// The default value for this is `false`
+    #[cfg(any(feature = "cranelift", feature = "winch"))]
+    pub fn cranelift_loop_vectorization(&mut self, enable: bool) -> &mut Self {
+        let val = if enable { "true" } else { "false" };
+        self.compiler_config
+            .settings
+            .insert("enable_loop_vectorization".to_string(), val.to_string());
+        self
+    }
+
     /// Controls whether proof-carrying code (PCC) is used to validate
     /// lowering of Wasm sandbox checks.
     ///
@@ -2046,6 +2100,26 @@ impl Config {
         self
     }
 
+    /// Whether Winch should apply cheap peephole optimizations to the machine
+    /// code it generates.
+    ///
+    /// Winch emits machine code in a single pass and keeps Wasm locals in
+    /// their stack slots, so it frequently stores a register to a local only
+    /// to load it back right away, for example for `local.set` followed by
+    /// `local.get`. When enabled, such reloads are replaced with register
+    /// moves, or removed entirely, as are redundant register-to-register
+    /// moves. This slightly improves the performance of the generated code
+    /// at negligible compile-time cost.
+    ///
+    /// This setting only has an effect on x86-64 when using
+    /// [`Strategy::Winch`] and is ignored otherwise.
+    ///
+    /// The default value for this is `false`
+    pub fn winch_peephole(&mut self, enable: bool) -> &mut Self {
+        self.tunables.winch_peephole = Some(enable);
+        self
+    }
+
     /// Returns the set of features that the currently selected compiler backend
     /// does not support at all and may panic on.
     ///
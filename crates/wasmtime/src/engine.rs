@@ -459,6 +459,7 @@ impl Engine {
             | "tls_model" // wasmtime doesn't use tls right now
             | "opt_level" // opt level doesn't change semantics
             | "enable_alias_analysis" // alias analysis-based opts don't change semantics
+            | "enable_loop_vectorization" // vectorized loops compute the same results
             | "probestack_size_log2" // probestack above asserted disabled
             | "regalloc" // shouldn't change semantics
             | "enable_incremental_compilation_cache_checks" // shouldn't change semantics
@@ -786,6 +787,24 @@ impl Engine {
         self.inner.epoch.fetch_add(1, Ordering::Relaxed);
     }
 
+    /// Returns the usage of each stripe of linear memory slots when this
+    /// engine uses the pooling allocator.
+    ///
+    /// When `PoolingAllocationConfig::memory_protection_keys` is enabled the
+    /// pooling allocator splits its linear memory slots into one stripe per
+    /// protection key, and all linear memories of a store are allocated from
+    /// the same stripe. Stores are assigned to the stripe with the fewest
+    /// live stores, and this can be used to monitor how evenly, and how
+    /// densely, stripes are used.
+    ///
+    /// Without protection keys there is a single unprotected stripe, and an
+    /// empty list is returned when this engine doesn't use the pooling
+    /// allocator.
+    #[cfg(feature = "pooling-allocator")]
+    pub fn pooling_memory_stripes(&self) -> Vec<crate::PoolMemoryStripe> {
+        self.allocator().memory_stripes()
+    }
+
     /// Returns a [`std::hash::Hash`] that can be used to check precompiled WebAssembly compatibility.
     ///
     /// The outputs of [`Engine::precompile_module`] and [`Engine::precompile_component`]
@@ -280,6 +280,7 @@ impl Metadata<'_> {
             generate_native_debuginfo,
             parse_wasm_debuginfo,
             consume_fuel,
+            approximate_fuel,
             epoch_interruption,
             memory_may_move,
             guard_before_linear_memory,
@@ -292,6 +293,8 @@ impl Metadata<'_> {
             inlining_intra_module,
             inlining_small_callee_size,
             inlining_sum_size_threshold,
+            inlining_hot_callee_size,
+            inlining_hot_sum_size_threshold,
 
             // This doesn't affect compilation, it's just a runtime setting.
             memory_reservation_for_growth: _,
@@ -304,6 +307,10 @@ impl Metadata<'_> {
 
             // Just a debugging aid, doesn't affect functionality at all.
             debug_adapter_modules: _,
+
+            // Only affects the quality of code generated by Winch, which
+            // doesn't need to be consistent with the engine's configuration.
+            winch_peephole: _,
         } = self.tunables;
 
         Self::check_collector(collector, other.collector)?;
@@ -328,6 +335,7 @@ impl Metadata<'_> {
             "WebAssembly backtrace support",
         )?;
         Self::check_bool(consume_fuel, other.consume_fuel, "fuel support")?;
+        Self::check_bool(approximate_fuel, other.approximate_fuel, "approximate fuel")?;
         Self::check_bool(
             epoch_interruption,
             other.epoch_interruption,
@@ -371,6 +379,16 @@ impl Metadata<'_> {
             other.inlining_sum_size_threshold,
             "function inlining sum-size threshold",
         )?;
+        Self::check_int(
+            inlining_hot_callee_size,
+            other.inlining_hot_callee_size,
+            "function inlining hot-callee size",
+        )?;
+        Self::check_int(
+            inlining_hot_sum_size_threshold,
+            other.inlining_hot_sum_size_threshold,
+            "function inlining hot sum-size threshold",
+        )?;
         Self::check_intra_module_inlining(inlining_intra_module, other.inlining_intra_module)?;
 
         Ok(())
@@ -376,7 +376,9 @@ pub use runtime::*;
 #[cfg(any(feature = "cranelift", feature = "winch"))]
 mod compile;
 #[cfg(any(feature = "cranelift", feature = "winch"))]
-pub use compile::{CodeBuilder, CodeHint};
+pub use compile::{CodeBuilder, CodeHint, CompileReport, FunctionCompileReport};
+#[cfg(all(feature = "runtime", any(feature = "cranelift", feature = "winch")))]
+pub use compile::StreamingModuleBuilder;
 
 mod config;
 mod engine;
@@ -384,6 +386,7 @@ mod profiling_agent;
 
 pub use crate::config::*;
 pub use crate::engine::*;
+pub use wasmtime_environ::CallProfile;
 
 #[cfg(feature = "std")]
 mod sync_std;
@@ -79,7 +79,7 @@ pub use code_memory::CodeMemory;
 pub use externals::*;
 pub use func::*;
 pub use gc::*;
-pub use instance::{Instance, InstancePre};
+pub use instance::{Instance, InstancePre, InstanceSnapshot};
 pub use instantiate::CompiledModule;
 pub use limits::*;
 pub use linker::*;
@@ -99,12 +99,14 @@ pub use values::*;
 pub(crate) use uninhabited::*;
 
 #[cfg(feature = "pooling-allocator")]
-pub use vm::PoolConcurrencyLimitError;
+pub use vm::{PoolConcurrencyLimitError, PoolMemoryStripe};
 
 #[cfg(feature = "profiling")]
 mod profiling;
 #[cfg(feature = "profiling")]
 pub use profiling::GuestProfiler;
+#[cfg(all(feature = "profiling", target_has_atomic = "64"))]
+pub use profiling::StackSampler;
 
 #[cfg(feature = "async")]
 pub(crate) mod stack;
@@ -1,8 +1,8 @@
 use crate::{code_memory::CodeMemory, type_registry::TypeCollection};
 use alloc::sync::Arc;
-use wasmtime_environ::ModuleTypes;
 #[cfg(feature = "component-model")]
 use wasmtime_environ::component::ComponentTypes;
+use wasmtime_environ::{FunctionLoc, ModuleTypes};
 
 /// Metadata in Wasmtime about a loaded compiled artifact in memory which is
 /// ready to execute.
@@ -36,10 +36,17 @@ pub struct CodeObject {
 }
 
 impl CodeObject {
-    pub fn new(mmap: Arc<CodeMemory>, signatures: TypeCollection, types: Types) -> CodeObject {
+    /// Creates a new `CodeObject` for `mmap`, which contains the defined wasm
+    /// functions at `wasm_funcs`.
+    pub fn new(
+        mmap: Arc<CodeMemory>,
+        signatures: TypeCollection,
+        types: Types,
+        wasm_funcs: impl IntoIterator<Item = FunctionLoc>,
+    ) -> CodeObject {
         // The corresponding unregister for this is below in `Drop for
         // CodeObject`.
-        crate::module::register_code(&mmap);
+        crate::module::register_code(&mmap, wasm_funcs);
 
         CodeObject {
             mmap,
@@ -427,7 +427,15 @@ impl Component {
         // Assemble the `CodeObject` artifact which is shared by all core wasm
         // modules as well as the final component.
         let types = Arc::new(types);
-        let code = Arc::new(CodeObject::new(code_memory, signatures, types.into()));
+        let wasm_funcs = static_modules
+            .values()
+            .flat_map(|m| m.funcs.values().map(|f| f.wasm_func_loc));
+        let code = Arc::new(CodeObject::new(
+            code_memory,
+            signatures,
+            types.into(),
+            wasm_funcs,
+        ));
 
         // Convert all information about static core wasm modules into actual
         // `Module` instances by converting each `CompiledModuleInfo`, the
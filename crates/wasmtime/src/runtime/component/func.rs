@@ -298,6 +298,81 @@ impl Func {
         }
     }
 
+    /// Invokes this function with parameters and results in their flattened
+    /// canonical ABI representation.
+    ///
+    /// This is a lower-level alternative to [`Func::call`] for embedders which
+    /// don't know the types of a function statically, and so can't use
+    /// [`TypedFunc`], but which also want to avoid converting all parameters
+    /// and results to and from [`Val`]. The C API, for example, uses this to
+    /// lower arguments directly from its own representation.
+    ///
+    /// The `lower` closure is given the core wasm parameters of this function,
+    /// all initialized to zero, which it must fill in. If the flattened
+    /// parameters don't fit in 16 core wasm values then this is instead a
+    /// single pointer to the parameters in linear memory, which can be
+    /// allocated with [`LowerContext::realloc`]. The values written are passed
+    /// to the guest as-is.
+    ///
+    /// The `lift` closure is then given the core wasm results of this function
+    /// which, similarly, are either the flattened results or a single pointer
+    /// to them in linear memory. Memory read through [`LiftContext::memory`]
+    /// is borrowed from the guest and, for example, strings and lists can be
+    /// read in-place without being copied.
+    ///
+    /// Like with [`Func::call`], [`Func::post_return`] must be called once the
+    /// results have been processed.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `lower` or `lift` returns an error, if a trap
+    /// occurs while executing the function, or if the function uses the
+    /// async ABI.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this is called on a function in an asynchronous store. Also
+    /// panics if `store` does not own this function.
+    pub fn call_flat<T: 'static, R>(
+        &self,
+        mut store: impl AsContextMut<Data = T>,
+        lower: impl FnOnce(&mut LowerContext<'_, T>, &mut [ValRaw]) -> Result<()>,
+        lift: impl FnOnce(&mut LiftContext<'_>, &[ValRaw]) -> Result<R>,
+    ) -> Result<R> {
+        let store = store.as_context_mut();
+        assert!(
+            !store.0.async_support(),
+            "must use `call_async` when async support is enabled on the config"
+        );
+        if self.abi_async(store.0) {
+            bail!("cannot call an async-lifted function with `call_flat`");
+        }
+
+        // SAFETY: the representations chosen here are the same as those in
+        // `call_impl`, except that parameters are fully initialized up-front
+        // so they can be handed out as a plain slice.
+        unsafe {
+            self.call_raw(
+                store,
+                |cx, ty, dst: &mut MaybeUninit<[ValRaw; MAX_FLAT_PARAMS]>| {
+                    let len = match ty {
+                        InterfaceType::Tuple(i) => cx.types[i].abi.flat_count(MAX_FLAT_PARAMS),
+                        _ => unreachable!(),
+                    };
+                    let dst = dst.write([ValRaw::u64(0); MAX_FLAT_PARAMS]);
+                    lower(cx, &mut dst[..len.unwrap_or(1)])
+                },
+                |cx, ty, src: &[ValRaw; MAX_FLAT_RESULTS]| {
+                    let len = match ty {
+                        InterfaceType::Tuple(i) => cx.types[i].abi.flat_count(MAX_FLAT_RESULTS),
+                        _ => unreachable!(),
+                    };
+                    lift(cx, &src[..len.unwrap_or(1)])
+                },
+            )
+        }
+    }
+
     fn check_params_results<T>(
         &self,
         store: StoreContextMut<T>,
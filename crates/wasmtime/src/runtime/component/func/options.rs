@@ -190,6 +190,16 @@ impl Options {
         self.async_
     }
 
+    /// Returns whether a `memory` canonical option was specified.
+    pub fn has_memory(&self) -> bool {
+        self.memory.is_some()
+    }
+
+    /// Returns whether a `realloc` canonical option was specified.
+    pub fn has_realloc(&self) -> bool {
+        self.realloc.is_some()
+    }
+
     #[cfg(feature = "component-model-async")]
     pub(crate) fn callback(&self) -> Option<NonNull<VMFuncRef>> {
         self.callback
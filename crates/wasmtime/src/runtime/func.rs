@@ -1115,6 +1115,45 @@ impl Func {
         Ok(result)
     }
 
+    /// Same as [`Func::call_unchecked`], but asynchronous, for stores with
+    /// [async support](crate::Config::async_support) enabled.
+    ///
+    /// # Unsafety
+    ///
+    /// This function has the same safety requirements as
+    /// [`Func::call_unchecked`]. Additionally `params_and_returns` must stay
+    /// valid until the returned future completes or is dropped.
+    ///
+    /// # Panics
+    ///
+    /// Panics if this is called on a function in a synchronous store, or if
+    /// `store` does not own this function.
+    #[cfg(feature = "async")]
+    pub async unsafe fn call_unchecked_async(
+        &self,
+        mut store: impl AsContextMut<Data: Send>,
+        params_and_returns: *mut [ValRaw],
+    ) -> Result<()> {
+        let mut store = store.as_context_mut();
+        assert!(
+            store.0.async_support(),
+            "cannot use `call_unchecked_async` without enabling async support in the config",
+        );
+        let params_and_returns =
+            SendSyncPtr::new(NonNull::new(params_and_returns).unwrap_or(NonNull::from(&mut [])));
+
+        store
+            .on_fiber(|store| {
+                let func_ref = self.vm_func_ref(store.0);
+                // SAFETY: the safety of this call is the same as the contract
+                // of this function.
+                unsafe {
+                    Self::call_unchecked_raw(store, func_ref, params_and_returns.as_non_null())
+                }
+            })
+            .await?
+    }
+
     /// Perform dynamic checks that the arguments given to us match
     /// the signature of this function and are appropriate to pass to this
     /// function.
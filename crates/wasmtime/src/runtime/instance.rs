@@ -1,4 +1,5 @@
 use crate::linker::{Definition, DefinitionType};
+use crate::module::WeakModule;
 use crate::prelude::*;
 use crate::runtime::vm::{
     self, Imports, ModuleRuntimeInfo, VMFuncRef, VMFunctionImport, VMGlobalImport, VMMemoryImport,
@@ -7,15 +8,15 @@ use crate::runtime::vm::{
 use crate::store::{AllocateInstanceKind, InstanceId, StoreInstanceId, StoreOpaque};
 use crate::types::matching;
 use crate::{
-    AsContextMut, Engine, Export, Extern, Func, Global, Memory, Module, ModuleExport, SharedMemory,
-    StoreContext, StoreContextMut, Table, Tag, TypedFunc,
+    AsContext, AsContextMut, Engine, Export, Extern, Func, Global, Memory, Module, ModuleExport,
+    SharedMemory, StoreContext, StoreContextMut, Table, Tag, TypedFunc,
 };
 use alloc::sync::Arc;
 use core::ptr::NonNull;
 use wasmparser::WasmFeatures;
 use wasmtime_environ::{
-    EntityIndex, EntityType, FuncIndex, GlobalIndex, MemoryIndex, PrimaryMap, TableIndex, TagIndex,
-    TypeTrace,
+    DefinedGlobalIndex, EntityIndex, EntityType, FuncIndex, GlobalIndex, MemoryIndex, PrimaryMap,
+    TableIndex, TagIndex, TypeTrace,
 };
 
 /// An instantiated WebAssembly module.
@@ -214,7 +215,7 @@ impl Instance {
     ) -> Result<Instance> {
         // SAFETY: the safety contract of `new_raw` is the same as this
         // function.
-        let (instance, start) = unsafe { Instance::new_raw(store.0, module, imports)? };
+        let (instance, start) = unsafe { Instance::new_raw(store.0, module, imports, None)? };
         if let Some(start) = start {
             instance.start_raw(store, start)?;
         }
@@ -253,6 +254,10 @@ impl Instance {
     /// This is not intended to be exposed from Wasmtime, it's intended to
     /// refactor out common code from `new_started` and `new_started_async`.
     ///
+    /// If `snapshot` is provided then the instance's memories and mutable
+    /// globals are initialized from it, and no `start` function is returned
+    /// since its effects are already part of the snapshot.
+    ///
     /// Note that this step needs to be run on a fiber in async mode even
     /// though it doesn't do any blocking work because an async resource
     /// limiter may need to yield.
@@ -266,6 +271,7 @@ impl Instance {
         store: &mut StoreOpaque,
         module: &Module,
         imports: Imports<'_>,
+        snapshot: Option<&InstanceSnapshot>,
     ) -> Result<(Instance, Option<FuncIndex>)> {
         if !Engine::same(store.engine(), module.engine()) {
             bail!("cross-`Engine` instantiation is not currently supported");
@@ -291,7 +297,7 @@ impl Instance {
         // the store.
         let id = unsafe {
             store.allocate_instance(
-                AllocateInstanceKind::Module(module_id),
+                AllocateInstanceKind::Module(module_id, snapshot.map(|s| &s.memories)),
                 &ModuleRuntimeInfo::Module(module.clone()),
                 imports,
             )?
@@ -326,9 +332,30 @@ impl Instance {
             .features()
             .contains(WasmFeatures::BULK_MEMORY);
 
-        vm::initialize_instance(store, id, compiled_module.module(), bulk_memory)?;
+        let snapshot = match snapshot {
+            Some(snapshot) => snapshot,
+            None => {
+                vm::initialize_instance(store, id, compiled_module.module(), bulk_memory)?;
+                return Ok((instance, compiled_module.module().start_func));
+            }
+        };
+
+        vm::initialize_instance_from_snapshot(
+            store,
+            id,
+            compiled_module.module(),
+            &snapshot.memories,
+        )?;
+        let vm_instance = store.instance(id);
+        for (index, bits) in snapshot.globals.iter() {
+            // SAFETY: snapshots only contain globals of numeric and vector
+            // types, for which all 128 bits of the definition are plain data.
+            unsafe {
+                vm_instance.global_ptr(*index).as_mut().set_u128(*bits);
+            }
+        }
 
-        Ok((instance, compiled_module.module().start_func))
+        Ok((instance, None))
     }
 
     pub(crate) fn from_wasmtime(id: InstanceId, store: &mut StoreOpaque) -> Instance {
@@ -364,6 +391,87 @@ impl Instance {
         store.module_for_instance(self.id).unwrap()
     }
 
+    /// Captures the current state of this instance so that new instances of
+    /// its module can start from it.
+    ///
+    /// This is intended for instances which perform expensive initialization
+    /// before they're ready to serve requests: a single instance can be warmed
+    /// up once, snapshotted, and then used as a template for any number of new
+    /// instances with [`InstancePre::instantiate_snapshot`], each in its own
+    /// [`Store`](crate::Store) and possibly on its own thread.
+    ///
+    /// The snapshot contains the contents of all memories defined by this
+    /// instance along with the values of its mutable globals. When
+    /// copy-on-write memory initialization is enabled, which is the default,
+    /// the contents of memories are captured in memory images which new
+    /// instances map copy-on-write, so instantiating from a snapshot shares
+    /// unmodified pages with the snapshot rather than copying them. See
+    /// [`Config::memory_init_cow`](crate::Config::memory_init_cow) for more
+    /// information.
+    ///
+    /// Tables and imported items are not part of the snapshot: new instances
+    /// initialize their tables from the module's element segments and use the
+    /// imports they're instantiated with.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if this instance defines a shared memory, or a
+    /// mutable global of a reference type, as neither can be captured.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `store` does not own this instance.
+    pub fn snapshot(&self, store: impl AsContext) -> Result<InstanceSnapshot> {
+        self._snapshot(store.as_context().0)
+    }
+
+    fn _snapshot(&self, store: &StoreOpaque) -> Result<InstanceSnapshot> {
+        let module = self._module(store).clone();
+        let env_module = module.env_module();
+        let instance = &store[self.id];
+
+        let mut memories = Vec::new();
+        for (index, ty) in env_module.memories.iter() {
+            let Some(index) = env_module.defined_memory_index(index) else {
+                continue;
+            };
+            if ty.shared {
+                bail!("cannot snapshot an instance which defines a shared memory");
+            }
+            let definition = instance.memory(index);
+            // SAFETY: the memory isn't shared and `store` is borrowed for the
+            // duration of the snapshot, so its contents can't change.
+            memories.push(unsafe {
+                core::slice::from_raw_parts(definition.base.as_ptr(), definition.current_length())
+            });
+        }
+        let memories = vm::MemorySnapshot::new(store.engine(), memories)?;
+
+        let mut globals = Vec::new();
+        for (index, ty) in env_module.globals.iter() {
+            let Some(index) = env_module.defined_global_index(index) else {
+                continue;
+            };
+            if !ty.mutability {
+                continue;
+            }
+            if let wasmtime_environ::WasmValType::Ref(_) = ty.wasm_ty {
+                bail!("cannot snapshot an instance which defines a mutable reference global");
+            }
+            // SAFETY: the global is of a numeric or vector type so all of its
+            // definition is plain data.
+            globals.push((index, unsafe {
+                instance.global_ptr(index).as_ref().get_u128()
+            }));
+        }
+
+        Ok(InstanceSnapshot {
+            module,
+            memories,
+            globals,
+        })
+    }
+
     /// Returns the list of exported items from this [`Instance`].
     ///
     /// # Panics
@@ -747,6 +855,36 @@ pub struct InstancePre<T> {
     _marker: core::marker::PhantomData<fn() -> T>,
 }
 
+/// An [`InstancePre`] which doesn't keep its module alive, see
+/// [`InstancePre::downgrade`].
+pub(crate) struct WeakInstancePre<T> {
+    module: WeakModule,
+    items: Arc<[Definition]>,
+    host_funcs: usize,
+    /// Note that these point into the code of `module`, so they're only valid
+    /// while it's alive.
+    func_refs: Arc<[VMFuncRef]>,
+    _marker: core::marker::PhantomData<fn() -> T>,
+}
+
+impl<T> WeakInstancePre<T> {
+    /// Returns the original [`InstancePre`] if its module is still alive.
+    pub(crate) fn upgrade(&self) -> Option<InstancePre<T>> {
+        Some(InstancePre {
+            module: self.module.upgrade()?,
+            items: self.items.clone(),
+            host_funcs: self.host_funcs,
+            func_refs: self.func_refs.clone(),
+            _marker: self._marker,
+        })
+    }
+
+    /// Returns whether the module is still alive.
+    pub(crate) fn is_alive(&self) -> bool {
+        self.module.is_alive()
+    }
+}
+
 /// InstancePre's clone does not require T: Clone
 impl<T> Clone for InstancePre<T> {
     fn clone(&self) -> Self {
@@ -809,6 +947,18 @@ impl<T: 'static> InstancePre<T> {
         &self.module
     }
 
+    /// Returns a copy of this [`InstancePre`] which doesn't keep its module
+    /// alive.
+    pub(crate) fn downgrade(&self) -> WeakInstancePre<T> {
+        WeakInstancePre {
+            module: self.module.downgrade(),
+            items: self.items.clone(),
+            host_funcs: self.host_funcs,
+            func_refs: self.func_refs.clone(),
+            _marker: self._marker,
+        }
+    }
+
     /// Instantiates this instance, creating a new instance within the provided
     /// `store`.
     ///
@@ -869,6 +1019,118 @@ impl<T: 'static> InstancePre<T> {
         // in match the module we're instantiating.
         unsafe { Instance::new_started_async(&mut store, &self.module, imports.as_ref()).await }
     }
+
+    /// Instantiates this instance's module from `snapshot`, creating a new
+    /// instance within the provided `store`.
+    ///
+    /// The new instance starts out in the state that the instance passed to
+    /// [`Instance::snapshot`] was in: its memories hold the captured contents
+    /// and its mutable globals the captured values. The module's data segments
+    /// and `start` function aren't run again since their effects are already
+    /// part of the snapshot. Everything else, such as tables, is initialized
+    /// as it would be by [`InstancePre::instantiate`], using the imports this
+    /// [`InstancePre`] closed over.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `snapshot` was taken from an instance of a
+    /// different module than this [`InstancePre`]'s, or if instantiation fails
+    /// as it would for [`InstancePre::instantiate`].
+    ///
+    /// # Panics
+    ///
+    /// Panics in the same situations as [`InstancePre::instantiate`].
+    pub fn instantiate_snapshot(
+        &self,
+        mut store: impl AsContextMut<Data = T>,
+        snapshot: &InstanceSnapshot,
+    ) -> Result<Instance> {
+        let mut store = store.as_context_mut();
+        assert!(
+            !store.0.async_support(),
+            "must use async instantiation when async support is enabled",
+        );
+        let imports = self.pre_instantiate_snapshot(&mut store.0, snapshot)?;
+
+        // SAFETY: the imports were type-checked by the constructor of
+        // `InstancePre` and the snapshot is of the same module.
+        let (instance, _) =
+            unsafe { Instance::new_raw(store.0, &self.module, imports.as_ref(), Some(snapshot))? };
+        Ok(instance)
+    }
+
+    /// Same as [`InstancePre::instantiate_snapshot`], but for stores with
+    /// async support enabled.
+    ///
+    /// # Panics
+    ///
+    /// Panics in the same situations as [`InstancePre::instantiate_async`].
+    #[cfg(feature = "async")]
+    pub async fn instantiate_snapshot_async(
+        &self,
+        mut store: impl AsContextMut<Data: Send>,
+        snapshot: &InstanceSnapshot,
+    ) -> Result<Instance> {
+        let mut store = store.as_context_mut();
+        assert!(
+            store.0.async_support(),
+            "must use sync instantiation when async support is disabled",
+        );
+        let owned_imports = self.pre_instantiate_snapshot(&mut store.0, snapshot)?;
+        let module = &self.module;
+        let imports = owned_imports.as_ref();
+
+        // Allocation runs on a fiber since an async resource limiter may need
+        // to yield.
+        store
+            .on_fiber(|store| {
+                // SAFETY: see `instantiate_snapshot`.
+                let (instance, _) =
+                    unsafe { Instance::new_raw(store.0, module, imports, Some(snapshot))? };
+                Ok(instance)
+            })
+            .await?
+    }
+
+    fn pre_instantiate_snapshot(
+        &self,
+        store: &mut StoreOpaque,
+        snapshot: &InstanceSnapshot,
+    ) -> Result<OwnedImports> {
+        if snapshot.module.id() != self.module.id() {
+            bail!("snapshot was taken from an instance of a different module");
+        }
+        pre_instantiate_raw(
+            store,
+            &self.module,
+            &self.items,
+            self.host_funcs,
+            &self.func_refs,
+        )
+    }
+}
+
+/// The state of an [`Instance`] captured by [`Instance::snapshot`], used as a
+/// template for new instances of the same module.
+///
+/// Instantiating from a snapshot with [`InstancePre::instantiate_snapshot`]
+/// skips the initialization that the original instance performed, and when
+/// copy-on-write memory initialization is enabled new instances share the
+/// snapshot's memory pages until they write to them. A snapshot is
+/// independent of the [`Store`](crate::Store) it was taken from and can be
+/// shared across threads to create instances in many stores concurrently.
+pub struct InstanceSnapshot {
+    module: Module,
+    memories: vm::MemorySnapshot,
+    /// The raw bits of each mutable global defined by the instance.
+    globals: Vec<(DefinedGlobalIndex, u128)>,
+}
+
+impl InstanceSnapshot {
+    /// Returns the module of the instance this snapshot was taken from.
+    pub fn module(&self) -> &Module {
+        &self.module
+    }
 }
 
 /// Helper function shared between
@@ -1,7 +1,9 @@
 use crate::func::HostFunc;
 use crate::hash_map::{Entry, HashMap};
-use crate::instance::InstancePre;
+use crate::instance::{InstancePre, WeakInstancePre};
+use crate::runtime::vm::CompiledModuleId;
 use crate::store::StoreOpaque;
+use crate::sync::RwLock;
 use crate::{
     AsContext, AsContextMut, Caller, Engine, Extern, ExternType, Func, FuncType, ImportType,
     Instance, Module, StoreContextMut, Val, ValRaw,
@@ -12,6 +14,7 @@ use core::fmt::{self, Debug};
 #[cfg(feature = "async")]
 use core::future::Future;
 use core::marker;
+use core::sync::atomic::{AtomicU64, Ordering};
 use log::warn;
 
 /// Structure used to link wasm modules/instances together.
@@ -87,9 +90,27 @@ pub struct Linker<T> {
     map: HashMap<ImportKey, Definition>,
     allow_shadowing: bool,
     allow_unknown_exports: bool,
+    /// The result of `_instantiate_pre` for modules recently instantiated
+    /// with this linker, cleared whenever a definition changes. Entries don't
+    /// keep their modules alive, and are evicted once they've been dropped.
+    instance_pres: RwLock<HashMap<CompiledModuleId, CachedInstancePre<T>>>,
+    /// Incremented on each use of `instance_pres` to order its entries by how
+    /// recently they were used.
+    instance_pres_clock: AtomicU64,
     _marker: marker::PhantomData<fn() -> T>,
 }
 
+/// Maximum number of modules whose resolved imports are cached in a
+/// [`Linker`], see [`Linker::instantiate`].
+const MAX_CACHED_INSTANCE_PRES: usize = 64;
+
+struct CachedInstancePre<T> {
+    pre: WeakInstancePre<T>,
+    /// The value of `Linker::instance_pres_clock` when this entry was last
+    /// used, for evicting the least recently used entry.
+    last_used: AtomicU64,
+}
+
 impl<T> Debug for Linker<T> {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         f.debug_struct("Linker").finish_non_exhaustive()
@@ -105,6 +126,8 @@ impl<T> Clone for Linker<T> {
             map: self.map.clone(),
             allow_shadowing: self.allow_shadowing,
             allow_unknown_exports: self.allow_unknown_exports,
+            instance_pres: RwLock::new(HashMap::new()),
+            instance_pres_clock: AtomicU64::new(0),
             _marker: self._marker,
         }
     }
@@ -153,6 +176,8 @@ impl<T> Linker<T> {
             strings: Vec::new(),
             allow_shadowing: false,
             allow_unknown_exports: false,
+            instance_pres: RwLock::new(HashMap::new()),
+            instance_pres_clock: AtomicU64::new(0),
             _marker: marker::PhantomData,
         }
     }
@@ -1031,6 +1056,7 @@ impl<T> Linker<T> {
     }
 
     fn insert(&mut self, key: ImportKey, item: Definition) -> Result<()> {
+        self.instance_pres.write().clear();
         match self.map.entry(key) {
             Entry::Occupied(_) if !self.allow_shadowing => {
                 let module = &self.strings[key.module];
@@ -1093,6 +1119,15 @@ impl<T> Linker<T> {
     /// failures see [`Instance::new`]. If an import is not found, the error
     /// may be downcast to an [`UnknownImportError`].
     ///
+    /// # Caching
+    ///
+    /// Resolving and type-checking imports is cached for recently
+    /// instantiated modules, so instantiating the same module repeatedly is
+    /// as fast as using an [`InstancePre`] from [`Linker::instantiate_pre`].
+    /// The cache is cleared whenever an item is defined in this linker, and
+    /// doesn't keep modules alive: a module's entry is evicted once the module
+    /// has been dropped. Modules which import tables or memories are not
+    /// cached since their current size is checked on each instantiation.
     ///
     /// # Panics
     ///
@@ -1221,16 +1256,55 @@ impl<T> Linker<T> {
     where
         T: 'static,
     {
+        let now = self.instance_pres_clock.fetch_add(1, Ordering::Relaxed);
+        if let Some(cached) = self.instance_pres.read().get(&module.id()) {
+            // `module` is alive, so this always succeeds.
+            if let Some(pre) = cached.pre.upgrade() {
+                cached.last_used.store(now, Ordering::Relaxed);
+                return Ok(pre);
+            }
+        }
+
         let mut imports = module
             .imports()
             .map(|import| self._get_by_import(&import))
             .collect::<Result<Vec<_>, _>>()?;
-        if let Some(store) = store {
-            for import in imports.iter_mut() {
-                import.update_size(store);
+        let mut cacheable = true;
+        for import in imports.iter_mut() {
+            let sized = matches!(
+                import,
+                Definition::Extern(_, DefinitionType::Table(..) | DefinitionType::Memory(..))
+            );
+            if sized {
+                cacheable = false;
+                if let Some(store) = store {
+                    import.update_size(store);
+                }
+            }
+        }
+        let pre = unsafe { InstancePre::new(module, imports)? };
+
+        if cacheable {
+            let mut cache = self.instance_pres.write();
+            cache.retain(|_, cached| cached.pre.is_alive());
+            if cache.len() >= MAX_CACHED_INSTANCE_PRES {
+                let lru = cache
+                    .iter()
+                    .min_by_key(|(_, cached)| cached.last_used.load(Ordering::Relaxed))
+                    .map(|(id, _)| *id);
+                if let Some(lru) = lru {
+                    cache.remove(&lru);
+                }
             }
+            cache.insert(
+                module.id(),
+                CachedInstancePre {
+                    pre: pre.downgrade(),
+                    last_used: AtomicU64::new(now),
+                },
+            );
         }
-        unsafe { InstancePre::new(module, imports) }
+        Ok(pre)
     }
 
     /// Returns an iterator over all items defined in this `Linker`, in
@@ -1537,3 +1611,36 @@ impl fmt::Display for UnknownImportError {
 }
 
 impl core::error::Error for UnknownImportError {}
+
+#[cfg(test)]
+mod tests {
+    use crate::{Engine, Linker, Module, Store};
+
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn cache_does_not_keep_modules_alive() -> crate::Result<()> {
+        let engine = Engine::default();
+        let mut linker = Linker::new(&engine);
+        linker.func_wrap("", "f", || {})?;
+
+        let wat = r#"(module (import "" "f" (func)))"#;
+        let instantiate = |module: &Module| -> crate::Result<()> {
+            let mut store = Store::new(&engine, ());
+            linker.instantiate(&mut store, module)?;
+            Ok(())
+        };
+
+        let module = Module::new(&engine, wat)?;
+        instantiate(&module)?;
+        assert_eq!(linker.instance_pres.read().len(), 1);
+        let weak = module.downgrade();
+        drop(module);
+        assert!(!weak.is_alive());
+
+        // Caching another module evicts the entry of the dropped one.
+        let module = Module::new(&engine, wat)?;
+        instantiate(&module)?;
+        assert_eq!(linker.instance_pres.read().len(), 1);
+        Ok(())
+    }
+}
@@ -11,7 +11,7 @@ use crate::{
     resources::ResourcesRequired,
     types::{ExportType, ExternType, ImportType},
 };
-use alloc::sync::Arc;
+use alloc::sync::{Arc, Weak};
 use core::fmt;
 use core::ops::Range;
 use core::ptr::NonNull;
@@ -129,6 +129,26 @@ pub struct Module {
     inner: Arc<ModuleInner>,
 }
 
+/// A handle to a [`Module`] which doesn't keep it alive, see
+/// [`Module::downgrade`].
+pub(crate) struct WeakModule {
+    inner: Weak<ModuleInner>,
+}
+
+impl WeakModule {
+    /// Returns the module if it's still alive.
+    pub(crate) fn upgrade(&self) -> Option<Module> {
+        Some(Module {
+            inner: self.inner.upgrade()?,
+        })
+    }
+
+    /// Returns whether the module is still alive.
+    pub(crate) fn is_alive(&self) -> bool {
+        self.inner.strong_count() > 0
+    }
+}
+
 struct ModuleInner {
     engine: Engine,
     /// The compiled artifacts for this module that will be instantiated and
@@ -516,7 +536,13 @@ impl Module {
 
         // Package up all our data into a `CodeObject` and delegate to the final
         // step of module compilation.
-        let code = Arc::new(CodeObject::new(code_memory, signatures, types.into()));
+        let wasm_funcs = info.funcs.values().map(|f| f.wasm_func_loc);
+        let code = Arc::new(CodeObject::new(
+            code_memory,
+            signatures,
+            types.into(),
+            wasm_funcs,
+        ));
         Module::from_parts_raw(engine, code, info, true)
     }
 
@@ -1068,6 +1094,13 @@ impl Module {
         self.inner.module.unique_id()
     }
 
+    /// Returns a handle to this module which doesn't keep it alive.
+    pub(crate) fn downgrade(&self) -> WeakModule {
+        WeakModule {
+            inner: Arc::downgrade(&self.inner),
+        }
+    }
+
     pub(crate) fn offsets(&self) -> &VMOffsets<HostPtr> {
         &self.inner.offsets
     }
@@ -10,7 +10,7 @@ use crate::{FrameInfo, Module, code_memory::CodeMemory};
 use alloc::collections::btree_map::{BTreeMap, Entry};
 use alloc::sync::Arc;
 use core::ptr::NonNull;
-use wasmtime_environ::VMSharedTypeIndex;
+use wasmtime_environ::{FunctionLoc, VMSharedTypeIndex};
 
 /// Used for registering modules with a store.
 ///
@@ -84,7 +84,9 @@ impl ModuleRegistry {
         Some((code, pc - *start))
     }
 
-    fn module_and_offset(&self, pc: usize) -> Option<(&Module, usize)> {
+    /// Looks up the module containing `pc` and the offset of `pc` within that
+    /// module's text section.
+    pub(crate) fn module_and_offset(&self, pc: usize) -> Option<(&Module, usize)> {
         let (code, offset) = self.code(pc)?;
         Some((code.module(pc)?, offset))
     }
@@ -266,15 +268,56 @@ fn global_code() -> &'static RwLock<GlobalRegistry> {
     GLOBAL_CODE.get_or_init(Default::default)
 }
 
-type GlobalRegistry = BTreeMap<usize, (usize, Arc<CodeMemory>)>;
+type GlobalRegistry = BTreeMap<usize, (usize, GlobalCode)>;
+
+struct GlobalCode {
+    code: Arc<CodeMemory>,
+
+    /// The locations of the defined wasm functions within `code`, sorted by
+    /// their start offset. Anything else in the text section is a trampoline
+    /// or other code generated by Wasmtime.
+    #[cfg_attr(
+        not(all(feature = "std", unix, has_native_signals)),
+        allow(dead_code, reason = "only used to deliver interrupts")
+    )]
+    wasm_funcs: Box<[FunctionLoc]>,
+}
 
 /// Find which registered region of code contains the given program counter, and
 /// what offset that PC is within that module's code.
 pub fn lookup_code(pc: usize) -> Option<(Arc<CodeMemory>, usize)> {
     let all_modules = global_code().read();
-    let (_end, (start, module)) = all_modules.range(pc..).next()?;
+    let (_end, (start, code)) = all_modules.range(pc..).next()?;
     let text_offset = pc.checked_sub(*start)?;
-    Some((module.clone(), text_offset))
+    Some((code.code.clone(), text_offset))
+}
+
+/// Returns whether `pc` is within the body of a defined wasm function, as
+/// opposed to a trampoline or code that isn't Wasmtime's.
+///
+/// Unlike [`lookup_code`] this never blocks, and `false` is also returned if
+/// looking up the code would block, for example when a signal arrives while
+/// the current thread is registering code.
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub fn try_is_wasm_func(pc: usize) -> bool {
+    let Some(all_modules) = global_code().try_read() else {
+        return false;
+    };
+    let Some((_end, (start, code))) = all_modules.range(pc..).next() else {
+        return false;
+    };
+    let Some(text_offset) = pc.checked_sub(*start) else {
+        return false;
+    };
+    let Ok(text_offset) = u32::try_from(text_offset) else {
+        return false;
+    };
+    let index = code
+        .wasm_funcs
+        .partition_point(|loc| loc.start + loc.length <= text_offset);
+    code.wasm_funcs
+        .get(index)
+        .is_some_and(|loc| loc.start <= text_offset)
 }
 
 /// Registers a new region of code.
@@ -285,14 +328,22 @@ pub fn lookup_code(pc: usize) -> Option<(Arc<CodeMemory>, usize)> {
 /// This is required to enable traps to work correctly since the signal handler
 /// will lookup in the `GLOBAL_CODE` list to determine which a particular pc
 /// is a trap or not.
-pub fn register_code(code: &Arc<CodeMemory>) {
+///
+/// The `wasm_funcs` are the locations of all wasm functions defined in `code`.
+pub fn register_code(code: &Arc<CodeMemory>, wasm_funcs: impl IntoIterator<Item = FunctionLoc>) {
     let text = code.text();
     if text.is_empty() {
         return;
     }
     let start = text.as_ptr() as usize;
     let end = start + text.len() - 1;
-    let prev = global_code().write().insert(end, (start, code.clone()));
+    let mut wasm_funcs = wasm_funcs.into_iter().collect::<Box<[_]>>();
+    wasm_funcs.sort_unstable_by_key(|loc| loc.start);
+    let code = GlobalCode {
+        code: code.clone(),
+        wasm_funcs,
+    };
+    let prev = global_code().write().insert(end, (start, code));
     assert!(prev.is_none());
 }
 
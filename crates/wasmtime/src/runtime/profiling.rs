@@ -3,7 +3,7 @@ use crate::component::Component;
 use crate::instantiate::CompiledModule;
 use crate::prelude::*;
 use crate::runtime::vm::Backtrace;
-use crate::{AsContext, CallHook, Module};
+use crate::{AsContext, CallHook, CallProfile, Module};
 use core::cmp::Ordering;
 use fxprof_processed_profile::debugid::DebugId;
 use fxprof_processed_profile::{
@@ -13,7 +13,12 @@ use fxprof_processed_profile::{
 use std::ops::Range;
 use std::sync::Arc;
 use std::time::{Duration, Instant};
-use wasmtime_environ::demangle_function_name_or_index;
+use wasmtime_environ::{ProfiledFunc, StaticModuleIndex, demangle_function_name_or_index};
+
+#[cfg(target_has_atomic = "64")]
+mod sampler;
+#[cfg(target_has_atomic = "64")]
+pub use sampler::StackSampler;
 
 // TODO: collect more data
 // - On non-Windows, measure thread-local CPU usage between events with
@@ -72,6 +77,15 @@ use wasmtime_environ::demangle_function_name_or_index;
 /// where they don't already have the WebAssembly module binary available this
 /// could theoretically lead to an undesirable information disclosure. So you
 /// should only include user-provided modules in profiles.
+///
+/// # Profile-guided optimization
+///
+/// In addition to the Firefox profile, every sample also records which Wasm
+/// functions were on the stack and which of them were calling each other. This
+/// is available as a [`CallProfile`] through [`GuestProfiler::call_profile`]
+/// and can be fed back into compilation with
+/// [`CodeBuilder::call_profile`](crate::CodeBuilder::call_profile) so that hot
+/// call sites are favored by the inliner.
 #[derive(Debug)]
 pub struct GuestProfiler {
     profile: Profile,
@@ -79,6 +93,8 @@ pub struct GuestProfiler {
     process: fxprof_processed_profile::ProcessHandle,
     thread: fxprof_processed_profile::ThreadHandle,
     start: Instant,
+    call_profile: CallProfile,
+    call_stack: Vec<ProfiledFunc>,
 }
 
 #[derive(Debug)]
@@ -86,6 +102,10 @@ struct ProfiledModule {
     module: Module,
     fxprof_libhandle: fxprof_processed_profile::LibraryHandle,
     text_range: Range<usize>,
+    /// The index of this module within the compilation unit described by
+    /// `GuestProfiler::call_profile`, or `None` if this module's frames are
+    /// not recorded there.
+    static_index: Option<StaticModuleIndex>,
 }
 
 type Modules = Vec<ProfiledModule>;
@@ -106,10 +126,29 @@ impl GuestProfiler {
     /// host code or functions from other modules will be omitted. See the
     /// "Security" section of the [`GuestProfiler`] documentation for guidance
     /// on what modules should not be included in this list.
+    ///
+    /// The [`CallProfile`] of this profiler describes the first module in
+    /// `modules`.
     pub fn new(
         module_name: &str,
         interval: Duration,
         modules: impl IntoIterator<Item = (String, Module)>,
+    ) -> Self {
+        let modules = modules.into_iter().enumerate().map(|(i, (name, module))| {
+            let static_index = if i == 0 {
+                Some(StaticModuleIndex::from_u32(0))
+            } else {
+                None
+            };
+            (name, module, static_index)
+        });
+        Self::new_with_static_indices(module_name, interval, modules)
+    }
+
+    fn new_with_static_indices(
+        module_name: &str,
+        interval: Duration,
+        modules: impl IntoIterator<Item = (String, Module, Option<StaticModuleIndex>)>,
     ) -> Self {
         let zero = ReferenceTimestamp::from_millis_since_unix_epoch(0.0);
         let mut profile = Profile::new(module_name, zero, interval.into());
@@ -118,7 +157,7 @@ impl GuestProfiler {
         // the disparate module information from components.
         let mut modules: Vec<_> = modules
             .into_iter()
-            .filter_map(|(name, module)| {
+            .filter_map(|(name, module, static_index)| {
                 let compiled = module.compiled_module();
                 let text_range = {
                     // Assumption: within text, the code for a given module is packed linearly and
@@ -136,6 +175,7 @@ impl GuestProfiler {
                         module,
                         fxprof_libhandle: libhandle,
                         text_range,
+                        static_index,
                     }
                 })
             })
@@ -153,6 +193,8 @@ impl GuestProfiler {
             process,
             thread,
             start,
+            call_profile: CallProfile::new(),
+            call_stack: Vec::new(),
         }
     }
 
@@ -161,6 +203,9 @@ impl GuestProfiler {
     /// See [`GuestProfiler::new`] for additional information; this function
     /// works identically except that it takes a component and sets up
     /// instrumentation to track calls in each of its constituent modules.
+    ///
+    /// The [`CallProfile`] of this profiler describes `component`; frames from
+    /// `extra_modules` are not recorded in it.
     #[cfg(feature = "component-model")]
     pub fn new_component(
         component_name: &str,
@@ -170,9 +215,16 @@ impl GuestProfiler {
     ) -> Self {
         let modules = component
             .static_modules()
-            .map(|m| (m.name().unwrap_or("<unknown>").to_string(), m.clone()))
-            .chain(extra_modules);
-        Self::new(component_name, interval, modules)
+            .enumerate()
+            .map(|(i, m)| {
+                (
+                    m.name().unwrap_or("<unknown>").to_string(),
+                    m.clone(),
+                    Some(StaticModuleIndex::from_u32(u32::try_from(i).unwrap())),
+                )
+            })
+            .chain(extra_modules.into_iter().map(|(name, m)| (name, m, None)));
+        Self::new_with_static_indices(component_name, interval, modules)
     }
 
     /// Add a sample to the profile. This function collects a backtrace from
@@ -191,6 +243,22 @@ impl GuestProfiler {
         let frames = lookup_frames(&self.modules, &backtrace);
         self.profile
             .add_sample(self.thread, now, frames, delta.into(), 1);
+
+        self.call_stack.clear();
+        self.call_stack
+            .extend(lookup_profiled_funcs(&self.modules, &backtrace));
+        self.call_profile.record_stack(&self.call_stack);
+    }
+
+    /// Returns the call-edge profile accumulated from all samples taken so
+    /// far.
+    ///
+    /// This profile can be persisted with [`CallProfile::to_bytes`], merged
+    /// with profiles from other stores running the same code, and passed to
+    /// [`CodeBuilder::call_profile`](crate::CodeBuilder::call_profile) when
+    /// recompiling the same module or component.
+    pub fn call_profile(&self) -> &CallProfile {
+        &self.call_profile
     }
 
     /// Add a marker for transitions between guest and host to the profile.
@@ -276,6 +344,19 @@ fn module_symbols(name: String, compiled: &CompiledModule) -> Option<LibraryInfo
     })
 }
 
+fn lookup_module(modules: &Modules, pc: usize) -> Option<&ProfiledModule> {
+    let idx = modules
+        .binary_search_by(|probe| {
+            if probe.text_range.contains(&pc) {
+                Ordering::Equal
+            } else {
+                probe.text_range.start.cmp(&pc)
+            }
+        })
+        .ok()?;
+    modules.get(idx)
+}
+
 fn lookup_frames<'a>(
     modules: &'a Modules,
     backtrace: &'a Backtrace,
@@ -286,16 +367,7 @@ fn lookup_frames<'a>(
         // first, so iterate in reverse.
         .rev()
         .filter_map(|frame| {
-            let idx = modules
-                .binary_search_by(|probe| {
-                    if probe.text_range.contains(&frame.pc()) {
-                        Ordering::Equal
-                    } else {
-                        probe.text_range.start.cmp(&frame.pc())
-                    }
-                })
-                .ok()?;
-            let module = modules.get(idx)?;
+            let module = lookup_module(modules, frame.pc())?;
 
             // We need to point to the modules full text (not just its functions) as
             // the offset for the final phase; these can be different for component
@@ -312,6 +384,24 @@ fn lookup_frames<'a>(
         })
 }
 
+/// Like `lookup_frames` but resolves frames to the defined functions recorded
+/// in a `CallProfile`, oldest frame first.
+fn lookup_profiled_funcs<'a>(
+    modules: &'a Modules,
+    backtrace: &'a Backtrace,
+) -> impl Iterator<Item = ProfiledFunc> + 'a {
+    backtrace.frames().rev().filter_map(|frame| {
+        let module = lookup_module(modules, frame.pc())?;
+        let static_index = module.static_index?;
+        let module_text_start = module.module.text().as_ptr_range().start as usize;
+        let (def_func, _) = module
+            .module
+            .compiled_module()
+            .func_by_text_offset(frame.pc() - module_text_start)?;
+        Some((static_index, def_func))
+    })
+}
+
 struct CallMarker;
 
 impl ProfilerMarker for CallMarker {
@@ -0,0 +1,274 @@
+use crate::hash_map::HashMap;
+use crate::prelude::*;
+use crate::runtime::vm::{Backtrace, CompiledModuleId};
+use crate::{AsContext, Engine, Module, Store, StoreContext, UpdateDeadline};
+use std::fmt::Write as _;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, Condvar, Mutex};
+use std::thread::JoinHandle;
+use std::time::Duration;
+use wasmtime_environ::{DefinedFuncIndex, demangle_function_name_or_index};
+
+/// Continuously samples the WebAssembly stacks of many stores and aggregates
+/// them into folded stacks, for example to render flamegraphs of production
+/// workloads.
+///
+/// Unlike [`GuestProfiler`](crate::GuestProfiler), which records a detailed
+/// profile for a single guest and must be driven by the embedder, a
+/// `StackSampler` is cheap to attach to every store and collects samples
+/// on its own. Creating a sampler spawns a thread which increments the
+/// engine's epoch at the configured interval, and every store passed to
+/// [`StackSampler::attach`] records a sample of its own stack whenever it
+/// observes a new epoch while running WebAssembly. Stores can be short-lived:
+/// their samples remain in the sampler after they're dropped.
+///
+/// Samples are aggregated by the tag given to [`StackSampler::attach`], for
+/// example to attribute them to a tenant, and by the sequence of functions on
+/// the stack. See [`StackSampler::folded`] for the format in which they are
+/// retrieved. The sampler only keeps the names of sampled functions, not their
+/// modules, and the number of distinct stacks it keeps is bounded by
+/// [`StackSampler::set_max_stacks`], so it can run indefinitely.
+///
+/// # Requirements
+///
+/// The engine must have [`Config::epoch_interruption`] enabled and the
+/// sampler takes over epochs for the whole engine: attached stores have their
+/// epoch deadline callback replaced, and the engine's epoch advances once per
+/// interval. Embedders which also use epochs to bound execution time should
+/// account for that tick rate, and should only create one sampler per engine.
+///
+/// # Accuracy
+///
+/// Like [`GuestProfiler`](crate::GuestProfiler) with epoch interruption,
+/// samples are only taken at function entries and loop headers, and only
+/// while WebAssembly is running rather than the host. Samples only include
+/// WebAssembly frames of the store being sampled.
+///
+/// [`Config::epoch_interruption`]: crate::Config::epoch_interruption
+pub struct StackSampler {
+    shared: Arc<Shared>,
+    ticker: Option<JoinHandle<()>>,
+}
+
+struct Shared {
+    /// Set when the sampler is dropped to stop the ticker thread.
+    stopped: Mutex<bool>,
+    stop: Condvar,
+    samples: Mutex<Samples>,
+    /// The maximum number of entries in `Samples::stacks`.
+    max_stacks: AtomicUsize,
+}
+
+#[derive(Default)]
+struct Samples {
+    /// Number of samples taken for each tag and stack, oldest frame first.
+    stacks: HashMap<(Arc<str>, Vec<SampledFunc>), u64>,
+    /// Number of samples taken for each tag whose stack wasn't in `stacks`
+    /// once it was full.
+    other: HashMap<Arc<str>, u64>,
+    /// The name of every function which appears in `stacks`, as
+    /// ``module`function``. Names rather than modules are kept so that samples
+    /// don't keep modules alive.
+    names: HashMap<SampledFunc, Box<str>>,
+}
+
+type SampledFunc = (CompiledModuleId, DefinedFuncIndex);
+
+/// The default for [`StackSampler::set_max_stacks`].
+const DEFAULT_MAX_STACKS: usize = 10_000;
+
+impl StackSampler {
+    /// Creates a new sampler for stores in `engine`, sampling them every
+    /// `interval`.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `engine` doesn't have
+    /// [`Config::epoch_interruption`](crate::Config::epoch_interruption)
+    /// enabled, if `interval` is zero, or if the ticker thread can't be
+    /// spawned.
+    pub fn new(engine: &Engine, interval: Duration) -> Result<StackSampler> {
+        if !engine.tunables().epoch_interruption {
+            bail!("stack sampling requires epoch interruption to be enabled");
+        }
+        if interval.is_zero() {
+            bail!("stack sampling interval must not be zero");
+        }
+        let shared = Arc::new(Shared {
+            stopped: Mutex::new(false),
+            stop: Condvar::new(),
+            samples: Mutex::default(),
+            max_stacks: AtomicUsize::new(DEFAULT_MAX_STACKS),
+        });
+        let ticker = {
+            let shared = shared.clone();
+            let engine = engine.clone();
+            std::thread::Builder::new()
+                .name("wasmtime-stack-sampler".to_string())
+                .spawn(move || {
+                    let mut stopped = shared.stopped.lock().unwrap();
+                    loop {
+                        stopped = shared.stop.wait_timeout(stopped, interval).unwrap().0;
+                        if *stopped {
+                            break;
+                        }
+                        engine.increment_epoch();
+                    }
+                })?
+        };
+        Ok(StackSampler {
+            shared,
+            ticker: Some(ticker),
+        })
+    }
+
+    /// Starts sampling `store`, attributing its samples to `tag`.
+    ///
+    /// This replaces any epoch deadline callback previously configured for
+    /// `store` and sets its epoch deadline to the next tick of this sampler.
+    pub fn attach<T: 'static>(&self, store: &mut Store<T>, tag: &str) {
+        let shared = self.shared.clone();
+        let tag: Arc<str> = tag.into();
+        store.set_epoch_deadline(1);
+        store.epoch_deadline_callback(move |store| {
+            shared.record(&tag, store.as_context());
+            Ok(UpdateDeadline::Continue(1))
+        });
+    }
+
+    /// Sets the maximum number of distinct tags and stacks which are kept,
+    /// 10,000 by default.
+    ///
+    /// Once this many have been sampled, samples of any other stack are only
+    /// counted per tag, and show up in [`StackSampler::folded`] as a single
+    /// `[other]` frame below the tag. Lowering the limit doesn't discard
+    /// stacks which were already sampled, but [`StackSampler::reset`] does.
+    pub fn set_max_stacks(&self, max: usize) {
+        self.shared.max_stacks.store(max, Ordering::Relaxed);
+    }
+
+    /// Returns the total number of samples taken so far.
+    pub fn sample_count(&self) -> u64 {
+        let samples = self.shared.samples.lock().unwrap();
+        samples.stacks.values().sum::<u64>() + samples.other.values().sum::<u64>()
+    }
+
+    /// Returns all samples taken so far as folded stacks.
+    ///
+    /// There's one line per distinct tag and stack, with the number of
+    /// samples of that stack at the end of the line. Each stack starts with
+    /// the tag, followed by the functions on the stack from the oldest to the
+    /// youngest, separated by semicolons. Functions are named
+    /// ``module`function``, where `module` is the module's
+    /// [name](Module::name). For example:
+    ///
+    /// ```text
+    /// tenant-a;app`_start;app`main;app`fib 42
+    /// tenant-b;lib`run 7
+    /// ```
+    ///
+    /// This is the format used by `inferno` and `flamegraph.pl`, so rendered
+    /// flamegraphs are split by tag first and by module second.
+    pub fn folded(&self) -> String {
+        let samples = self.shared.samples.lock().unwrap();
+        let mut lines = samples
+            .stacks
+            .iter()
+            .map(|((tag, stack), count)| {
+                let mut line = String::from(&**tag);
+                for func in stack {
+                    line.push(';');
+                    line.push_str(&samples.names[func]);
+                }
+                write!(line, " {count}").unwrap();
+                line
+            })
+            .chain(
+                samples
+                    .other
+                    .iter()
+                    .map(|(tag, count)| format!("{tag};[other] {count}")),
+            )
+            .collect::<Vec<_>>();
+        lines.sort_unstable();
+
+        let mut folded = String::new();
+        for line in lines {
+            folded.push_str(&line);
+            folded.push('\n');
+        }
+        folded
+    }
+
+    /// Discards all samples taken so far.
+    pub fn reset(&self) {
+        *self.shared.samples.lock().unwrap() = Samples::default();
+    }
+}
+
+impl Drop for StackSampler {
+    fn drop(&mut self) {
+        *self.shared.stopped.lock().unwrap() = true;
+        self.shared.stop.notify_one();
+        if let Some(ticker) = self.ticker.take() {
+            let _ = ticker.join();
+        }
+    }
+}
+
+impl Shared {
+    fn record<T>(&self, tag: &Arc<str>, store: StoreContext<'_, T>) {
+        let backtrace = Backtrace::new(store.0);
+        let registry = store.0.modules();
+
+        // Resolve frames to functions before taking the lock. Return
+        // addresses point just past the call, so look up the call itself.
+        let stack = backtrace
+            .frames()
+            .rev()
+            .filter_map(|frame| {
+                let (module, offset) = registry.module_and_offset(frame.pc() - 1)?;
+                let (index, _) = module.compiled_module().func_by_text_offset(offset)?;
+                Some((module, index))
+            })
+            .collect::<Vec<_>>();
+
+        let key = (
+            tag.clone(),
+            stack
+                .iter()
+                .map(|(module, index)| (module.id(), *index))
+                .collect::<Vec<_>>(),
+        );
+        let mut samples = self.samples.lock().unwrap();
+        if let Some(count) = samples.stacks.get_mut(&key) {
+            *count += 1;
+            return;
+        }
+        if samples.stacks.len() >= self.max_stacks.load(Ordering::Relaxed) {
+            *samples.other.entry(key.0).or_insert(0) += 1;
+            return;
+        }
+        for (module, index) in stack {
+            samples
+                .names
+                .entry((module.id(), index))
+                .or_insert_with(|| func_name(module, index));
+        }
+        samples.stacks.insert(key, 1);
+    }
+}
+
+fn func_name(module: &Module, index: DefinedFuncIndex) -> Box<str> {
+    let mut name = String::from(module.name().unwrap_or("<unknown>"));
+    name.push('`');
+    let compiled = module.compiled_module();
+    let func_index = compiled.module().func_index(index);
+    demangle_function_name_or_index(
+        &mut name,
+        compiled.func_name(func_index),
+        func_index.as_u32() as usize,
+    )
+    .unwrap();
+    name.into()
+}
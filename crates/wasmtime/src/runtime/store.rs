@@ -391,6 +391,11 @@ pub struct StoreOpaque {
     /// guest code.
     pkey: Option<ProtectionKey>,
 
+    /// State shared with this store's interrupt handles, created when the
+    /// first handle is requested.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    interrupt: Option<Arc<vm::InterruptState>>,
+
     /// Runtime state for components used in the handling of resources, borrow,
     /// and calls. These also interact with the `ResourceAny` type and its
     /// internal representation.
@@ -592,6 +597,8 @@ impl<T> Store<T> {
             hostcall_val_storage: Vec::new(),
             wasm_val_raw_storage: Vec::new(),
             pkey,
+            #[cfg(all(feature = "std", unix, has_native_signals))]
+            interrupt: None,
             #[cfg(feature = "component-model")]
             component_host_table: Default::default(),
             #[cfg(feature = "component-model")]
@@ -1097,7 +1104,7 @@ impl<T> StoreInner<T> {
 
     #[inline]
     pub fn call_hook(&mut self, s: CallHook) -> Result<()> {
-        if self.inner.pkey.is_none() && self.call_hook.is_none() {
+        if self.inner.pkey.is_none() && self.call_hook.is_none() && !self.inner.has_interrupt() {
             Ok(())
         } else {
             self.call_hook_slow_path(s)
@@ -1105,6 +1112,22 @@ impl<T> StoreInner<T> {
     }
 
     fn call_hook_slow_path(&mut self, s: CallHook) -> Result<()> {
+        // Interrupts which couldn't be delivered while wasm was running, or
+        // which were requested while it wasn't, are delivered the next time
+        // that wasm is resumed. This happens before any other hooks to keep
+        // them balanced as wasm won't run.
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        if let Some(interrupt) = &self.inner.interrupt {
+            match s {
+                CallHook::CallingWasm | CallHook::ReturningFromHost => {
+                    if interrupt.take_request() {
+                        return Err(Trap::Interrupt.into());
+                    }
+                }
+                CallHook::ReturningFromWasm | CallHook::CallingHost => {}
+            }
+        }
+
         if let Some(pkey) = &self.inner.pkey {
             let allocator = self.engine().allocator();
             match s {
@@ -1475,6 +1498,7 @@ impl StoreOpaque {
                 wmemcheck: false,
                 pkey,
                 tunables: engine.tunables(),
+                memory_snapshot: None,
             };
             let mem_ty = engine.tunables().gc_heap_memory_type();
             let tunables = engine.tunables();
@@ -1858,6 +1882,46 @@ impl StoreOpaque {
         Some(handler)
     }
 
+    #[inline]
+    fn has_interrupt(&self) -> bool {
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        return self.interrupt.is_some();
+        #[cfg(not(all(feature = "std", unix, has_native_signals)))]
+        return false;
+    }
+
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    #[inline]
+    pub fn interrupt_state(&self) -> Option<NonNull<vm::InterruptState>> {
+        self.interrupt.as_deref().map(NonNull::from)
+    }
+
+    /// Returns the state shared with this store's interrupt handles, creating
+    /// it and installing the process's interrupt signal handler if necessary.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    pub(crate) fn interrupt_handle(&mut self) -> Result<Arc<vm::InterruptState>> {
+        if self.engine().target().is_pulley() {
+            bail!("signal-based interruption is not supported with Pulley");
+        }
+        if !self.engine().tunables().signals_based_traps {
+            bail!("signal-based interruption requires signals-based traps");
+        }
+        if self
+            .engine()
+            .features()
+            .contains(wasmparser::WasmFeatures::STACK_SWITCHING)
+        {
+            bail!("signal-based interruption is not supported with stack switching");
+        }
+        if let Some(interrupt) = &self.interrupt {
+            return Ok(interrupt.clone());
+        }
+        vm::init_interrupts();
+        let interrupt = Arc::new(vm::InterruptState::new());
+        self.interrupt = Some(interrupt.clone());
+        Ok(interrupt)
+    }
+
     #[inline]
     pub fn vm_store_context_ptr(&self) -> NonNull<VMStoreContext> {
         NonNull::from(&self.vm_store_context)
@@ -2149,9 +2213,9 @@ at https://bytecodealliance.org/security.
     ) -> Result<InstanceId> {
         let id = self.instances.next_key();
 
-        let allocator = match kind {
-            AllocateInstanceKind::Module(_) => self.engine().allocator(),
-            AllocateInstanceKind::Dummy { allocator } => allocator,
+        let (allocator, memory_snapshot) = match kind {
+            AllocateInstanceKind::Module(_, snapshot) => (self.engine().allocator(), snapshot),
+            AllocateInstanceKind::Dummy { allocator } => (allocator, None),
         };
         // SAFETY: this function's own contract is the same as
         // `allocate_module`, namely the imports provided are valid.
@@ -2165,11 +2229,12 @@ at https://bytecodealliance.org/security.
                 wmemcheck: self.engine().config().wmemcheck,
                 pkey: self.get_pkey(),
                 tunables: self.engine().tunables(),
+                memory_snapshot,
             })?
         };
 
         let actual = match kind {
-            AllocateInstanceKind::Module(module_id) => {
+            AllocateInstanceKind::Module(module_id, _) => {
                 log::trace!(
                     "Adding instance to store: store={:?}, module={module_id:?}, instance={id:?}",
                     self.id()
@@ -2203,7 +2268,10 @@ at https://bytecodealliance.org/security.
 pub(crate) enum AllocateInstanceKind<'a> {
     /// An embedder-provided module is being allocated meaning that the default
     /// engine's allocator will be used.
-    Module(RegisteredModuleId),
+    ///
+    /// If a snapshot is provided then the instance's memories are initialized
+    /// from it rather than from the module.
+    Module(RegisteredModuleId, Option<&'a vm::MemorySnapshot>),
 
     /// Add a dummy instance that to the store.
     ///
@@ -2323,6 +2391,15 @@ unsafe impl<T> vm::VMStore for StoreInner<T> {
 
     #[cfg(target_has_atomic = "64")]
     fn new_epoch(&mut self) -> Result<u64, anyhow::Error> {
+        // Reaching an epoch deadline is also a point at which an interrupt
+        // that couldn't be delivered asynchronously can be.
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        if let Some(interrupt) = &self.inner.interrupt {
+            if interrupt.take_request() {
+                return Err(Trap::Interrupt.into());
+            }
+        }
+
         // Temporarily take the configured behavior to avoid mutably borrowing
         // multiple times.
         let mut behavior = self.epoch_deadline_behavior.take();
@@ -2473,6 +2550,10 @@ impl Drop for StoreOpaque {
                     allocator.decrement_component_instance_count();
                 }
             }
+
+            if let Some(pkey) = self.pkey {
+                allocator.release_pkey(pkey);
+            }
         }
     }
 }
@@ -243,6 +243,10 @@ unsafe impl InstanceAllocatorImpl for SingleMemoryInstance<'_> {
         unreachable!()
     }
 
+    fn release_pkey(&self, _: ProtectionKey) {
+        unreachable!()
+    }
+
     fn restrict_to_pkey(&self, _: ProtectionKey) {
         unreachable!()
     }
@@ -2,6 +2,7 @@
 use super::coredump::WasmCoreDump;
 use crate::prelude::*;
 use crate::store::StoreOpaque;
+use crate::sync::OnceLock;
 use crate::{AsContext, Module};
 use core::fmt;
 use wasmtime_environ::{FilePos, demangle_function_name, demangle_function_name_or_index};
@@ -114,7 +115,7 @@ pub(crate) fn from_runtime_box(
 
     if let Some(bt) = backtrace {
         let bt = WasmBacktrace::from_captured(store, bt, pc);
-        if !bt.wasm_trace.is_empty() {
+        if !bt.unsymbolicated.is_empty() {
             error = error.context(bt);
         }
     }
@@ -143,6 +144,12 @@ pub(crate) fn from_runtime_box(
 /// Capturing of wasm backtraces can be configured through the
 /// [`Config::wasm_backtrace`](crate::Config::wasm_backtrace) method.
 ///
+/// Frames are only symbolicated, which includes looking up function names and
+/// any DWARF debug information, the first time they're requested through
+/// [`WasmBacktrace::frames`] or when the backtrace is printed. Errors which are
+/// inspected and discarded without looking at their backtrace, such as a WASI
+/// `proc_exit`, therefore only pay for walking the stack.
+///
 /// For more information about errors in wasmtime see the documentation of the
 /// [`Trap`] type.
 ///
@@ -178,9 +185,12 @@ pub(crate) fn from_runtime_box(
 /// # Ok(())
 /// # }
 /// ```
-#[derive(Debug)]
 pub struct WasmBacktrace {
-    wasm_trace: Vec<FrameInfo>,
+    /// Symbolicated frames, lazily computed from `unsymbolicated` on first
+    /// access.
+    wasm_trace: OnceLock<Vec<FrameInfo>>,
+    /// The module and text offset of each wasm frame in this backtrace.
+    unsymbolicated: Vec<(Module, usize)>,
     hint_wasm_backtrace_details_env: bool,
     // This is currently only present for the `Debug` implementation for extra
     // context.
@@ -241,7 +251,8 @@ impl WasmBacktrace {
             Self::force_capture(store)
         } else {
             WasmBacktrace {
-                wasm_trace: Vec::new(),
+                wasm_trace: OnceLock::new(),
+                unsymbolicated: Vec::new(),
                 hint_wasm_backtrace_details_env: false,
                 _runtime_trace: crate::runtime::vm::Backtrace::empty(),
             }
@@ -264,7 +275,7 @@ impl WasmBacktrace {
         runtime_trace: crate::runtime::vm::Backtrace,
         trap_pc: Option<usize>,
     ) -> Self {
-        let mut wasm_trace = Vec::<FrameInfo>::with_capacity(runtime_trace.frames().len());
+        let mut unsymbolicated = Vec::with_capacity(runtime_trace.frames().len());
         let mut hint_wasm_backtrace_details_env = false;
         let wasm_backtrace_details_env_used =
             store.engine().config().wasm_backtrace_details_env_used;
@@ -312,8 +323,19 @@ impl WasmBacktrace {
             // let Some(..)` instead of the `unwrap` you might otherwise expect
             // and we ignore frames from modules that were not registered in
             // this store's module registry.
-            if let Some((info, module)) = store.modules().lookup_frame_info(pc_to_lookup) {
-                wasm_trace.push(info);
+            //
+            // Note that only the module and offset are recorded here, and
+            // building a `FrameInfo` is deferred until the frames are actually
+            // requested.
+            if let Some((module, offset)) = store.modules().module_and_offset(pc_to_lookup) {
+                if module
+                    .compiled_module()
+                    .func_by_text_offset(offset)
+                    .is_none()
+                {
+                    continue;
+                }
+                unsymbolicated.push((module.clone(), offset));
 
                 // If this frame has unparsed debug information and the
                 // store's configuration indicates that we were
@@ -332,7 +354,8 @@ impl WasmBacktrace {
         }
 
         Self {
-            wasm_trace,
+            wasm_trace: OnceLock::new(),
+            unsymbolicated,
             _runtime_trace: runtime_trace,
             hint_wasm_backtrace_details_env,
         }
@@ -340,8 +363,28 @@ impl WasmBacktrace {
 
     /// Returns a list of function frames in WebAssembly this backtrace
     /// represents.
+    ///
+    /// The first call to this method symbolicates all frames.
     pub fn frames(&self) -> &[FrameInfo] {
-        self.wasm_trace.as_slice()
+        self.wasm_trace.get_or_init(|| {
+            self.unsymbolicated
+                .iter()
+                .filter_map(|(module, offset)| FrameInfo::new(module.clone(), *offset))
+                .collect()
+        })
+    }
+}
+
+impl fmt::Debug for WasmBacktrace {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("WasmBacktrace")
+            .field("wasm_trace", &self.frames())
+            .field(
+                "hint_wasm_backtrace_details_env",
+                &self.hint_wasm_backtrace_details_env,
+            )
+            .field("_runtime_trace", &self._runtime_trace)
+            .finish()
     }
 }
 
@@ -350,7 +393,7 @@ impl fmt::Display for WasmBacktrace {
         writeln!(f, "error while executing at wasm backtrace:")?;
 
         let mut needs_newline = false;
-        for (i, frame) in self.wasm_trace.iter().enumerate() {
+        for (i, frame) in self.frames().iter().enumerate() {
             // Avoid putting a trailing newline on the output
             if needs_newline {
                 writeln!(f, "")?;
@@ -14,6 +14,8 @@ use crate::AsContextMut;
 use crate::Store;
 #[cfg(has_native_signals)]
 use crate::prelude::*;
+#[cfg(has_native_signals)]
+use alloc::sync::Arc;
 
 /// Extensions for the [`Store`] type only available on Unix.
 pub trait StoreExt {
@@ -27,6 +29,19 @@ pub trait StoreExt {
             + Fn(libc::c_int, *const libc::siginfo_t, *const libc::c_void) -> bool
             + Send
             + Sync;
+
+    /// Returns a handle which can be used to interrupt WebAssembly running in
+    /// this store from any thread.
+    ///
+    /// See [`InterruptHandle`] for more information.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if this store's [`Engine`](crate::Engine) targets
+    /// Pulley, has signals-based traps disabled, or has the stack switching
+    /// proposal enabled.
+    #[cfg(has_native_signals)]
+    fn interrupt_handle(&mut self) -> Result<InterruptHandle>;
 }
 
 impl<T> StoreExt for Store<T> {
@@ -42,4 +57,55 @@ impl<T> StoreExt for Store<T> {
             .0
             .set_signal_handler(Some(Box::new(handler)));
     }
+
+    #[cfg(has_native_signals)]
+    fn interrupt_handle(&mut self) -> Result<InterruptHandle> {
+        let state = self.as_context_mut().0.interrupt_handle()?;
+        Ok(InterruptHandle { state })
+    }
+}
+
+/// A handle used to interrupt WebAssembly running in a [`Store`], created
+/// with [`StoreExt::interrupt_handle`].
+///
+/// Unlike [`Config::epoch_interruption`](crate::Config::epoch_interruption)
+/// this doesn't require any checks in compiled code, so WebAssembly runs at
+/// full speed until it's interrupted. Instead [`InterruptHandle::interrupt`]
+/// sends a signal, `SIGURG`, to the thread running the store and WebAssembly
+/// is then unwound from within the signal handler with a
+/// [`Trap::Interrupt`](crate::Trap::Interrupt). Creating the first handle
+/// installs the signal handler for the whole process.
+///
+/// Interrupts always trap: WebAssembly can't be resumed after an interrupt as
+/// it's stopped at an arbitrary instruction. Use
+/// [`Store::epoch_deadline_async_yield_and_update`] to periodically yield to
+/// an async executor instead.
+///
+/// An interrupt stays pending until it's delivered. If no WebAssembly is
+/// running in the store when it's requested then the next call into
+/// WebAssembly traps. WebAssembly is also only interrupted asynchronously when
+/// it's executing the body of a WebAssembly function. If the thread is running
+/// host code or a trampoline instead, or the store has allocated GC objects
+/// whose barriers can't be interrupted, then the interrupt is delivered the
+/// next time a host function returns to WebAssembly or an epoch deadline is
+/// reached. Embedders that need to bound how long WebAssembly keeps
+/// running can call [`InterruptHandle::interrupt`] periodically until the
+/// call completes.
+///
+/// [`Store::epoch_deadline_async_yield_and_update`]: crate::Store::epoch_deadline_async_yield_and_update
+#[cfg(has_native_signals)]
+#[derive(Clone)]
+pub struct InterruptHandle {
+    state: Arc<crate::runtime::vm::InterruptState>,
+}
+
+#[cfg(has_native_signals)]
+impl InterruptHandle {
+    /// Requests that WebAssembly running in this handle's store traps with
+    /// [`Trap::Interrupt`](crate::Trap::Interrupt).
+    ///
+    /// This may be called from any thread, but not from a signal handler.
+    pub fn interrupt(&self) {
+        self.state.interrupt();
+    }
 }
@@ -97,12 +97,13 @@ pub use crate::runtime::vm::gc::*;
 pub use crate::runtime::vm::imports::Imports;
 pub use crate::runtime::vm::instance::{
     GcHeapAllocationIndex, Instance, InstanceAllocationRequest, InstanceAllocator,
-    InstanceAllocatorImpl, InstanceAndStore, InstanceHandle, MemoryAllocationIndex,
+    InstanceAllocatorImpl, InstanceAndStore, InstanceHandle, MemoryAllocationIndex, MemorySnapshot,
     OnDemandInstanceAllocator, StorePtr, TableAllocationIndex, initialize_instance,
+    initialize_instance_from_snapshot,
 };
 #[cfg(feature = "pooling-allocator")]
 pub use crate::runtime::vm::instance::{
-    InstanceLimits, PoolConcurrencyLimitError, PoolingInstanceAllocator,
+    InstanceLimits, PoolConcurrencyLimitError, PoolMemoryStripe, PoolingInstanceAllocator,
     PoolingInstanceAllocatorConfig,
 };
 pub use crate::runtime::vm::interpreter::*;
@@ -115,6 +116,8 @@ pub use crate::runtime::vm::stack_switching::*;
 pub use crate::runtime::vm::store_box::*;
 #[cfg(feature = "std")]
 pub use crate::runtime::vm::sys::mmap::open_file_for_mmap;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub use crate::runtime::vm::sys::signals::{InterruptState, InterruptThread, init_interrupts};
 #[cfg(has_host_compiler_backend)]
 pub use crate::runtime::vm::sys::unwind::UnwindRegistration;
 pub use crate::runtime::vm::table::{Table, TableElement};
@@ -34,6 +34,7 @@ const INVALID_PTR: usize = 0xdead_dead_beef_beef_u64 as usize;
 mod handle_table;
 mod libcalls;
 mod resources;
+mod transcode;
 
 pub use self::handle_table::{HandleTable, RemovedResource};
 #[cfg(feature = "component-model-async")]
@@ -4,7 +4,7 @@ use crate::component::Instance;
 use crate::prelude::*;
 #[cfg(feature = "component-model-async")]
 use crate::runtime::component::concurrent::ResourcePair;
-use crate::runtime::vm::component::{ComponentInstance, VMComponentContext};
+use crate::runtime::vm::component::{ComponentInstance, VMComponentContext, transcode};
 use crate::runtime::vm::{HostResultHasUnwindSentinel, VMStore, VmSafe};
 use core::cell::Cell;
 use core::ptr::NonNull;
@@ -189,8 +189,10 @@ unsafe fn utf8_to_utf8(
     let dst = unsafe { slice::from_raw_parts_mut(dst, len) };
     assert_no_overlap(src, dst);
     log::trace!("utf8-to-utf8 {len}");
-    let src = core::str::from_utf8(src).map_err(|_| anyhow!("invalid utf8 encoding"))?;
-    dst.copy_from_slice(src.as_bytes());
+    // Only the non-ASCII suffix of the string needs to be validated.
+    let ascii = transcode::ascii_prefix(src);
+    core::str::from_utf8(&src[ascii..]).map_err(|_| anyhow!("invalid utf8 encoding"))?;
+    dst.copy_from_slice(src);
     Ok(())
 }
 
@@ -216,9 +218,14 @@ unsafe fn utf16_to_utf16(
 
 /// Transcodes utf16 to itself, returning whether all code points were inside of
 /// the latin1 space.
-fn run_utf16_to_utf16(src: &[u16], mut dst: &mut [u16]) -> Result<bool> {
-    let mut all_latin1 = true;
-    for ch in core::char::decode_utf16(src.iter().map(|i| u16::from_le(*i))) {
+fn run_utf16_to_utf16(src: &[u16], dst: &mut [u16]) -> Result<bool> {
+    // Code units before the first surrogate are valid on their own and can be
+    // copied as-is, leaving only the rest of the string to be decoded.
+    let prefix = transcode::utf16_non_surrogate_prefix(src).min(dst.len());
+    dst[..prefix].copy_from_slice(&src[..prefix]);
+    let mut all_latin1 = transcode::utf16_latin1_prefix(&src[..prefix]) == prefix;
+    let mut dst = &mut dst[prefix..];
+    for ch in core::char::decode_utf16(src[prefix..].iter().map(|i| u16::from_le(*i))) {
         let ch = ch.map_err(|_| anyhow!("invalid utf16 encoding"))?;
         all_latin1 = all_latin1 && u8::try_from(u32::from(ch)).is_ok();
         let result = ch.encode_utf16(dst);
@@ -264,9 +271,7 @@ unsafe fn latin1_to_utf16(
     let src = unsafe { slice::from_raw_parts(src, len) };
     let dst = unsafe { slice::from_raw_parts_mut(dst, len) };
     assert_no_overlap(src, dst);
-    for (src, dst) in src.iter().zip(dst) {
-        *dst = u16::from(*src).to_le();
-    }
+    transcode::latin1_to_utf16(src, dst);
     log::trace!("latin1-to-utf16 {len}");
     Ok(())
 }
@@ -302,8 +307,14 @@ unsafe fn utf8_to_utf16(
 }
 
 fn run_utf8_to_utf16(src: &[u8], dst: &mut [u16]) -> Result<usize> {
+    // Inflate the ASCII prefix of the string, if any, with vector
+    // instructions and then transcode the rest one character at a time.
+    let ascii = transcode::ascii_prefix(src).min(dst.len());
+    let (ascii_src, src) = src.split_at(ascii);
     let src = core::str::from_utf8(src).map_err(|_| anyhow!("invalid utf8 encoding"))?;
-    let mut amt = 0;
+    let (ascii_dst, dst) = dst.split_at_mut(ascii);
+    transcode::latin1_to_utf16(ascii_src, ascii_dst);
+    let mut amt = ascii;
     for (i, dst) in src.encode_utf16().zip(dst) {
         *dst = i.to_le();
         amt += 1;
@@ -342,17 +353,22 @@ unsafe fn utf16_to_utf8(
     let mut dst = unsafe { slice::from_raw_parts_mut(dst, dst_len) };
     assert_no_overlap(src, dst);
 
+    // Deflate the ASCII prefix of the string, if any, with vector
+    // instructions before transcoding the rest one character at a time.
+    let ascii = transcode::utf16_to_ascii(src, dst);
+    dst = &mut dst[ascii..];
+
     // This iterator will convert to native endianness and additionally count
     // how many items have been read from the iterator so far. This
     // count is used to return how many of the source code units were read.
-    let src_iter_read = Cell::new(0);
-    let src_iter = src.iter().map(|i| {
+    let src_iter_read = Cell::new(ascii);
+    let src_iter = src[ascii..].iter().map(|i| {
         src_iter_read.set(src_iter_read.get() + 1);
         u16::from_le(*i)
     });
 
-    let mut src_read = 0;
-    let mut dst_written = 0;
+    let mut src_read = ascii;
+    let mut dst_written = ascii;
 
     for ch in core::char::decode_utf16(src_iter) {
         let ch = ch.map_err(|_| anyhow!("invalid utf16 encoding"))?;
@@ -480,15 +496,7 @@ unsafe fn utf16_to_latin1(
     let dst = unsafe { slice::from_raw_parts_mut(dst, len) };
     assert_no_overlap(src, dst);
 
-    let mut size = 0;
-    for (src, dst) in src.iter().zip(dst) {
-        let src = u16::from_le(*src);
-        match u8::try_from(src) {
-            Ok(src) => *dst = src,
-            Err(_) => break,
-        }
-        size += 1;
-    }
+    let size = transcode::utf16_to_latin1(src, dst);
     log::trace!("utf16-to-latin1 {len} => {size}");
     Ok(SizePair {
         src_read: size,
@@ -0,0 +1,424 @@
+//! Vectorized helpers for the string transcoding libcalls in `libcalls.rs`.
+//!
+//! Strings passed between components are frequently large and mostly ASCII,
+//! for example JSON documents or log lines. The helpers here process as much
+//! of a string as they can with vector instructions and report how far they
+//! got, leaving the remainder, if any, to the scalar loops in `libcalls.rs`
+//! which handle multi-unit characters and error reporting.
+//!
+//! On x86\_64 an AVX2 implementation is selected at runtime when the host
+//! supports it, and otherwise the SSE2 implementation, which is part of the
+//! x86\_64 baseline, is used. Other architectures use the scalar
+//! implementation.
+//!
+//! All `u16` slices here are utf16 code units stored in little-endian order,
+//! as in linear memory.
+
+macro_rules! dispatch {
+    ($name:ident($($arg:expr),*)) => {{
+        #[cfg(target_arch = "x86_64")]
+        {
+            #[cfg(feature = "std")]
+            if std::is_x86_feature_detected!("avx2") {
+                // SAFETY: AVX2 support was just detected at runtime.
+                return unsafe { x86::avx2::$name($($arg),*) };
+            }
+            return x86::sse2::$name($($arg),*);
+        }
+        #[cfg(not(target_arch = "x86_64"))]
+        return scalar::$name($($arg),*);
+    }};
+}
+
+/// Returns the length of the longest prefix of `src` which is entirely
+/// ASCII.
+pub fn ascii_prefix(src: &[u8]) -> usize {
+    dispatch!(ascii_prefix(src))
+}
+
+/// Inflates the latin1 (or ASCII) bytes of `src` into the utf16 code units of
+/// `dst`.
+///
+/// # Panics
+///
+/// Panics if `dst` is shorter than `src`.
+pub fn latin1_to_utf16(src: &[u8], dst: &mut [u16]) {
+    let dst = &mut dst[..src.len()];
+    dispatch!(latin1_to_utf16(src, dst))
+}
+
+/// Deflates the longest prefix of `src` which consists of ASCII code units
+/// into `dst`, returning the number of code units transcoded.
+///
+/// At most `dst.len()` code units are transcoded.
+pub fn utf16_to_ascii(src: &[u16], dst: &mut [u8]) -> usize {
+    dispatch!(narrow_utf16(src, dst, 0x7f))
+}
+
+/// Deflates the longest prefix of `src` which consists of latin1 code units
+/// into `dst`, returning the number of code units transcoded.
+///
+/// At most `dst.len()` code units are transcoded.
+pub fn utf16_to_latin1(src: &[u16], dst: &mut [u8]) -> usize {
+    dispatch!(narrow_utf16(src, dst, 0xff))
+}
+
+/// Returns the length of the longest prefix of `src` which contains no
+/// surrogate code units, and is therefore valid utf16 on its own.
+pub fn utf16_non_surrogate_prefix(src: &[u16]) -> usize {
+    dispatch!(utf16_non_surrogate_prefix(src))
+}
+
+/// Returns the length of the longest prefix of `src` which consists of
+/// latin1 code units.
+pub fn utf16_latin1_prefix(src: &[u16]) -> usize {
+    dispatch!(utf16_latin1_prefix(src))
+}
+
+mod scalar {
+    pub fn ascii_prefix(src: &[u8]) -> usize {
+        src.iter().take_while(|b| b.is_ascii()).count()
+    }
+
+    pub fn latin1_to_utf16(src: &[u8], dst: &mut [u16]) {
+        for (src, dst) in src.iter().zip(dst) {
+            *dst = u16::from(*src).to_le();
+        }
+    }
+
+    pub fn narrow_utf16(src: &[u16], dst: &mut [u8], max: u16) -> usize {
+        let mut size = 0;
+        for (src, dst) in src.iter().zip(dst) {
+            let src = u16::from_le(*src);
+            if src > max {
+                break;
+            }
+            *dst = src as u8;
+            size += 1;
+        }
+        size
+    }
+
+    pub fn utf16_non_surrogate_prefix(src: &[u16]) -> usize {
+        src.iter()
+            .take_while(|u| !matches!(u16::from_le(**u), 0xd800..=0xdfff))
+            .count()
+    }
+
+    pub fn utf16_latin1_prefix(src: &[u16]) -> usize {
+        src.iter().take_while(|u| u16::from_le(**u) <= 0xff).count()
+    }
+}
+
+#[cfg(target_arch = "x86_64")]
+mod x86 {
+    pub mod sse2 {
+        use super::super::scalar;
+        use core::arch::x86_64::*;
+
+        pub fn ascii_prefix(src: &[u8]) -> usize {
+            let mut i = 0;
+            while i + 16 <= src.len() {
+                // SAFETY: `i + 16` is in-bounds of `src`.
+                let mask =
+                    unsafe { _mm_movemask_epi8(_mm_loadu_si128(src.as_ptr().add(i).cast())) };
+                if mask != 0 {
+                    return i + mask.trailing_zeros() as usize;
+                }
+                i += 16;
+            }
+            i + scalar::ascii_prefix(&src[i..])
+        }
+
+        pub fn latin1_to_utf16(src: &[u8], dst: &mut [u16]) {
+            assert_eq!(src.len(), dst.len());
+            let mut i = 0;
+            while i + 16 <= src.len() {
+                // SAFETY: `i + 16` is in-bounds of both `src` and `dst`.
+                unsafe {
+                    let bytes = _mm_loadu_si128(src.as_ptr().add(i).cast());
+                    let zero = _mm_setzero_si128();
+                    let out = dst.as_mut_ptr().add(i).cast::<__m128i>();
+                    _mm_storeu_si128(out, _mm_unpacklo_epi8(bytes, zero));
+                    _mm_storeu_si128(out.add(1), _mm_unpackhi_epi8(bytes, zero));
+                }
+                i += 16;
+            }
+            scalar::latin1_to_utf16(&src[i..], &mut dst[i..]);
+        }
+
+        pub fn narrow_utf16(src: &[u16], dst: &mut [u8], max: u16) -> usize {
+            let len = src.len().min(dst.len());
+            let mut i = 0;
+            while i + 16 <= len {
+                // SAFETY: `i + 16` is in-bounds of both `src` and `dst`.
+                unsafe {
+                    let units = src.as_ptr().add(i).cast::<__m128i>();
+                    let a = _mm_loadu_si128(units);
+                    let b = _mm_loadu_si128(units.add(1));
+                    let high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(!max as i16));
+                    let fits = _mm_cmpeq_epi16(high, _mm_setzero_si128());
+                    if _mm_movemask_epi8(fits) != 0xffff {
+                        break;
+                    }
+                    _mm_storeu_si128(dst.as_mut_ptr().add(i).cast(), _mm_packus_epi16(a, b));
+                }
+                i += 16;
+            }
+            i + scalar::narrow_utf16(&src[i..len], &mut dst[i..len], max)
+        }
+
+        pub fn utf16_non_surrogate_prefix(src: &[u16]) -> usize {
+            let mut i = 0;
+            while i + 8 <= src.len() {
+                // SAFETY: `i + 8` is in-bounds of `src`.
+                let mask = unsafe {
+                    let units = _mm_loadu_si128(src.as_ptr().add(i).cast());
+                    let masked = _mm_and_si128(units, _mm_set1_epi16(0xf800_u16 as i16));
+                    _mm_movemask_epi8(_mm_cmpeq_epi16(masked, _mm_set1_epi16(0xd800_u16 as i16)))
+                };
+                if mask != 0 {
+                    return i + mask.trailing_zeros() as usize / 2;
+                }
+                i += 8;
+            }
+            i + scalar::utf16_non_surrogate_prefix(&src[i..])
+        }
+
+        pub fn utf16_latin1_prefix(src: &[u16]) -> usize {
+            let mut i = 0;
+            while i + 8 <= src.len() {
+                // SAFETY: `i + 8` is in-bounds of `src`.
+                let mask = unsafe {
+                    let units = _mm_loadu_si128(src.as_ptr().add(i).cast());
+                    let high = _mm_and_si128(units, _mm_set1_epi16(0xff00_u16 as i16));
+                    !_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) & 0xffff
+                };
+                if mask != 0 {
+                    return i + mask.trailing_zeros() as usize / 2;
+                }
+                i += 8;
+            }
+            i + scalar::utf16_latin1_prefix(&src[i..])
+        }
+    }
+
+    #[cfg(feature = "std")]
+    pub mod avx2 {
+        use super::super::scalar;
+        use core::arch::x86_64::*;
+
+        #[target_feature(enable = "avx2")]
+        pub unsafe fn ascii_prefix(src: &[u8]) -> usize {
+            let mut i = 0;
+            while i + 32 <= src.len() {
+                // SAFETY: `i + 32` is in-bounds of `src`.
+                let mask =
+                    unsafe { _mm256_movemask_epi8(_mm256_loadu_si256(src.as_ptr().add(i).cast())) };
+                if mask != 0 {
+                    return i + mask.trailing_zeros() as usize;
+                }
+                i += 32;
+            }
+            i + scalar::ascii_prefix(&src[i..])
+        }
+
+        #[target_feature(enable = "avx2")]
+        pub unsafe fn latin1_to_utf16(src: &[u8], dst: &mut [u16]) {
+            assert_eq!(src.len(), dst.len());
+            let mut i = 0;
+            while i + 16 <= src.len() {
+                // SAFETY: `i + 16` is in-bounds of both `src` and `dst`.
+                unsafe {
+                    let bytes = _mm_loadu_si128(src.as_ptr().add(i).cast());
+                    _mm256_storeu_si256(
+                        dst.as_mut_ptr().add(i).cast(),
+                        _mm256_cvtepu8_epi16(bytes),
+                    );
+                }
+                i += 16;
+            }
+            scalar::latin1_to_utf16(&src[i..], &mut dst[i..]);
+        }
+
+        #[target_feature(enable = "avx2")]
+        pub unsafe fn narrow_utf16(src: &[u16], dst: &mut [u8], max: u16) -> usize {
+            let len = src.len().min(dst.len());
+            let mut i = 0;
+            while i + 32 <= len {
+                // SAFETY: `i + 32` is in-bounds of both `src` and `dst`.
+                unsafe {
+                    let units = src.as_ptr().add(i).cast::<__m256i>();
+                    let a = _mm256_loadu_si256(units);
+                    let b = _mm256_loadu_si256(units.add(1));
+                    let high =
+                        _mm256_and_si256(_mm256_or_si256(a, b), _mm256_set1_epi16(!max as i16));
+                    let fits = _mm256_cmpeq_epi16(high, _mm256_setzero_si256());
+                    if _mm256_movemask_epi8(fits) != -1 {
+                        break;
+                    }
+                    // `packus` operates on each 128-bit lane independently, so
+                    // restore the order of the 64-bit halves afterwards.
+                    let packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0b11_01_10_00);
+                    _mm256_storeu_si256(dst.as_mut_ptr().add(i).cast(), packed);
+                }
+                i += 32;
+            }
+            i + scalar::narrow_utf16(&src[i..len], &mut dst[i..len], max)
+        }
+
+        #[target_feature(enable = "avx2")]
+        pub unsafe fn utf16_non_surrogate_prefix(src: &[u16]) -> usize {
+            let mut i = 0;
+            while i + 16 <= src.len() {
+                // SAFETY: `i + 16` is in-bounds of `src`.
+                let mask = unsafe {
+                    let units = _mm256_loadu_si256(src.as_ptr().add(i).cast());
+                    let masked = _mm256_and_si256(units, _mm256_set1_epi16(0xf800_u16 as i16));
+                    let surrogates =
+                        _mm256_cmpeq_epi16(masked, _mm256_set1_epi16(0xd800_u16 as i16));
+                    _mm256_movemask_epi8(surrogates) as u32
+                };
+                if mask != 0 {
+                    return i + mask.trailing_zeros() as usize / 2;
+                }
+                i += 16;
+            }
+            i + scalar::utf16_non_surrogate_prefix(&src[i..])
+        }
+
+        #[target_feature(enable = "avx2")]
+        pub unsafe fn utf16_latin1_prefix(src: &[u16]) -> usize {
+            let mut i = 0;
+            while i + 16 <= src.len() {
+                // SAFETY: `i + 16` is in-bounds of `src`.
+                let mask = unsafe {
+                    let units = _mm256_loadu_si256(src.as_ptr().add(i).cast());
+                    let high = _mm256_and_si256(units, _mm256_set1_epi16(0xff00_u16 as i16));
+                    !(_mm256_movemask_epi8(_mm256_cmpeq_epi16(high, _mm256_setzero_si256())) as u32)
+                };
+                if mask != 0 {
+                    return i + mask.trailing_zeros() as usize / 2;
+                }
+                i += 16;
+            }
+            i + scalar::utf16_latin1_prefix(&src[i..])
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::prelude::*;
+
+    fn utf16(s: &str) -> Vec<u16> {
+        s.encode_utf16().map(|u| u.to_le()).collect()
+    }
+
+    // Strings long enough to exercise the vector loops along with their
+    // scalar tails, with non-ASCII characters at various offsets.
+    fn strings() -> Vec<String> {
+        let mut ret = Vec::new();
+        for len in [0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200] {
+            let ascii = "a".repeat(len);
+            ret.push(ascii.clone());
+            for suffix in ["é", "Ξ", "\u{10000}", "ÿ"] {
+                ret.push(format!("{ascii}{suffix}{ascii}"));
+            }
+        }
+        ret
+    }
+
+    /// One implementation of each helper, to be compared against `scalar`.
+    struct Backend<'a> {
+        ascii_prefix: &'a dyn Fn(&[u8]) -> usize,
+        latin1_to_utf16: &'a dyn Fn(&[u8], &mut [u16]),
+        narrow_utf16: &'a dyn Fn(&[u16], &mut [u8], u16) -> usize,
+        utf16_non_surrogate_prefix: &'a dyn Fn(&[u16]) -> usize,
+        utf16_latin1_prefix: &'a dyn Fn(&[u16]) -> usize,
+    }
+
+    fn check(backend: Backend<'_>) {
+        for s in strings() {
+            let bytes = s.as_bytes();
+            let units = utf16(&s);
+            // Start at a few offsets so that the vector loads are also
+            // unaligned.
+            for offset in 0..3 {
+                let src = bytes.get(offset..).unwrap_or(&[]);
+                assert_eq!((backend.ascii_prefix)(src), scalar::ascii_prefix(src));
+
+                let mut expected = vec![0; src.len()];
+                scalar::latin1_to_utf16(src, &mut expected);
+                let mut actual = vec![0; src.len()];
+                (backend.latin1_to_utf16)(src, &mut actual);
+                assert_eq!(actual, expected);
+
+                let src = units.get(offset..).unwrap_or(&[]);
+                for dst_len in [src.len(), src.len() / 2] {
+                    for max in [0x7f, 0xff] {
+                        let mut expected = vec![0; dst_len];
+                        let expected_len = scalar::narrow_utf16(src, &mut expected, max);
+                        let mut actual = vec![0; dst_len];
+                        let actual_len = (backend.narrow_utf16)(src, &mut actual, max);
+                        assert_eq!(actual_len, expected_len);
+                        assert_eq!(actual[..actual_len], expected[..expected_len]);
+                    }
+                }
+                assert_eq!(
+                    (backend.utf16_non_surrogate_prefix)(src),
+                    scalar::utf16_non_surrogate_prefix(src)
+                );
+                assert_eq!(
+                    (backend.utf16_latin1_prefix)(src),
+                    scalar::utf16_latin1_prefix(src)
+                );
+            }
+        }
+    }
+
+    #[test]
+    fn dispatch_matches_scalar() {
+        check(Backend {
+            ascii_prefix: &ascii_prefix,
+            latin1_to_utf16: &latin1_to_utf16,
+            narrow_utf16: &|src, dst, max| match max {
+                0x7f => utf16_to_ascii(src, dst),
+                _ => utf16_to_latin1(src, dst),
+            },
+            utf16_non_surrogate_prefix: &utf16_non_surrogate_prefix,
+            utf16_latin1_prefix: &utf16_latin1_prefix,
+        });
+    }
+
+    #[test]
+    #[cfg(target_arch = "x86_64")]
+    fn sse2_matches_scalar() {
+        check(Backend {
+            ascii_prefix: &x86::sse2::ascii_prefix,
+            latin1_to_utf16: &x86::sse2::latin1_to_utf16,
+            narrow_utf16: &x86::sse2::narrow_utf16,
+            utf16_non_surrogate_prefix: &x86::sse2::utf16_non_surrogate_prefix,
+            utf16_latin1_prefix: &x86::sse2::utf16_latin1_prefix,
+        });
+    }
+
+    #[test]
+    #[cfg(all(target_arch = "x86_64", feature = "std"))]
+    fn avx2_matches_scalar() {
+        if !std::is_x86_feature_detected!("avx2") {
+            return;
+        }
+        // SAFETY: AVX2 support was just detected at runtime.
+        unsafe {
+            check(Backend {
+                ascii_prefix: &|src| x86::avx2::ascii_prefix(src),
+                latin1_to_utf16: &|src, dst| x86::avx2::latin1_to_utf16(src, dst),
+                narrow_utf16: &|src, dst, max| x86::avx2::narrow_utf16(src, dst, max),
+                utf16_non_surrogate_prefix: &|src| x86::avx2::utf16_non_surrogate_prefix(src),
+                utf16_latin1_prefix: &|src| x86::avx2::utf16_latin1_prefix(src),
+            });
+        }
+    }
+}
@@ -144,6 +144,28 @@ impl MemoryImage {
         Ok(None)
     }
 
+    /// Creates an image of `contents` placed `offset` bytes into linear
+    /// memory, for example the contents of a memory captured from a running
+    /// instance.
+    ///
+    /// Returns `None` if `offset` or the length of `contents` isn't a multiple
+    /// of the host page size, or if images can't be created from data on this
+    /// platform.
+    pub(crate) fn from_contents(
+        engine: &Engine,
+        offset: usize,
+        contents: &Arc<impl ModuleMemoryImageSource>,
+    ) -> Result<Option<MemoryImage>> {
+        let page_size = host_page_size();
+        let len = contents.wasm_data().len();
+        if offset % page_size != 0 || len % page_size != 0 {
+            return Ok(None);
+        }
+        let offset = HostAlignedByteCount::new(offset).expect("offset is page-aligned");
+        let page_size = u32::try_from(page_size).unwrap();
+        MemoryImage::new(engine, page_size, offset, contents, 0..len)
+    }
+
     unsafe fn map_at(&self, mmap_base: &MmapOffset) -> Result<()> {
         unsafe {
             mmap_base.map_image_at(
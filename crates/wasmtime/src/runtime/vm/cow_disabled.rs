@@ -23,6 +23,16 @@ impl ModuleMemoryImages {
 #[derive(Debug, PartialEq)]
 pub enum MemoryImage {}
 
+impl MemoryImage {
+    pub(crate) fn from_contents(
+        _engine: &Engine,
+        _offset: usize,
+        _contents: &Arc<impl ModuleMemoryImageSource>,
+    ) -> Result<Option<MemoryImage>> {
+        Ok(None)
+    }
+}
+
 impl ModuleMemoryImages {
     pub fn new(
         _engine: &Engine,
@@ -40,6 +40,14 @@
 //! The precise set of stack roots is implemented with a mark bit in the object
 //! header. See the `trace` and `sweep` methods for more details.
 //!
+//! New objects are allocated by bumping a pointer through a nursery: a
+//! contiguous chunk of the heap taken out of the free list up front. This
+//! makes allocation cheap and keeps objects allocated together next to each
+//! other. Because this is not a moving collector, objects are never evacuated
+//! out of the nursery; instead, at the start of every collection the nursery
+//! is retired, returning its unused tail to the free list, and the objects
+//! that were allocated in it are tenured in place. See `Nursery` for details.
+//!
 //! For more general information on deferred reference counting, see *An
 //! Examination of Deferred Reference Counting and Cycle Detection* by Quinane:
 //! <https://openresearch-repository.anu.edu.au/bitstream/1885/42030/2/hon-thesis.pdf>
@@ -59,6 +67,7 @@ use core::{
     alloc::Layout,
     any::Any,
     mem,
+    num::NonZeroU32,
     ops::{Deref, DerefMut},
     ptr::NonNull,
 };
@@ -76,8 +85,9 @@ const GC_REF_ARRAY_ELEMS_OFFSET: u32 = ARRAY_LENGTH_OFFSET + (mem::size_of::<u32
 /// This reference-counting collector does not have a cycle collector, and so it
 /// will not be able to reclaim garbage cycles.
 ///
-/// This is not a moving collector; it doesn't have a nursery or do any
-/// compaction.
+/// This is not a moving collector; it doesn't do any compaction. New objects
+/// are bump-allocated from a nursery, but are tenured in place rather than
+/// evacuated.
 #[derive(Default)]
 pub struct DrcCollector {
     layouts: DrcTypeLayouts,
@@ -140,6 +150,9 @@ struct DrcHeap {
     /// A free list describing which ranges of the heap are available for use.
     free_list: Option<FreeList>,
 
+    /// The bump-allocation nursery that new objects are allocated from.
+    nursery: Nursery,
+
     /// An explicit stack to avoid recursion when deallocating one object needs
     /// to dec-ref another object, which can then be deallocated and dec-refs
     /// yet another object, etc...
@@ -166,6 +179,7 @@ impl DrcHeap {
             memory: None,
             vmmemory: None,
             free_list: None,
+            nursery: Nursery::default(),
             dec_ref_stack: Some(Vec::with_capacity(1)),
         })
     }
@@ -178,10 +192,64 @@ impl DrcHeap {
         let drc_ref = drc_ref(&gc_ref);
         let size = self.index(drc_ref).object_size();
         let layout = FreeList::layout(size);
-        self.free_list
-            .as_mut()
-            .unwrap()
-            .dealloc(gc_ref.as_heap_index().unwrap(), layout);
+        let index = gc_ref.as_heap_index().unwrap();
+        let free_list = self.free_list.as_mut().unwrap();
+
+        // Objects that die right after being allocated can go straight back
+        // into the nursery, without touching the free list.
+        let block_size = free_list.check_layout(layout).unwrap();
+        if !self.nursery.unbump(index, block_size) {
+            free_list.dealloc(index, layout);
+        }
+    }
+
+    /// Allocate a block for an object with the given layout, from the nursery
+    /// if possible, or else from the free list.
+    fn alloc_block(&mut self, layout: Layout) -> Result<Option<NonZeroU32>> {
+        let free_list = self.free_list.as_mut().unwrap();
+        let block_size = free_list.check_layout(layout)?;
+        if let Some(index) = self.nursery.bump(block_size) {
+            return Ok(Some(index));
+        }
+
+        if block_size > Nursery::MAX_OBJECT_SIZE {
+            return free_list.alloc(layout);
+        }
+
+        // The nursery is exhausted: retire it and carve a fresh chunk out of
+        // the free list. If the free list is too fragmented to provide a whole
+        // chunk, fall back to allocating this object directly from it.
+        self.retire_nursery();
+        let free_list = self.free_list.as_mut().unwrap();
+        let chunk = FreeList::layout(usize::try_from(Nursery::CHUNK_SIZE).unwrap());
+        match free_list.alloc(chunk)? {
+            Some(start) => {
+                log::trace!(
+                    "new nursery chunk {start:#x}..{:#x}",
+                    start.get() + Nursery::CHUNK_SIZE
+                );
+                self.nursery = Nursery::new(start, Nursery::CHUNK_SIZE);
+                Ok(self.nursery.bump(block_size))
+            }
+            None => free_list.alloc(layout),
+        }
+    }
+
+    /// Return the unused remainder of the nursery to the free list.
+    ///
+    /// Objects already allocated in the nursery stay where they are and are,
+    /// from now on, managed exactly like any other object in the heap.
+    fn retire_nursery(&mut self) {
+        if let Some((index, len)) = self.nursery.take_remaining() {
+            log::trace!(
+                "retiring nursery remainder {index:#x}..{:#x}",
+                index.get() + len
+            );
+            self.free_list
+                .as_mut()
+                .unwrap()
+                .dealloc(index, FreeList::layout(usize::try_from(len).unwrap()));
+        }
     }
 
     /// Increment the ref count for the associated object.
@@ -536,6 +604,84 @@ impl DrcHeap {
     }
 }
 
+/// A bump-pointer allocation region for new objects.
+///
+/// The nursery is a chunk of the GC heap that has been allocated out of the
+/// free list as a whole. New objects are allocated from it by bumping the
+/// `next` index, which is much cheaper than a first-fit search of the free
+/// list and places objects that are allocated together next to each other.
+///
+/// Objects are never moved out of the nursery. When the nursery is exhausted,
+/// or when a collection begins, it is retired: the unused tail of the chunk
+/// goes back to the free list and the objects allocated in it become part of
+/// the rest of the heap. Objects allocated in the nursery are freed back into
+/// the free list like any other object, except for the most-recently
+/// allocated object, which is simply un-bumped.
+#[derive(Default)]
+struct Nursery {
+    /// The start of the current chunk, or zero if there is no chunk.
+    start: u32,
+    /// The index of the next object to allocate.
+    next: u32,
+    /// The end of the current chunk.
+    end: u32,
+}
+
+impl Nursery {
+    /// The size of each chunk the nursery allocates from.
+    const CHUNK_SIZE: u32 = 64 * 1024;
+
+    /// Objects larger than this are always allocated directly from the free
+    /// list, so that a few large objects don't churn through nursery chunks.
+    const MAX_OBJECT_SIZE: u32 = Self::CHUNK_SIZE / 8;
+
+    fn new(start: NonZeroU32, len: u32) -> Self {
+        Nursery {
+            start: start.get(),
+            next: start.get(),
+            end: start.get() + len,
+        }
+    }
+
+    /// Bump-allocate a block of `size` bytes, if there is room.
+    #[inline]
+    fn bump(&mut self, size: u32) -> Option<NonZeroU32> {
+        if self.end - self.next < size {
+            return None;
+        }
+        let index = NonZeroU32::new(self.next)?;
+        self.next += size;
+        Some(index)
+    }
+
+    /// Give back the block at `index` of `size` bytes if it was the most
+    /// recently bump-allocated block.
+    ///
+    /// Returns whether the block was reclaimed by the nursery.
+    #[inline]
+    fn unbump(&mut self, index: NonZeroU32, size: u32) -> bool {
+        let index = index.get();
+        if self.start <= index && index + size == self.next {
+            self.next = index;
+            true
+        } else {
+            false
+        }
+    }
+
+    /// Reset this nursery, returning the unused remainder of its chunk, if
+    /// any.
+    fn take_remaining(&mut self) -> Option<(NonZeroU32, u32)> {
+        let index = NonZeroU32::new(self.next);
+        let len = self.end - self.next;
+        *self = Nursery::default();
+        match index {
+            Some(index) if len > 0 => Some((index, len)),
+            _ => None,
+        }
+    }
+}
+
 /// Convert the given GC reference as a typed GC reference pointing to a
 /// `VMDrcHeader`.
 fn drc_ref(gc_ref: &VMGcRef) -> &TypedGcRef<VMDrcHeader> {
@@ -703,6 +849,7 @@ unsafe impl GcHeap for DrcHeap {
             no_gc_count,
             over_approximated_stack_roots,
             free_list,
+            nursery,
             dec_ref_stack,
             memory,
             vmmemory,
@@ -716,6 +863,7 @@ unsafe impl GcHeap for DrcHeap {
         *no_gc_count = 0;
         **over_approximated_stack_roots = None;
         *free_list = None;
+        *nursery = Nursery::default();
         *vmmemory = None;
         debug_assert!(dec_ref_stack.as_ref().is_some_and(|s| s.is_empty()));
 
@@ -831,7 +979,7 @@ unsafe impl GcHeap for DrcHeap {
 
         let object_size = u32::try_from(layout.size()).unwrap();
 
-        let gc_ref = match self.free_list.as_mut().unwrap().alloc(layout)? {
+        let gc_ref = match self.alloc_block(layout)? {
             None => return Ok(Err(u64::try_from(layout.size()).unwrap())),
             Some(index) => VMGcRef::from_heap_index(index).unwrap(),
         };
@@ -982,6 +1130,10 @@ impl<'a> GarbageCollection<'a> for DrcCollection<'a> {
     fn collect_increment(&mut self) -> GcProgress {
         match self.phase {
             DrcCollectionPhase::Trace => {
+                // Retire the nursery so that the space of any objects freed
+                // during this collection can merge with its unused tail.
+                self.heap.retire_nursery();
+
                 log::trace!("Begin DRC trace");
                 self.heap.trace(&mut self.roots);
                 log::trace!("End DRC trace");
@@ -1058,6 +1210,35 @@ mod tests {
         );
     }
 
+    #[test]
+    fn nursery_bump_and_unbump() {
+        let mut nursery = Nursery::default();
+        assert_eq!(nursery.bump(16), None);
+        assert_eq!(nursery.take_remaining(), None);
+
+        let start = NonZeroU32::new(64).unwrap();
+        let mut nursery = Nursery::new(start, 64);
+        let a = nursery.bump(16).unwrap();
+        let b = nursery.bump(32).unwrap();
+        assert_eq!(a.get(), 64);
+        assert_eq!(b.get(), 80);
+        assert_eq!(nursery.bump(32), None);
+
+        // Only the most recent allocation can be given back.
+        assert!(!nursery.unbump(a, 16));
+        assert!(nursery.unbump(b, 32));
+        assert_eq!(nursery.bump(48).unwrap(), b);
+
+        assert_eq!(nursery.take_remaining(), None);
+        let mut nursery = Nursery::new(start, 64);
+        nursery.bump(16).unwrap();
+        assert_eq!(
+            nursery.take_remaining(),
+            Some((NonZeroU32::new(80).unwrap(), 48))
+        );
+        assert_eq!(nursery.bump(16), None);
+    }
+
     #[test]
     fn ref_count_is_at_correct_offset() {
         let extern_data = VMDrcHeader {
@@ -143,7 +143,7 @@ impl FreeList {
 
     /// Check the given layout for compatibility with this free list and return
     /// the actual block size we will use for this layout.
-    fn check_layout(&self, layout: Layout) -> Result<u32> {
+    pub fn check_layout(&self, layout: Layout) -> Result<u32> {
         ensure!(
             layout.align() <= ALIGN_USIZE,
             "requested allocation's alignment of {} is greater than max supported \
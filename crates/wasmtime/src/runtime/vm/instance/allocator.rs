@@ -5,9 +5,12 @@ use crate::runtime::vm::instance::{Instance, InstanceHandle};
 use crate::runtime::vm::memory::Memory;
 use crate::runtime::vm::mpk::ProtectionKey;
 use crate::runtime::vm::table::Table;
-use crate::runtime::vm::{CompiledModuleId, ModuleRuntimeInfo, VMFuncRef, VMGcRef, VMStore};
+use crate::runtime::vm::{
+    CompiledModuleId, MemoryImage, ModuleRuntimeInfo, VMFuncRef, VMGcRef, VMStore,
+};
 use crate::store::{AutoAssertNoGc, InstanceId, StoreOpaque};
 use crate::vm::VMGlobalDefinition;
+use alloc::sync::Arc;
 use core::ptr::NonNull;
 use core::{mem, ptr};
 use wasmtime_environ::{
@@ -28,11 +31,14 @@ use wasmtime_environ::{
 mod on_demand;
 pub use self::on_demand::OnDemandInstanceAllocator;
 
+mod snapshot;
+pub use self::snapshot::{MemorySnapshot, initialize_instance_from_snapshot};
+
 #[cfg(feature = "pooling-allocator")]
 mod pooling;
 #[cfg(feature = "pooling-allocator")]
 pub use self::pooling::{
-    InstanceLimits, PoolConcurrencyLimitError, PoolingInstanceAllocator,
+    InstanceLimits, PoolConcurrencyLimitError, PoolMemoryStripe, PoolingInstanceAllocator,
     PoolingInstanceAllocatorConfig,
 };
 
@@ -86,6 +92,25 @@ pub struct InstanceAllocationRequest<'a> {
 
     /// Tunable configuration options the engine is using.
     pub tunables: &'a Tunables,
+
+    /// Contents captured from another instance of the same module to
+    /// initialize this instance's memories with, instead of the module's own
+    /// memory images.
+    pub memory_snapshot: Option<&'a MemorySnapshot>,
+}
+
+impl<'a> InstanceAllocationRequest<'a> {
+    /// Returns the copy-on-write image to initialize the defined memory
+    /// `memory` with, if any.
+    pub(crate) fn memory_image(
+        &self,
+        memory: DefinedMemoryIndex,
+    ) -> Result<Option<&'a Arc<MemoryImage>>> {
+        match self.memory_snapshot {
+            Some(snapshot) => Ok(snapshot.memory_image(memory)),
+            None => self.runtime_info.memory_image(memory),
+        }
+    }
 }
 
 /// A pointer to a Store. This Option<*mut dyn Store> is wrapped in a struct
@@ -347,6 +372,10 @@ pub unsafe trait InstanceAllocatorImpl {
     /// pool-allocated store needs its own key.
     fn next_available_pkey(&self) -> Option<ProtectionKey>;
 
+    /// Release a protection key returned by `next_available_pkey` once the
+    /// store using it has been dropped.
+    fn release_pkey(&self, pkey: ProtectionKey);
+
     /// Restrict access to memory regions protected by `pkey`.
     ///
     /// This is useful for the pooling allocator, which can use memory
@@ -357,6 +386,13 @@ pub unsafe trait InstanceAllocatorImpl {
 
     /// Allow access to memory regions protected by any protection key.
     fn allow_all_pkeys(&self);
+
+    /// Returns the usage of each stripe of linear memory slots in this
+    /// allocator, or nothing if this allocator doesn't pool linear memories.
+    #[cfg(feature = "pooling-allocator")]
+    fn memory_stripes(&self) -> Vec<PoolMemoryStripe> {
+        Vec::new()
+    }
 }
 
 /// A thing that can allocate instances.
@@ -479,7 +515,16 @@ pub trait InstanceAllocator: InstanceAllocatorImpl {
                 .defined_memory_index(memory_index)
                 .expect("should be a defined memory since we skipped imported ones");
 
-            let memory = self.allocate_memory(request, ty, request.tunables, Some(memory_index))?;
+            // Memories may have grown before a snapshot was taken, in which
+            // case they start out at the size they were captured at.
+            let mut ty = *ty;
+            if let Some(snapshot) = request.memory_snapshot {
+                let size = u64::try_from(snapshot.byte_size(memory_index)).unwrap();
+                ty.limits.min = ty.limits.min.max(size >> ty.page_size_log2);
+            }
+
+            let memory =
+                self.allocate_memory(request, &ty, request.tunables, Some(memory_index))?;
             memories.push(memory);
         }
 
@@ -123,7 +123,7 @@ unsafe impl InstanceAllocatorImpl for OnDemandInstanceAllocator {
             .unwrap_or_else(|| &DefaultMemoryCreator);
 
         let image = if let Some(memory_index) = memory_index {
-            request.runtime_info.memory_image(memory_index)?
+            request.memory_image(memory_index)?
         } else {
             None
         };
@@ -212,6 +212,10 @@ unsafe impl InstanceAllocatorImpl for OnDemandInstanceAllocator {
         None
     }
 
+    fn release_pkey(&self, _: ProtectionKey) {
+        // The on-demand allocator never hands out protection keys.
+    }
+
     fn restrict_to_pkey(&self, _: ProtectionKey) {
         // The on-demand allocator cannot use protection keys; an on-demand
         // allocator will never hand out protection keys to the stores its
@@ -273,6 +273,29 @@ impl PoolConcurrencyLimitError {
     }
 }
 
+/// The usage of one stripe of linear memory slots in the pooling allocator.
+///
+/// See [`Engine::pooling_memory_stripes`](crate::Engine::pooling_memory_stripes)
+/// for more information.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[non_exhaustive]
+pub struct PoolMemoryStripe {
+    /// Whether the slots in this stripe are protected by a memory protection
+    /// key.
+    pub protected: bool,
+    /// The total number of linear memory slots in this stripe.
+    pub total_slots: usize,
+    /// The number of linear memory slots in this stripe which are currently
+    /// in use.
+    pub used_slots: usize,
+    /// The number of live stores which allocate their linear memories from
+    /// this stripe.
+    ///
+    /// This is always zero for stripes which aren't protected, since stores
+    /// are only assigned to a stripe when memory protection keys are in use.
+    pub stores: usize,
+}
+
 /// Implements the pooling instance allocator.
 ///
 /// This allocator internally maintains pools of instances, memories, tables,
@@ -740,6 +763,14 @@ unsafe impl InstanceAllocatorImpl for PoolingInstanceAllocator {
         self.memories.next_available_pkey()
     }
 
+    fn release_pkey(&self, pkey: ProtectionKey) {
+        self.memories.release_pkey(pkey)
+    }
+
+    fn memory_stripes(&self) -> Vec<PoolMemoryStripe> {
+        self.memories.stripes()
+    }
+
     fn restrict_to_pkey(&self, pkey: ProtectionKey) {
         mpk::allow(ProtectionMask::zero().or(pkey));
     }
@@ -306,7 +306,6 @@ impl ModuleAffinityIndexAllocator {
     }
 
     /// Return the number of empty slots available in this allocator.
-    #[cfg(test)]
     pub fn num_empty_slots(&self) -> usize {
         let inner = self.0.lock().unwrap();
         let total_slots = inner.slot_state.len();
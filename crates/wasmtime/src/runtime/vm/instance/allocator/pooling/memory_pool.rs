@@ -57,7 +57,8 @@ use super::{
 use crate::prelude::*;
 use crate::runtime::vm::{
     CompiledModuleId, InstanceAllocationRequest, InstanceLimits, Memory, MemoryBase,
-    MemoryImageSlot, Mmap, MmapOffset, PoolingInstanceAllocatorConfig, mmap::AlignedLength,
+    MemoryImageSlot, Mmap, MmapOffset, PoolMemoryStripe, PoolingInstanceAllocatorConfig,
+    mmap::AlignedLength,
 };
 use crate::{
     MpkEnabled,
@@ -81,6 +82,8 @@ use wasmtime_environ::{DefinedMemoryIndex, Module, Tunables};
 struct Stripe {
     allocator: ModuleAffinityIndexAllocator,
     pkey: Option<ProtectionKey>,
+    /// The number of live stores which were handed this stripe's `pkey`.
+    stores: AtomicUsize,
 }
 
 /// Represents a pool of WebAssembly linear memories.
@@ -135,7 +138,8 @@ pub struct MemoryPool {
     pub(super) keep_resident: HostAlignedByteCount,
 
     /// Keep track of protection keys handed out to initialized stores; this
-    /// allows us to round-robin the assignment of stores to stripes.
+    /// allows us to round-robin the assignment of stores to equally-loaded
+    /// stripes.
     next_available_pkey: AtomicUsize,
 }
 
@@ -233,6 +237,7 @@ impl MemoryPool {
             Stripe {
                 allocator,
                 pkey: pkeys.get(i).cloned(),
+                stores: AtomicUsize::new(0),
             }
         };
 
@@ -255,13 +260,61 @@ impl MemoryPool {
     }
 
     /// Return a protection key that stores can use for requesting new
+    /// memories.
+    ///
+    /// Stores are assigned to the stripe with the fewest live stores, breaking
+    /// ties by the most free slots and then round-robin. This keeps slot usage
+    /// even across stripes so that the pool isn't exhausted by one stripe
+    /// filling up while others still have free slots.
     pub fn next_available_pkey(&self) -> Option<ProtectionKey> {
-        let index = self.next_available_pkey.fetch_add(1, Ordering::SeqCst) % self.stripes.len();
+        let start = self.next_available_pkey.fetch_add(1, Ordering::SeqCst);
+        let num_stripes = self.stripes.len();
+        let index = (0..num_stripes)
+            .map(|i| (start + i) % num_stripes)
+            .min_by(|&a, &b| {
+                let (a, b) = (&self.stripes[a], &self.stripes[b]);
+                let stores = |s: &Stripe| s.stores.load(Ordering::Relaxed);
+                stores(a).cmp(&stores(b)).then_with(|| {
+                    b.allocator
+                        .num_empty_slots()
+                        .cmp(&a.allocator.num_empty_slots())
+                })
+            })
+            .unwrap();
+        let stripe = &self.stripes[index];
         debug_assert!(
-            self.stripes.len() < 2 || self.stripes[index].pkey.is_some(),
+            self.stripes.len() < 2 || stripe.pkey.is_some(),
             "if we are using stripes, we cannot have an empty protection key"
         );
-        self.stripes[index].pkey
+        if stripe.pkey.is_some() {
+            stripe.stores.fetch_add(1, Ordering::Relaxed);
+        }
+        stripe.pkey
+    }
+
+    /// Return a protection key previously returned by `next_available_pkey`
+    /// once the store using it has been dropped.
+    pub fn release_pkey(&self, pkey: ProtectionKey) {
+        let prev = self.stripes[pkey.as_stripe()]
+            .stores
+            .fetch_sub(1, Ordering::Relaxed);
+        debug_assert!(prev > 0);
+    }
+
+    /// Returns the current usage of each stripe in this pool.
+    pub fn stripes(&self) -> Vec<PoolMemoryStripe> {
+        self.stripes
+            .iter()
+            .map(|stripe| {
+                let total_slots = stripe.allocator.len();
+                PoolMemoryStripe {
+                    protected: stripe.pkey.is_some(),
+                    total_slots,
+                    used_slots: total_slots - stripe.allocator.num_empty_slots(),
+                    stores: stripe.stores.load(Ordering::Relaxed),
+                }
+            })
+            .collect()
     }
 
     /// Validate whether this memory pool supports the given module.
@@ -362,7 +415,7 @@ impl MemoryPool {
 
             let mut slot = self.take_memory_image_slot(allocation_index);
             let image = match memory_index {
-                Some(memory_index) => request.runtime_info.memory_image(memory_index)?,
+                Some(memory_index) => request.memory_image(memory_index)?,
                 None => None,
             };
             let initial_size = ty
@@ -860,6 +913,41 @@ mod tests {
         );
     }
 
+    #[test]
+    #[cfg_attr(miri, ignore)]
+    fn test_pooling_allocator_stripe_balancing() {
+        if !mpk::is_supported() {
+            println!(
+                "skipping `test_pooling_allocator_stripe_balancing` test; mpk is not supported"
+            );
+            return;
+        }
+
+        let config = PoolingInstanceAllocatorConfig {
+            memory_protection_keys: MpkEnabled::Enable,
+            ..PoolingInstanceAllocatorConfig::default()
+        };
+        let pool = MemoryPool::new(&config, &Tunables::default_host()).unwrap();
+        let num_stripes = pool.stripes.len();
+        assert!(num_stripes >= 2);
+
+        // Handing out a key per store spreads the stores evenly.
+        let pkeys = (0..2 * num_stripes)
+            .map(|_| pool.next_available_pkey().unwrap())
+            .collect::<Vec<_>>();
+        assert!(pool.stripes().iter().all(|s| s.stores == 2));
+
+        // Dropping the stores of one stripe makes it the next one to be used.
+        for pkey in pkeys.iter().filter(|k| k.as_stripe() == 1) {
+            pool.release_pkey(*pkey);
+        }
+        assert_eq!(pool.stripes()[1].stores, 0);
+        assert_eq!(pool.next_available_pkey().unwrap().as_stripe(), 1);
+        assert_eq!(pool.next_available_pkey().unwrap().as_stripe(), 1);
+        assert!(pool.stripes().iter().all(|s| s.stores == 2));
+        assert!(pool.stripes().iter().all(|s| s.used_slots == 0));
+    }
+
     #[test]
     fn check_known_layout_calculations() {
         for num_pkeys_available in 0..16 {
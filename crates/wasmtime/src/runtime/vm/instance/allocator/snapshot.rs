@@ -0,0 +1,162 @@
+//! Initialization of new instances from memory contents captured from an
+//! already-running instance of the same module.
+
+use super::{initialize_globals, initialize_tables};
+use crate::Engine;
+use crate::prelude::*;
+use crate::runtime::vm::const_expr::{ConstEvalContext, ConstExprEvaluator};
+use crate::runtime::vm::{MemoryImage, MmapVec, ModuleMemoryImageSource};
+use crate::store::{InstanceId, StoreOpaque};
+use alloc::sync::Arc;
+use core::ptr;
+use wasmtime_environ::{DefinedMemoryIndex, Module, PrimaryMap};
+
+/// The contents of an instance's defined memories, captured while it was
+/// running, used to initialize the memories of new instances of the same
+/// module in place of its data segments.
+///
+/// Where possible each memory's contents are turned into a [`MemoryImage`] so
+/// that new instances map them copy-on-write instead of copying them, which
+/// makes creating many instances from one snapshot cheap.
+pub struct MemorySnapshot {
+    memories: PrimaryMap<DefinedMemoryIndex, SnapshotMemory>,
+}
+
+struct SnapshotMemory {
+    /// The size of the memory, in bytes, when it was captured.
+    byte_size: usize,
+
+    /// The offset within the memory that `contents` starts at.
+    offset: usize,
+
+    /// The contents of the memory starting at `offset`, with leading and
+    /// trailing zero pages trimmed, or `None` if the memory was all zeros.
+    contents: Option<Arc<SnapshotContents>>,
+
+    /// A copy-on-write image of `contents`, if one could be created.
+    image: Option<Arc<MemoryImage>>,
+}
+
+struct SnapshotContents(Vec<u8>);
+
+impl ModuleMemoryImageSource for SnapshotContents {
+    fn wasm_data(&self) -> &[u8] {
+        &self.0
+    }
+
+    fn mmap(&self) -> Option<&MmapVec> {
+        None
+    }
+}
+
+impl MemorySnapshot {
+    /// Captures `memories`, the contents of each of an instance's defined
+    /// memories in order.
+    ///
+    /// Images are only created if copy-on-write memory initialization is
+    /// enabled in `engine`.
+    pub fn new<'a>(
+        engine: &Engine,
+        memories: impl IntoIterator<Item = &'a [u8]>,
+    ) -> Result<MemorySnapshot> {
+        let granule = trim_granule();
+        let mut snapshot = PrimaryMap::new();
+        for memory in memories {
+            let pages = memory.chunks(granule);
+            let nonzero = |page: &[u8]| page.iter().any(|b| *b != 0);
+            let (first, last) = match pages.clone().position(nonzero) {
+                Some(first) => (first, pages.rposition(nonzero).unwrap()),
+                None => {
+                    snapshot.push(SnapshotMemory {
+                        byte_size: memory.len(),
+                        offset: 0,
+                        contents: None,
+                        image: None,
+                    });
+                    continue;
+                }
+            };
+
+            let offset = first * granule;
+            let end = ((last + 1) * granule).min(memory.len());
+            let contents = Arc::new(SnapshotContents(memory[offset..end].to_vec()));
+            let image = if engine.tunables().memory_init_cow {
+                MemoryImage::from_contents(engine, offset, &contents)?.map(Arc::new)
+            } else {
+                None
+            };
+            snapshot.push(SnapshotMemory {
+                byte_size: memory.len(),
+                offset,
+                contents: Some(contents),
+                image,
+            });
+        }
+        Ok(MemorySnapshot { memories: snapshot })
+    }
+
+    /// Returns the size, in bytes, that `memory` had when it was captured.
+    pub fn byte_size(&self, memory: DefinedMemoryIndex) -> usize {
+        self.memories[memory].byte_size
+    }
+
+    /// Returns the copy-on-write image to initialize `memory` with, if any.
+    pub fn memory_image(&self, memory: DefinedMemoryIndex) -> Option<&Arc<MemoryImage>> {
+        self.memories[memory].image.as_ref()
+    }
+}
+
+/// The granularity at which zeros are trimmed from captured memories, which
+/// is the host page size so that what remains can be mapped as an image.
+#[cfg(has_virtual_memory)]
+fn trim_granule() -> usize {
+    crate::runtime::vm::host_page_size()
+}
+
+#[cfg(not(has_virtual_memory))]
+fn trim_granule() -> usize {
+    wasmtime_environ::Memory::DEFAULT_PAGE_SIZE as usize
+}
+
+/// Initializes an instance whose memories were allocated from `snapshot`.
+///
+/// Globals and tables are initialized from the module as usual, but the
+/// module's data segments are skipped since memories already hold the
+/// snapshot's contents. Memories which weren't mapped from a copy-on-write
+/// image have the snapshot's contents copied into them instead.
+pub fn initialize_instance_from_snapshot(
+    store: &mut StoreOpaque,
+    instance: InstanceId,
+    module: &Module,
+    snapshot: &MemorySnapshot,
+) -> Result<()> {
+    let mut context = ConstEvalContext::new(instance);
+    let mut const_evaluator = ConstExprEvaluator::default();
+
+    initialize_globals(store, &mut context, &mut const_evaluator, module)?;
+    initialize_tables(store, &mut context, &mut const_evaluator, module)?;
+
+    let instance = store.instance_mut(instance);
+    for (index, memory) in snapshot.memories.iter() {
+        let contents = match &memory.contents {
+            Some(contents) => &contents.0,
+            None => continue,
+        };
+        if !instance.memories[index].1.needs_init() {
+            continue;
+        }
+        let definition = instance.get_memory(module.memory_index(index));
+        assert!(memory.offset + contents.len() <= definition.current_length());
+        // SAFETY: the assert above ensures that all `contents.len()` bytes
+        // starting at `memory.offset` are within this memory's accessible
+        // range. The source is the snapshot's own heap-allocated copy of the
+        // contents, taken in `MemorySnapshot::new`, so it can't overlap
+        // with the new instance's linear memory.
+        unsafe {
+            let dst = definition.base.as_ptr().add(memory.offset);
+            ptr::copy_nonoverlapping(contents.as_ptr(), dst, contents.len());
+        }
+    }
+
+    Ok(())
+}
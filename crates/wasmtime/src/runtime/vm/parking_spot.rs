@@ -8,6 +8,10 @@
 //!   on a queue keyed by some address.
 //! - *Unparking* refers to dequeuing a thread from a queue keyed by some address
 //!   and resuming it.
+//!
+//! Queues are spread across a fixed number of independently locked shards,
+//! selected by hashing the address, so that threads waiting on or notifying
+//! unrelated addresses don't contend on a single lock.
 
 #![deny(missing_docs)]
 
@@ -26,10 +30,31 @@ struct Spot {
     tail: Option<SendSyncPtr<WaiterInner>>,
 }
 
-/// The thread global `ParkingSpot`.
+/// The number of shards in a `ParkingSpot`, which must be a power of two.
+const NUM_SHARDS: usize = 64;
+
+/// One independently locked shard of a `ParkingSpot`.
+///
+/// This is aligned to avoid false sharing between the locks of neighboring
+/// shards.
 #[derive(Default, Debug)]
+#[repr(align(128))]
+struct Shard {
+    spots: Mutex<BTreeMap<u64, Spot>>,
+}
+
+/// The thread global `ParkingSpot`.
+#[derive(Debug)]
 pub struct ParkingSpot {
-    inner: Mutex<BTreeMap<u64, Spot>>,
+    shards: [Shard; NUM_SHARDS],
+}
+
+impl Default for ParkingSpot {
+    fn default() -> ParkingSpot {
+        ParkingSpot {
+            shards: core::array::from_fn(|_| Shard::default()),
+        }
+    }
 }
 
 #[derive(Default)]
@@ -108,10 +133,8 @@ impl ParkingSpot {
         deadline: Option<Instant>,
         waiter: &mut Waiter,
     ) -> WaitResult {
-        let mut inner = self
-            .inner
-            .lock()
-            .expect("failed to lock inner parking table");
+        let shard = self.shard(key);
+        let mut inner = shard.lock().expect("failed to lock inner parking table");
 
         // This is the "atomic" part of the `validate` check which ensure that
         // the memory location still indicates that we're allowed to block.
@@ -168,7 +191,7 @@ impl ParkingSpot {
 
                 drop(inner);
                 thread::park_timeout(timeout);
-                inner = self.inner.lock().unwrap();
+                inner = shard.lock().unwrap();
 
                 if ptr.as_ref().notified {
                     break false;
@@ -178,7 +201,11 @@ impl ParkingSpot {
             if timed_out {
                 // If this thread timed out then it is still present in the
                 // waiter queue, so remove it.
-                inner.get_mut(&key).unwrap().remove(ptr);
+                let spot = inner.get_mut(&key).unwrap();
+                spot.remove(ptr);
+                if spot.head.is_none() {
+                    inner.remove(&key);
+                }
                 WaitResult::TimedOut
             } else {
                 // If this node was notified then we should not be in a queue
@@ -218,16 +245,31 @@ impl ParkingSpot {
         unparked
     }
 
+    /// Runs `f` on the queue for `addr`, if any threads are waiting on it,
+    /// and discards the queue afterwards if it's empty.
     fn with_lot<T, F: FnMut(&mut Spot)>(&self, addr: &T, mut f: F) {
         let key = addr as *const _ as u64;
         let mut inner = self
-            .inner
+            .shard(key)
             .lock()
             .expect("failed to lock inner parking table");
         if let Some(spot) = inner.get_mut(&key) {
             f(spot);
+            if spot.head.is_none() {
+                inner.remove(&key);
+            }
         }
     }
+
+    /// Returns the shard responsible for waiters on `key`.
+    fn shard(&self, key: u64) -> &Mutex<BTreeMap<u64, Spot>> {
+        // Fibonacci hashing moves the low bits of the address, which are the
+        // ones that differ between nearby atomics, into the high bits which
+        // are used as the index.
+        let hash = key.wrapping_mul(0x9e37_79b9_7f4a_7c15);
+        let index = hash >> (u64::BITS - NUM_SHARDS.ilog2());
+        &self.shards[index as usize].spots
+    }
 }
 
 impl Waiter {
@@ -590,6 +632,41 @@ mod tests {
         }
     }
 
+    #[test]
+    fn empty_queues_are_discarded() {
+        let parking_spot = ParkingSpot::default();
+        let atomics = [AtomicU64::new(0), AtomicU64::new(0), AtomicU64::new(0)];
+        let num_queues = |spot: &ParkingSpot| {
+            spot.shards
+                .iter()
+                .map(|s| s.spots.lock().unwrap().len())
+                .sum::<usize>()
+        };
+
+        // A wait which times out removes its queue.
+        let mut waiter = Waiter::new();
+        let deadline = Instant::now() + Duration::from_millis(1);
+        parking_spot.wait64(&atomics[0], 0, deadline, &mut waiter);
+        assert_eq!(num_queues(&parking_spot), 0);
+
+        // As does notifying the last waiter of a queue.
+        thread::scope(|s| {
+            for atomic in &atomics {
+                s.spawn(|| {
+                    let mut waiter = Waiter::new();
+                    while atomic.load(Ordering::SeqCst) == 0 {
+                        parking_spot.wait64(atomic, 0, None, &mut waiter);
+                    }
+                });
+            }
+            for atomic in &atomics {
+                atomic.store(1, Ordering::SeqCst);
+                parking_spot.notify(atomic, 1);
+            }
+        });
+        assert_eq!(num_queues(&parking_spot), 0);
+    }
+
     #[test]
     fn wait_with_timeout() {
         let parking_spot = ParkingSpot::default();
@@ -2,11 +2,13 @@
 
 use crate::prelude::*;
 use crate::runtime::vm::sys::traphandlers::wasmtime_longjmp;
-use crate::runtime::vm::traphandlers::{TrapRegisters, TrapTest, tls};
+use crate::runtime::vm::traphandlers::{InterruptTest, TrapRegisters, TrapTest, tls};
 use std::cell::RefCell;
 use std::io;
 use std::mem;
 use std::ptr::{self, null_mut};
+use std::sync::Mutex;
+use std::sync::atomic::{AtomicBool, Ordering};
 
 /// Function which may handle custom signals while processing traps.
 pub type SignalHandler =
@@ -17,6 +19,7 @@ static mut PREV_SIGSEGV: libc::sigaction = UNINIT_SIGACTION;
 static mut PREV_SIGBUS: libc::sigaction = UNINIT_SIGACTION;
 static mut PREV_SIGILL: libc::sigaction = UNINIT_SIGACTION;
 static mut PREV_SIGFPE: libc::sigaction = UNINIT_SIGACTION;
+static mut PREV_SIGURG: libc::sigaction = UNINIT_SIGACTION;
 
 pub struct TrapHandler;
 
@@ -181,52 +184,188 @@ unsafe extern "C" fn trap_handler(
             TrapTest::HandledByEmbedder => return true,
             TrapTest::Trap { jmp_buf } => jmp_buf,
         };
-        // On macOS this is a bit special, unfortunately. If we were to
-        // `siglongjmp` out of the signal handler that notably does
-        // *not* reset the sigaltstack state of our signal handler. This
-        // seems to trick the kernel into thinking that the sigaltstack
-        // is still in use upon delivery of the next signal, meaning
-        // that the sigaltstack is not ever used again if we immediately
-        // call `wasmtime_longjmp` here.
-        //
-        // Note that if we use `longjmp` instead of `siglongjmp` then
-        // the problem is fixed. The problem with that, however, is that
-        // `setjmp` is much slower than `sigsetjmp` due to the
-        // preservation of the process's signal mask. The reason
-        // `longjmp` appears to work is that it seems to call a function
-        // (according to published macOS sources) called
-        // `_sigunaltstack` which updates the kernel to say the
-        // sigaltstack is no longer in use. We ideally want to call that
-        // here but I don't think there's a stable way for us to call
-        // that.
-        //
-        // Given all that, on macOS only, we do the next best thing. We
-        // return from the signal handler after updating the register
-        // context. This will cause control to return to our shim
-        // function defined here which will perform the
-        // `wasmtime_longjmp` (`siglongjmp`) for us. The reason this
-        // works is that by returning from the signal handler we'll
-        // trigger all the normal machinery for "the signal handler is
-        // done running" which will clear the sigaltstack flag and allow
-        // reusing it for the next signal. Then upon resuming in our custom
-        // code we blow away the stack anyway with a longjmp.
-        if cfg!(target_vendor = "apple") {
-            unsafe extern "C" fn wasmtime_longjmp_shim(jmp_buf: *const u8) {
-                unsafe { wasmtime_longjmp(jmp_buf) }
-            }
+        unsafe { resume_at_jmp_buf(context, jmp_buf) }
+    });
+
+    if handled {
+        return;
+    }
+
+    unsafe { delegate_signal_to_previous_handler(previous, signum, siginfo, context) }
+}
+
+/// Resumes execution at `jmp_buf` from within a signal handler invoked with
+/// `context`, unwinding the WebAssembly that was interrupted by the signal.
+///
+/// Returns `true` if the signal handler should return to let the resumption
+/// happen, which is only the case on macOS.
+unsafe fn resume_at_jmp_buf(context: *mut libc::c_void, jmp_buf: *const u8) -> bool {
+    // On macOS this is a bit special, unfortunately. If we were to
+    // `siglongjmp` out of the signal handler that notably does
+    // *not* reset the sigaltstack state of our signal handler. This
+    // seems to trick the kernel into thinking that the sigaltstack
+    // is still in use upon delivery of the next signal, meaning
+    // that the sigaltstack is not ever used again if we immediately
+    // call `wasmtime_longjmp` here.
+    //
+    // Note that if we use `longjmp` instead of `siglongjmp` then
+    // the problem is fixed. The problem with that, however, is that
+    // `setjmp` is much slower than `sigsetjmp` due to the
+    // preservation of the process's signal mask. The reason
+    // `longjmp` appears to work is that it seems to call a function
+    // (according to published macOS sources) called
+    // `_sigunaltstack` which updates the kernel to say the
+    // sigaltstack is no longer in use. We ideally want to call that
+    // here but I don't think there's a stable way for us to call
+    // that.
+    //
+    // Given all that, on macOS only, we do the next best thing. We
+    // return from the signal handler after updating the register
+    // context. This will cause control to return to our shim
+    // function defined here which will perform the
+    // `wasmtime_longjmp` (`siglongjmp`) for us. The reason this
+    // works is that by returning from the signal handler we'll
+    // trigger all the normal machinery for "the signal handler is
+    // done running" which will clear the sigaltstack flag and allow
+    // reusing it for the next signal. Then upon resuming in our custom
+    // code we blow away the stack anyway with a longjmp.
+    if cfg!(target_vendor = "apple") {
+        unsafe extern "C" fn wasmtime_longjmp_shim(jmp_buf: *const u8) {
+            unsafe { wasmtime_longjmp(jmp_buf) }
+        }
+        unsafe {
+            set_pc(context, wasmtime_longjmp_shim as usize, jmp_buf as usize);
+        }
+        return true;
+    }
+    unsafe { wasmtime_longjmp(jmp_buf) }
+}
+
+/// State shared between a store and its handles used to interrupt
+/// WebAssembly running in that store with a signal.
+///
+/// Interrupts are requested with [`InterruptState::interrupt`] and are then
+/// delivered either asynchronously by the `SIGURG` handler installed by
+/// [`init_interrupts`], if the thread running the store is executing
+/// WebAssembly when the signal arrives, or otherwise by the store itself the
+/// next time it transitions into WebAssembly.
+pub struct InterruptState {
+    /// Whether an interrupt has been requested and not yet delivered.
+    requested: AtomicBool,
+    /// The thread that's currently running this store's WebAssembly, if any.
+    ///
+    /// This is only read and written with the lock held which guarantees that
+    /// a signal is never sent to a thread that's since left WebAssembly, and
+    /// possibly exited.
+    thread: Mutex<InterruptThread>,
+}
+
+/// The thread registered with an [`InterruptState`], saved when WebAssembly is
+/// entered and restored when it's exited again.
+#[derive(Clone, Copy, Default)]
+pub struct InterruptThread(Option<libc::pthread_t>);
+
+impl InterruptState {
+    pub fn new() -> InterruptState {
+        InterruptState {
+            requested: AtomicBool::new(false),
+            thread: Mutex::new(InterruptThread::default()),
+        }
+    }
+
+    /// Requests that the WebAssembly running in this store is interrupted,
+    /// sending a signal to its thread if WebAssembly is running right now.
+    pub fn interrupt(&self) {
+        self.requested.store(true, Ordering::SeqCst);
+        let thread = self.thread.lock().unwrap();
+        if let Some(thread) = thread.0 {
             unsafe {
-                set_pc(context, wasmtime_longjmp_shim as usize, jmp_buf as usize);
+                libc::pthread_kill(thread, libc::SIGURG);
             }
-            return true;
         }
-        unsafe { wasmtime_longjmp(jmp_buf) }
+    }
+
+    /// Returns whether an interrupt has been requested and not yet delivered.
+    pub fn is_requested(&self) -> bool {
+        self.requested.load(Ordering::Relaxed)
+    }
+
+    /// Consumes a requested interrupt, returning whether there was one.
+    pub fn take_request(&self) -> bool {
+        self.requested.swap(false, Ordering::SeqCst)
+    }
+
+    /// Registers the current thread as the one running this store's
+    /// WebAssembly, returning the previously registered thread.
+    pub fn enter(&self) -> InterruptThread {
+        let current = InterruptThread(Some(unsafe { libc::pthread_self() }));
+        mem::replace(&mut *self.thread.lock().unwrap(), current)
+    }
+
+    /// Restores the `prev` thread returned from [`InterruptState::enter`].
+    pub fn exit(&self, prev: InterruptThread) {
+        *self.thread.lock().unwrap() = prev;
+    }
+}
+
+/// Installs the `SIGURG` handler used to deliver interrupts requested through
+/// [`InterruptState::interrupt`], if it isn't already installed.
+///
+/// `SIGURG` is used as it's ignored by default and otherwise rarely used,
+/// which is also why the Go runtime uses it for goroutine preemption. The
+/// handler forwards signals which weren't sent by Wasmtime to any handler
+/// previously installed.
+pub fn init_interrupts() {
+    static INIT: std::sync::Once = std::sync::Once::new();
+    INIT.call_once(|| unsafe {
+        let mut handler: libc::sigaction = mem::zeroed();
+        // SA_SIGINFO and SA_ONSTACK are used for the same reasons as the trap
+        // handlers above. SA_RESTART means that an interrupt which arrives
+        // while the host is blocked in a system call doesn't make that system
+        // call fail with `EINTR`.
+        handler.sa_flags = libc::SA_SIGINFO | libc::SA_ONSTACK | libc::SA_RESTART;
+        handler.sa_sigaction = interrupt_handler as usize;
+        libc::sigemptyset(&mut handler.sa_mask);
+        if libc::sigaction(libc::SIGURG, &handler, &raw mut PREV_SIGURG) != 0 {
+            panic!(
+                "unable to install signal handler: {}",
+                io::Error::last_os_error(),
+            );
+        }
+    });
+}
+
+unsafe extern "C" fn interrupt_handler(
+    signum: libc::c_int,
+    siginfo: *mut libc::siginfo_t,
+    context: *mut libc::c_void,
+) {
+    let handled = tls::with(|info| {
+        let Some(info) = info else {
+            return false;
+        };
+        let regs = unsafe { get_trap_registers(context, signum) };
+        match info.test_if_interrupt(regs) {
+            InterruptTest::NotRequested => false,
+            InterruptTest::Pending => true,
+            InterruptTest::Trap { jmp_buf } => unsafe { resume_at_jmp_buf(context, jmp_buf) },
+        }
     });
 
     if handled {
         return;
     }
 
-    unsafe { delegate_signal_to_previous_handler(previous, signum, siginfo, context) }
+    // Unlike the trap handlers above there's no faulting instruction to
+    // re-execute here, so only forward to a previous handler if there is one
+    // rather than resetting the signal's disposition.
+    unsafe {
+        let previous = &raw const PREV_SIGURG;
+        let action = (*previous).sa_sigaction;
+        if action != libc::SIG_DFL && action != libc::SIG_IGN {
+            delegate_signal_to_previous_handler(previous, signum, siginfo, context);
+        }
+    }
 }
 
 pub unsafe fn delegate_signal_to_previous_handler(
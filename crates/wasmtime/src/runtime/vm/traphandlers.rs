@@ -16,6 +16,8 @@ mod signals;
 pub use self::signals::*;
 
 use crate::runtime::module::lookup_code;
+#[cfg(all(feature = "std", unix, has_native_signals))]
+use crate::runtime::module::try_is_wasm_func;
 use crate::runtime::store::{ExecutorRef, StoreOpaque};
 use crate::runtime::vm::sys::traphandlers;
 use crate::runtime::vm::{InterpreterRef, VMContext, VMStoreContext, f32x4, f64x2, i8x16};
@@ -58,6 +60,24 @@ pub(crate) enum TrapTest {
     },
 }
 
+/// Return value from `test_if_interrupt`.
+#[cfg(all(feature = "std", unix, has_native_signals))]
+pub(crate) enum InterruptTest {
+    /// No interrupt was requested for the wasm running on this thread, so the
+    /// signal is forwarded to whatever process handler is next.
+    NotRequested,
+    /// An interrupt was requested but the wasm can't be unwound right now, for
+    /// example because the host is running, so it's left pending to be
+    /// delivered by the store later.
+    Pending,
+    /// The interrupt was delivered as a trap and the stack needs to be unwound
+    /// now.
+    Trap {
+        /// How to longjmp back to the original wasm frame.
+        jmp_buf: *const u8,
+    },
+}
+
 fn lazy_per_thread_init() {
     traphandlers::lazy_per_thread_init();
 }
@@ -445,6 +465,8 @@ where
 mod call_thread_state {
     use super::*;
     use crate::EntryStoreContext;
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    use crate::runtime::vm::{InterruptState, InterruptThread};
     use crate::runtime::vm::{Unwind, VMStackChain};
 
     /// Temporary state stored on the stack which is registered in the `tls`
@@ -473,6 +495,10 @@ mod call_thread_state {
         pub(super) jmp_buf: Cell<*const u8>,
         #[cfg(all(has_native_signals))]
         pub(super) signal_handler: Option<*const SignalHandler>,
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        pub(super) interrupt: Option<NonNull<InterruptState>>,
+        #[cfg(all(feature = "std", unix, has_native_signals))]
+        interrupt_prev_thread: Cell<InterruptThread>,
         pub(super) capture_backtrace: bool,
         #[cfg(feature = "coredump")]
         pub(super) capture_coredump: bool,
@@ -515,6 +541,10 @@ mod call_thread_state {
                 jmp_buf: Cell::new(ptr::null()),
                 #[cfg(all(has_native_signals))]
                 signal_handler: store.signal_handler(),
+                #[cfg(all(feature = "std", unix, has_native_signals))]
+                interrupt: store.interrupt_state(),
+                #[cfg(all(feature = "std", unix, has_native_signals))]
+                interrupt_prev_thread: Cell::new(InterruptThread::default()),
                 capture_backtrace: store.engine().config().wasm_backtrace,
                 #[cfg(feature = "coredump")]
                 capture_coredump: store.engine().config().coredump_on_trap,
@@ -564,6 +594,15 @@ mod call_thread_state {
         pub(crate) unsafe fn push(&self) {
             assert!(self.prev.get().is_null());
             self.prev.set(tls::raw::replace(self));
+
+            // Interrupts for this store are now sent to this thread, including
+            // when an async fiber's activations are pushed onto a different
+            // thread than the one they were suspended on.
+            #[cfg(all(feature = "std", unix, has_native_signals))]
+            if let Some(interrupt) = self.interrupt {
+                self.interrupt_prev_thread
+                    .set(unsafe { interrupt.as_ref().enter() });
+            }
         }
 
         /// Pops this `CallThreadState` from the linked list stored in TLS.
@@ -576,6 +615,11 @@ mod call_thread_state {
         /// Panics if this activation isn't the head of the list.
         #[inline]
         pub(crate) unsafe fn pop(&self) {
+            #[cfg(all(feature = "std", unix, has_native_signals))]
+            if let Some(interrupt) = self.interrupt {
+                unsafe { interrupt.as_ref().exit(self.interrupt_prev_thread.take()) }
+            }
+
             let prev = self.prev.replace(ptr::null());
             let head = tls::raw::replace(prev);
             assert!(core::ptr::eq(head, self));
@@ -791,6 +835,56 @@ impl CallThreadState {
         }
     }
 
+    /// Invoked by the platform's interrupt signal handler to deliver an
+    /// interrupt requested through this activation's store.
+    ///
+    /// An interrupt can only be delivered as a trap when native wasm code is
+    /// executing, and not for example when the host or Wasmtime's runtime is
+    /// running on behalf of wasm. In that case it's left pending for the store
+    /// to deliver the next time it returns to wasm.
+    #[cfg(all(feature = "std", unix, has_native_signals))]
+    pub(crate) fn test_if_interrupt(&self, regs: TrapRegisters) -> InterruptTest {
+        let Some(interrupt) = self.interrupt else {
+            return InterruptTest::NotRequested;
+        };
+        let interrupt = unsafe { interrupt.as_ref() };
+        if !interrupt.is_requested() {
+            return InterruptTest::NotRequested;
+        }
+
+        let jmp_buf = self.jmp_buf.get();
+        if jmp_buf.is_null() || jmp_buf == Self::JMP_BUF_INTERPRETER_SENTINEL.cast_const() {
+            return InterruptTest::Pending;
+        }
+
+        // Only unwind from within the body of a wasm function. Trampolines
+        // don't necessarily have a frame that the backtrace captured below
+        // can walk, and anything else isn't wasm at all. Looking up the code
+        // must not block as this thread may have been interrupted while
+        // holding the lock to register code.
+        if !try_is_wasm_func(regs.pc) {
+            return InterruptTest::Pending;
+        }
+
+        // Barriers for GC references are inlined into wasm code and aren't
+        // safe to stop halfway through, so only interrupt wasm asynchronously
+        // while this store doesn't have any GC objects.
+        if unsafe { self.vm_store_context.as_ref().gc_heap.current_length() } != 0 {
+            return InterruptTest::Pending;
+        }
+
+        // The store may have delivered the interrupt itself concurrently, in
+        // which case there's nothing left to do.
+        if !interrupt.take_request() {
+            return InterruptTest::Pending;
+        }
+
+        self.set_jit_trap(regs, None, wasmtime_environ::Trap::Interrupt);
+        InterruptTest::Trap {
+            jmp_buf: self.take_jmp_buf(),
+        }
+    }
+
     #[cfg(has_host_compiler_backend)]
     pub(crate) fn take_jmp_buf(&self) -> *const u8 {
         self.jmp_buf.replace(ptr::null())
@@ -55,4 +55,10 @@ impl<T> RwLock<T> {
     pub fn write(&self) -> impl DerefMut<Target = T> + '_ {
         self.0.write().unwrap()
     }
+
+    /// Acquires a read lock if that's possible without blocking.
+    #[inline]
+    pub fn try_read(&self) -> Option<impl Deref<Target = T> + '_> {
+        self.0.try_read().ok()
+    }
 }
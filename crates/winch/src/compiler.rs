@@ -7,8 +7,9 @@ use std::sync::Mutex;
 use wasmparser::FuncValidatorAllocations;
 use wasmtime_cranelift::CompiledFunction;
 use wasmtime_environ::{
-    CompileError, CompiledFunctionBody, DefinedFuncIndex, FuncKey, FunctionBodyData, FunctionLoc,
-    ModuleTranslation, ModuleTypesBuilder, PrimaryMap, StaticModuleIndex, Tunables, VMOffsets,
+    CompileError, CompiledFunctionBody, DefinedFuncIndex, FuncKey, FunctionBodyData,
+    FunctionCompileStats, FunctionLoc, ModuleTranslation, ModuleTypesBuilder, PrimaryMap,
+    StaticModuleIndex, Tunables, VMOffsets,
 };
 use winch_codegen::{BuiltinFunctions, CallingConvention, TargetIsa};
 
@@ -158,10 +159,16 @@ impl wasmtime_environ::Compiler for Compiler {
             self.emit_unwind_info(&mut func)?;
         }
 
+        let stats = FunctionCompileStats {
+            code_size: func.buffer.data().len(),
+            ..Default::default()
+        };
+
         Ok(CompiledFunctionBody {
             code: box_dyn_any_compiled_function(func),
             // TODO: Winch doesn't support GC objects and stack maps and all that yet.
             needs_gc_heap: false,
+            stats,
         })
     }
 
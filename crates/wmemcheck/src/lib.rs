@@ -9,8 +9,17 @@ use std::cmp::*;
 use std::collections::HashMap;
 
 /// Memory checker for wasm guest.
+///
+/// The state of each byte of guest memory, see [`MemState`], is stored as two
+/// bits in separate bitmaps so that checks and updates of a range of memory
+/// operate on 64 bytes at a time rather than byte-by-byte.
 pub struct Wmemcheck {
-    metadata: Vec<MemState>,
+    /// Set for bytes which are either [`MemState::ValidToWrite`] or
+    /// [`MemState::ValidToReadWrite`].
+    allocated: Bitmap,
+    /// Set for bytes which are [`MemState::ValidToReadWrite`]. Always a subset
+    /// of `allocated`.
+    defined: Bitmap,
     mallocs: HashMap<usize, usize>,
     pub stack_pointer: usize,
     max_stack_size: usize,
@@ -46,10 +55,10 @@ pub enum MemState {
 impl Wmemcheck {
     /// Initializes memory checker instance.
     pub fn new(mem_size: usize) -> Wmemcheck {
-        let metadata = vec![MemState::Unallocated; mem_size];
         let mallocs = HashMap::new();
         Wmemcheck {
-            metadata,
+            allocated: Bitmap::new(mem_size),
+            defined: Bitmap::new(mem_size),
             mallocs,
             stack_pointer: 0,
             max_stack_size: 0,
@@ -57,25 +66,27 @@ impl Wmemcheck {
         }
     }
 
+    /// Returns the memory state of the byte at `addr`.
+    pub fn state(&self, addr: usize) -> MemState {
+        if self.defined.get(addr) {
+            MemState::ValidToReadWrite
+        } else if self.allocated.get(addr) {
+            MemState::ValidToWrite
+        } else {
+            MemState::Unallocated
+        }
+    }
+
     /// Updates memory checker memory state metadata when malloc is called.
     pub fn malloc(&mut self, addr: usize, len: usize) -> Result<(), AccessError> {
         if !self.is_in_bounds_heap(addr, len) {
             return Err(AccessError::OutOfBounds { addr, len });
         }
-        for i in addr..addr + len {
-            match self.metadata[i] {
-                MemState::ValidToWrite => {
-                    return Err(AccessError::DoubleMalloc { addr, len });
-                }
-                MemState::ValidToReadWrite => {
-                    return Err(AccessError::DoubleMalloc { addr, len });
-                }
-                _ => {}
-            }
-        }
-        for i in addr..addr + len {
-            self.metadata[i] = MemState::ValidToWrite;
+        if self.allocated.any(addr, addr + len) {
+            return Err(AccessError::DoubleMalloc { addr, len });
         }
+        // Nothing in the range is allocated so nothing is defined either.
+        self.allocated.set(addr, addr + len, true);
         self.mallocs.insert(addr, len);
         Ok(())
     }
@@ -88,16 +99,8 @@ impl Wmemcheck {
         if !(self.is_in_bounds_stack(addr, len) || self.is_in_bounds_heap(addr, len)) {
             return Err(AccessError::OutOfBounds { addr, len });
         }
-        for i in addr..addr + len {
-            match self.metadata[i] {
-                MemState::Unallocated => {
-                    return Err(AccessError::InvalidRead { addr, len });
-                }
-                MemState::ValidToWrite => {
-                    return Err(AccessError::InvalidRead { addr, len });
-                }
-                _ => {}
-            }
+        if !self.defined.all(addr, addr + len) {
+            return Err(AccessError::InvalidRead { addr, len });
         }
         Ok(())
     }
@@ -110,14 +113,10 @@ impl Wmemcheck {
         if !(self.is_in_bounds_stack(addr, len) || self.is_in_bounds_heap(addr, len)) {
             return Err(AccessError::OutOfBounds { addr, len });
         }
-        for i in addr..addr + len {
-            if let MemState::Unallocated = self.metadata[i] {
-                return Err(AccessError::InvalidWrite { addr, len });
-            }
-        }
-        for i in addr..addr + len {
-            self.metadata[i] = MemState::ValidToReadWrite;
+        if !self.allocated.all(addr, addr + len) {
+            return Err(AccessError::InvalidWrite { addr, len });
         }
+        self.defined.set(addr, addr + len, true);
         Ok(())
     }
 
@@ -127,20 +126,17 @@ impl Wmemcheck {
             return Err(AccessError::InvalidFree { addr });
         }
         let len = self.mallocs[&addr];
-        for i in addr..addr + len {
-            if let MemState::Unallocated = self.metadata[i] {
-                return Err(AccessError::InvalidFree { addr });
-            }
+        if !self.allocated.all(addr, addr + len) {
+            return Err(AccessError::InvalidFree { addr });
         }
         self.mallocs.remove(&addr);
-        for i in addr..addr + len {
-            self.metadata[i] = MemState::Unallocated;
-        }
+        self.allocated.set(addr, addr + len, false);
+        self.defined.set(addr, addr + len, false);
         Ok(())
     }
 
     fn is_in_bounds_heap(&self, addr: usize, len: usize) -> bool {
-        self.max_stack_size <= addr && addr + len <= self.metadata.len()
+        self.max_stack_size <= addr && addr + len <= self.allocated.len
     }
 
     fn is_in_bounds_stack(&self, addr: usize, len: usize) -> bool {
@@ -155,13 +151,11 @@ impl Wmemcheck {
                 len: new_sp - self.stack_pointer,
             });
         } else if new_sp < self.stack_pointer {
-            for i in new_sp..self.stack_pointer + 1 {
-                self.metadata[i] = MemState::ValidToReadWrite;
-            }
+            self.allocated.set(new_sp, self.stack_pointer + 1, true);
+            self.defined.set(new_sp, self.stack_pointer + 1, true);
         } else {
-            for i in self.stack_pointer..new_sp {
-                self.metadata[i] = MemState::Unallocated;
-            }
+            self.allocated.set(self.stack_pointer, new_sp, false);
+            self.defined.set(self.stack_pointer, new_sp, false);
         }
         self.stack_pointer = new_sp;
         Ok(())
@@ -188,11 +182,134 @@ impl Wmemcheck {
 
     /// Updates memory checker metadata size when memory.grow is called.
     pub fn update_mem_size(&mut self, num_bytes: usize) {
-        let to_append = vec![MemState::Unallocated; num_bytes];
-        self.metadata.extend(to_append);
+        self.allocated.grow(num_bytes);
+        self.defined.grow(num_bytes);
+    }
+}
+
+/// One bit per byte of guest memory, packed into 64-bit words.
+///
+/// Bits past `len` in the last word are always clear, so growing the bitmap
+/// leaves the new bytes clear.
+struct Bitmap {
+    words: Vec<u64>,
+    len: usize,
+}
+
+/// Number of whole words which are checked at once by [`Bitmap::all`] and
+/// [`Bitmap::any`] before exiting early, which lets the compiler vectorize
+/// checks of large ranges.
+const BLOCK_WORDS: usize = 8;
+
+impl Bitmap {
+    fn new(len: usize) -> Bitmap {
+        Bitmap {
+            words: vec![0; len.div_ceil(64)],
+            len,
+        }
+    }
+
+    fn grow(&mut self, additional: usize) {
+        self.len += additional;
+        self.words.resize(self.len.div_ceil(64), 0);
+    }
+
+    fn get(&self, index: usize) -> bool {
+        assert!(index < self.len);
+        self.words[index / 64] & (1 << (index % 64)) != 0
+    }
+
+    /// Splits the range `start..end` into the word containing its first bit,
+    /// the range of whole words in between, and the word containing its last
+    /// bit, along with the mask of the range's bits within the first and last
+    /// words.
+    ///
+    /// Small accesses which don't straddle a word boundary, which is always
+    /// the case for naturally aligned loads and stores, only have a first
+    /// word.
+    fn split(&self, start: usize, end: usize) -> Split {
+        assert!(start < end && end <= self.len);
+        let (first, last) = (start / 64, (end - 1) / 64);
+        let first_mask = !0u64 << (start % 64);
+        let last_mask = !0u64 >> (63 - (end - 1) % 64);
+        if first == last {
+            Split::Single(first, first_mask & last_mask)
+        } else {
+            Split::Multiple {
+                first: (first, first_mask),
+                whole: first + 1..last,
+                last: (last, last_mask),
+            }
+        }
+    }
+
+    /// Sets or clears all bits in `start..end`.
+    fn set(&mut self, start: usize, end: usize, value: bool) {
+        if start == end {
+            return;
+        }
+        let apply = |word: &mut u64, mask: u64| {
+            if value {
+                *word |= mask;
+            } else {
+                *word &= !mask;
+            }
+        };
+        match self.split(start, end) {
+            Split::Single(i, mask) => apply(&mut self.words[i], mask),
+            Split::Multiple { first, whole, last } => {
+                apply(&mut self.words[first.0], first.1);
+                self.words[whole].fill(if value { !0 } else { 0 });
+                apply(&mut self.words[last.0], last.1);
+            }
+        }
+    }
+
+    /// Returns whether all bits in `start..end` are set.
+    fn all(&self, start: usize, end: usize) -> bool {
+        if start == end {
+            return true;
+        }
+        match self.split(start, end) {
+            Split::Single(i, mask) => self.words[i] & mask == mask,
+            Split::Multiple { first, whole, last } => {
+                self.words[first.0] & first.1 == first.1
+                    && self.words[last.0] & last.1 == last.1
+                    && self.words[whole]
+                        .chunks(BLOCK_WORDS)
+                        .all(|block| block.iter().fold(!0, |acc, w| acc & w) == !0)
+            }
+        }
+    }
+
+    /// Returns whether any bit in `start..end` is set.
+    fn any(&self, start: usize, end: usize) -> bool {
+        if start == end {
+            return false;
+        }
+        match self.split(start, end) {
+            Split::Single(i, mask) => self.words[i] & mask != 0,
+            Split::Multiple { first, whole, last } => {
+                self.words[first.0] & first.1 != 0
+                    || self.words[last.0] & last.1 != 0
+                    || self.words[whole]
+                        .chunks(BLOCK_WORDS)
+                        .any(|block| block.iter().fold(0, |acc, w| acc | w) != 0)
+            }
+        }
     }
 }
 
+/// A range of bits within a [`Bitmap`], see [`Bitmap::split`].
+enum Split {
+    Single(usize, u64),
+    Multiple {
+        first: (usize, u64),
+        whole: std::ops::Range<usize>,
+        last: (usize, u64),
+    },
+}
+
 #[test]
 fn basic_wmemcheck() {
     let mut wmemcheck_state = Wmemcheck::new(640 * 1024);
@@ -385,3 +502,65 @@ fn from_test_program() {
     assert!(wmemcheck_state.write(70832, 1).is_ok());
     assert!(wmemcheck_state.read(1138, 1).is_ok());
 }
+
+#[test]
+fn ranges_across_words() {
+    let mut wmemcheck_state = Wmemcheck::new(640 * 1024);
+
+    assert!(wmemcheck_state.malloc(0x1003, 1000).is_ok());
+    assert_eq!(wmemcheck_state.state(0x1002), MemState::Unallocated);
+    assert_eq!(wmemcheck_state.state(0x1003), MemState::ValidToWrite);
+    assert_eq!(wmemcheck_state.state(0x1003 + 999), MemState::ValidToWrite);
+    assert_eq!(wmemcheck_state.state(0x1003 + 1000), MemState::Unallocated);
+    assert_eq!(
+        wmemcheck_state.malloc(0x1003 + 999, 1),
+        Err(AccessError::DoubleMalloc {
+            addr: 0x1003 + 999,
+            len: 1
+        })
+    );
+
+    assert!(wmemcheck_state.write(0x1003, 900).is_ok());
+    assert!(wmemcheck_state.read(0x1003, 900).is_ok());
+    assert_eq!(
+        wmemcheck_state.read(0x1003, 901),
+        Err(AccessError::InvalidRead {
+            addr: 0x1003,
+            len: 901
+        })
+    );
+    assert_eq!(
+        wmemcheck_state.write(0x1003, 1001),
+        Err(AccessError::InvalidWrite {
+            addr: 0x1003,
+            len: 1001
+        })
+    );
+
+    assert!(wmemcheck_state.free(0x1003).is_ok());
+    assert_eq!(wmemcheck_state.state(0x1003 + 500), MemState::Unallocated);
+    assert!(wmemcheck_state.malloc(0x1000, 2048).is_ok());
+    assert_eq!(
+        wmemcheck_state.read(0x1010, 8),
+        Err(AccessError::InvalidRead {
+            addr: 0x1010,
+            len: 8
+        })
+    );
+}
+
+#[test]
+fn grow_memory() {
+    let mut wmemcheck_state = Wmemcheck::new(100);
+
+    assert!(wmemcheck_state.malloc(90, 10).is_ok());
+    assert_eq!(
+        wmemcheck_state.malloc(100, 10),
+        Err(AccessError::OutOfBounds { addr: 100, len: 10 })
+    );
+    wmemcheck_state.update_mem_size(64 * 1024);
+    assert_eq!(wmemcheck_state.state(100), MemState::Unallocated);
+    assert!(wmemcheck_state.malloc(100, 1000).is_ok());
+    assert!(wmemcheck_state.write(90, 1010).is_ok());
+    assert!(wmemcheck_state.read(95, 200).is_ok());
+}
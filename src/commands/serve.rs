@@ -21,8 +21,8 @@ use wasmtime::component::{Component, Linker, ResourceTable};
 use wasmtime::{Engine, Store, StoreLimits, UpdateDeadline};
 use wasmtime_wasi::p2::{StreamError, StreamResult};
 use wasmtime_wasi::{WasiCtx, WasiCtxBuilder, WasiCtxView, WasiView};
-use wasmtime_wasi_http::bindings::ProxyPre;
 use wasmtime_wasi_http::bindings::http::types::{ErrorCode, Scheme};
+use wasmtime_wasi_http::bindings::{Proxy, ProxyPre};
 use wasmtime_wasi_http::io::TokioIo;
 use wasmtime_wasi_http::{
     DEFAULT_OUTGOING_BODY_BUFFER_CHUNKS, DEFAULT_OUTGOING_BODY_CHUNK_SIZE, WasiHttpCtx,
@@ -113,6 +113,20 @@ pub struct ServeCommand {
     #[arg(long)]
     no_logging_prefix: bool,
 
+    /// Number of instances of the component to keep instantiated ahead of
+    /// incoming requests.
+    ///
+    /// Each request is still handled by an instance, with its own store and
+    /// resource table, which hasn't handled any other request. With this
+    /// option that instance is taken from a pool of up to `N` instances
+    /// created in the background, and a replacement is instantiated once the
+    /// request has started, which moves instantiation off of the request's
+    /// critical path. With the pooling allocator, the linear memories of
+    /// finished instances are reset by its copy-on-write machinery for reuse
+    /// by later ones. A value around the number of cores is a good start.
+    #[arg(long, value_name = "N", default_value_t = 0)]
+    prewarm_instances: usize,
+
     /// The WebAssembly component to run.
     #[arg(value_name = "WASM", required = true)]
     component: PathBuf,
@@ -420,6 +434,9 @@ impl ServeCommand {
         log::info!("Listening on {}", self.addr);
 
         let handler = ProxyHandler::new(self, engine, instance);
+        for _ in 0..handler.0.cmd.prewarm_instances {
+            handler.0.spawn_prewarm();
+        }
 
         loop {
             // Wait for a socket, but also "race" against shutdown to break out
@@ -711,12 +728,57 @@ struct ProxyHandlerInner {
     engine: Engine,
     instance_pre: ProxyPre<Host>,
     next_id: AtomicU64,
+    prewarmed: Mutex<Vec<FreshInstance>>,
+}
+
+/// An instance of the component which is yet to handle a request, along with
+/// the ID of the request it's going to handle.
+struct FreshInstance {
+    req_id: u64,
+    store: Store<Host>,
+    proxy: Proxy,
 }
 
 impl ProxyHandlerInner {
     fn next_req_id(&self) -> u64 {
         self.next_id.fetch_add(1, Ordering::Relaxed)
     }
+
+    /// Returns an instance to handle the next request, see
+    /// `--prewarm-instances`.
+    async fn take_instance(self: &Arc<Self>) -> Result<FreshInstance> {
+        let prewarmed = self.prewarmed.lock().unwrap().pop();
+        match prewarmed {
+            Some(instance) => {
+                self.spawn_prewarm();
+                Ok(instance)
+            }
+            None => self.instantiate().await,
+        }
+    }
+
+    async fn instantiate(&self) -> Result<FreshInstance> {
+        let req_id = self.next_req_id();
+        let mut store = self.cmd.new_store(&self.engine, req_id)?;
+        let proxy = self.instance_pre.instantiate_async(&mut store).await?;
+        Ok(FreshInstance {
+            req_id,
+            store,
+            proxy,
+        })
+    }
+
+    /// Instantiates the component in the background and adds the instance to
+    /// the pool of prewarmed instances.
+    fn spawn_prewarm(self: &Arc<Self>) {
+        let inner = self.clone();
+        tokio::task::spawn(async move {
+            match inner.instantiate().await {
+                Ok(instance) => inner.prewarmed.lock().unwrap().push(instance),
+                Err(e) => log::error!("failed to prewarm an instance: {e:?}"),
+            }
+        });
+    }
 }
 
 #[derive(Clone)]
@@ -729,6 +791,7 @@ impl ProxyHandler {
             engine,
             instance_pre,
             next_id: AtomicU64::from(0),
+            prewarmed: Mutex::new(Vec::new()),
         }))
     }
 }
@@ -742,7 +805,11 @@ async fn handle_request(
 ) -> Result<hyper::Response<HyperOutgoingBody>> {
     let (sender, receiver) = tokio::sync::oneshot::channel();
 
-    let req_id = inner.next_req_id();
+    let FreshInstance {
+        req_id,
+        mut store,
+        proxy,
+    } = inner.take_instance().await?;
 
     log::info!(
         "Request {req_id} handling {} to {}",
@@ -750,11 +817,8 @@ async fn handle_request(
         req.uri()
     );
 
-    let mut store = inner.cmd.new_store(&inner.engine, req_id)?;
-
     let req = store.data_mut().new_incoming_request(Scheme::Http, req)?;
     let out = store.data_mut().new_response_outparam(sender)?;
-    let proxy = inner.instance_pre.instantiate_async(&mut store).await?;
 
     let comp = component.clone();
     let task = tokio::task::spawn(async move {
@@ -1720,6 +1720,35 @@ mod test_programs {
         Ok(())
     }
 
+    #[tokio::test]
+    async fn cli_serve_count_requests() -> Result<()> {
+        for prewarm in ["0", "2"] {
+            let server = WasmtimeServe::new(CLI_SERVE_COUNT_REQUESTS_COMPONENT, |cmd| {
+                cmd.arg(format!("--prewarm-instances={prewarm}"));
+            })?;
+
+            // Every request is handled by an instance which hasn't seen any
+            // other request, whether or not it was instantiated ahead of time.
+            for _ in 0..5 {
+                let resp = server
+                    .send_request(
+                        hyper::Request::builder()
+                            .uri("http://localhost/")
+                            .body(String::new())
+                            .context("failed to make request")?,
+                    )
+                    .await?;
+
+                assert!(resp.status().is_success());
+                let headers = resp.headers();
+                assert_eq!(headers.get("count"), Some(&HeaderValue::from_static("1")));
+            }
+
+            server.finish()?;
+        }
+        Ok(())
+    }
+
     #[tokio::test]
     async fn cli_serve_outgoing_body_config() -> Result<()> {
         let server = WasmtimeServe::new(CLI_SERVE_ECHO_ENV_COMPONENT, |cmd| {
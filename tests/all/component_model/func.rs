@@ -4,7 +4,7 @@ use super::{REALLOC_AND_FREE, TypedFuncExt};
 use anyhow::Result;
 use std::sync::Arc;
 use wasmtime::component::*;
-use wasmtime::{Config, Engine, Store, StoreContextMut, Trap};
+use wasmtime::{Config, Engine, Store, StoreContextMut, Trap, ValRaw};
 
 const CANON_32BIT_NAN: u32 = 0b01111111110000000000000000000000;
 const CANON_64BIT_NAN: u64 = 0b0111111111111000000000000000000000000000000000000000000000000000;
@@ -815,6 +815,81 @@ fn strings() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn call_flat() -> Result<()> {
+    let component = format!(
+        r#"(component
+            (core module $m
+                (memory (export "memory") 1)
+                (func (export "roundtrip") (param i32 i32) (result i32)
+                    (local $base i32)
+                    (local.set $base
+                        (call $realloc
+                            (i32.const 0)
+                            (i32.const 0)
+                            (i32.const 4)
+                            (i32.const 8)))
+                    (i32.store offset=0
+                        (local.get $base)
+                        (local.get 0))
+                    (i32.store offset=4
+                        (local.get $base)
+                        (local.get 1))
+                    (local.get $base)
+                )
+
+                {REALLOC_AND_FREE}
+            )
+            (core instance $i (instantiate $m))
+
+            (func (export "roundtrip") (param "a" string) (result string)
+                (canon lift
+                    (core func $i "roundtrip")
+                    (memory $i "memory")
+                    (realloc (func $i "realloc"))
+                )
+            )
+        )"#
+    );
+
+    let engine = super::engine();
+    let component = Component::new(&engine, component)?;
+    let mut store = Store::new(&engine, ());
+    let instance = Linker::new(&engine).instantiate(&mut store, &component)?;
+    let roundtrip = instance.get_func(&mut store, "roundtrip").unwrap();
+
+    let input = "hello there";
+    let ret = roundtrip.call_flat(
+        &mut store,
+        |cx, params| {
+            assert_eq!(params.len(), 2);
+            let ptr = cx.realloc(0, 0, 1, input.len())?;
+            cx.as_slice_mut()[ptr..][..input.len()].copy_from_slice(input.as_bytes());
+            params[0] = ValRaw::u32(ptr as u32);
+            params[1] = ValRaw::u32(input.len() as u32);
+            Ok(())
+        },
+        |cx, results| {
+            assert_eq!(results.len(), 1);
+            let ret = results[0].get_u32() as usize;
+            let memory = cx.memory();
+            let ptr = u32::from_le_bytes(memory[ret..][..4].try_into().unwrap()) as usize;
+            let len = u32::from_le_bytes(memory[ret + 4..][..4].try_into().unwrap()) as usize;
+            Ok(String::from_utf8(memory[ptr..][..len].to_vec())?)
+        },
+    )?;
+    assert_eq!(ret, input);
+    roundtrip.post_return(&mut store)?;
+
+    // Errors from lowering are propagated.
+    let err = roundtrip
+        .call_flat(&mut store, |_, _| anyhow::bail!("oops"), |_, _| Ok(()))
+        .unwrap_err();
+    assert_eq!(err.to_string(), "oops");
+
+    Ok(())
+}
+
 #[tokio::test]
 async fn async_reentrance() -> Result<()> {
     _ = env_logger::try_init();
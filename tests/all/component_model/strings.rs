@@ -79,6 +79,9 @@ const STRINGS: &[&str] = &[
     //
     // 24 bytes in utf8, 13 units in utf16, first 8 usvs are latin1-compatible
     "à ascii ＶＷＸＹＺ",
+    // ascii prefix long enough to be transcoded with vector instructions,
+    // followed by latin1, utf16 and surrogate pair characters
+    "a long ascii prefix which is transcoded in bulk à ＶＷＸＹＺ \u{10000}",
 ];
 
 static ENCODINGS: [&str; 3] = ["utf8", "utf16", "latin1+utf16"];
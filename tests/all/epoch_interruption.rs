@@ -497,3 +497,88 @@ async fn drop_future_on_epoch_yield(config: &mut Config) -> Result<()> {
     assert_eq!(true, alive_flag.load(Ordering::Acquire));
     Ok(())
 }
+
+#[test]
+fn stack_sampler_attributes_samples_to_tags() -> Result<()> {
+    use std::time::Duration;
+
+    let mut config = Config::new();
+    config.epoch_interruption(true);
+    let engine = Engine::new(&config)?;
+    let module = spinner(&engine)?;
+    let sampler = StackSampler::new(&engine, Duration::from_millis(1))?;
+    spin_with_tags(&sampler, &module, &["tenant-a", "tenant-b"])?;
+
+    assert!(sampler.sample_count() > 0);
+    let folded = sampler.folded();
+    for line in folded.lines() {
+        let (stack, count) = line.rsplit_once(' ').unwrap();
+        assert!(count.parse::<u64>()? > 0);
+        assert!(
+            stack == "tenant-a;spinner`spin" || stack == "tenant-b;spinner`spin",
+            "unexpected stack: {line}"
+        );
+    }
+    assert!(folded.contains("tenant-a;"));
+    assert!(folded.contains("tenant-b;"));
+
+    sampler.reset();
+    assert_eq!(sampler.sample_count(), 0);
+    assert_eq!(sampler.folded(), "");
+    Ok(())
+}
+
+#[test]
+fn stack_sampler_limits_stacks() -> Result<()> {
+    use std::time::Duration;
+
+    let mut config = Config::new();
+    config.epoch_interruption(true);
+    let engine = Engine::new(&config)?;
+    assert!(StackSampler::new(&engine, Duration::ZERO).is_err());
+
+    let module = spinner(&engine)?;
+    let sampler = StackSampler::new(&engine, Duration::from_millis(1))?;
+    sampler.set_max_stacks(1);
+    spin_with_tags(&sampler, &module, &["tenant-a", "tenant-b"])?;
+
+    // Only the first stack is kept and the second tag's samples are only
+    // counted.
+    let folded = sampler.folded();
+    let stacks = folded
+        .lines()
+        .map(|line| line.rsplit_once(' ').unwrap().0)
+        .collect::<Vec<_>>();
+    assert_eq!(stacks, ["tenant-a;spinner`spin", "tenant-b;[other]"]);
+    Ok(())
+}
+
+fn spinner(engine: &Engine) -> Result<Module> {
+    Module::new(
+        engine,
+        r#"
+            (module $spinner
+                (import "" "done" (func $done (result i32)))
+                (func $spin (export "spin")
+                    (loop $l
+                        (br_if $l (i32.eqz (call $done))))))
+        "#,
+    )
+}
+
+// Spins in `module` for 50ms in a new store for each of `tags`, in order.
+fn spin_with_tags(sampler: &StackSampler, module: &Module, tags: &[&str]) -> Result<()> {
+    use std::time::{Duration, Instant};
+
+    for tag in tags {
+        let mut store = Store::new(module.engine(), Instant::now());
+        sampler.attach(&mut store, tag);
+        let done = Func::wrap(&mut store, |caller: Caller<'_, Instant>| {
+            i32::from(caller.data().elapsed() > Duration::from_millis(50))
+        });
+        let instance = Instance::new(&mut store, module, &[done.into()])?;
+        let spin = instance.get_typed_func::<(), ()>(&mut store, "spin")?;
+        spin.call(&mut store, ())?;
+    }
+    Ok(())
+}
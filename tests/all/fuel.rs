@@ -48,6 +48,142 @@ fn run(config: &mut Config) -> Result<()> {
     Ok(())
 }
 
+#[wasmtime_test]
+#[cfg_attr(miri, ignore)]
+fn approximate_is_an_upper_bound(config: &mut Config) -> Result<()> {
+    config.consume_fuel(true);
+    config.approximate_fuel(true);
+    let test = std::fs::read_to_string("tests/all/fuel.wast")?;
+    let buf = ParseBuffer::new(&test)?;
+    let mut wast = parser::parse::<FuelWast<'_>>(&buf)?;
+    for (span, fuel, module) in wast.assertions.iter_mut() {
+        let consumed = fuel_consumed(&config, &module.encode()?)?;
+        if consumed >= *fuel {
+            continue;
+        }
+        let (line, col) = span.linecol_in(&test);
+        panic!(
+            "tests/all/fuel.wast:{}:{} - expected at least {} fuel, found {}",
+            line + 1,
+            col + 1,
+            fuel,
+            consumed
+        );
+    }
+    Ok(())
+}
+
+#[wasmtime_test]
+#[cfg_attr(miri, ignore)]
+fn approximate_loops(config: &mut Config) -> Result<()> {
+    config.consume_fuel(true);
+    config.approximate_fuel(true);
+
+    // Without any conditionally executed code the approximation is exact: 1
+    // for entering the function, 2 for the code before the loop and 5 for
+    // each of the 100 iterations.
+    let wasm = wat::parse_str(
+        r#"
+            (module
+                (func $f
+                    (local i32)
+                    i32.const 100
+                    local.set 0
+                    loop
+                        local.get 0
+                        i32.const 1
+                        i32.sub
+                        local.tee 0
+                        br_if 0
+                    end
+                )
+                (start $f)
+            )
+        "#,
+    )?;
+    assert_eq!(fuel_consumed(&config, &wasm)?, 503);
+
+    // Infinite loops still run out of fuel.
+    let engine = Engine::new(&config)?;
+    let module = Module::new(&engine, "(module (func loop br 0 end) (start 0))")?;
+    let mut store = Store::new(&engine, ());
+    store.set_fuel(10_000)?;
+    let error = Instance::new(&mut store, &module, &[]).err().unwrap();
+    assert_eq!(error.downcast::<Trap>().unwrap(), Trap::OutOfFuel);
+    Ok(())
+}
+
+#[wasmtime_test]
+#[cfg_attr(miri, ignore)]
+fn approximate_skips_untaken_arms(config: &mut Config) -> Result<()> {
+    config.consume_fuel(true);
+
+    // A loop which runs one of three large `br_table` targets and one of two
+    // large `if`/`else` arms per iteration. Charging the arms which aren't
+    // taken would make the approximation several times the exact amount.
+    let arm = "i32.const 0 drop ".repeat(100);
+    let wat = format!(
+        r#"
+            (module
+                (func $f
+                    (local i32)
+                    i32.const 300
+                    local.set 0
+                    loop
+                        block
+                            block
+                                block
+                                    local.get 0
+                                    i32.const 3
+                                    i32.rem_u
+                                    br_table 0 1 2
+                                end
+                                {arm}
+                                br 1
+                            end
+                            {arm}
+                            local.get 0
+                            br_if 0
+                            {arm}
+                        end
+                        local.get 0
+                        i32.const 1
+                        i32.and
+                        if
+                            {arm}
+                        else
+                            {arm}
+                            local.get 0
+                            i32.const 4
+                            i32.lt_u
+                            if
+                                {arm}
+                            end
+                        end
+                        local.get 0
+                        i32.const 1
+                        i32.sub
+                        local.tee 0
+                        br_if 0
+                    end
+                )
+                (start $f)
+            )
+        "#
+    );
+    let wasm = wat::parse_str(&wat)?;
+
+    config.approximate_fuel(false);
+    let exact = fuel_consumed(&config, &wasm)?;
+    config.approximate_fuel(true);
+    let approximate = fuel_consumed(&config, &wasm)?;
+    assert!(
+        exact <= approximate && approximate <= 2 * exact,
+        "exact fuel {exact}, approximate fuel {approximate}"
+    );
+    Ok(())
+}
+
 fn fuel_consumed(config: &Config, wasm: &[u8]) -> Result<u64> {
     let engine = Engine::new(&config)?;
     let module = Module::new(&engine, wasm)?;
@@ -1394,3 +1394,65 @@ fn drc_gc_inbetween_host_calls() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn drc_nursery_survivors_interleaved_with_garbage() -> Result<()> {
+    let _ = env_logger::try_init();
+
+    let mut config = Config::new();
+    config.wasm_function_references(true);
+    config.wasm_gc(true);
+    config.collector(Collector::DeferredReferenceCounting);
+
+    let engine = Engine::new(&config)?;
+
+    let module = Module::new(
+        &engine,
+        r#"
+            (module
+                (type $node (struct (field i32) (field (ref null $node))))
+
+                (func (export "run") (param $n i32) (result i32)
+                    (local $list (ref null $node))
+                    (local $i i32)
+                    (local $sum i32)
+
+                    ;; Build a list of `n` nodes, with garbage allocated
+                    ;; before and after every node that stays alive.
+                    (loop $build
+                        (drop (struct.new $node (i32.const -1) (ref.null $node)))
+                        (local.set $list (struct.new $node (local.get $i) (local.get $list)))
+                        (drop (struct.new $node (i32.const -1) (local.get $list)))
+                        (br_if $build
+                            (i32.lt_u
+                                (local.tee $i (i32.add (local.get $i) (i32.const 1)))
+                                (local.get $n))))
+
+                    ;; Sum up the list.
+                    (loop $sum
+                        (local.set $sum
+                            (i32.add
+                                (local.get $sum)
+                                (struct.get $node 0 (local.get $list))))
+                        (br_if $sum
+                            (i32.eqz
+                                (ref.is_null
+                                    (local.tee $list
+                                        (struct.get $node 1 (local.get $list)))))))
+                    (local.get $sum))
+            )
+        "#,
+    )?;
+
+    let mut store = Store::new(&engine, ());
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let run = instance.get_typed_func::<u32, u32>(&mut store, "run")?;
+
+    for n in [1, 100, 10_000] {
+        assert_eq!(run.call(&mut store, n)?, n * (n - 1) / 2);
+        store.gc(None);
+    }
+
+    Ok(())
+}
@@ -135,3 +135,64 @@ fn function_interrupt_from_afar() -> anyhow::Result<()> {
     assert_eq!(trap, Trap::Interrupt);
     Ok(())
 }
+
+#[test]
+#[cfg(all(unix, has_native_signals))]
+fn loop_signal_interrupt_from_afar() -> anyhow::Result<()> {
+    use wasmtime::unix::StoreExt;
+
+    // Call an imported function once to learn that the loop is about to be
+    // entered. The loop itself has no calls and no epoch checks so it can
+    // only be stopped by a signal.
+    static STARTED: AtomicBool = AtomicBool::new(false);
+    let mut store = Store::<()>::default();
+    let module = Module::new(
+        store.engine(),
+        r#"
+            (import "" "" (func))
+
+            (func (export "loop")
+                call 0
+                (loop br 0)
+            )
+        "#,
+    )?;
+    let func = Func::wrap(&mut store, || {
+        STARTED.store(true, SeqCst);
+    });
+    let instance = Instance::new(&mut store, &module, &[func.into()])?;
+
+    let handle = store.interrupt_handle()?;
+    let thread = std::thread::spawn(move || {
+        while !STARTED.load(SeqCst) {
+            std::thread::yield_now();
+        }
+        std::thread::sleep(std::time::Duration::from_millis(10));
+        handle.interrupt();
+    });
+
+    let iloop = instance.get_typed_func::<(), ()>(&mut store, "loop")?;
+    let trap = iloop.call(&mut store, ()).unwrap_err().downcast::<Trap>()?;
+    thread.join().unwrap();
+    assert_eq!(trap, Trap::Interrupt);
+    Ok(())
+}
+
+#[test]
+#[cfg(all(unix, has_native_signals))]
+fn signal_interrupt_delivered_on_next_call() -> anyhow::Result<()> {
+    use wasmtime::unix::StoreExt;
+
+    let mut store = Store::<()>::default();
+    let module = Module::new(store.engine(), r#"(func (export "f"))"#)?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    let f = instance.get_typed_func::<(), ()>(&mut store, "f")?;
+
+    // An interrupt requested while no wasm is running traps the next call,
+    // and only that call.
+    store.interrupt_handle()?.interrupt();
+    let trap = f.call(&mut store, ()).unwrap_err().downcast::<Trap>()?;
+    assert_eq!(trap, Trap::Interrupt);
+    f.call(&mut store, ())?;
+    Ok(())
+}
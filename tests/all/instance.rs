@@ -79,3 +79,116 @@ fn linear_memory_limits() -> Result<()> {
         Ok(())
     }
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn instantiate_snapshot() -> Result<()> {
+    let wat = r#"
+        (module
+            (import "" "base" (global $base i32))
+            (memory (export "memory") 1)
+            (global $counter (export "counter") (mut i32) (i32.const 0))
+            (global $limit i64 (i64.const 7))
+            (data (i32.const 0) "initial")
+
+            (func $start
+                (i32.store8 (i32.const 100)
+                    (i32.add (i32.load8_u (i32.const 100)) (i32.const 1))))
+            (start $start)
+
+            (func (export "init")
+                (drop (memory.grow (i32.const 1)))
+                (i32.store (i32.const 0) (i32.const 0x61727261))
+                (i32.store (i32.const 65536) (global.get $base))
+                (global.set $counter (i32.const 10)))
+
+            (func (export "bump") (result i32)
+                (global.set $counter (i32.add (global.get $counter) (i32.const 1)))
+                (i32.store (i32.const 65536)
+                    (i32.add (i32.load (i32.const 65536)) (i32.const 1)))
+                (i32.load (i32.const 65536)))
+        )
+    "#;
+
+    for (cow, pooling) in [(true, false), (false, false), (true, true)] {
+        let mut config = Config::new();
+        config.memory_init_cow(cow);
+        if pooling {
+            let mut pool = crate::small_pool_config();
+            pool.total_memories(2);
+            pool.max_memory_size(2 << 16);
+            config.allocation_strategy(pool);
+        }
+        let engine = Engine::new(&config)?;
+        let module = Module::new(&engine, wat)?;
+
+        let mut parent = Store::new(&engine, ());
+        let base = Global::new(
+            &mut parent,
+            GlobalType::new(ValType::I32, Mutability::Const),
+            5.into(),
+        )?;
+        let instance = Instance::new(&mut parent, &module, &[base.into()])?;
+        instance
+            .get_typed_func::<(), ()>(&mut parent, "init")?
+            .call(&mut parent, ())?;
+        let snapshot = instance.snapshot(&parent)?;
+
+        // Writes to the parent after the snapshot aren't visible in children.
+        let memory = instance.get_memory(&mut parent, "memory").unwrap();
+        memory.data_mut(&mut parent)[0] = b'x';
+
+        for _ in 0..2 {
+            let mut store = Store::new(&engine, ());
+            let base = Global::new(
+                &mut store,
+                GlobalType::new(ValType::I32, Mutability::Const),
+                100.into(),
+            )?;
+            let mut linker = Linker::new(&engine);
+            linker.define(&store, "", "base", base)?;
+            let pre = linker.instantiate_pre(&module)?;
+            let child = pre.instantiate_snapshot(&mut store, &snapshot)?;
+
+            let memory = child.get_memory(&mut store, "memory").unwrap();
+            assert_eq!(memory.size(&store), 2);
+            // The data segment and `start` function weren't run again.
+            assert_eq!(&memory.data(&store)[..7], b"arraial");
+            assert_eq!(memory.data(&store)[100], 1);
+            let counter = child.get_global(&mut store, "counter").unwrap();
+            assert_eq!(counter.get(&mut store).unwrap_i32(), 10);
+
+            // Each child modifies its own copy of the snapshot.
+            let bump = child.get_typed_func::<(), i32>(&mut store, "bump")?;
+            assert_eq!(bump.call(&mut store, ())?, 6);
+            assert_eq!(bump.call(&mut store, ())?, 7);
+            assert_eq!(counter.get(&mut store).unwrap_i32(), 12);
+        }
+
+        let other = Module::new(&engine, r#"(module (import "" "base" (global i32)))"#)?;
+        let mut store = Store::new(&engine, ());
+        let base = Global::new(
+            &mut store,
+            GlobalType::new(ValType::I32, Mutability::Const),
+            0.into(),
+        )?;
+        let mut linker = Linker::new(&engine);
+        linker.define(&store, "", "base", base)?;
+        let pre = linker.instantiate_pre(&other)?;
+        assert!(pre.instantiate_snapshot(&mut store, &snapshot).is_err());
+    }
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn snapshot_rejects_mutable_reference_globals() -> Result<()> {
+    let mut store = Store::<()>::default();
+    let module = Module::new(
+        store.engine(),
+        r#"(module (global (mut funcref) (ref.null func)))"#,
+    )?;
+    let instance = Instance::new(&mut store, &module, &[])?;
+    assert!(instance.snapshot(&store).is_err());
+    Ok(())
+}
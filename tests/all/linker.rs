@@ -370,6 +370,87 @@ fn instance_pre() -> Result<()> {
     Ok(())
 }
 
+#[test]
+#[cfg_attr(miri, ignore)]
+fn instantiate_sees_new_definitions() -> Result<()> {
+    let engine = Engine::default();
+    let mut linker = Linker::new(&engine);
+    linker.allow_shadowing(true);
+    linker.func_wrap("", "f", || 1)?;
+
+    let module = Module::new(
+        &engine,
+        r#"(module
+            (import "" "f" (func $f (result i32)))
+            (func (export "run") (result i32) call $f)
+        )"#,
+    )?;
+    let run = |linker: &Linker<()>| -> Result<i32> {
+        let mut store = Store::new(&engine, ());
+        let instance = linker.instantiate(&mut store, &module)?;
+        let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        run.call(&mut store, ())
+    };
+    assert_eq!(run(&linker)?, 1);
+    assert_eq!(run(&linker)?, 1);
+
+    // Redefining the import is visible to the next instantiation.
+    linker.func_wrap("", "f", || 2)?;
+    assert_eq!(run(&linker)?, 2);
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn instantiate_many_modules() -> Result<()> {
+    let engine = Engine::default();
+    let mut linker = Linker::new(&engine);
+    linker.func_wrap("", "f", || 1)?;
+
+    // Instantiate more modules than the linker caches.
+    let modules = (0..100)
+        .map(|i| {
+            Module::new(
+                &engine,
+                format!(
+                    r#"(module
+                        (import "" "f" (func $f (result i32)))
+                        (func (export "run") (result i32) call $f i32.const {i} i32.add)
+                    )"#
+                ),
+            )
+        })
+        .collect::<Result<Vec<_>>>()?;
+    let mut store = Store::new(&engine, ());
+    for _ in 0..2 {
+        for i in 0..modules.len() {
+            // Every other instantiation is of the first module, which keeps
+            // it hot while the others cycle through the cache.
+            let i = if i % 2 == 0 { 0 } else { i };
+            let instance = linker.instantiate(&mut store, &modules[i])?;
+            let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+            assert_eq!(run.call(&mut store, ())?, 1 + i as i32);
+        }
+    }
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn instantiate_sees_memory_growth() -> Result<()> {
+    let engine = Engine::default();
+    let mut store = Store::new(&engine, ());
+    let memory = Memory::new(&mut store, MemoryType::new(1, None))?;
+    let mut linker = Linker::new(&engine);
+    linker.define(&mut store, "", "m", memory)?;
+
+    let module = Module::new(&engine, r#"(module (import "" "m" (memory 2)))"#)?;
+    assert!(linker.instantiate(&mut store, &module).is_err());
+    memory.grow(&mut store, 1)?;
+    linker.instantiate(&mut store, &module)?;
+    Ok(())
+}
+
 #[test]
 #[cfg_attr(miri, ignore)]
 fn test_trapping_unknown_import() -> Result<()> {
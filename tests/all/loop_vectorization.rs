@@ -0,0 +1,155 @@
+//! Tests that loops vectorized by Cranelift's `enable_loop_vectorization`
+//! setting compute the same results, and trap in the same way, as the scalar
+//! loops they replace.
+//!
+//! The vectorizer currently only applies on x86-64 hosts with SSE4.1; on other
+//! hosts these tests check the scalar loops against themselves.
+
+#![cfg(not(miri))]
+
+use wasmtime::*;
+
+const WAT: &str = r#"
+(module
+    (memory (export "memory") 1)
+
+    ;; Sums the `n` i32s at `p`.
+    (func (export "sum") (param $p i32) (param $n i32) (result i32)
+        (local $acc i32)
+        (if (local.get $n)
+            (then
+                (loop $l
+                    (local.set $acc
+                        (i32.add (local.get $acc) (i32.load (local.get $p))))
+                    (local.set $p (i32.add (local.get $p) (i32.const 4)))
+                    (br_if $l
+                        (local.tee $n (i32.sub (local.get $n) (i32.const 1))))
+                )
+            )
+        )
+        (local.get $acc)
+    )
+
+    ;; Xors the i64s from `p` up to, but not including, `end`.
+    (func (export "xor") (param $p i32) (param $end i32) (result i64)
+        (local $acc i64)
+        (if (i32.lt_u (local.get $p) (local.get $end))
+            (then
+                (loop $l
+                    (local.set $acc
+                        (i64.xor (local.get $acc) (i64.load (local.get $p))))
+                    (local.set $p (i32.add (local.get $p) (i32.const 8)))
+                    (br_if $l (i32.lt_u (local.get $p) (local.get $end)))
+                )
+            )
+        )
+        (local.get $acc)
+    )
+)
+"#;
+
+struct Tester {
+    store: Store<()>,
+    sum: TypedFunc<(u32, u32), u32>,
+    xor: TypedFunc<(u32, u32), u64>,
+}
+
+impl Tester {
+    fn new(vectorize: bool) -> Result<Tester> {
+        let mut config = Config::new();
+        config.cranelift_opt_level(OptLevel::Speed);
+        config.cranelift_loop_vectorization(vectorize);
+        let engine = Engine::new(&config)?;
+        let module = Module::new(&engine, WAT)?;
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+
+        // Fill memory with a pattern which doesn't repeat every vector.
+        let memory = instance.get_memory(&mut store, "memory").unwrap();
+        for (i, byte) in memory.data_mut(&mut store).iter_mut().enumerate() {
+            *byte = (i.wrapping_mul(37) ^ (i >> 8)) as u8;
+        }
+
+        let sum = instance.get_typed_func(&mut store, "sum")?;
+        let xor = instance.get_typed_func(&mut store, "xor")?;
+        Ok(Tester { store, sum, xor })
+    }
+
+    fn sum(&mut self, p: u32, n: u32) -> Result<u32> {
+        self.sum.call(&mut self.store, (p, n))
+    }
+
+    fn xor(&mut self, p: u32, end: u32) -> Result<u64> {
+        self.xor.call(&mut self.store, (p, end))
+    }
+}
+
+const PAGE: u32 = 0x10000;
+
+#[test]
+fn reductions_match_scalar_loops() -> Result<()> {
+    let mut scalar = Tester::new(false)?;
+    let mut vector = Tester::new(true)?;
+
+    // Cover lengths around multiples of the vector width, and unaligned
+    // start addresses.
+    for p in 0..20 {
+        for n in 0..70 {
+            assert_eq!(scalar.sum(p, n)?, vector.sum(p, n)?, "sum({p}, {n})");
+            let end = p + 8 * n;
+            assert_eq!(scalar.xor(p, end)?, vector.xor(p, end)?, "xor({p}, {end})");
+        }
+    }
+
+    // Loops ending exactly at the end of memory.
+    for n in 0..70 {
+        let p = PAGE - 4 * n;
+        assert_eq!(scalar.sum(p, n)?, vector.sum(p, n)?, "sum({p}, {n})");
+        let p = PAGE - 8 * n;
+        assert_eq!(scalar.xor(p, PAGE)?, vector.xor(p, PAGE)?, "xor({p})");
+    }
+    Ok(())
+}
+
+#[test]
+fn reductions_trap_like_scalar_loops() -> Result<()> {
+    let mut scalar = Tester::new(false)?;
+    let mut vector = Tester::new(true)?;
+
+    // Loops running off the end of memory, where a vector load would cover
+    // some bytes in bounds and some out of bounds.
+    for n in 1..40 {
+        for overrun in 1..8 {
+            let p = PAGE + overrun - 4 * n;
+            let s = scalar.sum(p, n).unwrap_err();
+            let v = vector.sum(p, n).unwrap_err();
+            assert_eq!(s.downcast_ref::<Trap>(), Some(&Trap::MemoryOutOfBounds));
+            assert_eq!(v.downcast_ref::<Trap>(), Some(&Trap::MemoryOutOfBounds));
+
+            let p = PAGE + overrun - 8 * n;
+            let end = PAGE + overrun;
+            let s = scalar.xor(p, end).unwrap_err();
+            let v = vector.xor(p, end).unwrap_err();
+            assert_eq!(s.downcast_ref::<Trap>(), Some(&Trap::MemoryOutOfBounds));
+            assert_eq!(v.downcast_ref::<Trap>(), Some(&Trap::MemoryOutOfBounds));
+        }
+    }
+
+    // Loops starting far out of bounds, near the top of the 32-bit address
+    // space.
+    assert_eq!(
+        scalar
+            .xor(u32::MAX - 0x100, u32::MAX)
+            .unwrap_err()
+            .downcast_ref::<Trap>(),
+        Some(&Trap::MemoryOutOfBounds),
+    );
+    assert_eq!(
+        vector
+            .xor(u32::MAX - 0x100, u32::MAX)
+            .unwrap_err()
+            .downcast_ref::<Trap>(),
+        Some(&Trap::MemoryOutOfBounds),
+    );
+    Ok(())
+}
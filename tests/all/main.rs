@@ -29,6 +29,7 @@ mod instance;
 mod invoke_func_via_table;
 mod limits;
 mod linker;
+mod loop_vectorization;
 mod memory;
 mod memory_creator;
 mod module;
@@ -649,3 +649,226 @@ fn deserialize_raw_fails_for_native() {
         );
     }
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn call_profile_guides_inlining() -> Result<()> {
+    use std::time::Duration;
+    use wasmtime_environ::{DefinedFuncIndex, StaticModuleIndex};
+
+    let wat = r#"
+        (module
+            (import "" "sample" (func $sample))
+            (func $callee (param i32) (result i32)
+                call $sample
+                (i32.add (local.get 0) (i32.const 1)))
+            (func (export "run") (param i32) (result i32)
+                (call $callee (local.get 0)))
+        )
+    "#;
+    let callee = (
+        StaticModuleIndex::from_u32(0),
+        DefinedFuncIndex::from_u32(0),
+    );
+    let run = (
+        StaticModuleIndex::from_u32(0),
+        DefinedFuncIndex::from_u32(1),
+    );
+
+    let mut config = Config::new();
+    config.compiler_inlining(true);
+    let engine = Engine::new(&config)?;
+
+    let profile_module = |module: &Module| -> Result<CallProfile> {
+        let engine = module.engine();
+        let profiler = GuestProfiler::new(
+            "test",
+            Duration::from_millis(1),
+            [("test".to_string(), module.clone())],
+        );
+        let mut store = Store::new(engine, Some(profiler));
+        let mut linker = Linker::new(engine);
+        linker.func_wrap(
+            "",
+            "sample",
+            |mut caller: Caller<'_, Option<GuestProfiler>>| {
+                let mut profiler = caller.data_mut().take().unwrap();
+                profiler.sample(&caller, Duration::ZERO);
+                *caller.data_mut() = Some(profiler);
+            },
+        )?;
+        let instance = linker.instantiate(&mut store, module)?;
+        let func = instance.get_typed_func::<i32, i32>(&mut store, "run")?;
+        for i in 0..10 {
+            assert_eq!(func.call(&mut store, i)?, i + 1);
+        }
+        Ok(store.data_mut().take().unwrap().call_profile().clone())
+    };
+
+    // Without a profile intra-module calls are not inlined, so both frames
+    // show up in samples.
+    let module = Module::new(&engine, wat)?;
+    let profile = profile_module(&module)?;
+    assert_eq!(profile.total_samples(), 10);
+    assert_eq!(profile.edge_samples(run, callee), 10);
+    assert!(profile.is_hot_edge(run, callee));
+
+    // Round-trip the profile through its serialized form and recompile with
+    // it; the hot edge is now inlined.
+    let profile_hot = CallProfile::from_bytes(&profile.to_bytes())?;
+    let module = CodeBuilder::new(&engine)
+        .wasm_binary_or_text(wat.as_bytes(), None)?
+        .call_profile(&profile_hot)?
+        .compile_module()?;
+    let profile = profile_module(&module)?;
+    assert_eq!(profile.total_samples(), 10);
+    assert_eq!(profile.func_samples(run), 10);
+    assert_eq!(profile.edge_samples(run, callee), 0);
+
+    // Explicitly disabling intra-module inlining takes precedence over the
+    // profile.
+    let mut config = Config::new();
+    config.compiler_inlining(true);
+    unsafe {
+        config.cranelift_flag_set("wasmtime_inlining_intra_module", "no");
+    }
+    let engine = Engine::new(&config)?;
+    let module = CodeBuilder::new(&engine)
+        .wasm_binary_or_text(wat.as_bytes(), None)?
+        .call_profile(&profile_hot)?
+        .compile_module()?;
+    let profile = profile_module(&module)?;
+    assert_eq!(profile.edge_samples(run, callee), 10);
+
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn compile_report() -> Result<()> {
+    let wat = r#"
+        (module
+            (import "" "f" (func))
+            (func $small (result i32)
+                i32.const 1)
+            (func $big (param i32) (result i32)
+                (local i32)
+                (loop $l
+                    (local.set 1 (i32.add (local.get 1) (local.get 0)))
+                    (br_if $l (local.tee 0 (i32.sub (local.get 0) (i32.const 1)))))
+                (local.get 1))
+        )
+    "#;
+    let engine = Engine::default();
+    let (module, report) = CodeBuilder::new(&engine)
+        .wasm_binary_or_text(wat.as_bytes(), None)?
+        .compile_module_with_report()?;
+    assert_eq!(module.imports().len(), 1);
+
+    assert!(!report.module_cache_hit());
+    let functions = report.functions();
+    assert_eq!(functions.len(), 2);
+    assert_eq!(functions[0].index(), 1);
+    assert!(functions[0].name().contains("small"));
+    assert_eq!(functions[1].index(), 2);
+    assert!(functions[1].name().contains("big"));
+    assert!(functions[0].wasm_size() < functions[1].wasm_size());
+    for f in functions {
+        assert!(f.code_size() > 0);
+        assert!(!f.cache_hit());
+    }
+    assert!(report.total_compile_time() >= functions[1].compile_time());
+
+    assert!(functions[0].ir_size() < functions[1].ir_size());
+    assert!(
+        functions[1]
+            .pass_times()
+            .iter()
+            .any(|(pass, _)| *pass == "Register allocation")
+    );
+
+    Ok(())
+}
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn streaming_module_builder() -> Result<()> {
+    let wasm = wat::parse_str(
+        r#"
+            (module
+                (memory 1)
+                (func $add (param i32 i32) (result i32)
+                    (i32.add (local.get 0) (local.get 1)))
+                (func (export "run") (result i32)
+                    (call $add (i32.const 1) (i32.load8_u (i32.const 1))))
+                (func $trap (export "trap")
+                    unreachable)
+                (data (i32.const 0) "hello"))
+        "#,
+    )?;
+
+    for parallel in [true, false] {
+        let mut config = Config::new();
+        config.parallel_compilation(parallel);
+        let engine = Engine::new(&config)?;
+
+        // Feed the binary a byte at a time to exercise every split point. The
+        // data and name sections follow the code section, so they're
+        // translated after the functions have been handed to the compiler.
+        let mut builder = StreamingModuleBuilder::new(&engine);
+        for byte in wasm.iter() {
+            builder.feed(std::slice::from_ref(byte))?;
+        }
+        let module = builder.finish()?;
+        let mut store = Store::new(&engine, ());
+        let instance = Instance::new(&mut store, &module, &[])?;
+        let run = instance.get_typed_func::<(), i32>(&mut store, "run")?;
+        assert_eq!(run.call(&mut store, ())?, 1 + i32::from(b'e'));
+        let trap = instance.get_typed_func::<(), ()>(&mut store, "trap")?;
+        let err = trap.call(&mut store, ()).unwrap_err();
+        let trace = err.downcast_ref::<WasmBacktrace>().unwrap();
+        assert_eq!(trace.frames()[0].func_name(), Some("trap"));
+
+        // The whole binary in one chunk works as well.
+        let mut builder = StreamingModuleBuilder::new(&engine);
+        builder.feed(&wasm)?;
+        builder.finish()?;
+    }
+
+    let engine = Engine::default();
+
+    // A truncated binary is only an error once it's known to be complete.
+    let mut builder = StreamingModuleBuilder::new(&engine);
+    builder.feed(&wasm[..wasm.len() - 1])?;
+    assert!(builder.finish().is_err());
+
+    // A builder can be dropped before the whole binary has arrived.
+    let mut builder = StreamingModuleBuilder::new(&engine);
+    builder.feed(&wasm[..wasm.len() / 2])?;
+    drop(builder);
+
+    // An invalid function body is rejected as soon as it has been compiled,
+    // without waiting for the rest of the module.
+    let wasm = wat::parse_str(
+        r#"
+            (module
+                (func (result i32) (i64.const 0))
+                (data "hello"))
+        "#,
+    )?;
+    let mut builder = StreamingModuleBuilder::new(&engine);
+    let end_of_code = wasm.len() - "hello".len() - 4;
+    builder.feed(&wasm[..end_of_code])?;
+    let err = loop {
+        if let Err(e) = builder.feed(&[]) {
+            break e;
+        }
+        std::thread::sleep(std::time::Duration::from_millis(1));
+    };
+    assert!(
+        format!("{err:?}").contains("type mismatch"),
+        "bad error: {err:?}"
+    );
+
+    Ok(())
+}
@@ -1333,3 +1333,43 @@ fn instantiate_non_page_aligned_sizes() -> Result<()> {
     Instance::new(&mut store, &module, &[])?;
     Ok(())
 }
+
+#[test]
+#[cfg_attr(miri, ignore)]
+fn memory_stripes_balance_stores() -> Result<()> {
+    let mut pool = crate::small_pool_config();
+    pool.total_memories(8)
+        .total_tables(8)
+        .memory_protection_keys(MpkEnabled::Auto)
+        .max_memory_protection_keys(2);
+    let mut config = Config::new();
+    config.memory_reservation(1 << 20);
+    config.memory_guard_size(1 << 16);
+    config.allocation_strategy(pool);
+    let engine = Engine::new(&config)?;
+    let module = Module::new(&engine, "(module (memory 1))")?;
+
+    let stripes = engine.pooling_memory_stripes();
+    assert_eq!(stripes.iter().map(|s| s.total_slots).sum::<usize>(), 8);
+    assert!(stripes.iter().all(|s| s.used_slots == 0 && s.stores == 0));
+
+    let mut stores = Vec::new();
+    for _ in 0..4 {
+        let mut store = Store::new(&engine, ());
+        Instance::new(&mut store, &module, &[])?;
+        stores.push(store);
+    }
+    let stripes = engine.pooling_memory_stripes();
+    assert_eq!(stripes.iter().map(|s| s.used_slots).sum::<usize>(), 4);
+    if stripes.len() >= 2 {
+        // Stores are spread evenly across the protection keys.
+        assert!(stripes.iter().all(|s| s.protected));
+        assert!(stripes.iter().all(|s| s.stores == 4 / stripes.len()));
+        assert!(stripes.iter().all(|s| s.used_slots == s.stores));
+    }
+
+    drop(stores);
+    let stripes = engine.pooling_memory_stripes();
+    assert!(stripes.iter().all(|s| s.used_slots == 0 && s.stores == 0));
+    Ok(())
+}
@@ -12,7 +12,10 @@ use crate::{
 use cranelift_codegen::{
     CallInfo, Final, MachBuffer, MachBufferFinalized, MachInst, MachInstEmit, MachInstEmitState,
     MachLabel, PatchRegion, Writable,
-    ir::{ExternalName, MemFlags, SourceLoc, TrapCode, Type, UserExternalNameRef, types},
+    binemit::CodeOffset,
+    ir::{
+        ExternalName, MemFlags, RelSourceLoc, SourceLoc, TrapCode, Type, UserExternalNameRef, types,
+    },
     isa::{
         unwind::UnwindInst,
         x64::{
@@ -31,7 +34,7 @@ use cranelift_codegen::{
 use crate::reg::WritableReg;
 use cranelift_assembler_x64 as asm;
 
-use super::address::Address;
+use super::{address::Address, regs};
 use smallvec::SmallVec;
 
 // Conversions between winch-codegen x64 types and cranelift-codegen x64 types.
@@ -277,6 +280,20 @@ pub(crate) enum VroundMode {
     TowardZero,
 }
 
+/// A store of a general purpose register into the current frame, recorded by
+/// the peephole optimizer when it is the last instruction emitted.
+#[derive(Copy, Clone)]
+struct FrameStore {
+    /// The register that was stored.
+    src: Reg,
+    /// The frame register, either `rsp` or `rbp`, used as the base.
+    base: Reg,
+    /// The offset from `base`.
+    offset: u32,
+    /// The size of the store.
+    size: OperandSize,
+}
+
 /// Low level assembler implementation for x64.
 pub(crate) struct Assembler {
     /// The machine instruction buffer.
@@ -289,26 +306,67 @@ pub(crate) struct Assembler {
     isa_flags: x64_settings::Flags,
     /// Constant pool.
     pool: ConstantPool,
+    /// Whether the peephole optimizations are enabled.
+    ///
+    /// The peephole optimizations only look at the immediately preceding
+    /// instruction, so they are applied while emitting and don't require an
+    /// additional pass over the buffer:
+    ///
+    /// * 64-bit register moves from a register to itself are dropped.
+    /// * A load from a frame slot immediately following a store of a
+    ///   register to the same slot is turned into a register move, or dropped
+    ///   entirely when the destination is the stored register. This is the
+    ///   common shape of `local.set` followed by `local.get`, or of spilling
+    ///   a value right before it's popped from the value stack.
+    peephole: bool,
+    /// The last instruction emitted, if it's a frame store and the peephole
+    /// optimizations are enabled.
+    ///
+    /// Cleared by every other instruction and by every direct access to the
+    /// underlying buffer, which is how labels are bound; this guarantees that
+    /// no other control flow can reach an instruction that is forwarded to.
+    last_store: Option<FrameStore>,
 }
 
 impl Assembler {
     /// Create a new x64 assembler.
-    pub fn new(shared_flags: settings::Flags, isa_flags: x64_settings::Flags) -> Self {
+    pub fn new(
+        shared_flags: settings::Flags,
+        isa_flags: x64_settings::Flags,
+        peephole: bool,
+    ) -> Self {
         Self {
             buffer: MachBuffer::<Inst>::new(),
             emit_state: Default::default(),
             emit_info: EmitInfo::new(shared_flags, isa_flags.clone()),
             pool: ConstantPool::new(),
             isa_flags,
+            peephole,
+            last_store: None,
         }
     }
 
     /// Get a mutable reference to underlying
     /// machine buffer.
     pub fn buffer_mut(&mut self) -> &mut MachBuffer<Inst> {
+        self.last_store = None;
         &mut self.buffer
     }
 
+    /// Starts a new source location range.
+    ///
+    /// Unlike [`Assembler::buffer_mut`], this doesn't prevent peephole
+    /// optimizations across the range boundary, since source locations have
+    /// no effect on control flow.
+    pub fn start_srcloc(&mut self, loc: RelSourceLoc) -> (CodeOffset, RelSourceLoc) {
+        self.buffer.start_srcloc(loc)
+    }
+
+    /// Ends the current source location range.
+    pub fn end_srcloc(&mut self) {
+        self.buffer.end_srcloc();
+    }
+
     /// Get a reference to the underlying machine buffer.
     pub fn buffer(&self) -> &MachBuffer<Inst> {
         &self.buffer
@@ -335,9 +393,44 @@ impl Assembler {
     }
 
     fn emit(&mut self, inst: Inst) {
+        self.last_store = None;
         inst.emit(&mut self.buffer, &self.emit_info, &mut self.emit_state);
     }
 
+    /// Returns the frame slot described by `addr`, if the peephole
+    /// optimizations are enabled and `addr` is relative to `rsp` or `rbp`.
+    fn frame_slot(&self, addr: &Address) -> Option<(Reg, u32)> {
+        match *addr {
+            Address::Offset { base, offset }
+                if self.peephole && (base == regs::rsp() || base == regs::rbp()) =>
+            {
+                Some((base, offset))
+            }
+            _ => None,
+        }
+    }
+
+    /// Attempts to forward the register stored by the previous instruction to
+    /// a load of `size` bytes from `addr` into `dst`.
+    ///
+    /// Returns `true` if the load was replaced and must not be emitted.
+    fn forward_frame_load(&mut self, addr: &Address, dst: WritableReg, size: OperandSize) -> bool {
+        let (Some(store), Some((base, offset))) = (self.last_store, self.frame_slot(addr)) else {
+            return false;
+        };
+        if store.base != base || store.offset != offset || store.size != size {
+            return false;
+        }
+        // A 32-bit move zero-extends into the full register just like the
+        // 32-bit load it replaces does, so only 64-bit self-moves can be
+        // elided by `mov_rr`.
+        self.mov_rr(store.src, dst, size);
+        // The value is still in memory and in `store.src`, so a subsequent
+        // load can be forwarded too.
+        self.last_store = Some(store);
+        true
+    }
+
     fn to_synthetic_amode(addr: &Address, memflags: MemFlags) -> SyntheticAmode {
         match *addr {
             Address::Offset { base, offset } => {
@@ -386,6 +479,9 @@ impl Assembler {
 
     /// Register-to-register move.
     pub fn mov_rr(&mut self, src: Reg, dst: WritableReg, size: OperandSize) {
+        if self.peephole && size == OperandSize::S64 && src == dst.to_reg() {
+            return;
+        }
         let dst: WritableGpr = dst.map(|r| r.into());
         let inst = match size {
             OperandSize::S8 => asm::inst::movb_mr::new(dst, src).into(),
@@ -409,6 +505,19 @@ impl Assembler {
             _ => unreachable!(),
         };
         self.emit(Inst::External { inst });
+
+        // Only full-width stores can be forwarded to loads, since the loads
+        // of narrower values that the peephole would see are extending.
+        if let (Some((base, offset)), OperandSize::S32 | OperandSize::S64) =
+            (self.frame_slot(addr), size)
+        {
+            self.last_store = Some(FrameStore {
+                src,
+                base,
+                offset,
+                size,
+            });
+        }
     }
 
     /// Immediate-to-memory move.
@@ -444,6 +553,12 @@ impl Assembler {
         ext: Option<Extend<Zero>>,
         memflags: MemFlags,
     ) {
+        match ext.map(ExtMode::from) {
+            None if self.forward_frame_load(addr, dst, OperandSize::S64) => return,
+            Some(ExtMode::LQ) if self.forward_frame_load(addr, dst, OperandSize::S32) => return,
+            _ => {}
+        }
+
         let src = Self::to_synthetic_amode(addr, memflags);
 
         if let Some(ext) = ext {
@@ -1294,11 +1294,11 @@ impl Masm for MacroAssembler {
     }
 
     fn start_source_loc(&mut self, loc: RelSourceLoc) -> Result<(CodeOffset, RelSourceLoc)> {
-        Ok(self.asm.buffer_mut().start_srcloc(loc))
+        Ok(self.asm.start_srcloc(loc))
     }
 
     fn end_source_loc(&mut self) -> Result<()> {
-        self.asm.buffer_mut().end_srcloc();
+        self.asm.end_srcloc();
         Ok(())
     }
 
@@ -3168,6 +3168,7 @@ impl MacroAssembler {
         ptr_size: impl PtrSize,
         shared_flags: settings::Flags,
         isa_flags: x64_settings::Flags,
+        peephole: bool,
     ) -> Result<Self> {
         let ptr_type: WasmValType = ptr_type_from_ptr_size(ptr_size.size());
 
@@ -3175,7 +3176,7 @@ impl MacroAssembler {
             sp_offset: 0,
             sp_max: 0,
             stack_max_use_add: None,
-            asm: Assembler::new(shared_flags.clone(), isa_flags.clone()),
+            asm: Assembler::new(shared_flags.clone(), isa_flags.clone(), peephole),
             flags: isa_flags,
             shared_flags,
             ptr_size: ptr_type.try_into()?,
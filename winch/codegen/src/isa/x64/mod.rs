@@ -101,6 +101,7 @@ impl TargetIsa for X64 {
             pointer_bytes,
             self.shared_flags.clone(),
             self.isa_flags.clone(),
+            tunables.winch_peephole,
         )?;
         let stack = Stack::new();
 